@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    AutomationBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    constexpr int numBenchmarkBlocks = 2000;
+
+    int getParameterIndex(TradeMarkEQAudioProcessor& processor, const juce::String& id)
+    {
+        auto* parameter = processor.apvts.getParameter(id);
+        jassert(parameter != nullptr);
+
+        return parameter->getParameterIndex();
+    }
+
+    //==============================================================================
+    /** Where a scheduled step lands: one block with the step at an offset
+        against the same block cut there by hand, and against the step
+        taking effect at the start of the block as it would unscheduled.
+    */
+    struct Timing
+    {
+        double scheduled{ 0 }, unscheduled{ 0 };
+    };
+
+    Timing measureTiming(int offset)
+    {
+        juce::AudioBuffer<float> input(2, Benchmark::blockSize);
+        Benchmark::fillWithNoise(input, 17);
+
+        const auto& ids = getPeakParameterIDs(2);
+        juce::MidiBuffer midi;
+
+        auto render = [&](auto&& process)
+        {
+            TradeMarkEQAudioProcessor processor;
+            Benchmark::setParameter(processor.apvts, ids.freq, 1000.f);
+            Benchmark::setParameter(processor.apvts, ids.gain, 0.f);
+            Benchmark::prepareToPlay(processor);
+
+            juce::AudioBuffer<float> buffer;
+            buffer.makeCopyOf(input);
+            process(processor, buffer);
+            return buffer;
+        };
+
+        const auto target = [&](TradeMarkEQAudioProcessor& processor)
+        {
+            auto* gain = processor.apvts.getParameter(ids.gain);
+            return gain->convertTo0to1(12.f);
+        };
+
+        auto byHand = render([&](TradeMarkEQAudioProcessor& processor, juce::AudioBuffer<float>& buffer)
+            {
+                juce::AudioBuffer<float> first(buffer.getArrayOfWritePointers(), 2, 0, offset);
+                juce::AudioBuffer<float> second(buffer.getArrayOfWritePointers(), 2, offset, Benchmark::blockSize - offset);
+
+                processor.processBlock(first, midi);
+                processor.apvts.getParameter(ids.gain)->setValueNotifyingHost(target(processor));
+                processor.processBlock(second, midi);
+            });
+
+        auto scheduled = render([&](TradeMarkEQAudioProcessor& processor, juce::AudioBuffer<float>& buffer)
+            {
+                processor.scheduleParameterChange(getParameterIndex(processor, ids.gain), target(processor), offset);
+                processor.processBlock(buffer, midi);
+            });
+
+        auto unscheduled = render([&](TradeMarkEQAudioProcessor& processor, juce::AudioBuffer<float>& buffer)
+            {
+                processor.apvts.getParameter(ids.gain)->setValueNotifyingHost(target(processor));
+                processor.processBlock(buffer, midi);
+            });
+
+        auto maximumDifference = [&](const juce::AudioBuffer<float>& other)
+        {
+            auto maximum = 0.f;
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int n = 0; n < Benchmark::blockSize; ++n)
+                    maximum = juce::jmax(maximum, std::abs(other.getSample(ch, n) - byHand.getSample(ch, n)));
+
+            return (double)juce::Decibels::gainToDecibels(maximum, -200.f);
+        };
+
+        return { maximumDifference(scheduled), maximumDifference(unscheduled) };
+    }
+
+    //==============================================================================
+    /** Changes to the first few bands' gains, every `interval` samples,
+        either a slow sine sampled that finely or steps between two values.
+    */
+    struct Pattern
+    {
+        const char* name;
+        int numParameters, interval;
+        bool steps;
+    };
+
+    template <typename Schedule>
+    void scheduleBlock(const Pattern& pattern, const std::vector<int>& indices, juce::int64 blockStart, Schedule&& schedule)
+    {
+        for (int p = 0; p < pattern.numParameters; ++p)
+        {
+            for (int offset = pattern.interval / 2; offset < Benchmark::blockSize; offset += pattern.interval)
+            {
+                const auto time = blockStart + offset;
+                const auto value = pattern.steps
+                    ? ((time / pattern.interval + p) % 2 == 0 ? 0.3f : 0.7f)
+                    : 0.5f + 0.25f * (float)std::sin(juce::MathConstants<double>::twoPi * (double)time / (2.0 * Benchmark::sampleRate) + p);
+
+                schedule(indices[(size_t)p], value, offset);
+            }
+        }
+    }
+
+    std::vector<int> getGainIndices(TradeMarkEQAudioProcessor& processor)
+    {
+        std::vector<int> indices;
+
+        for (int band = 0; band < 4; ++band)
+            indices.push_back(getParameterIndex(processor, getPeakParameterIDs(band).gain));
+
+        return indices;
+    }
+
+    /** The segments per block a pattern comes to, planned without the audio. */
+    double countSegments(const Pattern& pattern)
+    {
+        TradeMarkEQAudioProcessor processor;
+        AutomationScheduler scheduler(processor.getParameters());
+        const auto indices = getGainIndices(processor);
+
+        juce::int64 total = 0;
+
+        for (int block = 0; block < numBenchmarkBlocks; ++block)
+        {
+            scheduleBlock(pattern, indices, (juce::int64)block * Benchmark::blockSize, [&](int index, float value, int offset)
+                {
+                    scheduler.schedule(index, value, offset);
+                });
+
+            const auto numSegments = scheduler.beginBlock(Benchmark::blockSize);
+
+            for (int i = 0; i < numSegments; ++i)
+                scheduler.applySegment(i);
+
+            total += numSegments;
+        }
+
+        return (double)total / numBenchmarkBlocks;
+    }
+
+    double measureCost(const Pattern& pattern)
+    {
+        TradeMarkEQAudioProcessor processor;
+        Benchmark::setParameter(processor.apvts, "LowCut Slope", (float)Slope_24);
+        Benchmark::prepareToPlay(processor);
+
+        const auto indices = getGainIndices(processor);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        Benchmark::fillWithNoise(buffer, 18);
+
+        juce::MidiBuffer midi;
+        juce::int64 blockStart = 0;
+
+        return Benchmark::nanosecondsPerSample(numBenchmarkBlocks, [&]
+            {
+                scheduleBlock(pattern, indices, blockStart, [&](int index, float value, int offset)
+                    {
+                        processor.scheduleParameterChange(index, value, offset);
+                    });
+
+                processor.processBlock(buffer, midi);
+                blockStart += Benchmark::blockSize;
+            });
+    }
+}
+
+void runAutomationBenchmarks()
+{
+    Benchmark::printHeader("Step at an offset, against the block split by hand");
+
+    for (auto offset : { 37, 300, 511 })
+    {
+        const auto timing = measureTiming(offset);
+        const juce::String name("Offset " + juce::String(offset));
+
+        Benchmark::printRow(name + ", scheduled", timing.scheduled, "dB");
+        Benchmark::printRow(name + ", at the block start", timing.unscheduled, "dB");
+    }
+
+    Benchmark::printHeader("Automation, stereo, " + juce::String(Benchmark::blockSize) + " sample blocks");
+
+    const Pattern patterns[] = {
+        { "None", 0, 1, false },
+        { "One step per block", 1, Benchmark::blockSize, true },
+        { "Sine on a gain, every sample", 1, 1, false },
+        { "Sine on four gains, every 16", 4, 16, false },
+        { "Steps on four gains, every 8", 4, 8, true },
+    };
+
+    for (const auto& pattern : patterns)
+    {
+        Benchmark::printRow(juce::String(pattern.name) + ", CPU", measureCost(pattern), "ns/sample");
+        Benchmark::printRow(juce::String(pattern.name) + ", segments", countSegments(pattern), "per block");
+    }
+}
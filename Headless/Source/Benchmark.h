@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    Benchmark.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <iostream>
+
+namespace Benchmark
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    /** Runs fn() `repeats` times and returns the fastest run in seconds. Taking
+        the minimum keeps scheduler noise out of the numbers.
+    */
+    template <typename Fn>
+    double timeBestOf(int repeats, Fn&& fn)
+    {
+        auto best = std::numeric_limits<double>::max();
+
+        for (int i = 0; i < repeats; ++i)
+        {
+            auto start = juce::Time::getHighResolutionTicks();
+            fn();
+            auto end = juce::Time::getHighResolutionTicks();
+
+            best = juce::jmin(best, juce::Time::highResolutionTicksToSeconds(end - start));
+        }
+
+        return best;
+    }
+
+    /** Times `numBlocks` calls of processBlock() and returns ns per sample. */
+    template <typename Fn>
+    double nanosecondsPerSample(int numBlocks, Fn&& processBlock)
+    {
+        auto seconds = timeBestOf(5, [&]
+            {
+                for (int i = 0; i < numBlocks; ++i)
+                    processBlock();
+            });
+
+        return seconds * 1.0e9 / (double(numBlocks) * blockSize);
+    }
+
+    /** Prepares a processor the way a host does, telling it the sample rate first. */
+    inline void prepareToPlay(juce::AudioProcessor& processor, double rate = sampleRate, int maximumBlockSize = blockSize)
+    {
+        processor.setRateAndBufferSizeDetails(rate, maximumBlockSize);
+        processor.prepareToPlay(rate, maximumBlockSize);
+    }
+
+    inline void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::int64 seed)
+    {
+        juce::Random random(seed);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = random.nextFloat() * 2.f - 1.f;
+        }
+    }
+
+    inline void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& id, float value)
+    {
+        auto* parameter = apvts.getParameter(id);
+        jassert(parameter != nullptr);
+
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    inline void printHeader(const juce::String& title)
+    {
+        std::cout << std::endl << title << std::endl
+                  << juce::String::repeatedString("-", title.length()) << std::endl;
+    }
+
+    inline void printRow(const juce::String& name, double value, const juce::String& unit)
+    {
+        std::cout << name.paddedRight(' ', 40) << juce::String(value, 2).paddedLeft(' ', 10)
+                  << " " << unit << std::endl;
+    }
+}
+
+//==============================================================================
+void runCutFilterBenchmarks();
+void runPeakBandBenchmarks();
+void runDynamicBandBenchmarks();
+void runModulationBenchmarks();
+void runChannelModeBenchmarks();
+void runStateBenchmarks();
+void runPresetLibraryBenchmarks();
+void runCoefficientCacheBenchmarks();
+void runFootprintBenchmarks();
+void runIsaBenchmarks();
+void runLoudnessBenchmarks();
+void runPrecisionBenchmarks();
+void runAutomationBenchmarks();
+
+/** Runs growing numbers of instances in an AudioProcessorGraph, driven like
+    an audio device would drive them. Takes the maximum number of instances
+    and the seconds per run as optional arguments.
+*/
+void runStressTest(const juce::ArgumentList& args);
+
+/** Runs random settings, sample rates, block sizes and automation through
+    the original IIR::Filter chain and through every engine and instruction
+    set, and fails if any of them differs by more than float rounding. Takes
+    the number of cases and any number of audio files to run as well.
+*/
+void runEquivalenceTest(const juce::ArgumentList& args);
+
+/** Plays audio files, or noise, through an instance and prints what its
+    level and loudness meters read. Fails if the output peak or correlation
+    crosses the limits given with --max-peak= or --min-correlation=.
+*/
+void runLevelCheck(const juce::ArgumentList& args);
+
+/** Looks for resonances in audio files, or in noise with a hum and a
+    resonance, prints them with the notches the plug-in would suggest and
+    what the analysis costs. With --apply, runs the audio through the
+    notches and looks again.
+*/
+void runResonanceCheck(const juce::ArgumentList& args);
+
+/** Fits the match EQ to a reference and an input file, or to pink noise
+    and the same noise through a known EQ, and prints how long the analysis
+    and the fit take and how close the fit gets. With --apply, plays the
+    input through the plug-in with the fit set and measures it again.
+*/
+void runMatchCheck(const juce::ArgumentList& args);
+
+/** Renders the EQ curve, a preset's or a test curve with something of
+    everything, as minimum and linear phase impulses of several lengths, and
+    prints how long each takes and how far its magnitude response is from the
+    filters'. Writes the impulse to a file when given one.
+*/
+void runImpulseCheck(const juce::ArgumentList& args);
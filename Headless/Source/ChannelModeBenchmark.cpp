@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    ChannelModeBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    enum class Stereo
+    {
+        Linked,
+        Routed,
+        Unlinked
+    };
+
+    double measure(ChannelMode mode, Stereo stereo)
+    {
+        TradeMarkEQAudioProcessor processor;
+        auto& apvts = processor.apvts;
+
+        Benchmark::setParameter(apvts, "Channel Mode", (float)mode);
+        Benchmark::setParameter(apvts, "LowCut Freq", 40.f);
+        Benchmark::setParameter(apvts, "HighCut Freq", 16000.f);
+        Benchmark::setParameter(apvts, "LowCut Slope", (float)Slope_24);
+        Benchmark::setParameter(apvts, "HighCut Slope", (float)Slope_24);
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            auto& ids = getPeakParameterIDs(i);
+
+            Benchmark::setParameter(apvts, ids.gain, 3.f);
+
+            // Alternate the bands between the two channels.
+            if (stereo == Stereo::Routed)
+                Benchmark::setParameter(apvts, ids.channels,
+                    (float)(i % 2 == 0 ? ChannelRouting::LeftOrMid : ChannelRouting::RightOrSide));
+
+            // A different EQ on the second channel.
+            if (stereo == Stereo::Unlinked)
+            {
+                Benchmark::setParameter(apvts, ids.secondFreq, peakBands[i].defaultFreq * 1.5f);
+                Benchmark::setParameter(apvts, ids.secondGain, -4.f);
+                Benchmark::setParameter(apvts, ids.secondQuality, 2.f);
+            }
+        }
+
+        if (stereo == Stereo::Unlinked)
+        {
+            Benchmark::setParameter(apvts, "Channel Link", 1.f);
+            Benchmark::setParameter(apvts, "LowCut Freq 2", 80.f);
+            Benchmark::setParameter(apvts, "HighCut Freq 2", 12000.f);
+            Benchmark::setParameter(apvts, "LowCut Slope 2", (float)Slope_48);
+            Benchmark::setParameter(apvts, "HighCut Slope 2", (float)Slope_12);
+        }
+
+        Benchmark::prepareToPlay(processor);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        juce::MidiBuffer midi;
+
+        return Benchmark::nanosecondsPerSample(1000, [&]
+            {
+                Benchmark::fillWithNoise(buffer, 7);
+                processor.processBlock(buffer, midi);
+            });
+    }
+}
+
+void runChannelModeBenchmarks()
+{
+    Benchmark::printHeader("Channel modes, full processBlock, stereo, "
+        + juce::String(Benchmark::blockSize) + " sample blocks");
+
+    auto linked = measure(ChannelMode::LeftRight, Stereo::Linked);
+    Benchmark::printRow("Linked stereo", linked, "ns/sample");
+
+    auto routed = measure(ChannelMode::LeftRight, Stereo::Routed);
+    Benchmark::printRow("Bands routed left/right", routed, "ns/sample");
+    Benchmark::printRow("  relative to linked", routed / linked, "x");
+
+    // Each channel with its own EQ, still one stereo pass.
+    auto unlinked = measure(ChannelMode::LeftRight, Stereo::Unlinked);
+    Benchmark::printRow("Unlinked left/right", unlinked, "ns/sample");
+    Benchmark::printRow("  relative to linked", unlinked / linked, "x");
+
+    auto midSide = measure(ChannelMode::MidSide, Stereo::Unlinked);
+    Benchmark::printRow("Mid/side, unlinked", midSide, "ns/sample");
+    Benchmark::printRow("  relative to linked", midSide / linked, "x");
+}
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    CoefficientCacheBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    constexpr int numInstances = 100;
+    constexpr int numBlocks = 200;
+
+    // A mix template, seeded so every instance built from it matches exactly.
+    void applyTemplate(juce::AudioProcessorValueTreeState& apvts, juce::int64 seed)
+    {
+        juce::Random random(seed);
+
+        Benchmark::setParameter(apvts, "LowCut Freq", 30.f + random.nextFloat() * 100.f);
+        Benchmark::setParameter(apvts, "HighCut Freq", 12000.f + random.nextFloat() * 6000.f);
+        Benchmark::setParameter(apvts, "LowCut Slope", (float)Slope_24);
+        Benchmark::setParameter(apvts, "HighCut Slope", (float)Slope_48);
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            auto& ids = getPeakParameterIDs(i);
+            auto& band = peakBands[i];
+
+            Benchmark::setParameter(apvts, ids.freq, band.minFreq + random.nextFloat() * (band.maxFreq - band.minFreq));
+            Benchmark::setParameter(apvts, ids.gain, random.nextFloat() * 12.f - 6.f);
+            Benchmark::setParameter(apvts, ids.quality, 0.5f + random.nextFloat() * 2.f);
+        }
+    }
+
+    struct Result
+    {
+        double microsecondsPerCycle;
+        CoefficientCache::Statistics statistics;
+    };
+
+    // Every instance processes one block per cycle, like a host running a
+    // session with numInstances tracks.
+    Result measure(int numTemplates, bool useCache)
+    {
+        auto& cache = CoefficientCache::getInstance();
+        cache.setEnabled(useCache);
+        cache.clear();
+
+        std::vector<std::unique_ptr<TradeMarkEQAudioProcessor>> instances;
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            instances.push_back(std::make_unique<TradeMarkEQAudioProcessor>());
+            applyTemplate(instances.back()->apvts, i % numTemplates);
+            Benchmark::prepareToPlay(*instances.back());
+        }
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        juce::MidiBuffer midi;
+
+        Benchmark::fillWithNoise(buffer, 11);
+        cache.resetStatistics();
+
+        auto runCycles = [&]
+        {
+            for (int block = 0; block < numBlocks; ++block)
+                for (auto& instance : instances)
+                    instance->processBlock(buffer, midi);
+        };
+
+        // Timed as a session runs, without counting, then counted on a run of its own.
+        auto seconds = Benchmark::timeBestOf(3, runCycles);
+
+        cache.setCounting(true);
+        runCycles();
+        cache.setCounting(false);
+
+        auto statistics = cache.getStatistics();
+        cache.setEnabled(true);
+
+        return { seconds * 1.0e6 / numBlocks, statistics };
+    }
+
+    void printComparison(const juce::String& name, int numTemplates)
+    {
+        auto uncached = measure(numTemplates, false);
+        auto cached = measure(numTemplates, true);
+
+        Benchmark::printRow(name + ", no cache", uncached.microsecondsPerCycle, "us/cycle");
+        Benchmark::printRow(name + ", shared cache", cached.microsecondsPerCycle, "us/cycle");
+        Benchmark::printRow("  hit rate", cached.statistics.getHitRate() * 100.0, "%");
+        Benchmark::printRow("  saved", (1.0 - cached.microsecondsPerCycle / uncached.microsecondsPerCycle) * 100.0, "%");
+    }
+}
+
+void runCoefficientCacheBenchmarks()
+{
+    Benchmark::printHeader("Shared coefficient cache, " + juce::String(numInstances) + " instances, "
+        + juce::String(Benchmark::blockSize) + " sample blocks");
+
+    printComparison("1 template", 1);
+    printComparison("10 templates", 10);
+    printComparison("Every instance different", numInstances);
+}
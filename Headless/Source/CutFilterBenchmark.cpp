@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    CutFilterBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    using Filter = juce::dsp::IIR::Filter<float>;
+
+    // The cut filter as it was before FilterCascade: four IIR::Filters in a
+    // ProcessorChain, with the unused stages bypassed.
+    using LegacyCutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
+
+    template <int Index>
+    void setLegacyStage(LegacyCutFilter& chain, const CutFilter::CoefficientsArray& coefficients, int numSections)
+    {
+        auto active = Index < numSections;
+        chain.setBypassed<Index>(!active);
+
+        if (active)
+            *chain.get<Index>().coefficients = *coefficients[Index];
+    }
+
+    void setLegacySections(LegacyCutFilter& chain, const CutFilter::CoefficientsArray& coefficients, int numSections)
+    {
+        setLegacyStage<0>(chain, coefficients, numSections);
+        setLegacyStage<1>(chain, coefficients, numSections);
+        setLegacyStage<2>(chain, coefficients, numSections);
+        setLegacyStage<3>(chain, coefficients, numSections);
+    }
+
+    template <typename Processor>
+    double measure(Processor& processor, juce::AudioBuffer<float>& buffer)
+    {
+        juce::dsp::AudioBlock<float> block(buffer);
+        juce::dsp::ProcessContextReplacing<float> context(block);
+
+        return Benchmark::nanosecondsPerSample(2000, [&] { processor.process(context); });
+    }
+}
+
+void runCutFilterBenchmarks()
+{
+    Benchmark::printHeader("Low cut, 100 Hz, mono, " + juce::String(Benchmark::blockSize) + " sample blocks");
+
+    juce::dsp::ProcessSpec spec{ Benchmark::sampleRate, (juce::uint32)Benchmark::blockSize, 1 };
+
+    juce::AudioBuffer<float> buffer(1, Benchmark::blockSize);
+    Benchmark::fillWithNoise(buffer, 1);
+
+    for (auto slope : { Slope_12, Slope_24, Slope_36, Slope_48, Slope_72, Slope_96 })
+    {
+        auto numSections = getNumCutSections(slope);
+        auto coefficients = juce::dsp::FilterDesign<float>::
+            designIIRHighpassHighOrderButterworthMethod(100.f, Benchmark::sampleRate, 2 * numSections);
+
+        auto label = juce::String(numSections * 12) + " dB/Oct";
+
+        if (numSections <= 4)
+        {
+            LegacyCutFilter legacy;
+            legacy.prepare(spec);
+            setLegacySections(legacy, coefficients, numSections);
+
+            Benchmark::printRow(label + ", ProcessorChain", measure(legacy, buffer), "ns/sample");
+        }
+
+        CutFilter cascade;
+        cascade.prepare(spec);
+        cascade.setSections(coefficients, numSections);
+
+        Benchmark::printRow(label + ", FilterCascade", measure(cascade, buffer), "ns/sample");
+    }
+}
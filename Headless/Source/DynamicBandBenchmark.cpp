@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    DynamicBandBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+void runDynamicBandBenchmarks()
+{
+    Benchmark::printHeader("Dynamic peak bands, full processBlock, stereo, "
+        + juce::String(Benchmark::blockSize) + " sample blocks");
+
+    juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+    juce::MidiBuffer midi;
+
+    double staticCost = 0;
+
+    for (int numDynamic = 0; numDynamic <= numPeakBands; ++numDynamic)
+    {
+        TradeMarkEQAudioProcessor processor;
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            auto& ids = getPeakParameterIDs(i);
+
+            Benchmark::setParameter(processor.apvts, ids.gain, 3.f);
+            Benchmark::setParameter(processor.apvts, ids.dynamic, i < numDynamic ? 1.f : 0.f);
+            Benchmark::setParameter(processor.apvts, ids.threshold, -30.f);
+            Benchmark::setParameter(processor.apvts, ids.ratio, 4.f);
+        }
+
+        Benchmark::prepareToPlay(processor);
+
+        auto cost = Benchmark::nanosecondsPerSample(1000, [&]
+            {
+                Benchmark::fillWithNoise(buffer, 3);
+                processor.processBlock(buffer, midi);
+            });
+
+        if (numDynamic == 0)
+            staticCost = cost;
+
+        auto label = juce::String(numDynamic) + " of " + juce::String(numPeakBands) + " bands dynamic";
+        Benchmark::printRow(label, cost, "ns/sample");
+
+        if (numDynamic > 0)
+            Benchmark::printRow("  per dynamic band", (cost - staticCost) / numDynamic, "ns/sample");
+    }
+}
@@ -0,0 +1,609 @@
+/*
+  ==============================================================================
+
+    EquivalenceTest.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    /** The filters the way the plug-in first ran them, and the golden
+        reference every faster engine is held to: one juce::dsp::IIR::Filter
+        per biquad and channel, designed by FilterDesign and
+        IIR::Coefficients, with M/S done as a separate pass around the
+        filters.
+
+        Built for float it is the reference itself. Built for double, with
+        the same float coefficients, it shows how far float rounding alone
+        moves the reference, which is what sets the tolerance.
+    */
+    template <typename SampleType>
+    class ReferenceChain
+    {
+    public:
+        void prepare(double newSampleRate, int maximumBlockSize)
+        {
+            sampleRate = newSampleRate;
+
+            juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32)maximumBlockSize, 1 };
+
+            prepareStages(lowCut, spec);
+            prepareStages(peaks, spec);
+            prepareStages(highCut, spec);
+
+            buffer.setSize(2, maximumBlockSize);
+        }
+
+        void update(const ChainSettings& settings)
+        {
+            channelMode = settings.channelMode;
+
+            // Each channel switches on the stages it uses.
+            for (auto& stage : lowCut)
+                stage.active = false;
+
+            for (auto& stage : peaks)
+                stage.active = false;
+
+            for (auto& stage : highCut)
+                stage.active = false;
+
+            for (size_t ch = 0; ch < 2; ++ch)
+            {
+                auto& channel = getChannelSettings(settings, (int)ch);
+
+                // Unlinked, each channel runs its own settings and the routing doesn't apply.
+                auto isRoutedTo = [&](ChannelRouting routing)
+                {
+                    return !settings.channelsLinked || (getChannelMask(routing) & (1u << ch)) != 0;
+                };
+
+                updateCut(lowCut, ch, channel.lowCutBypassed, isRoutedTo(settings.lowCutChannels), channel.lowCutSlope,
+                    juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(channel.lowCutFreq,
+                        sampleRate, 2 * getNumCutSections(channel.lowCutSlope)));
+
+                updateCut(highCut, ch, channel.highCutBypassed, isRoutedTo(settings.highCutChannels), channel.highCutSlope,
+                    juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(channel.highCutFreq,
+                        sampleRate, 2 * getNumCutSections(channel.highCutSlope)));
+
+                for (int i = 0; i < numPeakBands; ++i)
+                {
+                    auto& peak = channel.peaks[(size_t)i];
+
+                    auto design = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, peak.freq, peak.quality,
+                        juce::Decibels::decibelsToGain(peak.gainInDecibels));
+
+                    load(peaks[(size_t)i], ch, !peak.bypassed, isRoutedTo(peak.channels), design.get());
+                }
+            }
+        }
+
+        /** Processes a stereo block in SampleType. The result stays here, for getChannel(). */
+        void process(const float* const* input, int numSamples)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int n = 0; n < numSamples; ++n)
+                    buffer.setSample(ch, n, (SampleType)input[ch][n]);
+
+            auto* left = buffer.getWritePointer(0);
+            auto* right = buffer.getWritePointer(1);
+
+            if (channelMode == ChannelMode::MidSide)
+            {
+                for (int n = 0; n < numSamples; ++n)
+                {
+                    auto l = left[n], r = right[n];
+                    left[n] = (l + r) * SampleType(0.5);
+                    right[n] = (l - r) * SampleType(0.5);
+                }
+            }
+
+            juce::dsp::AudioBlock<SampleType> block(buffer.getArrayOfWritePointers(), 2, (size_t)numSamples);
+
+            processStages(lowCut, block);
+            processStages(peaks, block);
+            processStages(highCut, block);
+
+            if (channelMode == ChannelMode::MidSide)
+            {
+                for (int n = 0; n < numSamples; ++n)
+                {
+                    auto mid = left[n], side = right[n];
+                    left[n] = mid + side;
+                    right[n] = mid - side;
+                }
+            }
+        }
+
+        const SampleType* getChannel(int channel) const { return buffer.getReadPointer(channel); }
+
+    private:
+        using Filter = juce::dsp::IIR::Filter<SampleType>;
+
+        struct Stage
+        {
+            Filter filters[2];
+            bool active{ false };
+        };
+
+        template <typename Stages>
+        static void prepareStages(Stages& stages, const juce::dsp::ProcessSpec& spec)
+        {
+            for (auto& stage : stages)
+                for (auto& filter : stage.filters)
+                    filter.prepare(spec);
+        }
+
+        template <typename Stages>
+        static void processStages(Stages& stages, juce::dsp::AudioBlock<SampleType>& block)
+        {
+            for (auto& stage : stages)
+            {
+                if (!stage.active)
+                    continue;
+
+                for (size_t ch = 0; ch < 2; ++ch)
+                {
+                    auto channelBlock = block.getSingleChannelBlock(ch);
+                    stage.filters[ch].process(juce::dsp::ProcessContextReplacing<SampleType>(channelBlock));
+                }
+            }
+        }
+
+        // A stage runs while either channel uses it. A channel a filter isn't
+        // routed to, or that bypasses a filter the other channel runs, goes
+        // through b0 = 1 and nothing else, like it does in the engine, so that
+        // both lose the filter state the same way while it's elsewhere.
+        // nullptr is a section the channel's slope doesn't reach.
+        void load(Stage& stage, size_t ch, bool active, bool routed, const juce::dsp::IIR::Coefficients<float>* design)
+        {
+            stage.active = stage.active || (active && design != nullptr);
+
+            auto& coefficients = *stage.filters[ch].coefficients;
+
+            if (active && routed && design != nullptr)
+            {
+                auto* c = design->getRawCoefficients();
+                coefficients = juce::dsp::IIR::Coefficients<SampleType>((SampleType)c[0], (SampleType)c[1], (SampleType)c[2],
+                    SampleType(1), (SampleType)c[3], (SampleType)c[4]);
+            }
+            else
+            {
+                coefficients = juce::dsp::IIR::Coefficients<SampleType>(1, 0, 0, 1, 0, 0);
+            }
+        }
+
+        template <typename Stages>
+        void updateCut(Stages& stages, size_t ch, bool bypassed, bool routed, Slope slope,
+            const juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>>& designs)
+        {
+            auto numSections = getNumCutSections(slope);
+            jassert(designs.size() == numSections);
+
+            for (int i = 0; i < (int)stages.size(); ++i)
+                load(stages[(size_t)i], ch, !bypassed, routed, i < numSections ? designs.getObjectPointerUnchecked(i) : nullptr);
+        }
+
+        double sampleRate{ 44100.0 };
+        ChannelMode channelMode{ ChannelMode::LeftRight };
+
+        std::array<Stage, CutFilter::maxSections> lowCut, highCut;
+        std::array<Stage, numPeakBands> peaks;
+
+        juce::AudioBuffer<SampleType> buffer;
+    };
+
+    //==============================================================================
+    constexpr double sampleRates[]{ 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+    constexpr int maximumBlockSize = 1024;
+    constexpr double caseSeconds = 0.5;
+
+    // An engine passes when it stays within this many times the reference's
+    // own float rounding error, or under the floor, whichever is larger.
+    // Transposed direct form II in float is badly conditioned for low cuts at
+    // high sample rates, and there the reference is off by a few percent
+    // itself; anything that reorders the arithmetic lands about as far away.
+    constexpr double roundingMargin = 4.0;
+    constexpr double floorDecibels = -100.0;
+
+    struct ParameterChange
+    {
+        int parameter;
+        float value;
+    };
+
+    struct Block
+    {
+        int numSamples;
+        std::vector<ParameterChange> changes;
+    };
+
+    struct TestCase
+    {
+        juce::String name;
+        double sampleRate{ 44100.0 };
+        juce::AudioBuffer<float> signal;
+        std::vector<ParameterChange> initialSettings;
+        std::vector<Block> blocks;
+    };
+
+    /** Every parameter the reference models. Dynamics and modulation have no
+        counterpart in the original chain, so they stay off.
+    */
+    juce::StringArray getStaticParameterIDs()
+    {
+        juce::StringArray ids{ "LowCut Freq", "LowCut Slope", "LowCut Steep Slope", "LowCut Bypassed", "LowCut Channels",
+                               "HighCut Freq", "HighCut Slope", "HighCut Steep Slope", "HighCut Bypassed", "HighCut Channels",
+                               "Channel Mode", "Channel Link",
+                               "LowCut Freq 2", "LowCut Slope 2", "LowCut Steep Slope 2", "LowCut Bypassed 2",
+                               "HighCut Freq 2", "HighCut Slope 2", "HighCut Steep Slope 2", "HighCut Bypassed 2" };
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            auto& band = getPeakParameterIDs(i);
+            ids.addArray({ band.freq, band.gain, band.quality, band.bypassed, band.channels,
+                           band.secondFreq, band.secondGain, band.secondQuality, band.secondBypassed });
+        }
+
+        return ids;
+    }
+
+    //==============================================================================
+    juce::AudioBuffer<float> makeNoise(int numSamples, juce::Random& random)
+    {
+        juce::AudioBuffer<float> signal(2, numSamples);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int n = 0; n < numSamples; ++n)
+                signal.setSample(ch, n, (random.nextFloat() * 2.f - 1.f) * 0.5f);
+
+        return signal;
+    }
+
+    /** An exponential sweep from 20 Hz to 20 kHz on the left and the other
+        way round on the right, so M/S sees both a mid and a side.
+    */
+    juce::AudioBuffer<float> makeSweep(int numSamples, double sampleRate)
+    {
+        juce::AudioBuffer<float> signal(2, numSamples);
+
+        const auto low = 20.0, high = juce::jmin(20000.0, sampleRate * 0.45);
+        const auto seconds = numSamples / sampleRate;
+        const auto rate = std::log(high / low);
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            auto t = n / sampleRate;
+            auto phase = juce::MathConstants<double>::twoPi * low * seconds / rate * (std::exp(t / seconds * rate) - 1.0);
+            auto phaseDown = juce::MathConstants<double>::twoPi * high * seconds / rate * (1.0 - std::exp(-t / seconds * rate));
+
+            signal.setSample(0, n, (float)(0.5 * std::sin(phase)));
+            signal.setSample(1, n, (float)(0.5 * std::sin(phaseDown)));
+        }
+
+        return signal;
+    }
+
+    /** Unit impulses every 100 ms, alternating between the channels. */
+    juce::AudioBuffer<float> makeImpulses(int numSamples, double sampleRate)
+    {
+        juce::AudioBuffer<float> signal(2, numSamples);
+        signal.clear();
+
+        const auto spacing = juce::roundToInt(sampleRate * 0.1);
+
+        for (int n = 0, i = 0; n < numSamples; n += spacing, ++i)
+            signal.setSample(i % 2, n, 1.f);
+
+        return signal;
+    }
+
+    juce::AudioBuffer<float> readFile(const juce::File& file, double& sampleRate)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+
+        if (reader == nullptr)
+            juce::ConsoleApplication::fail("Can't read " + file.getFullPathName());
+
+        sampleRate = reader->sampleRate;
+
+        auto numSamples = (int)juce::jmin(reader->lengthInSamples, (juce::int64)(sampleRate * 10.0));
+        juce::AudioBuffer<float> signal(2, numSamples);
+
+        // Mono files go to both channels.
+        reader->read(&signal, 0, numSamples, 0, true, true);
+        return signal;
+    }
+
+    /** Block sizes the way different hosts hand them out: one fixed size,
+        anything from 1 sample up, or a single sample between full blocks.
+    */
+    std::vector<Block> makeBlocks(int numSamples, int numParameters, bool automate, juce::Random& random)
+    {
+        std::vector<Block> blocks;
+
+        const int fixedSizes[]{ 32, 64, 128, 256, 512, maximumBlockSize };
+        const auto pattern = random.nextInt(3);
+        const auto fixedSize = fixedSizes[random.nextInt((int)std::size(fixedSizes))];
+
+        for (int position = 0; position < numSamples;)
+        {
+            Block block;
+
+            switch (pattern)
+            {
+                case 0:  block.numSamples = fixedSize; break;
+                case 1:  block.numSamples = 1 + random.nextInt(maximumBlockSize); break;
+                default: block.numSamples = blocks.size() % 2 == 0 ? 1 : maximumBlockSize; break;
+            }
+
+            block.numSamples = juce::jmin(block.numSamples, numSamples - position);
+
+            if (automate && random.nextFloat() < 0.2f)
+                block.changes.push_back({ random.nextInt(numParameters), random.nextFloat() });
+
+            position += block.numSamples;
+            blocks.push_back(std::move(block));
+        }
+
+        return blocks;
+    }
+
+    TestCase makeCase(int index, juce::AudioBuffer<float> signal, double sampleRate, const juce::String& signalName,
+        int numParameters, juce::Random& random)
+    {
+        TestCase testCase;
+        testCase.sampleRate = sampleRate;
+        testCase.signal = std::move(signal);
+
+        for (int i = 0; i < numParameters; ++i)
+            testCase.initialSettings.push_back({ i, random.nextFloat() });
+
+        auto automate = random.nextBool();
+        testCase.blocks = makeBlocks(testCase.signal.getNumSamples(), numParameters, automate, random);
+
+        testCase.name = "case " + juce::String(index) + ", " + signalName + ", " + juce::String(sampleRate) + " Hz"
+            + (automate ? ", automated" : "");
+
+        return testCase;
+    }
+
+    //==============================================================================
+    void apply(juce::AudioProcessorValueTreeState& apvts, const juce::StringArray& ids,
+        const std::vector<ParameterChange>& changes)
+    {
+        for (auto& change : changes)
+            apvts.getParameter(ids[change.parameter])->setValueNotifyingHost(change.value);
+    }
+
+    /** Runs a case through the reference, in float and double. */
+    void runReference(const TestCase& testCase, const juce::StringArray& ids,
+        juce::AudioBuffer<float>& reference, juce::AudioBuffer<double>& exact)
+    {
+        // Only here to turn parameter values into ChainSettings exactly the way the engine does.
+        TradeMarkEQAudioProcessor parameters;
+        apply(parameters.apvts, ids, testCase.initialSettings);
+
+        ReferenceChain<float> chain;
+        ReferenceChain<double> doubleChain;
+        chain.prepare(testCase.sampleRate, maximumBlockSize);
+        doubleChain.prepare(testCase.sampleRate, maximumBlockSize);
+
+        reference.setSize(2, testCase.signal.getNumSamples());
+        exact.setSize(2, testCase.signal.getNumSamples());
+
+        int position = 0;
+
+        for (auto& block : testCase.blocks)
+        {
+            apply(parameters.apvts, ids, block.changes);
+
+            auto settings = getChainSettings(parameters.apvts);
+            chain.update(settings);
+            doubleChain.update(settings);
+
+            const float* input[]{ testCase.signal.getReadPointer(0, position), testCase.signal.getReadPointer(1, position) };
+
+            chain.process(input, block.numSamples);
+            doubleChain.process(input, block.numSamples);
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                reference.copyFrom(ch, position, chain.getChannel(ch), block.numSamples);
+
+                for (int n = 0; n < block.numSamples; ++n)
+                    exact.setSample(ch, position + n, doubleChain.getChannel(ch)[n]);
+            }
+
+            position += block.numSamples;
+        }
+    }
+
+    /** Runs a case through a full plug-in instance, with the host's block
+        sizes and automation, and with SampleType the precision the host uses.
+    */
+    template <typename SampleType = float>
+    juce::AudioBuffer<float> runEngine(const TestCase& testCase, const juce::StringArray& ids, FilterPrecision precision)
+    {
+        TradeMarkEQAudioProcessor processor;
+        processor.setFilterPrecision(precision);
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                            : juce::AudioProcessor::singlePrecision);
+        apply(processor.apvts, ids, testCase.initialSettings);
+        Benchmark::prepareToPlay(processor, testCase.sampleRate, maximumBlockSize);
+
+        juce::AudioBuffer<SampleType> output;
+        output.makeCopyOf(testCase.signal);
+
+        juce::MidiBuffer midi;
+        int position = 0;
+
+        for (auto& block : testCase.blocks)
+        {
+            apply(processor.apvts, ids, block.changes);
+
+            juce::AudioBuffer<SampleType> view(output.getArrayOfWritePointers(), 2, position, block.numSamples);
+            processor.processBlock(view, midi);
+
+            position += block.numSamples;
+        }
+
+        juce::AudioBuffer<float> result;
+        result.makeCopyOf(output);
+        return result;
+    }
+
+    //==============================================================================
+    struct Result
+    {
+        double maxError{ 0 }, tolerance{ 0 }, errorEnergy{ 0 }, signalEnergy{ 0 };
+
+        bool passed() const { return maxError <= tolerance; }
+
+        double getNullDepthDecibels() const
+        {
+            return errorEnergy > 0 ? 10.0 * std::log10(signalEnergy / errorEnergy) : 300.0;
+        }
+    };
+
+    Result compare(const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference,
+        const juce::AudioBuffer<double>& exact)
+    {
+        Result result;
+        double roundingError = 0;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            for (int n = 0; n < reference.getNumSamples(); ++n)
+            {
+                auto expected = (double)reference.getSample(ch, n);
+                auto error = (double)output.getSample(ch, n) - expected;
+
+                result.maxError = juce::jmax(result.maxError, std::abs(error));
+                result.errorEnergy += error * error;
+                result.signalEnergy += expected * expected;
+
+                roundingError = juce::jmax(roundingError, std::abs(expected - exact.getSample(ch, n)));
+            }
+        }
+
+        result.tolerance = juce::jmax(juce::Decibels::decibelsToGain(floorDecibels), roundingMargin * roundingError);
+        return result;
+    }
+
+    struct EngineSummary
+    {
+        juce::String name;
+        double worstErrorDecibels{ -300.0 }, worstNullDecibels{ 300.0 };
+        int numFailed{ 0 };
+        juce::String firstFailure;
+    };
+
+    void addResult(EngineSummary& summary, const TestCase& testCase, const Result& result)
+    {
+        summary.worstErrorDecibels = juce::jmax(summary.worstErrorDecibels, juce::Decibels::gainToDecibels(result.maxError, -300.0));
+        summary.worstNullDecibels = juce::jmin(summary.worstNullDecibels, result.getNullDepthDecibels());
+
+        if (!result.passed() && summary.numFailed++ == 0)
+            summary.firstFailure = testCase.name + ": error " + juce::String(result.maxError) + ", tolerance " + juce::String(result.tolerance);
+    }
+}
+
+void runEquivalenceTest(const juce::ArgumentList& args)
+{
+    auto numCases = args.arguments.size() > 1 ? juce::jmax(1, args[1].text.getIntValue()) : 60;
+
+    const auto ids = getStaticParameterIDs();
+    juce::Random random(0x7e57);
+    std::vector<TestCase> cases;
+
+    for (int i = 0; i < numCases; ++i)
+    {
+        auto sampleRate = sampleRates[random.nextInt((int)std::size(sampleRates))];
+        auto numSamples = (int)(sampleRate * caseSeconds);
+
+        switch (i % 3)
+        {
+            case 0:  cases.push_back(makeCase(i, makeNoise(numSamples, random), sampleRate, "noise", ids.size(), random)); break;
+            case 1:  cases.push_back(makeCase(i, makeSweep(numSamples, sampleRate), sampleRate, "sweep", ids.size(), random)); break;
+            default: cases.push_back(makeCase(i, makeImpulses(numSamples, sampleRate), sampleRate, "impulses", ids.size(), random)); break;
+        }
+    }
+
+    // Signal files are run at their own sample rate, once for every two sets of random settings.
+    for (int i = 2; i < args.arguments.size(); ++i)
+    {
+        auto file = args[i].resolveAsExistingFile();
+        double sampleRate = 0;
+        auto signal = readFile(file, sampleRate);
+
+        for (int j = 0; j < 2; ++j)
+            cases.push_back(makeCase((int)cases.size(), signal, sampleRate, file.getFileName(), ids.size(), random));
+    }
+
+    // Every instruction set is an engine of its own, all in float, and
+    // mixed precision is one more on the instruction set the plug-in picks.
+    const auto activeIsa = DspKernels::getActiveIsa();
+    std::vector<EngineSummary> engines;
+
+    for (auto isa : DspKernels::allIsas)
+        if (DspKernels::isSupported(isa))
+            engines.push_back({ juce::String("FilterCascade, ") + DspKernels::getName(isa) });
+
+    engines.push_back({ "FilterCascade, mixed precision" });
+    engines.push_back({ "FilterCascade, double host" });
+
+    juce::AudioBuffer<float> reference;
+    juce::AudioBuffer<double> exact;
+
+    for (auto& testCase : cases)
+    {
+        runReference(testCase, ids, reference, exact);
+
+        size_t engine = 0;
+
+        for (auto isa : DspKernels::allIsas)
+        {
+            if (!DspKernels::setActiveIsa(isa))
+                continue;
+
+            addResult(engines[engine++], testCase, compare(runEngine(testCase, ids, FilterPrecision::Float), reference, exact));
+        }
+
+        // Both closer to the exact result than the float reference is, so
+        // they're always inside the tolerance when they work.
+        DspKernels::setActiveIsa(activeIsa);
+        addResult(engines[engine++], testCase, compare(runEngine(testCase, ids, FilterPrecision::Mixed), reference, exact));
+        addResult(engines[engine], testCase, compare(runEngine<double>(testCase, ids, FilterPrecision::Mixed), reference, exact));
+    }
+
+    DspKernels::setActiveIsa(activeIsa);
+
+    Benchmark::printHeader("Equivalence with the IIR::Filter reference, " + juce::String((int)cases.size()) + " cases");
+
+    auto numFailed = 0;
+
+    for (auto& summary : engines)
+    {
+        Benchmark::printRow(summary.name + ": worst error", summary.worstErrorDecibels, "dBFS");
+        Benchmark::printRow(summary.name + ": shallowest null", summary.worstNullDecibels, "dB");
+        Benchmark::printRow(summary.name + ": failed cases", summary.numFailed, "");
+
+        if (summary.numFailed > 0)
+            std::cout << "  first failure: " << summary.firstFailure << std::endl;
+
+        numFailed += summary.numFailed;
+    }
+
+    if (numFailed > 0)
+        juce::ConsoleApplication::fail(juce::String(numFailed) + " cases differ from the reference");
+}
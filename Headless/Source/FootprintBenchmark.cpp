@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    FootprintBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+// The headless tool counts its own heap use, so the footprint numbers below
+// come from the allocator rather than from sizeof. Every allocation carries
+// its size in a small header in front of the block.
+namespace
+{
+    std::atomic<juce::int64> liveHeapBytes{ 0 };
+
+    constexpr size_t allocationHeader = alignof(std::max_align_t);
+}
+
+void* operator new(size_t size)
+{
+    auto* block = static_cast<char*>(std::malloc(size + allocationHeader));
+
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    *reinterpret_cast<size_t*>(block) = size;
+    liveHeapBytes.fetch_add((juce::int64)size, std::memory_order_relaxed);
+
+    return block + allocationHeader;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer == nullptr)
+        return;
+
+    auto* block = static_cast<char*>(pointer) - allocationHeader;
+
+    liveHeapBytes.fetch_sub((juce::int64)*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+//==============================================================================
+namespace
+{
+    constexpr int numInstances = 50;
+
+    struct Footprint
+    {
+        double bytesPerInstance, microsecondsPerInstance;
+    };
+
+    // Builds numInstances instances (and editors, if asked), and measures
+    // how much heap they hold on to and how long they took.
+    Footprint measure(bool withEditor)
+    {
+        std::vector<std::unique_ptr<TradeMarkEQAudioProcessor>> instances;
+        std::vector<std::unique_ptr<juce::AudioProcessorEditor>> editors;
+
+        instances.reserve(numInstances);
+        editors.reserve(numInstances);
+
+        auto heapBefore = liveHeapBytes.load();
+        auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            instances.push_back(std::make_unique<TradeMarkEQAudioProcessor>());
+            Benchmark::prepareToPlay(*instances.back());
+
+            if (withEditor)
+                editors.emplace_back(instances.back()->createEditor());
+        }
+
+        auto end = juce::Time::getHighResolutionTicks();
+        auto heapAfter = liveHeapBytes.load();
+
+        editors.clear();
+        instances.clear();
+
+        // The instances live on the heap too, so this includes their sizeof.
+        auto bytes = (double)(heapAfter - heapBefore) / numInstances;
+
+        return { bytes, juce::Time::highResolutionTicksToSeconds(end - start) * 1.0e6 / numInstances };
+    }
+}
+
+void runFootprintBenchmarks()
+{
+    Benchmark::printHeader("Footprint, " + juce::String(numInstances) + " instances, construct + prepare");
+
+    // The first instance pays for everything built once per process.
+    measure(true);
+
+    auto processorOnly = measure(false);
+    Benchmark::printRow("Processor only", processorOnly.bytesPerInstance / 1024.0, "KB/instance");
+    Benchmark::printRow("  time to instantiate", processorOnly.microsecondsPerInstance, "us");
+
+    auto editorOpen = measure(true);
+    Benchmark::printRow("Processor + editor", editorOpen.bytesPerInstance / 1024.0, "KB/instance");
+    Benchmark::printRow("  time to instantiate", editorOpen.microsecondsPerInstance, "us");
+}
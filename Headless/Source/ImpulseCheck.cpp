@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    ImpulseCheck.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/ImpulseExport.h"
+
+namespace
+{
+    // Deeper than this into a cut, the error says more about the truncation than the design.
+    constexpr double errorFloorDecibels = -40.0;
+
+    void loadPreset(TradeMarkEQAudioProcessor& processor, const juce::String& presetName)
+    {
+        auto& presets = processor.getPresetManager();
+
+        for (int i = 0; i < presets.getNumPresets(); ++i)
+        {
+            if (presets.getPresetName(i).equalsIgnoreCase(presetName))
+            {
+                presets.loadPreset(i);
+                return;
+            }
+        }
+
+        juce::ConsoleApplication::fail("Unknown preset: " + presetName);
+    }
+
+    struct Error
+    {
+        double maximum{ 0 }, rms{ 0 };
+    };
+
+    /** How far an impulse's magnitude response strays from the chain's, in dB,
+        between 20 Hz and 20 kHz, wherever the chain passes anything to speak of.
+    */
+    Error measureError(const juce::AudioBuffer<float>& impulse, const ChainSettings& settings, double sampleRate)
+    {
+        auto fftOrder = 1;
+
+        while ((1 << fftOrder) < impulse.getNumSamples() * 4)
+            ++fftOrder;
+
+        const auto fftSize = 1 << fftOrder;
+
+        std::vector<double> frequencies;
+
+        for (int k = 1; k <= fftSize / 2; ++k)
+        {
+            auto frequency = k * sampleRate / fftSize;
+
+            if (frequency >= 20.0 && frequency <= juce::jmin(20000.0, sampleRate * 0.45))
+                frequencies.push_back(frequency);
+        }
+
+        EqChain chain;
+        updateEqChain(chain, settings, sampleRate);
+        updateChannelMode(chain, ChannelMode::LeftRight);
+
+        const DspKernels::FrequencyGrid grid(frequencies, sampleRate);
+        const auto firstBin = juce::roundToInt(frequencies.front() * fftSize / sampleRate);
+
+        juce::dsp::FFT fft(fftOrder);
+        std::vector<float> data((size_t)fftSize * 2);
+        std::vector<double> expected(frequencies.size());
+
+        Error error;
+        int numPoints = 0;
+
+        for (int ch = 0; ch < impulse.getNumChannels(); ++ch)
+        {
+            std::fill(data.begin(), data.end(), 0.f);
+            std::copy_n(impulse.getReadPointer(ch), impulse.getNumSamples(), data.begin());
+            fft.performFrequencyOnlyForwardTransform(data.data(), true);
+
+            std::fill(expected.begin(), expected.end(), 1.0);
+            accumulateMagnitudes(chain, grid, expected.data(), (size_t)ch);
+
+            for (size_t i = 0; i < frequencies.size(); ++i)
+            {
+                auto target = juce::Decibels::gainToDecibels(expected[i], -200.0);
+
+                if (target < errorFloorDecibels)
+                    continue;
+
+                auto difference = std::abs(juce::Decibels::gainToDecibels((double)data[(size_t)firstBin + i], -200.0) - target);
+
+                error.maximum = juce::jmax(error.maximum, difference);
+                error.rms += difference * difference;
+                ++numPoints;
+            }
+        }
+
+        error.rms = numPoints > 0 ? std::sqrt(error.rms / numPoints) : 0.0;
+        return error;
+    }
+
+    ImpulseExport::Phase getPhase(const juce::String& name)
+    {
+        if (name.isEmpty() || name == "minimum")
+            return ImpulseExport::Phase::Minimum;
+
+        if (name == "linear")
+            return ImpulseExport::Phase::Linear;
+
+        if (name == "both")
+            return ImpulseExport::Phase::Both;
+
+        juce::ConsoleApplication::fail("Unknown phase: " + name + " (minimum, linear or both)");
+        return ImpulseExport::Phase::Minimum;
+    }
+}
+
+void runImpulseCheck(const juce::ArgumentList& args)
+{
+    const auto presetName = args.getValueForOption("--preset");
+    const auto lengthOption = args.getValueForOption("--length");
+    const auto rateOption = args.getValueForOption("--rate");
+
+    ImpulseExport::Options options;
+    options.phase = getPhase(args.getValueForOption("--phase"));
+    options.format = args.containsOption("--raw") ? ImpulseExport::Format::RawFloat : ImpulseExport::Format::Wav;
+    options.sampleRate = rateOption.isNotEmpty() ? rateOption.getDoubleValue() : Benchmark::sampleRate;
+
+    if (options.sampleRate < 8000.0)
+        juce::ConsoleApplication::fail("The sample rate should be at least 8000 Hz");
+
+    TradeMarkEQAudioProcessor processor;
+
+    if (presetName.isNotEmpty())
+    {
+        loadPreset(processor, presetName);
+    }
+    else
+    {
+        // Something of everything: steep cuts at both ends and three bands.
+        auto& apvts = processor.apvts;
+
+        Benchmark::setParameter(apvts, "LowCut Freq", 40.f);
+        Benchmark::setParameter(apvts, "LowCut Slope", (float)Slope_48);
+        Benchmark::setParameter(apvts, "HighCut Freq", 16000.f);
+        Benchmark::setParameter(apvts, "HighCut Slope", (float)Slope_24);
+
+        Benchmark::setParameter(apvts, getPeakParameterIDs(0).gain, 3.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(2).freq, 2500.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(2).gain, -6.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(2).quality, 2.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(4).gain, 4.f);
+    }
+
+    const auto settings = getChainSettings(processor.apvts);
+
+    std::vector<int> lengths{ 1024, 4096, 16384, 65536 };
+
+    if (lengthOption.isNotEmpty())
+    {
+        options.length = juce::jlimit(ImpulseExport::minLength, ImpulseExport::maxLength, lengthOption.getIntValue());
+        lengths = { options.length };
+    }
+
+    Benchmark::printHeader("Impulse rendering at " + juce::String(options.sampleRate, 0) + " Hz");
+
+    for (auto length : lengths)
+    {
+        juce::AudioBuffer<float> minimum, linear;
+
+        auto minimumSeconds = Benchmark::timeBestOf(5, [&] { minimum = ImpulseExport::renderMinimumPhase(settings, length, options.sampleRate); });
+        auto linearSeconds = Benchmark::timeBestOf(5, [&] { linear = ImpulseExport::renderLinearPhase(settings, length, options.sampleRate); });
+
+        auto minimumError = measureError(minimum, settings, options.sampleRate);
+        auto linearError = measureError(linear, settings, options.sampleRate);
+
+        std::cout << juce::String(length).paddedLeft(' ', 6) << " samples, " << minimum.getNumChannels()
+                  << (minimum.getNumChannels() == 1 ? " channel" : " channels") << std::endl;
+
+        std::cout << "  minimum phase: " << juce::String(minimumSeconds * 1000.0, 2).paddedLeft(' ', 7) << " ms, error "
+                  << juce::String(minimumError.maximum, 2) << " dB max, " << juce::String(minimumError.rms, 3) << " dB RMS" << std::endl;
+
+        std::cout << "  linear phase:  " << juce::String(linearSeconds * 1000.0, 2).paddedLeft(' ', 7) << " ms, error "
+                  << juce::String(linearError.maximum, 2) << " dB max, " << juce::String(linearError.rms, 3) << " dB RMS" << std::endl;
+    }
+
+    // The first argument that isn't an option is where to write it.
+    for (int i = 1; i < args.arguments.size(); ++i)
+    {
+        if (args[i].isOption())
+            continue;
+
+        auto result = ImpulseExport::exportImpulses(settings, options, args[i].resolveAsFile());
+
+        if (!result.wasOk())
+            juce::ConsoleApplication::fail(result.error);
+
+        for (const auto& file : result.files)
+            std::cout << "Wrote " << file.getFullPathName() << std::endl;
+
+        std::cout << "  in " << juce::String(result.seconds * 1000.0, 1) << " ms" << std::endl;
+        break;
+    }
+}
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    IsaBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    using Cascade = FilterCascade<float, 8>;
+
+    Cascade makeCascade(bool midSide)
+    {
+        Cascade cascade;
+
+        for (int i = 0; i < Cascade::maxSections; ++i)
+        {
+            auto frequency = 60.f * std::pow(2.f, (float)i);
+            auto gain = juce::Decibels::decibelsToGain(i % 2 == 0 ? 4.f : -3.f);
+            cascade.setSection(i, *juce::dsp::IIR::Coefficients<float>::makePeakFilter(Benchmark::sampleRate, frequency, 1.f, gain));
+        }
+
+        cascade.setNumSections(Cascade::maxSections);
+        cascade.setMidSide(midSide, midSide);
+        cascade.prepare({ Benchmark::sampleRate, (juce::uint32)Benchmark::blockSize, 2 });
+
+        return cascade;
+    }
+
+    double measureCascade(bool midSide)
+    {
+        auto cascade = makeCascade(midSide);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        Benchmark::fillWithNoise(buffer, 3);
+
+        return Benchmark::nanosecondsPerSample(2000, [&]
+            {
+                juce::dsp::AudioBlock<float> block(buffer);
+                cascade.process(juce::dsp::ProcessContextReplacing<float>(block));
+            });
+    }
+
+    double measureCrossfade()
+    {
+        juce::AudioBuffer<float> output(1, Benchmark::blockSize), previous(1, Benchmark::blockSize);
+        Benchmark::fillWithNoise(output, 4);
+        Benchmark::fillWithNoise(previous, 5);
+
+        const auto& kernels = DspKernels::get();
+
+        return Benchmark::nanosecondsPerSample(20000, [&]
+            {
+                kernels.crossfade(output.getWritePointer(0), previous.getReadPointer(0),
+                    (size_t)Benchmark::blockSize, 100, 1.f / 1440.f);
+            });
+    }
+
+    /** Microseconds for one full 8-section response curve, 1000 points wide. */
+    double measureResponseCurve()
+    {
+        auto cascade = makeCascade(false);
+
+        std::vector<double> frequencies;
+
+        for (int i = 0; i < 1000; ++i)
+            frequencies.push_back(juce::mapToLog10(i / 1000.0, 20.0, 20000.0));
+
+        DspKernels::FrequencyGrid grid(frequencies, Benchmark::sampleRate);
+        std::vector<double> mags(grid.size());
+
+        auto seconds = Benchmark::timeBestOf(5, [&]
+            {
+                for (int i = 0; i < 100; ++i)
+                {
+                    std::fill(mags.begin(), mags.end(), 1.0);
+                    cascade.accumulateMagnitudes(grid, mags.data());
+                }
+            });
+
+        return seconds * 1.0e6 / 100.0;
+    }
+}
+
+void runIsaBenchmarks()
+{
+    auto detected = DspKernels::getDetectedIsa();
+    auto active = DspKernels::getActiveIsa();
+
+    Benchmark::printHeader(juce::String("DSP kernels per instruction set (detected: ")
+        + DspKernels::getName(detected) + ", active: " + DspKernels::getName(active) + ")");
+
+    for (auto isa : DspKernels::allIsas)
+    {
+        if (!DspKernels::setActiveIsa(isa))
+            continue;
+
+        juce::String name(DspKernels::getName(isa));
+
+        Benchmark::printRow(name + ": 8 sections, stereo", measureCascade(false), "ns/sample");
+        Benchmark::printRow(name + ": 8 sections, mid/side", measureCascade(true), "ns/sample");
+        Benchmark::printRow(name + ": recall crossfade", measureCrossfade(), "ns/sample");
+        Benchmark::printRow(name + ": response curve, 1000 points", measureResponseCurve(), "us");
+    }
+
+    DspKernels::setActiveIsa(active);
+}
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+    LevelCheck.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    /** The extremes of what the meters showed over a whole run. */
+    struct LevelSummary
+    {
+        std::array<float, 2> inputPeak{ LevelMeter::silence, LevelMeter::silence };
+        std::array<float, 2> outputPeak{ LevelMeter::silence, LevelMeter::silence };
+        std::array<float, 2> outputRms{ LevelMeter::silence, LevelMeter::silence };
+        float lowestCorrelation{ 1.f };
+
+        LoudnessMeter::Readings inputLoudness, outputLoudness;
+
+        /** Reads the meters the way the editor does, after a block. */
+        void update(const TradeMarkEQAudioProcessor& processor)
+        {
+            auto input = processor.getInputLevels();
+            auto output = processor.getOutputLevels();
+
+            for (size_t ch = 0; ch < 2; ++ch)
+            {
+                inputPeak[ch] = juce::jmax(inputPeak[ch], input.peak[ch]);
+                outputPeak[ch] = juce::jmax(outputPeak[ch], output.peak[ch]);
+                outputRms[ch] = juce::jmax(outputRms[ch], output.rms[ch]);
+            }
+
+            // Silence reads as 0, which says nothing about the phase.
+            if (output.rms[0] > LevelMeter::silence && output.rms[1] > LevelMeter::silence)
+                lowestCorrelation = juce::jmin(lowestCorrelation, output.correlation);
+
+            inputLoudness = processor.getInputLoudness();
+            outputLoudness = processor.getOutputLoudness();
+        }
+    };
+
+    /** Plays a source through a fresh instance, block by block, as an offline render. */
+    template <typename ReadBlock>
+    LevelSummary run(double sampleRate, const juce::String& presetName, juce::int64 numSamples, ReadBlock&& read)
+    {
+        TradeMarkEQAudioProcessor processor;
+        auto& presets = processor.getPresetManager();
+
+        if (presetName.isNotEmpty())
+        {
+            auto found = false;
+
+            for (int i = 0; i < presets.getNumPresets() && !found; ++i)
+            {
+                if (presets.getPresetName(i).equalsIgnoreCase(presetName))
+                {
+                    presets.loadPreset(i);
+                    found = true;
+                }
+            }
+
+            if (!found)
+                juce::ConsoleApplication::fail("Unknown preset: " + presetName);
+        }
+
+        processor.setNonRealtime(true);
+        Benchmark::prepareToPlay(processor, sampleRate);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        juce::MidiBuffer midi;
+        LevelSummary summary;
+
+        for (juce::int64 start = 0; start < numSamples; start += Benchmark::blockSize)
+        {
+            auto length = (int)juce::jmin((juce::int64)Benchmark::blockSize, numSamples - start);
+            buffer.setSize(2, length, false, false, true);
+
+            read(buffer, start);
+            processor.processBlock(buffer, midi);
+            summary.update(processor);
+        }
+
+        processor.releaseResources();
+        return summary;
+    }
+
+    juce::String formatDecibels(float value)
+    {
+        return value > LevelMeter::silence ? juce::String(value, 1) : juce::String("-inf");
+    }
+
+    void printSummary(const juce::String& name, const LevelSummary& summary)
+    {
+        std::cout << name << std::endl;
+
+        auto row = [](const juce::String& label, const juce::String& value)
+            {
+                std::cout << "  " << label.paddedRight(' ', 26) << value << std::endl;
+            };
+
+        row("input peak (L / R)", formatDecibels(summary.inputPeak[0]) + " / " + formatDecibels(summary.inputPeak[1]) + " dBFS");
+        row("output peak (L / R)", formatDecibels(summary.outputPeak[0]) + " / " + formatDecibels(summary.outputPeak[1]) + " dBFS");
+        row("output RMS, max (L / R)", formatDecibels(summary.outputRms[0]) + " / " + formatDecibels(summary.outputRms[1]) + " dBFS");
+        row("output correlation, min", juce::String(summary.lowestCorrelation, 2));
+        row("integrated (in / out)", formatDecibels(summary.inputLoudness.integrated) + " / "
+            + formatDecibels(summary.outputLoudness.integrated) + " LUFS");
+        row("output true peak", formatDecibels(summary.outputLoudness.truePeak) + " dBTP");
+    }
+}
+
+void runLevelCheck(const juce::ArgumentList& args)
+{
+    auto presetName = args.getValueForOption("--preset");
+    auto maxPeak = args.getValueForOption("--max-peak");
+    auto minCorrelation = args.getValueForOption("--min-correlation");
+
+    std::vector<std::pair<juce::String, LevelSummary>> results;
+
+    for (int i = 1; i < args.arguments.size(); ++i)
+    {
+        if (args[i].isOption())
+            continue;
+
+        auto file = args[i].resolveAsExistingFile();
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+
+        if (reader == nullptr)
+            juce::ConsoleApplication::fail("Can't read " + file.getFullPathName());
+
+        // Streamed a block at a time, so files of any length fit. Mono files go to both channels.
+        results.push_back({ file.getFileName(), run(reader->sampleRate, presetName, reader->lengthInSamples,
+            [&](juce::AudioBuffer<float>& buffer, juce::int64 start)
+            {
+                reader->read(&buffer, 0, buffer.getNumSamples(), start, true, true);
+            }) });
+    }
+
+    // Without files, ten seconds of noise at -12 dBFS.
+    if (results.empty())
+    {
+        juce::int64 seed = 0;
+
+        results.push_back({ "noise", run(Benchmark::sampleRate, presetName, (juce::int64)(Benchmark::sampleRate * 10.0),
+            [&](juce::AudioBuffer<float>& buffer, juce::int64)
+            {
+                Benchmark::fillWithNoise(buffer, ++seed);
+                buffer.applyGain(juce::Decibels::decibelsToGain(-12.f));
+            }) });
+    }
+
+    juce::StringArray failures;
+
+    for (auto& [name, summary] : results)
+    {
+        printSummary(name, summary);
+
+        if (maxPeak.isNotEmpty()
+            && juce::jmax(summary.outputPeak[0], summary.outputPeak[1]) > maxPeak.getFloatValue())
+            failures.add(name + ": output peak above " + maxPeak + " dBFS");
+
+        if (minCorrelation.isNotEmpty() && summary.lowestCorrelation < minCorrelation.getFloatValue())
+            failures.add(name + ": output correlation below " + minCorrelation);
+    }
+
+    if (!failures.isEmpty())
+        juce::ConsoleApplication::fail(failures.joinIntoString("\n"));
+}
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    LoudnessBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    /** A stereo sine, the same on both channels. */
+    juce::AudioBuffer<float> makeSine(double frequency, float amplitude, double phase, double seconds)
+    {
+        juce::AudioBuffer<float> signal(2, (int)(seconds * Benchmark::sampleRate));
+        const auto step = juce::MathConstants<double>::twoPi * frequency / Benchmark::sampleRate;
+
+        for (int n = 0; n < signal.getNumSamples(); ++n)
+        {
+            auto value = amplitude * (float)std::sin(phase + step * n);
+            signal.setSample(0, n, value);
+            signal.setSample(1, n, value);
+        }
+
+        return signal;
+    }
+
+    LoudnessMeter::Readings measure(const juce::AudioBuffer<float>& signal)
+    {
+        LoudnessMeter meter;
+        meter.prepare(Benchmark::sampleRate, Benchmark::blockSize, 2);
+
+        for (int start = 0; start < signal.getNumSamples(); start += Benchmark::blockSize)
+        {
+            auto length = juce::jmin(Benchmark::blockSize, signal.getNumSamples() - start);
+            meter.process(juce::dsp::AudioBlock<const float>(signal).getSubBlock((size_t)start, (size_t)length));
+        }
+
+        return meter.getReadings();
+    }
+
+    /** Runs ten seconds of noise through an instance with three bands boosted
+        and returns the time per sample and the correction it settled on.
+    */
+    std::pair<double, float> runAutoGain(AutoGainMode mode)
+    {
+        TradeMarkEQAudioProcessor processor;
+
+        for (int i = 1; i < 4; ++i)
+            Benchmark::setParameter(processor.apvts, getPeakParameterIDs(i).gain, 6.f);
+
+        Benchmark::setParameter(processor.apvts, "Auto Gain", (float)mode);
+        Benchmark::prepareToPlay(processor);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        juce::MidiBuffer midi;
+        juce::int64 seed = 0;
+
+        auto cost = Benchmark::nanosecondsPerSample(1000, [&]
+            {
+                Benchmark::fillWithNoise(buffer, ++seed);
+                buffer.applyGain(0.25f);
+                processor.processBlock(buffer, midi);
+            });
+
+        return { cost, processor.getAutoGainDecibels() };
+    }
+}
+
+void runLoudnessBenchmarks()
+{
+    Benchmark::printHeader("Level and loudness meters and auto gain, stereo, "
+        + juce::String(Benchmark::blockSize) + " sample blocks");
+
+    {
+        LoudnessMeter meter;
+        meter.prepare(Benchmark::sampleRate, Benchmark::blockSize, 2);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        Benchmark::fillWithNoise(buffer, 1);
+
+        Benchmark::printRow("loudness meter", Benchmark::nanosecondsPerSample(2000, [&]
+            {
+                meter.process(juce::dsp::AudioBlock<const float>(buffer));
+            }), "ns/sample");
+    }
+
+    {
+        LevelMeter meter;
+        meter.prepare(Benchmark::sampleRate, 2);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        Benchmark::fillWithNoise(buffer, 2);
+
+        Benchmark::printRow("peak, RMS and correlation", Benchmark::nanosecondsPerSample(2000, [&]
+            {
+                meter.process(juce::dsp::AudioBlock<const float>(buffer));
+            }), "ns/sample");
+    }
+
+    // BS.2217: a 997 Hz sine at -23 dBFS on both channels reads -23 LUFS.
+    auto sine = measure(makeSine(997.0, juce::Decibels::decibelsToGain(-23.f), 0.0, 20.0));
+    Benchmark::printRow("997 Hz at -23 dBFS, integrated", sine.integrated, "LUFS");
+    Benchmark::printRow("997 Hz at -23 dBFS, short-term", sine.shortTerm, "LUFS");
+
+    // Sampled 45 degrees off its crests, a full scale sine at fs / 4 never
+    // has a sample above -3 dBFS.
+    auto offset = measure(makeSine(Benchmark::sampleRate / 4.0, 1.f, juce::MathConstants<double>::pi / 4.0, 1.0));
+    Benchmark::printRow("fs / 4 at 0 dBTP, true peak", offset.truePeak, "dBTP");
+
+    for (auto [mode, name] : { std::pair{ AutoGainMode::Off, "off" },
+                               std::pair{ AutoGainMode::Measured, "measured" },
+                               std::pair{ AutoGainMode::Estimated, "estimated" } })
+    {
+        auto [cost, correction] = runAutoGain(mode);
+
+        Benchmark::printRow(juce::String("processBlock, auto gain ") + name, cost, "ns/sample");
+
+        if (mode != AutoGainMode::Off)
+            Benchmark::printRow("  correction for 3 bands at +6 dB", correction, "dB");
+    }
+}
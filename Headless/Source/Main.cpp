@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    Command line tools for TradeMarkEQ that don't need a host or an audio
+    device: benchmarks for the DSP code, a multi-instance stress test, an
+    equivalence test against the original filter chain, level checks,
+    resonance scans, match EQ fits and impulse exports.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Benchmark.h"
+
+namespace
+{
+    struct BenchmarkEntry
+    {
+        const char* name;
+        void (*run)();
+    };
+
+    const BenchmarkEntry benchmarks[]
+    {
+        { "cut", runCutFilterBenchmarks },
+        { "bands", runPeakBandBenchmarks },
+        { "dynamic", runDynamicBandBenchmarks },
+        { "modulation", runModulationBenchmarks },
+        { "channels", runChannelModeBenchmarks },
+        { "state", runStateBenchmarks },
+        { "library", runPresetLibraryBenchmarks },
+        { "cache", runCoefficientCacheBenchmarks },
+        { "footprint", runFootprintBenchmarks },
+        { "isa", runIsaBenchmarks },
+        { "loudness", runLoudnessBenchmarks },
+        { "precision", runPrecisionBenchmarks },
+        { "automation", runAutomationBenchmarks },
+    };
+
+    void runBenchmarks(const juce::ArgumentList& args)
+    {
+        auto selected = args.arguments.size() > 1 ? args[1].text : juce::String();
+        auto ranAny = false;
+
+        for (auto& benchmark : benchmarks)
+        {
+            if (selected.isEmpty() || selected == benchmark.name)
+            {
+                benchmark.run();
+                ranAny = true;
+            }
+        }
+
+        if (!ranAny)
+            juce::ConsoleApplication::fail("Unknown benchmark: " + selected);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // The processor's parameter state runs timers, so it needs a message manager.
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+
+    app.addHelpCommand("--help|-h", "Usage:", true);
+
+    app.addCommand({ "--bench",
+                     "--bench [name]",
+                     "Runs the DSP benchmarks",
+                     "Runs every benchmark, or only the named one (cut, bands, dynamic, modulation, channels, state, library, cache, footprint, isa, loudness, precision, automation).",
+                     runBenchmarks });
+
+    app.addCommand({ "--stress",
+                     "--stress [max instances] [seconds]",
+                     "Runs the multi-instance stress test",
+                     "Runs 1, 2, 4... up to max instances (default 64) in series and in parallel in an "
+                     "AudioProcessorGraph, with random automation, and reports CPU load, cost per instance "
+                     "and missed deadlines. Each run lasts the given number of seconds (default 2).",
+                     runStressTest });
+
+    app.addCommand({ "--verify",
+                     "--verify [cases] [audio files...]",
+                     "Checks every engine against the original IIR::Filter chain",
+                     "Runs noise, sweeps and impulses (default 60 cases) plus any audio files given, with random "
+                     "settings, sample rates, block sizes and automation, through the original IIR::Filter chain "
+                     "and through the plug-in on every instruction set the CPU has. Fails if any output differs "
+                     "from the reference by more than float rounding.",
+                     runEquivalenceTest });
+
+    app.addCommand({ "--levels",
+                     "--levels [--preset=name] [--max-peak=dBFS] [--min-correlation=value] [audio files...]",
+                     "Prints what the meters read for audio files played through the plug-in",
+                     "Plays each file (or ten seconds of noise) through an instance, optionally with a factory or "
+                     "user preset loaded, and prints the highest input and output peaks, the highest output RMS, "
+                     "the lowest output correlation and the loudness. Fails if the output peak is above "
+                     "--max-peak or the correlation drops below --min-correlation, for automated level checks.",
+                     runLevelCheck });
+
+    app.addCommand({ "--resonances",
+                     "--resonances [--preset=name] [--apply] [audio files...]",
+                     "Finds resonances in audio files and suggests notches for them",
+                     "Runs each file (or twenty seconds of noise with a hum and a resonance) through the resonance "
+                     "detector and prints the resonances it settles on, the peak band settings that would notch them "
+                     "out, optionally with a preset loaded, and the time each analysis frame takes. With --apply, "
+                     "plays the audio through the plug-in with the notches set and prints what's left.",
+                     runResonanceCheck });
+
+    app.addCommand({ "--match",
+                     "--match [--apply] [reference file] [input file]",
+                     "Fits the match EQ to a reference and prints the settings",
+                     "Analyses the long-term spectra of both files (or of four minutes of pink noise, and the same "
+                     "noise through a known EQ as the reference) on every core, fits the cuts and peak bands to the "
+                     "difference, and prints the settings with the time each step takes. With --apply, plays the "
+                     "input through the plug-in with the fit set and prints how far it is from the reference.",
+                     runMatchCheck });
+
+    app.addCommand({ "--impulse",
+                     "--impulse [--preset=name] [--length=samples] [--rate=Hz] [--phase=minimum|linear|both] [--raw] [output file]",
+                     "Renders the EQ curve as an impulse response for convolution",
+                     "Renders a preset's curve (or a test curve) as minimum and linear phase impulses, at the given "
+                     "length or at 1024 to 65536 samples, and prints the time each takes and how far its magnitude "
+                     "response is from the filters'. With an output file, writes the chosen phase there as a 32 bit "
+                     "float WAV file, or as raw interleaved floats with --raw.",
+                     runImpulseCheck });
+
+    return app.findAndRunCommand(argc, argv);
+}
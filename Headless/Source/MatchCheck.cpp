@@ -0,0 +1,290 @@
+/*
+  ==============================================================================
+
+    MatchCheck.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/MatchEq.h"
+
+namespace
+{
+    // Long enough to stand in for a full song.
+    constexpr double songSeconds = 240.0;
+
+    /** Writes a stereo 24 bit WAV file a block at a time, fill() making each block. */
+    template <typename FillBlock>
+    void writeFile(const juce::File& file, double rate, juce::int64 numSamples, FillBlock&& fill)
+    {
+        file.deleteFile();
+
+        auto stream = file.createOutputStream();
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(stream != nullptr
+            ? wav.createWriterFor(stream.get(), rate, 2, 24, {}, 0) : nullptr);
+
+        if (writer == nullptr)
+            juce::ConsoleApplication::fail("Can't write " + file.getFullPathName());
+
+        // The writer owns the stream now.
+        stream.release();
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+
+        for (juce::int64 start = 0; start < numSamples; start += Benchmark::blockSize)
+        {
+            auto length = (int)juce::jmin((juce::int64)Benchmark::blockSize, numSamples - start);
+
+            buffer.setSize(2, length, false, false, true);
+            fill(buffer);
+            writer->writeFromAudioSampleBuffer(buffer, 0, length);
+        }
+    }
+
+    /** Paul Kellet's economy pink noise filter on white noise, about -20 dBFS RMS. */
+    struct PinkNoise
+    {
+        explicit PinkNoise(juce::int64 seed) : random(seed) {}
+
+        float next() noexcept
+        {
+            auto white = random.nextFloat() * 2.f - 1.f;
+
+            b0 = 0.99765f * b0 + white * 0.0990460f;
+            b1 = 0.96300f * b1 + white * 0.2965164f;
+            b2 = 0.57000f * b2 + white * 1.0526913f;
+
+            return (b0 + b1 + b2 + white * 0.1848f) * 0.05f;
+        }
+
+        juce::Random random;
+        float b0{ 0 }, b1{ 0 }, b2{ 0 };
+    };
+
+    /** A song's worth of stereo pink noise as the input, and the same noise
+        through a known EQ as the reference, so the fit has a right answer.
+    */
+    void writeTestFiles(const juce::File& reference, const juce::File& input)
+    {
+        const auto numSamples = (juce::int64)(Benchmark::sampleRate * songSeconds);
+
+        auto writeNoise = [numSamples](const juce::File& file, TradeMarkEQAudioProcessor* processor)
+            {
+                PinkNoise left(1), right(2);
+                juce::MidiBuffer midi;
+
+                writeFile(file, Benchmark::sampleRate, numSamples, [&](juce::AudioBuffer<float>& buffer)
+                    {
+                        for (int n = 0; n < buffer.getNumSamples(); ++n)
+                        {
+                            buffer.setSample(0, n, left.next());
+                            buffer.setSample(1, n, right.next());
+                        }
+
+                        if (processor != nullptr)
+                            processor->processBlock(buffer, midi);
+                    });
+            };
+
+        TradeMarkEQAudioProcessor eq;
+        auto& apvts = eq.apvts;
+
+        Benchmark::setParameter(apvts, "LowCut Freq", 70.f);
+        Benchmark::setParameter(apvts, "LowCut Slope", (float)Slope_24);
+        Benchmark::setParameter(apvts, "HighCut Bypassed", 1.f);
+
+        Benchmark::setParameter(apvts, getPeakParameterIDs(1).freq, 250.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(1).gain, 4.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(3).freq, 3500.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(3).gain, -5.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(3).quality, 1.5f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(4).freq, 10000.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(4).gain, 3.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(4).quality, 0.7f);
+
+        eq.setNonRealtime(true);
+        Benchmark::prepareToPlay(eq);
+
+        std::cout << "Writing " << songSeconds << " s of pink noise, and the same through a 70 Hz 24 dB/Oct low cut, "
+                     "+4 dB at 250 Hz, -5 dB at 3.5 kHz and +3 dB at 10 kHz as the reference" << std::endl;
+
+        writeNoise(input, nullptr);
+        writeNoise(reference, &eq);
+    }
+
+    /** The weighted RMS of a target about its weighted mean: how far apart the two spectra are, in dB. */
+    double getDifference(const MatchEqTarget& target)
+    {
+        double sum = 0, total = 0;
+
+        for (size_t i = 0; i < target.frequencies.size(); ++i)
+        {
+            if (!target.ceilings[i])
+            {
+                sum += target.weights[i] * target.decibels[i];
+                total += target.weights[i];
+            }
+        }
+
+        if (total == 0)
+            return 0.0;
+
+        const auto mean = sum / total;
+        double variance = 0;
+
+        for (size_t i = 0; i < target.frequencies.size(); ++i)
+            if (!target.ceilings[i])
+                variance += target.weights[i] * juce::square(target.decibels[i] - mean);
+
+        return std::sqrt(variance / total);
+    }
+
+    SpectrumAverage analyse(const juce::File& file, juce::ThreadPool& pool)
+    {
+        SpectrumAverage average;
+        auto seconds = Benchmark::timeBestOf(1, [&] { average = SpectrumAverage::fromFile(file, pool); });
+
+        if (average.getNumFrames() == 0)
+            juce::ConsoleApplication::fail("Can't read " + file.getFullPathName());
+
+        std::cout << "  " << file.getFileName() << ": " << juce::String(average.getSeconds(), 1) << " s analysed in "
+                  << juce::String(seconds * 1000.0, 1) << " ms" << std::endl;
+
+        return average;
+    }
+
+    void printSettings(const ChainSettings& settings)
+    {
+        auto printCut = [](const char* name, bool bypassed, float frequency, Slope slope)
+            {
+                std::cout << "  " << juce::String(name).paddedRight(' ', 12);
+
+                if (bypassed)
+                    std::cout << "bypassed" << std::endl;
+                else
+                    std::cout << juce::String(frequency, 0).paddedLeft(' ', 6) << " Hz  "
+                              << 12 * getNumCutSections(slope) << " dB/Oct" << std::endl;
+            };
+
+        printCut("LowCut", settings.lowCutBypassed, settings.lowCutFreq, settings.lowCutSlope);
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            const auto& peak = settings.peaks[(size_t)i];
+
+            std::cout << "  " << juce::String(peakBands[i].name).paddedRight(' ', 12)
+                      << juce::String(peak.freq, 0).paddedLeft(' ', 6) << " Hz"
+                      << juce::String(peak.gainInDecibels, 1).paddedLeft(' ', 7) << " dB"
+                      << "  Q " << juce::String(peak.quality, 2) << std::endl;
+        }
+
+        printCut("HighCut", settings.highCutBypassed, settings.highCutFreq, settings.highCutSlope);
+    }
+
+    /** Plays a file through the processor and averages what comes out. */
+    SpectrumAverage playThrough(TradeMarkEQAudioProcessor& processor, const juce::File& file)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+
+        if (reader == nullptr)
+            juce::ConsoleApplication::fail("Can't read " + file.getFullPathName());
+
+        processor.setNonRealtime(true);
+        Benchmark::prepareToPlay(processor, reader->sampleRate);
+
+        SpectrumAverage average(reader->sampleRate);
+        SpectrumAverage::FrameAnalyser analyser;
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        juce::MidiBuffer midi;
+        std::vector<float> pending;
+
+        for (juce::int64 start = 0; start < reader->lengthInSamples; start += Benchmark::blockSize)
+        {
+            reader->read(&buffer, 0, Benchmark::blockSize, start, true, true);
+            processor.processBlock(buffer, midi);
+
+            for (int n = 0; n < buffer.getNumSamples(); ++n)
+                pending.push_back(0.5f * (buffer.getSample(0, n) + buffer.getSample(1, n)));
+
+            while ((int)pending.size() >= SpectrumAverage::fftSize)
+            {
+                analyser.addFrame(average, pending.data());
+                pending.erase(pending.begin(), pending.begin() + SpectrumAverage::hopSize);
+            }
+        }
+
+        return average;
+    }
+}
+
+void runMatchCheck(const juce::ArgumentList& args)
+{
+    auto apply = args.containsOption("--apply");
+
+    juce::Array<juce::File> files;
+
+    for (int i = 1; i < args.arguments.size(); ++i)
+        if (!args[i].isOption())
+            files.add(args[i].resolveAsExistingFile());
+
+    if (files.size() == 1 || files.size() > 2)
+        juce::ConsoleApplication::fail("Give a reference and an input file, or neither");
+
+    TradeMarkEQAudioProcessor processor;
+
+    // Made up test files are deleted at the end.
+    std::unique_ptr<juce::TemporaryFile> testReference, testInput;
+
+    if (files.isEmpty())
+    {
+        testReference = std::make_unique<juce::TemporaryFile>(".wav");
+        testInput = std::make_unique<juce::TemporaryFile>(".wav");
+        writeTestFiles(testReference->getFile(), testInput->getFile());
+
+        files = { testReference->getFile(), testInput->getFile() };
+
+        // The slopes are the user's to choose, so the fit gets the right one.
+        Benchmark::setParameter(processor.apvts, "LowCut Slope", (float)Slope_24);
+    }
+
+    juce::ThreadPool pool(juce::jmax(1, juce::SystemStats::getNumCpus() - 1));
+
+    std::cout << "Long-term spectra, on " << pool.getNumThreads() + 1 << " threads" << std::endl;
+
+    auto reference = analyse(files[0], pool);
+    auto input = analyse(files[1], pool);
+
+    MatchEqTarget target;
+    MatchEqFit fit;
+
+    auto fitSeconds = Benchmark::timeBestOf(1, [&]
+        {
+            target = makeMatchEqTarget(reference, input);
+            fit = fitMatchEq(target, getChainSettings(processor.apvts), input.getSampleRate());
+        });
+
+    std::cout << "Fit: " << juce::String(fitSeconds * 1000.0, 1) << " ms, " << fit.iterations << " iterations, "
+              << juce::String(fit.errorBefore, 2) << " dB from the target flat, "
+              << juce::String(fit.errorAfter, 2) << " dB with the fit" << std::endl;
+
+    printSettings(fit.settings);
+
+    if (!apply)
+        return;
+
+    // What the input sounds like through the plug-in with the fit set, against the reference.
+    processor.applyMatch(fit.settings);
+
+    auto matched = playThrough(processor, files[1]);
+
+    std::cout << "Played through the plug-in: " << juce::String(getDifference(target), 2) << " dB from the reference before, "
+              << juce::String(getDifference(makeMatchEqTarget(reference, matched)), 2) << " dB after" << std::endl;
+}
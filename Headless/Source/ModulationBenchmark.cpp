@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    ModulationBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    enum class Setup
+    {
+        Static,
+        GainOnly,
+        FreqAndQuality,
+        EverythingModulated
+    };
+
+    double measure(Setup setup)
+    {
+        TradeMarkEQAudioProcessor processor;
+        auto& apvts = processor.apvts;
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            auto& ids = getPeakParameterIDs(i);
+
+            Benchmark::setParameter(apvts, ids.gain, 3.f);
+
+            if (setup == Setup::Static)
+                continue;
+
+            Benchmark::setParameter(apvts, ids.modSource, (float)ModSource::LFO);
+            Benchmark::setParameter(apvts, ids.modRate, 2.f + (float)i);
+            Benchmark::setParameter(apvts, ids.modGain, 6.f);
+
+            if (setup != Setup::GainOnly)
+            {
+                Benchmark::setParameter(apvts, ids.modFreq, 1.f);
+                Benchmark::setParameter(apvts, ids.modQuality, 0.5f);
+            }
+
+            if (setup == Setup::EverythingModulated)
+            {
+                Benchmark::setParameter(apvts, ids.dynamic, 1.f);
+                Benchmark::setParameter(apvts, ids.threshold, -30.f);
+            }
+        }
+
+        if (setup == Setup::EverythingModulated)
+        {
+            for (auto* cut : { "LowCut", "HighCut" })
+            {
+                Benchmark::setParameter(apvts, juce::String(cut) + " Mod Source", (float)ModSource::Envelope);
+                Benchmark::setParameter(apvts, juce::String(cut) + " Mod Freq", 1.f);
+                Benchmark::setParameter(apvts, juce::String(cut) + " Slope", (float)Slope_48);
+            }
+
+            Benchmark::setParameter(apvts, "LowCut Freq", 80.f);
+            Benchmark::setParameter(apvts, "HighCut Freq", 12000.f);
+        }
+
+        Benchmark::prepareToPlay(processor);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        juce::MidiBuffer midi;
+
+        return Benchmark::nanosecondsPerSample(1000, [&]
+            {
+                Benchmark::fillWithNoise(buffer, 5);
+                processor.processBlock(buffer, midi);
+            });
+    }
+}
+
+void runModulationBenchmarks()
+{
+    Benchmark::printHeader("Band modulation, full processBlock, stereo, "
+        + juce::String(Benchmark::blockSize) + " sample blocks, "
+        + juce::String(controlInterval) + " sample control interval");
+
+    auto staticCost = measure(Setup::Static);
+    Benchmark::printRow("Static bands", staticCost, "ns/sample");
+
+    for (auto [setup, label] : { std::pair{ Setup::GainOnly, "LFO on gain, all bands" },
+                                 std::pair{ Setup::FreqAndQuality, "LFO on freq, gain and Q, all bands" },
+                                 std::pair{ Setup::EverythingModulated, "+ dynamics and modulated 48 dB cuts" } })
+    {
+        auto cost = measure(setup);
+
+        Benchmark::printRow(label, cost, "ns/sample");
+        Benchmark::printRow("  overhead", cost - staticCost, "ns/sample");
+    }
+}
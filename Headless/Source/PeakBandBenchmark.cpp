@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    PeakBandBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    constexpr int maxBenchmarkBands = 24;
+
+    using Filter = juce::dsp::IIR::Filter<float>;
+
+    // Same cascade type the processor uses, just sized for the largest band
+    // count measured here.
+    using BenchmarkPeakFilters = FilterCascade<float, maxBenchmarkBands>;
+
+    PeakSettings makeBand(int index, int numBands)
+    {
+        PeakSettings peak;
+        peak.freq = juce::mapToLog10((index + 0.5f) / (float)numBands, 20.f, 20000.f);
+        peak.gainInDecibels = (index % 2 == 0) ? 6.f : -6.f;
+        peak.quality = 2.f;
+        return peak;
+    }
+
+    double measureCascade(int numBands, juce::AudioBuffer<float>& buffer)
+    {
+        BenchmarkPeakFilters peaks;
+        peaks.prepare({ Benchmark::sampleRate, (juce::uint32)Benchmark::blockSize, 2 });
+
+        for (int i = 0; i < numBands; ++i)
+        {
+            peaks.setSection(i, makePeakFilter(makeBand(i, numBands), Benchmark::sampleRate));
+            peaks.setSectionEnabled(i, true);
+        }
+
+        juce::dsp::AudioBlock<float> block(buffer);
+        juce::dsp::ProcessContextReplacing<float> context(block);
+
+        return Benchmark::nanosecondsPerSample(2000, [&] { peaks.process(context); });
+    }
+
+    // One IIR::Filter per band and channel, the way the bands used to be run.
+    double measureFilters(int numBands, juce::AudioBuffer<float>& buffer)
+    {
+        std::vector<Filter> filters((size_t)numBands * 2);
+
+        for (int i = 0; i < numBands; ++i)
+        {
+            auto coefficients = makePeakFilter(makeBand(i, numBands), Benchmark::sampleRate);
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                auto& filter = filters[(size_t)(i * 2 + ch)];
+                *filter.coefficients = juce::dsp::IIR::Coefficients<float>(coefficients);
+                filter.prepare({ Benchmark::sampleRate, (juce::uint32)Benchmark::blockSize, 1 });
+            }
+        }
+
+        juce::dsp::AudioBlock<float> block(buffer);
+        auto left = block.getSingleChannelBlock(0);
+        auto right = block.getSingleChannelBlock(1);
+        juce::dsp::ProcessContextReplacing<float> leftContext(left), rightContext(right);
+
+        return Benchmark::nanosecondsPerSample(2000, [&]
+            {
+                for (int i = 0; i < numBands; ++i)
+                {
+                    filters[(size_t)(i * 2)].process(leftContext);
+                    filters[(size_t)(i * 2 + 1)].process(rightContext);
+                }
+            });
+    }
+}
+
+void runPeakBandBenchmarks()
+{
+    Benchmark::printHeader("Peak bands, stereo, " + juce::String(Benchmark::blockSize) + " sample blocks");
+
+    juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+    Benchmark::fillWithNoise(buffer, 2);
+
+    for (auto numBands : { 1, 5, 7, 12, 24 })
+    {
+        jassert(numBands <= maxBenchmarkBands);
+
+        auto cascade = measureCascade(numBands, buffer);
+        auto filters = measureFilters(numBands, buffer);
+        auto label = juce::String(numBands) + " bands";
+
+        Benchmark::printRow(label + ", IIR::Filter per band", filters, "ns/sample");
+        Benchmark::printRow(label + ", FilterCascade", cascade, "ns/sample");
+        Benchmark::printRow(label + ", FilterCascade per band", cascade / numBands, "ns/sample/band");
+    }
+}
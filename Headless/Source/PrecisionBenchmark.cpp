@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+
+    PrecisionBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    using Cascade = FilterCascade<float, 8>;
+    using Reference = FilterCascade<double, 8>;
+
+    // Long enough for the slowest filters here to settle many times over.
+    constexpr double noiseSeconds = 10.0;
+
+    struct PrecisionCase
+    {
+        juce::String name;
+        double sampleRate;
+        Cascade::CoefficientsArray sections;
+    };
+
+    std::vector<PrecisionCase> makeCases()
+    {
+        using Design = juce::dsp::FilterDesign<float>;
+        std::vector<PrecisionCase> cases;
+
+        cases.push_back({ "Low cut, 20 Hz, 48 dB/Oct, 192 kHz", 192000.0,
+            Design::designIIRHighpassHighOrderButterworthMethod(20.f, 192000.0, 8) });
+
+        cases.push_back({ "Low cut, 30 Hz, 96 dB/Oct, 48 kHz", 48000.0,
+            Design::designIIRHighpassHighOrderButterworthMethod(30.f, 48000.0, 16) });
+
+        cases.push_back({ "High cut, 2 kHz, 48 dB/Oct, 48 kHz", 48000.0,
+            Design::designIIRLowpassHighOrderButterworthMethod(2000.f, 48000.0, 8) });
+
+        // Octave spaced peaks from 60 Hz, the low ones close to the unit circle.
+        PrecisionCase peaks{ "Peaks, 60 Hz to 7.7 kHz, 96 kHz", 96000.0, {} };
+
+        for (int i = 0; i < Cascade::maxSections; ++i)
+        {
+            auto gain = juce::Decibels::decibelsToGain(i % 2 == 0 ? 6.f : -6.f);
+            peaks.sections.add(juce::dsp::IIR::Coefficients<float>::makePeakFilter(peaks.sampleRate,
+                60.f * std::pow(2.f, (float)i), 4.f, gain));
+        }
+
+        cases.push_back(std::move(peaks));
+        return cases;
+    }
+
+    const char* getName(FilterPrecision precision)
+    {
+        switch (precision)
+        {
+            case FilterPrecision::Mixed:  return "Mixed";
+            case FilterPrecision::Double: return "Double";
+            case FilterPrecision::Float:
+            default:                      return "Float";
+        }
+    }
+
+    juce::String describeSections(juce::uint32 mask, int numSections)
+    {
+        juce::StringArray sections;
+
+        for (int i = 0; i < numSections; ++i)
+            if ((mask & (1u << i)) != 0)
+                sections.add(juce::String(i + 1));
+
+        return sections.isEmpty() ? juce::String("none") : sections.joinIntoString(", ");
+    }
+
+    struct Measurement
+    {
+        double noiseDecibels{ 0 }, nanoseconds{ 0 };
+        juce::uint32 promoted{ 0 };
+    };
+
+    /** Runs stereo noise through the cascade and through the same coefficients
+        in double, and measures how far below the output the difference is.
+    */
+    Measurement measure(const PrecisionCase& testCase, FilterPrecision precision)
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        const auto numSections = testCase.sections.size();
+        const juce::dsp::ProcessSpec spec{ testCase.sampleRate, (juce::uint32)Benchmark::blockSize, 2 };
+
+        Cascade cascade;
+        cascade.setPrecision(precision);
+        cascade.setSections(testCase.sections, numSections);
+        cascade.prepare(spec);
+
+        Reference reference;
+
+        for (int i = 0; i < numSections; ++i)
+        {
+            auto& design = *testCase.sections.getObjectPointerUnchecked(i);
+            jassert(design.getFilterOrder() == 2);
+
+            auto* c = design.getRawCoefficients();
+            reference.setSection(i, Reference::Design{ c[0], c[1], c[2], 1.0, c[3], c[4] });
+        }
+
+        reference.setNumSections(numSections);
+        reference.prepare(spec);
+
+        juce::AudioBuffer<float> output(2, Benchmark::blockSize);
+        juce::AudioBuffer<double> expected(2, Benchmark::blockSize);
+        juce::Random random(11);
+
+        const auto numBlocks = juce::roundToInt(testCase.sampleRate * noiseSeconds / Benchmark::blockSize);
+        double errorPower = 0, signalPower = 0;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int n = 0; n < Benchmark::blockSize; ++n)
+                {
+                    auto sample = random.nextFloat() - 0.5f;
+                    output.setSample(ch, n, sample);
+                    expected.setSample(ch, n, (double)sample);
+                }
+            }
+
+            juce::dsp::AudioBlock<float> block(output);
+            cascade.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+            juce::dsp::AudioBlock<double> expectedBlock(expected);
+            reference.process(juce::dsp::ProcessContextReplacing<double>(expectedBlock));
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int n = 0; n < Benchmark::blockSize; ++n)
+                {
+                    auto target = expected.getSample(ch, n);
+                    errorPower += juce::square((double)output.getSample(ch, n) - target);
+                    signalPower += target * target;
+                }
+            }
+        }
+
+        Measurement measurement;
+        measurement.noiseDecibels = 10.0 * std::log10(juce::jmax(errorPower, 1.0e-300) / signalPower);
+        measurement.promoted = cascade.getPromotedSections();
+
+        Benchmark::fillWithNoise(output, 12);
+
+        measurement.nanoseconds = Benchmark::nanosecondsPerSample(2000, [&]
+            {
+                juce::dsp::AudioBlock<float> block(output);
+                cascade.process(juce::dsp::ProcessContextReplacing<float>(block));
+            });
+
+        return measurement;
+    }
+
+    //==============================================================================
+    enum class Host
+    {
+        Float,
+        ConvertedDouble,
+        Double
+    };
+
+    /** A whole instance with both cuts and three bands in use, in a host
+        that mixes in float, in double with the conversion a plug-in without
+        double support needs, or in double handed straight over.
+    */
+    double measureHost(Host host)
+    {
+        TradeMarkEQAudioProcessor processor;
+        auto& apvts = processor.apvts;
+
+        Benchmark::setParameter(apvts, "LowCut Freq", 40.f);
+        Benchmark::setParameter(apvts, "LowCut Slope", (float)Slope_48);
+        Benchmark::setParameter(apvts, "HighCut Freq", 16000.f);
+        Benchmark::setParameter(apvts, "HighCut Slope", (float)Slope_24);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(0).gain, 3.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(2).gain, -6.f);
+        Benchmark::setParameter(apvts, getPeakParameterIDs(4).gain, 4.f);
+
+        processor.setProcessingPrecision(host == Host::Double ? juce::AudioProcessor::doublePrecision
+                                                              : juce::AudioProcessor::singlePrecision);
+        Benchmark::prepareToPlay(processor);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        Benchmark::fillWithNoise(buffer, 13);
+
+        juce::AudioBuffer<double> hostBuffer;
+        hostBuffer.makeCopyOf(buffer);
+
+        juce::MidiBuffer midi;
+
+        switch (host)
+        {
+            case Host::Float:
+                return Benchmark::nanosecondsPerSample(2000, [&] { processor.processBlock(buffer, midi); });
+
+            case Host::ConvertedDouble:
+                return Benchmark::nanosecondsPerSample(2000, [&]
+                    {
+                        buffer.makeCopyOf(hostBuffer, true);
+                        processor.processBlock(buffer, midi);
+                        hostBuffer.makeCopyOf(buffer, true);
+                    });
+
+            case Host::Double:
+            default:
+                return Benchmark::nanosecondsPerSample(2000, [&] { processor.processBlock(hostBuffer, midi); });
+        }
+    }
+}
+
+void runPrecisionBenchmarks()
+{
+    for (const auto& testCase : makeCases())
+    {
+        Benchmark::printHeader(testCase.name + ", stereo, " + juce::String(Benchmark::blockSize) + " sample blocks");
+
+        for (auto precision : { FilterPrecision::Float, FilterPrecision::Mixed, FilterPrecision::Double })
+        {
+            auto measurement = measure(testCase, precision);
+            juce::String name(getName(precision));
+
+            Benchmark::printRow(name + ", noise relative to the output", measurement.noiseDecibels, "dB");
+            Benchmark::printRow(name + ", CPU", measurement.nanoseconds, "ns/sample");
+
+            if (precision == FilterPrecision::Mixed)
+                std::cout << "  sections in double: " << describeSections(measurement.promoted, testCase.sections.size())
+                          << " of " << testCase.sections.size() << std::endl;
+        }
+    }
+
+    Benchmark::printHeader("Whole instance, stereo, " + juce::String(Benchmark::blockSize) + " sample blocks");
+
+    Benchmark::printRow("Float host", measureHost(Host::Float), "ns/sample");
+    Benchmark::printRow("Double host, converted to float", measureHost(Host::ConvertedDouble), "ns/sample");
+    Benchmark::printRow("Double host, processed in double", measureHost(Host::Double), "ns/sample");
+}
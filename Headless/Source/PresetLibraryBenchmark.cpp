@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    PresetLibraryBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    constexpr int numPresets = 50000;
+
+    std::vector<PresetLibrary::Entry> makeEntries(const juce::Array<juce::AudioProcessorParameter*>& parameters)
+    {
+        const juce::StringArray styles{ "Warm", "Bright", "Tight", "Open", "Smooth", "Punchy", "Dark", "Airy" };
+        const juce::StringArray sources{ "Vocal", "Kick", "Snare", "Bass", "Guitar", "Piano", "Bus", "Master" };
+
+        juce::Random random(17);
+        std::vector<PresetLibrary::Entry> entries;
+        entries.reserve(numPresets);
+
+        for (int i = 0; i < numPresets; ++i)
+        {
+            PresetLibrary::Entry entry;
+
+            auto& style = styles[random.nextInt(styles.size())];
+            auto& source = sources[random.nextInt(sources.size())];
+
+            entry.name = style + " " + source + " " + juce::String(i).paddedLeft('0', 5);
+            entry.tags = { style, source, "House" };
+
+            for (int p = 0; p < parameters.size(); ++p)
+                entry.values.push_back(random.nextFloat());
+
+            entries.push_back(std::move(entry));
+        }
+
+        return entries;
+    }
+
+    template <typename Fn>
+    double microseconds(Fn&& fn)
+    {
+        return Benchmark::timeBestOf(5, fn) * 1.0e6;
+    }
+}
+
+void runPresetLibraryBenchmarks()
+{
+    Benchmark::printHeader("Preset library, " + juce::String(numPresets) + " presets");
+
+    TradeMarkEQAudioProcessor processor;
+    auto& parameters = processor.getParameters();
+
+    juce::TemporaryFile bank(".tmeqbank");
+
+    auto entries = makeEntries(parameters);
+    auto writeSeconds = Benchmark::timeBestOf(1, [&] { PresetLibrary::write(bank.getFile(), entries, parameters); });
+
+    Benchmark::printRow("Write bank", writeSeconds * 1.0e3, "ms");
+    Benchmark::printRow("Bank size", (double)bank.getFile().getSize() / (1024.0 * 1024.0), "MB");
+
+    PresetLibrary library;
+
+    Benchmark::printRow("Open (map + check header)", microseconds([&] { library.open(bank.getFile(), parameters); }), "us");
+
+    if (library.getNumPresets() != numPresets)
+    {
+        std::cout << "Failed to open the bank" << std::endl;
+        return;
+    }
+
+    juce::Random random(3);
+    std::vector<float> values;
+
+    auto readCost = microseconds([&]
+        {
+            for (int i = 0; i < 1000; ++i)
+                library.getValues(random.nextInt(numPresets), values);
+        }) / 1000.0;
+
+    Benchmark::printRow("Read one preset", readCost, "us");
+
+    size_t numFound = 0;
+
+    Benchmark::printRow("Name prefix search \"warm vocal\"",
+        microseconds([&] { numFound = library.findByNamePrefix("warm vocal", 100).size(); }), "us");
+    Benchmark::printRow("  results", (double)numFound, "");
+
+    Benchmark::printRow("Tag search \"kick\"",
+        microseconds([&] { numFound = library.findByTag("kick", 100).size(); }), "us");
+    Benchmark::printRow("  results", (double)numFound, "");
+
+    Benchmark::printRow("Full-text search \"49999\" (scans)",
+        microseconds([&] { numFound = library.search("49999", 100).size(); }), "us");
+    Benchmark::printRow("  results", (double)numFound, "");
+
+    Benchmark::printRow("Recall a library preset",
+        microseconds([&] { library.getValues(12345, values); processor.recallParameterValues(values, false); }), "us");
+
+    // The same bank with every record number in both indices pointing past
+    // the records: searches have to skip them all rather than read past the file.
+    juce::MemoryBlock damaged;
+    bank.getFile().loadFileAsData(damaged);
+
+    auto* bytes = static_cast<char*>(damaged.getData());
+    auto nameIndex = (size_t)juce::ByteOrder::littleEndianInt64(bytes + 40);
+    auto tagIndex = (size_t)juce::ByteOrder::littleEndianInt64(bytes + 48);
+    auto strings = (size_t)juce::ByteOrder::littleEndianInt64(bytes + 56);
+
+    for (auto at = nameIndex; at < tagIndex; at += 4)
+        std::memset(bytes + at, 0xff, 4);
+
+    for (auto at = tagIndex + 8; at < strings; at += 12)
+        std::memset(bytes + at, 0xff, 4);
+
+    juce::TemporaryFile damagedBank(".tmeqbank");
+    damagedBank.getFile().replaceWithData(damaged.getData(), damaged.getSize());
+
+    PresetLibrary damagedLibrary;
+
+    if (damagedLibrary.open(damagedBank.getFile(), parameters))
+    {
+        numFound = damagedLibrary.findByNamePrefix("warm", 100).size() + damagedLibrary.findByTag("kick", 100).size();
+        Benchmark::printRow("Damaged indices, indexed results", (double)numFound, "");
+    }
+}
@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+    ResonanceCheck.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    struct Scan
+    {
+        std::vector<ResonanceTracker::Resonance> resonances;
+        int frames{ 0 };
+        double secondsPerFrame{ 0 };
+    };
+
+    /** Feeds a source through a ResonanceTracker a hop at a time, at the
+        detector's highest frame rate, timing every frame.
+    */
+    template <typename ReadBlock>
+    Scan scan(double sampleRate, juce::int64 numSamples, ReadBlock&& read)
+    {
+        constexpr auto fftSize = ResonanceTracker::fftSize;
+
+        const auto hop = juce::roundToInt(sampleRate / ResonanceDetector::maxFramesPerSecond);
+
+        ResonanceTracker tracker;
+        tracker.prepare(sampleRate);
+
+        juce::AudioBuffer<float> buffer(2, hop);
+        std::vector<float> history((size_t)fftSize, 0.f);
+        Scan result;
+        double seconds = 0;
+
+        for (juce::int64 start = 0; start + hop <= numSamples; start += hop)
+        {
+            read(buffer, start);
+
+            // Summed to mono, as the tap on the audio thread does.
+            std::copy(history.begin() + juce::jmin(hop, fftSize), history.end(), history.begin());
+
+            auto* mono = history.data() + fftSize - juce::jmin(hop, fftSize);
+            auto offset = juce::jmax(0, hop - fftSize);
+
+            juce::FloatVectorOperations::copyWithMultiply(mono, buffer.getReadPointer(0) + offset, 0.5f, juce::jmin(hop, fftSize));
+            juce::FloatVectorOperations::addWithMultiply(mono, buffer.getReadPointer(1) + offset, 0.5f, juce::jmin(hop, fftSize));
+
+            seconds += Benchmark::timeBestOf(1, [&] { tracker.analyseFrame(history.data(), hop / sampleRate); });
+            ++result.frames;
+        }
+
+        result.resonances = tracker.getResonances();
+        result.secondsPerFrame = result.frames > 0 ? seconds / result.frames : 0.0;
+
+        return result;
+    }
+
+    void loadPreset(TradeMarkEQAudioProcessor& processor, const juce::String& presetName)
+    {
+        auto& presets = processor.getPresetManager();
+
+        for (int i = 0; i < presets.getNumPresets(); ++i)
+        {
+            if (presets.getPresetName(i).equalsIgnoreCase(presetName))
+            {
+                presets.loadPreset(i);
+                return;
+            }
+        }
+
+        juce::ConsoleApplication::fail("Unknown preset: " + presetName);
+    }
+
+    void printResonances(const std::vector<ResonanceTracker::Resonance>& resonances)
+    {
+        if (resonances.empty())
+            std::cout << "  no resonances" << std::endl;
+
+        for (const auto& resonance : resonances)
+            std::cout << "  " << juce::String(resonance.frequency, 1).paddedLeft(' ', 8) << " Hz"
+                      << "  Q " << juce::String(resonance.quality, 1).paddedLeft(' ', 5)
+                      << "  +" << juce::String(resonance.prominence, 1) << " dB"
+                      << "  in " << juce::roundToInt(resonance.persistence * 100.f) << "% of frames" << std::endl;
+    }
+
+    void printNotches(const std::vector<NotchSuggestion>& notches)
+    {
+        for (const auto& notch : notches)
+            std::cout << "  " << juce::String(peakBands[notch.band].name).paddedRight(' ', 12)
+                      << juce::String(notch.frequency, 0).paddedLeft(' ', 6) << " Hz"
+                      << "  Q " << juce::String(notch.quality, 2)
+                      << "  " << juce::String(notch.gainInDecibels, 1) << " dB" << std::endl;
+    }
+
+    void printCost(const Scan& result)
+    {
+        const auto share = result.secondsPerFrame * ResonanceDetector::maxFramesPerSecond;
+
+        std::cout << "  analysis: " << juce::String(result.secondsPerFrame * 1000.0, 3) << " ms per frame, "
+                  << juce::String(share * 100.0, 2) << "% of a core at "
+                  << ResonanceDetector::maxFramesPerSecond << " frames/s (budget "
+                  << juce::String(ResonanceDetector::cpuBudget * 100.0, 2) << "%)" << std::endl;
+    }
+}
+
+void runResonanceCheck(const juce::ArgumentList& args)
+{
+    auto presetName = args.getValueForOption("--preset");
+    auto apply = args.containsOption("--apply");
+
+    struct Source
+    {
+        juce::String name;
+        double sampleRate;
+        juce::int64 numSamples;
+        std::function<void(juce::AudioBuffer<float>&, juce::int64)> read;
+    };
+
+    std::vector<Source> sources;
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    juce::OwnedArray<juce::AudioFormatReader> readers;
+
+    for (int i = 1; i < args.arguments.size(); ++i)
+    {
+        if (args[i].isOption())
+            continue;
+
+        auto file = args[i].resolveAsExistingFile();
+        auto* reader = readers.add(formats.createReaderFor(file));
+
+        if (reader == nullptr)
+            juce::ConsoleApplication::fail("Can't read " + file.getFullPathName());
+
+        sources.push_back({ file.getFileName(), reader->sampleRate, reader->lengthInSamples,
+            [reader](juce::AudioBuffer<float>& buffer, juce::int64 start)
+            {
+                reader->read(&buffer, 0, buffer.getNumSamples(), start, true, true);
+            } });
+    }
+
+    // Without files, twenty seconds of noise at -20 dBFS with a 60 Hz hum and
+    // a Q 8 resonance at 1.5 kHz, 12 dB above it.
+    if (sources.empty())
+    {
+        auto random = std::make_shared<juce::Random>(1);
+        auto resonance = std::make_shared<juce::dsp::IIR::Filter<float>>(
+            juce::dsp::IIR::Coefficients<float>::makePeakFilter(Benchmark::sampleRate, 1500.f, 8.f,
+                juce::Decibels::decibelsToGain(12.f)));
+
+        sources.push_back({ "noise, hum and a resonance", Benchmark::sampleRate, (juce::int64)(Benchmark::sampleRate * 20.0),
+            [random, resonance](juce::AudioBuffer<float>& buffer, juce::int64 start)
+            {
+                auto* left = buffer.getWritePointer(0);
+                const auto step = juce::MathConstants<double>::twoPi * 60.0 / Benchmark::sampleRate;
+
+                for (int n = 0; n < buffer.getNumSamples(); ++n)
+                {
+                    auto noise = resonance->processSample((random->nextFloat() * 2.f - 1.f) * 0.1f);
+                    left[n] = noise + 0.03f * (float)std::sin(step * (double)(start + n));
+                }
+
+                buffer.copyFrom(1, 0, buffer, 0, 0, buffer.getNumSamples());
+            } });
+    }
+
+    for (auto& source : sources)
+    {
+        std::cout << source.name << std::endl;
+
+        auto found = scan(source.sampleRate, source.numSamples, source.read);
+        printResonances(found.resonances);
+        printCost(found);
+
+        TradeMarkEQAudioProcessor processor;
+
+        if (presetName.isNotEmpty())
+            loadPreset(processor, presetName);
+
+        auto notches = processor.suggestNotches(found.resonances);
+
+        std::cout << "  suggested notches:" << std::endl;
+        printNotches(notches);
+
+        if (!apply || notches.empty())
+            continue;
+
+        // Runs the source through the plug-in with the notches set, and looks again.
+        processor.applyNotches(notches);
+        processor.setNonRealtime(true);
+
+        const auto hop = juce::roundToInt(source.sampleRate / ResonanceDetector::maxFramesPerSecond);
+        Benchmark::prepareToPlay(processor, source.sampleRate, hop);
+
+        juce::MidiBuffer midi;
+
+        auto after = scan(source.sampleRate, source.numSamples, [&](juce::AudioBuffer<float>& buffer, juce::int64 start)
+            {
+                source.read(buffer, start);
+                processor.processBlock(buffer, midi);
+            });
+
+        std::cout << "  after notching:" << std::endl;
+        printResonances(after.resonances);
+    }
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    StateBenchmark.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    constexpr int numInstances = 300;
+
+    // Moves every parameter away from its default, like a real session would.
+    void randomiseParameters(juce::AudioProcessor& processor, juce::int64 seed)
+    {
+        juce::Random random(seed);
+
+        for (auto* parameter : processor.getParameters())
+            parameter->setValueNotifyingHost(random.nextFloat());
+    }
+
+    // The restore path from before the compact format.
+    void restoreThroughValueTree(TradeMarkEQAudioProcessor& processor, const juce::MemoryBlock& state)
+    {
+        auto tree = juce::ValueTree::readFromData(state.getData(), state.getSize());
+
+        if (tree.isValid())
+            processor.apvts.replaceState(tree);
+    }
+
+    template <typename Restore>
+    double microsecondsPerInstance(Restore&& restore)
+    {
+        auto seconds = Benchmark::timeBestOf(3, [&]
+            {
+                std::vector<std::unique_ptr<TradeMarkEQAudioProcessor>> instances;
+
+                for (int i = 0; i < numInstances; ++i)
+                {
+                    instances.push_back(std::make_unique<TradeMarkEQAudioProcessor>());
+                    Benchmark::prepareToPlay(*instances.back());
+                    restore(*instances.back());
+                }
+            });
+
+        return seconds * 1.0e6 / numInstances;
+    }
+}
+
+void runStateBenchmarks()
+{
+    Benchmark::printHeader("Session load, " + juce::String(numInstances)
+        + " instances, construct + prepare + restore");
+
+    TradeMarkEQAudioProcessor source;
+    randomiseParameters(source, 11);
+
+    juce::MemoryBlock compactState;
+    source.getStateInformation(compactState);
+
+    juce::MemoryBlock legacyState;
+    {
+        juce::MemoryOutputStream stream(legacyState, false);
+        source.apvts.copyState().writeToStream(stream);
+    }
+
+    Benchmark::printRow("Compact state size", (double)compactState.getSize(), "bytes");
+    Benchmark::printRow("ValueTree state size", (double)legacyState.getSize(), "bytes");
+
+    auto nothing = microsecondsPerInstance([](TradeMarkEQAudioProcessor&) {});
+    Benchmark::printRow("No restore", nothing, "us/instance");
+
+    auto valueTree = microsecondsPerInstance([&](TradeMarkEQAudioProcessor& processor)
+        {
+            restoreThroughValueTree(processor, legacyState);
+        });
+    Benchmark::printRow("ValueTree blob, replaceState", valueTree - nothing, "us/instance");
+
+    auto legacy = microsecondsPerInstance([&](TradeMarkEQAudioProcessor& processor)
+        {
+            processor.setStateInformation(legacyState.getData(), (int)legacyState.getSize());
+        });
+    Benchmark::printRow("ValueTree blob, bulk apply", legacy - nothing, "us/instance");
+
+    auto compact = microsecondsPerInstance([&](TradeMarkEQAudioProcessor& processor)
+        {
+            processor.setStateInformation(compactState.getData(), (int)compactState.getSize());
+        });
+    Benchmark::printRow("Compact blob, bulk apply", compact - nothing, "us/instance");
+
+    // A state whose layout hash doesn't match, as after a parameter was
+    // inserted rather than appended, falls back to the IDs stored with it.
+    juce::MemoryBlock movedState(compactState);
+    static_cast<char*>(movedState.getData())[8] ^= 0x5a;
+
+    auto byID = microsecondsPerInstance([&](TradeMarkEQAudioProcessor& processor)
+        {
+            processor.setStateInformation(movedState.getData(), (int)movedState.getSize());
+        });
+    Benchmark::printRow("Compact blob, restored by ID", byID - nothing, "us/instance");
+
+    TradeMarkEQAudioProcessor restored;
+    restored.setStateInformation(movedState.getData(), (int)movedState.getSize());
+
+    auto numDifferent = 0;
+    const auto expected = source.getParameterValues();
+    const auto actual = restored.getParameterValues();
+
+    for (size_t i = 0; i < expected.size(); ++i)
+        if (std::abs(expected[i] - actual[i]) > 1.0e-4f)
+            ++numDifferent;
+
+    Benchmark::printRow("Parameters lost restoring by ID", (double)numDifferent, "parameters");
+}
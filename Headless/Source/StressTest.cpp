@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+
+    StressTest.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    enum class Topology
+    {
+        Series,
+        Parallel
+    };
+
+    using Graph = juce::AudioProcessorGraph;
+    using IOProcessor = Graph::AudioGraphIOProcessor;
+
+    /** N instances in one AudioProcessorGraph, either chained one after the
+        other or all fed from the input and summed at the output, plus the
+        parameters the host automates on each of them.
+    */
+    class StressGraph
+    {
+    public:
+        StressGraph(int numInstances, Topology topology)
+        {
+            graph.setPlayConfigDetails(2, 2, Benchmark::sampleRate, Benchmark::blockSize);
+
+            auto input = graph.addNode(std::make_unique<IOProcessor>(IOProcessor::audioInputNode));
+            auto output = graph.addNode(std::make_unique<IOProcessor>(IOProcessor::audioOutputNode));
+            auto previous = input;
+
+            for (int i = 0; i < numInstances; ++i)
+            {
+                auto processor = std::make_unique<TradeMarkEQAudioProcessor>();
+                addAutomatedParameters(*processor);
+                instances.push_back(processor.get());
+
+                auto node = graph.addNode(std::move(processor));
+
+                connect(topology == Topology::Series ? previous : input, node);
+
+                if (topology == Topology::Parallel)
+                    connect(node, output);
+
+                previous = node;
+            }
+
+            if (topology == Topology::Series)
+                connect(previous, output);
+
+            graph.prepareToPlay(Benchmark::sampleRate, Benchmark::blockSize);
+        }
+
+        ~StressGraph()
+        {
+            graph.releaseResources();
+        }
+
+        /** Moves a few parameters on every instance, the way a host playing
+            back automation would: setValue() from the audio thread.
+        */
+        void automate(juce::Random& random)
+        {
+            for (auto& parameter : automated)
+            {
+                if (random.nextInt(4) == 0)
+                    parameter.target->setValue(parameter.range.getStart()
+                        + random.nextFloat() * parameter.range.getLength());
+            }
+        }
+
+        void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+        {
+            graph.processBlock(buffer, midi);
+        }
+
+        /** The lowest level any instance's QualityScheduler has dropped to. */
+        QualityScheduler::Level getLowestQuality() const
+        {
+            auto lowest = QualityScheduler::Level::Full;
+
+            for (auto* instance : instances)
+                lowest = juce::jmax(lowest, instance->getQualityScheduler().getPublishedLevel());
+
+            return lowest;
+        }
+
+    private:
+        struct AutomatedParameter
+        {
+            juce::AudioProcessorParameter* target;
+            juce::Range<float> range; // normalised
+        };
+
+        void connect(Graph::Node::Ptr source, Graph::Node::Ptr destination)
+        {
+            for (int channel = 0; channel < 2; ++channel)
+                graph.addConnection({ { source->nodeID, channel }, { destination->nodeID, channel } });
+        }
+
+        void addAutomatedParameters(TradeMarkEQAudioProcessor& processor)
+        {
+            auto add = [&](const juce::String& id, juce::Range<float> range)
+                {
+                    auto* parameter = processor.apvts.getParameter(id);
+                    jassert(parameter != nullptr);
+
+                    automated.push_back({ parameter, range });
+                };
+
+            add("LowCut Freq", { 0.f, 0.3f });
+            add("HighCut Freq", { 0.7f, 1.f });
+
+            // Gains stay within a few dB, so long chains don't run away.
+            for (int i = 0; i < numPeakBands; ++i)
+            {
+                auto& ids = getPeakParameterIDs(i);
+
+                add(ids.freq, { 0.f, 1.f });
+                add(ids.gain, { 0.45f, 0.55f });
+                add(ids.quality, { 0.f, 1.f });
+            }
+        }
+
+        Graph graph;
+        std::vector<AutomatedParameter> automated;
+        std::vector<TradeMarkEQAudioProcessor*> instances; // owned by the graph
+    };
+
+    struct StressResult
+    {
+        double cpuLoad, microsecondsPerInstance, worstBlockMs;
+        int deadlineMisses, numBlocks;
+        QualityScheduler::Level lowestQuality;
+    };
+
+    /** Calls the graph once per block period for the given length of time,
+        like an audio device would, and times every callback against its
+        deadline.
+    */
+    StressResult run(int numInstances, Topology topology, double seconds)
+    {
+        StressGraph graph(numInstances, topology);
+
+        juce::AudioBuffer<float> buffer(2, Benchmark::blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(numInstances);
+
+        const auto blockSeconds = Benchmark::blockSize / Benchmark::sampleRate;
+        const auto blockTicks = juce::Time::secondsToHighResolutionTicks(blockSeconds);
+        const auto numBlocks = juce::jmax(1, (int)(seconds / blockSeconds));
+        constexpr int numWarmUpBlocks = 20;
+
+        StressResult result{ 0, 0, 0, 0, numBlocks, QualityScheduler::Level::Full };
+        double busySeconds = 0;
+
+        auto nextCallback = juce::Time::getHighResolutionTicks();
+
+        for (int block = -numWarmUpBlocks; block < numBlocks; ++block)
+        {
+            // Sleep through most of the wait and spin the rest, so callbacks
+            // start on time without burning a core in between.
+            while (juce::Time::getHighResolutionTicks() < nextCallback)
+            {
+                auto remaining = juce::Time::highResolutionTicksToSeconds(nextCallback - juce::Time::getHighResolutionTicks());
+
+                if (remaining > 0.002)
+                    juce::Thread::sleep(1);
+            }
+
+            nextCallback += blockTicks;
+
+            Benchmark::fillWithNoise(buffer, block);
+            buffer.applyGain(0.1f);
+
+            auto start = juce::Time::getHighResolutionTicks();
+
+            graph.automate(random);
+            graph.process(buffer, midi);
+
+            auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            if (block < 0)
+                continue;
+
+            busySeconds += elapsed;
+            result.worstBlockMs = juce::jmax(result.worstBlockMs, elapsed * 1.0e3);
+
+            if (elapsed > blockSeconds)
+            {
+                ++result.deadlineMisses;
+
+                // A device would drop the late buffer and carry on from now.
+                nextCallback = juce::Time::getHighResolutionTicks();
+            }
+        }
+
+        result.lowestQuality = graph.getLowestQuality();
+        result.cpuLoad = busySeconds / (numBlocks * blockSeconds);
+        result.microsecondsPerInstance = busySeconds * 1.0e6 / ((double)numBlocks * numInstances);
+
+        return result;
+    }
+
+    void printResult(int numInstances, Topology topology, const StressResult& result)
+    {
+        std::cout << juce::String(numInstances).paddedLeft(' ', 9)
+                  << (topology == Topology::Series ? "  series  " : "  parallel")
+                  << juce::String(result.cpuLoad * 100.0, 1).paddedLeft(' ', 10)
+                  << juce::String(result.microsecondsPerInstance, 2).paddedLeft(' ', 14)
+                  << juce::String(result.worstBlockMs, 3).paddedLeft(' ', 12)
+                  << juce::String(result.deadlineMisses).paddedLeft(' ', 8)
+                  << " / " << juce::String(result.numBlocks).paddedRight(' ', 6)
+                  << QualityScheduler::getName(result.lowestQuality) << std::endl;
+    }
+}
+
+void runStressTest(const juce::ArgumentList& args)
+{
+    auto maxInstances = args.arguments.size() > 1 ? juce::jmax(1, args[1].text.getIntValue()) : 64;
+    auto seconds = args.arguments.size() > 2 ? juce::jmax(0.1, args[2].text.getDoubleValue()) : 2.0;
+
+    Benchmark::printHeader("Stress test, AudioProcessorGraph, " + juce::String(Benchmark::blockSize)
+        + " sample blocks at " + juce::String(Benchmark::sampleRate / 1000.0, 1) + " kHz, "
+        + juce::String(seconds, 1) + " s per run");
+
+    std::cout << "instances  topology    CPU (%)  us/instance   worst (ms)  misses        quality" << std::endl;
+
+    for (int numInstances = 1; numInstances <= maxInstances; numInstances *= 2)
+    {
+        for (auto topology : { Topology::Series, Topology::Parallel })
+            printResult(numInstances, topology, run(numInstances, topology, seconds));
+    }
+}
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    AutoGain.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Where the auto-gain stage takes its correction from.
+enum class AutoGainMode
+{
+    Off,
+
+    // The short-term loudness of the input minus that of the EQ's output.
+    Measured,
+
+    // How much the EQ curve changes the K-weighted energy of pink noise,
+    // worked out from the curve alone.
+    Estimated
+};
+
+/**
+    A gain stage after the EQ that undoes the EQ's change in loudness, so
+    comparing settings isn't won by whichever one is louder.
+
+    The correction is ramped, so new targets never click. Turning the stage
+    off ramps back to unity.
+*/
+class AutoGain
+{
+public:
+    /** The largest correction, either way. */
+    static constexpr float maxDecibels = 24.f;
+
+    void prepare(double sampleRate) noexcept
+    {
+        gain.reset(sampleRate, rampSeconds);
+        gain.setCurrentAndTargetValue(1.f);
+
+        targetDecibels = 0.f;
+        publishedDecibels.store(0.f, std::memory_order_relaxed);
+    }
+
+    void setTargetDecibels(float newTargetDecibels) noexcept
+    {
+        newTargetDecibels = juce::jlimit(-maxDecibels, maxDecibels, newTargetDecibels);
+
+        if (newTargetDecibels == targetDecibels)
+            return;
+
+        targetDecibels = newTargetDecibels;
+        gain.setTargetValue(juce::Decibels::decibelsToGain(targetDecibels, -maxDecibels - 1.f));
+        publishedDecibels.store(targetDecibels, std::memory_order_relaxed);
+    }
+
+    /** The correction being applied, or ramped to. Audio thread only. */
+    float getTargetDecibels() const noexcept { return targetDecibels; }
+
+    /** The correction being applied, or ramped to, for any thread. */
+    float getDecibels() const noexcept { return publishedDecibels.load(std::memory_order_relaxed); }
+
+    template <typename SampleType>
+    void process(juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        if (!gain.isSmoothing())
+        {
+            if (auto value = gain.getTargetValue(); value != 1.f)
+                block.multiplyBy(value);
+
+            return;
+        }
+
+        for (size_t i = 0; i < block.getNumSamples(); ++i)
+        {
+            auto value = gain.getNextValue();
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+                block.getChannelPointer(ch)[i] *= value;
+        }
+    }
+
+    /** Applies the same gain to a copy of the block, say a float one of a
+        double block, so the copy doesn't have to be made again afterwards.
+    */
+    template <typename SampleType, typename CopyType>
+    void process(juce::dsp::AudioBlock<SampleType>& block, juce::dsp::AudioBlock<CopyType>& copy) noexcept
+    {
+        jassert(copy.getNumSamples() == block.getNumSamples());
+
+        if (!gain.isSmoothing())
+        {
+            if (auto value = gain.getTargetValue(); value != 1.f)
+            {
+                block.multiplyBy(value);
+                copy.multiplyBy(value);
+            }
+
+            return;
+        }
+
+        const auto numCopied = juce::jmin(block.getNumSamples(), copy.getNumSamples());
+
+        for (size_t i = 0; i < block.getNumSamples(); ++i)
+        {
+            auto value = gain.getNextValue();
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+                block.getChannelPointer(ch)[i] *= value;
+
+            if (i < numCopied)
+                for (size_t ch = 0; ch < copy.getNumChannels(); ++ch)
+                    copy.getChannelPointer(ch)[i] *= value;
+        }
+    }
+
+private:
+    static constexpr double rampSeconds = 0.1;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> gain{ 1.f };
+    float targetDecibels{ 0 };
+
+    std::atomic<float> publishedDecibels{ 0.f };
+};
@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    AutomationScheduler.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "AutomationScheduler.h"
+
+AutomationScheduler::AutomationScheduler(const juce::Array<juce::AudioProcessorParameter*>& parametersToUse) :
+    parameters(parametersToUse),
+    queued((size_t)capacity),
+    plannedValues((size_t)parametersToUse.size()),
+    plannedBlocks((size_t)parametersToUse.size()),
+    values((size_t)parametersToUse.size()),
+    heldFrom((size_t)parametersToUse.size()),
+    held((size_t)parametersToUse.size(), false)
+{
+    waiting.reserve((size_t)capacity);
+    planned.reserve((size_t)capacity);
+}
+
+void AutomationScheduler::prepare() noexcept
+{
+    const juce::SpinLock::ScopedLockType lock(writeLock);
+
+    fifo.reset();
+    waiting.clear();
+    planned.clear();
+    nextBlockStart.store(0, std::memory_order_relaxed);
+
+    std::fill(held.begin(), held.end(), false);
+    numHeld = 0;
+    holdingValues = false;
+}
+
+bool AutomationScheduler::schedule(int parameterIndex, float normalisedValue, int sampleOffset) noexcept
+{
+    if (!juce::isPositiveAndBelow(parameterIndex, parameters.size()))
+        return false;
+
+    const juce::SpinLock::ScopedLockType lock(writeLock);
+
+    if (fifo.getFreeSpace() == 0)
+        return false;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    queued[(size_t)start1] = { nextBlockStart.load(std::memory_order_relaxed) + juce::jmax(0, sampleOffset),
+                               parameterIndex, juce::jlimit(0.f, 1.f, normalisedValue) };
+
+    fifo.finishedWrite(1);
+    return true;
+}
+
+int AutomationScheduler::beginBlock(int numSamples) noexcept
+{
+    const auto blockStart = nextBlockStart.load(std::memory_order_relaxed);
+    const auto blockEnd = blockStart + juce::jmax(0, numSamples);
+
+    nextBlockStart.store(blockEnd, std::memory_order_relaxed);
+
+    pullQueuedEvents();
+    releaseMovedParameters();
+
+    blockLength = juce::jmax(0, numSamples);
+    numSegments = 0;
+    planned.clear();
+    startSegment(0);
+
+    const auto hasDueEvents = numSamples > 0 && !waiting.empty() && waiting.front().time < blockEnd;
+    holdingValues = hasDueEvents || numHeld > 0;
+
+    // The held values stay where the last block left them.
+    if (holdingValues)
+        for (size_t i = 0; i < values.size(); ++i)
+            if (!held[i])
+                values[i] = parameters.getUnchecked((int)i)->getValue();
+
+    if (!hasDueEvents)
+        return 1;
+
+    ++blockNumber;
+
+    // Far enough apart that there are never more than maxSegments.
+    const auto spacing = juce::jmax(minSegmentLength, (numSamples + maxSegments - 1) / maxSegments);
+
+    // Everything before `kept` is a change that's due but too small to
+    // start a segment so far; everything after the due ones is for later.
+    size_t kept = 0;
+
+    for (size_t i = 0; i < waiting.size(); ++i)
+    {
+        const auto event = waiting[i];
+
+        if (event.time >= blockEnd)
+        {
+            waiting[kept++] = event;
+            continue;
+        }
+
+        const auto offset = (int)juce::jlimit((juce::int64)0, (juce::int64)numSamples - 1, event.time - blockStart);
+        const auto segmentStart = segmentStarts[(size_t)numSegments - 1];
+
+        if (offset < segmentStart + spacing)
+        {
+            addToSegment(event);
+            continue;
+        }
+
+        const auto index = (size_t)event.parameterIndex;
+        const auto current = plannedBlocks[index] == blockNumber ? plannedValues[index] : values[index];
+
+        if (std::abs(event.value - current) < audibleChange)
+        {
+            waiting[kept++] = event;
+            continue;
+        }
+
+        // The small changes held back so far start here too.
+        startSegment(offset);
+
+        for (size_t j = 0; j < kept; ++j)
+            addToSegment(waiting[j]);
+
+        kept = 0;
+        addToSegment(event);
+    }
+
+    waiting.resize(kept);
+    return numSegments;
+}
+
+AutomationScheduler::Segment AutomationScheduler::applySegment(int index) noexcept
+{
+    jassert(juce::isPositiveAndBelow(index, numSegments));
+
+    const auto first = index > 0 ? segmentEvents[(size_t)index - 1] : 0;
+
+    for (auto i = first; i < segmentEvents[(size_t)index]; ++i)
+    {
+        const auto& event = planned[(size_t)i];
+        const auto parameterIndex = (size_t)event.parameterIndex;
+
+        values[parameterIndex] = event.value;
+
+        if (!held[parameterIndex])
+        {
+            held[parameterIndex] = true;
+            heldFrom[parameterIndex] = parameters.getUnchecked(event.parameterIndex)->getValue();
+            ++numHeld;
+        }
+    }
+
+    const auto start = segmentStarts[(size_t)index];
+    const auto end = index + 1 < numSegments ? segmentStarts[(size_t)index + 1] : blockLength;
+
+    return { start, end - start };
+}
+
+void AutomationScheduler::pullQueuedEvents() noexcept
+{
+    const auto numToRead = juce::jmin(fifo.getNumReady(), capacity - (int)waiting.size());
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numToRead, start1, size1, start2, size2);
+
+    for (auto [start, size] : { std::pair{ start1, size1 }, std::pair{ start2, size2 } })
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            // Nearly always in order already, so this rarely moves anything.
+            const auto event = queued[(size_t)(start + i)];
+            auto position = waiting.size();
+            waiting.push_back(event);
+
+            for (; position > 0 && waiting[position - 1].time > event.time; --position)
+                waiting[position] = waiting[position - 1];
+
+            waiting[position] = event;
+        }
+    }
+
+    fifo.finishedRead(size1 + size2);
+}
+
+void AutomationScheduler::releaseMovedParameters() noexcept
+{
+    if (numHeld == 0)
+        return;
+
+    for (size_t i = 0; i < held.size(); ++i)
+    {
+        if (held[i] && parameters.getUnchecked((int)i)->getValue() != heldFrom[i])
+        {
+            held[i] = false;
+            --numHeld;
+        }
+    }
+}
+
+void AutomationScheduler::startSegment(int start) noexcept
+{
+    jassert(numSegments < maxSegments);
+
+    segmentStarts[(size_t)numSegments] = start;
+    segmentEvents[(size_t)numSegments] = (int)planned.size();
+    ++numSegments;
+}
+
+void AutomationScheduler::addToSegment(const Event& event) noexcept
+{
+    planned.push_back(event);
+    segmentEvents[(size_t)numSegments - 1] = (int)planned.size();
+
+    plannedValues[(size_t)event.parameterIndex] = event.value;
+    plannedBlocks[(size_t)event.parameterIndex] = blockNumber;
+}
@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    AutomationScheduler.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Parameter changes with sample offsets, and the block split at them, so
+    timestamped automation lands on its sample whatever the host's buffer
+    size.
+
+    Changes are queued with schedule(), from any thread, counted from the
+    start of the next block. At the start of a block beginBlock() pulls the
+    ones that fall inside it and cuts the block into segments, and
+    applySegment() moves a copy of every parameter's normalised value,
+    getValues(), to where each segment starts. The processor builds each
+    segment's settings from that copy and runs the segment as a block of
+    its own, so the filters are redesigned between segments and nowhere
+    else.
+
+    The parameters themselves are never touched, so scheduled values never
+    reach the host as edits it could record. A scheduled value is held in
+    the copy over the blocks that follow, until the host or the editor moves
+    the parameter, at which point their value wins.
+
+    Nothing in the plug-in produces timestamped changes yet: JUCE hands the
+    host's automation over at block boundaries. Only --bench automation
+    calls schedule() for now.
+
+    Splitting costs a filter update and a pass through the per-block work,
+    so a block is only split where it's worth it:
+
+    - A change smaller than audibleChange, measured from the last value the
+      plan gave the parameter, doesn't start a segment. It rides
+      along until one starts, or until the changes add up to something
+      audible, so a finely sampled ramp becomes a few steps.
+    - Segments start at least minSegmentLength apart, and no more than
+      maxSegments make up a block. A change closer than that to the start of
+      the segment lands at its start, a little early.
+
+    Changes still waiting when the block ends go at the start of the next.
+*/
+class AutomationScheduler
+{
+public:
+    // Changes waiting to be pulled, and waiting for their block.
+    static constexpr int capacity = 1024;
+
+    static constexpr int maxSegments = 16;
+    static constexpr int minSegmentLength = 32;
+
+    /** In normalised units: about a fortieth of a dB on the gains, and less
+        than a quarter of a semitone on the frequencies above 100 Hz.
+    */
+    static constexpr float audibleChange = 0.0005f;
+
+    struct Segment
+    {
+        int start, length;
+    };
+
+    explicit AutomationScheduler(const juce::Array<juce::AudioProcessorParameter*>& parametersToUse);
+
+    /** Starts the timeline again and drops everything queued. Before processing starts. */
+    void prepare() noexcept;
+
+    /** Queues a change of a parameter, by index, to a normalised value,
+        sampleOffset samples after the start of the next block. Any thread.
+        False when the queue is full or there's no such parameter.
+    */
+    bool schedule(int parameterIndex, float normalisedValue, int sampleOffset) noexcept;
+
+    /** Plans the next block and returns how many segments it splits into,
+        at least one. Audio thread only, like everything below.
+    */
+    int beginBlock(int numSamples) noexcept;
+
+    /** Moves the values that change where a segment starts, and returns it. */
+    Segment applySegment(int index) noexcept;
+
+    /** Whether the settings should come from getValues() rather than the
+        parameters, because this block or an earlier one scheduled a value
+        the parameters don't have yet.
+    */
+    bool isHoldingValues() const noexcept { return holdingValues; }
+
+    /** Every parameter's normalised value, in parameter order, as of the
+        last applySegment(). Only up to date while isHoldingValues().
+    */
+    const std::vector<float>& getValues() const noexcept { return values; }
+
+private:
+    struct Event
+    {
+        juce::int64 time;
+        int parameterIndex;
+        float value;
+    };
+
+    void pullQueuedEvents() noexcept;
+    void releaseMovedParameters() noexcept;
+    void startSegment(int start) noexcept;
+    void addToSegment(const Event& event) noexcept;
+
+    const juce::Array<juce::AudioProcessorParameter*> parameters;
+
+    juce::SpinLock writeLock;
+    juce::AbstractFifo fifo{ capacity };
+    std::vector<Event> queued;
+
+    std::atomic<juce::int64> nextBlockStart{ 0 };
+
+    // Audio thread only. Waiting changes in time order, and the plan for the
+    // current block: where each segment starts and the changes it makes.
+    std::vector<Event> waiting, planned;
+    std::array<int, maxSegments> segmentStarts{}, segmentEvents{};
+    int numSegments{ 1 }, blockLength{ 0 };
+
+    // Where each parameter stands as the plan goes along, read from the
+    // parameter the first time a block touches it.
+    std::vector<float> plannedValues;
+    std::vector<juce::uint32> plannedBlocks;
+    juce::uint32 blockNumber{ 0 };
+
+    // The copy the segments are built from, which keeps the held values
+    // between blocks, and what each held parameter stood at when its hold began.
+    std::vector<float> values, heldFrom;
+    std::vector<bool> held;
+    int numHeld{ 0 };
+    bool holdingValues{ false };
+
+    JUCE_DECLARE_NON_COPYABLE(AutomationScheduler)
+};
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+    BandModulator.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+enum class ModSource
+{
+    Off,
+    LFO,
+    Envelope
+};
+
+struct ModulationSettings
+{
+    ModSource source{ ModSource::Off };
+    float rateHz{ 1.f };
+
+    // How far a full-scale modulation value moves each target.
+    float freqDepthOctaves{ 0 }, gainDepthDecibels{ 0 }, qualityDepthOctaves{ 0 };
+
+    bool isActive() const noexcept
+    {
+        return source != ModSource::Off
+            && (freqDepthOctaves != 0.f || gainDepthDecibels != 0.f || qualityDepthOctaves != 0.f);
+    }
+};
+
+/**
+    Follows the level of the input so bands can be modulated by it. Its
+    output is the level mapped from -60..0 dBFS onto 0..1.
+*/
+class EnvelopeFollower
+{
+public:
+    void prepare(double sampleRate) noexcept
+    {
+        attackCoefficient = std::exp(-1.f / (0.005f * (float)sampleRate));
+        releaseCoefficient = std::exp(-1.f / (0.150f * (float)sampleRate));
+        reset();
+    }
+
+    void reset() noexcept { envelope = 0.f; }
+
+    float process(const juce::dsp::AudioBlock<const float>& input) noexcept
+    {
+        const auto numChannels = input.getNumChannels();
+        const auto numSamples = input.getNumSamples();
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            auto peak = 0.f;
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+                peak = juce::jmax(peak, std::abs(input.getChannelPointer(ch)[n]));
+
+            auto coefficient = peak > envelope ? attackCoefficient : releaseCoefficient;
+            envelope = peak + coefficient * (envelope - peak);
+        }
+
+        juce::dsp::util::snapToZero(envelope);
+
+        return juce::jlimit(0.f, 1.f, juce::Decibels::gainToDecibels(envelope, -60.f) / 60.f + 1.f);
+    }
+
+private:
+    float attackCoefficient{ 0 }, releaseCoefficient{ 0 };
+    float envelope{ 0 };
+};
+
+/**
+    The modulation source of one band. It is advanced once per control
+    interval, and returns -1..1 for the LFO or 0..1 for the envelope.
+*/
+class BandModulator
+{
+public:
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void reset() noexcept { phase = 0.f; }
+
+    float advance(const ModulationSettings& settings, int numSamples, float envelopeValue) noexcept
+    {
+        switch (settings.source)
+        {
+            case ModSource::LFO:
+            {
+                auto value = std::sin(juce::MathConstants<float>::twoPi * phase);
+
+                phase += settings.rateHz * (float)numSamples / (float)sampleRate;
+                phase -= std::floor(phase);
+
+                return value;
+            }
+
+            case ModSource::Envelope:
+                return envelopeValue;
+
+            case ModSource::Off:
+            default:
+                return 0.f;
+        }
+    }
+
+private:
+    double sampleRate{ 44100.0 };
+    float phase{ 0 };
+};
@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "CoefficientCache.h"
+
+namespace
+{
+    template <typename To, typename From>
+    To bitCast(From value) noexcept
+    {
+        static_assert(sizeof(To) == sizeof(From), "sizes must match");
+
+        To result;
+        std::memcpy(&result, &value, sizeof(To));
+        return result;
+    }
+}
+
+CoefficientCache& CoefficientCache::getInstance()
+{
+    static CoefficientCache instance;
+    return instance;
+}
+
+CoefficientCache::KeyWords CoefficientCache::toWords(const Key& key) noexcept
+{
+    auto sampleRateBits = bitCast<juce::uint64>(key.sampleRate);
+
+    return { { (juce::uint32)key.shape,
+               (juce::uint32)key.numSections,
+               bitCast<juce::uint32>(key.freq),
+               bitCast<juce::uint32>(key.quality),
+               bitCast<juce::uint32>(key.gainInDecibels),
+               (juce::uint32)sampleRateBits,
+               (juce::uint32)(sampleRateBits >> 32) } };
+}
+
+juce::uint32 CoefficientCache::getHash(const KeyWords& words) noexcept
+{
+    // FNV-1a, one word at a time.
+    juce::uint32 hash = 2166136261u;
+
+    for (auto word : words)
+    {
+        hash ^= word;
+        hash *= 16777619u;
+    }
+
+    return hash ^ (hash >> 16);
+}
+
+bool CoefficientCache::find(const Key& key, Designs& designs) noexcept
+{
+    const auto keyWords = toWords(key);
+    const auto bucket = (int)(getHash(keyWords) % (juce::uint32)numBuckets);
+    const auto numWords = (size_t)key.numSections * 6;
+
+    for (int way = 0; way < numWays; ++way)
+    {
+        auto& slot = slots[(size_t)(bucket * numWays + way)];
+        auto before = slot.sequence.load(std::memory_order_acquire);
+
+        if (before == 0 || (before & 1) != 0)
+            continue;
+
+        auto matches = true;
+
+        for (size_t i = 0; i < (size_t)keySize && matches; ++i)
+            matches = slot.words[i].load(std::memory_order_relaxed) == keyWords[i];
+
+        if (!matches)
+            continue;
+
+        auto* output = designs.front().data();
+
+        for (size_t i = 0; i < numWords; ++i)
+            output[i] = bitCast<float>(slot.words[keySize + i].load(std::memory_order_relaxed));
+
+        // Anything copied while a writer was busy shows up as a changed counter.
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.sequence.load(std::memory_order_relaxed) == before)
+        {
+            if (counting.load(std::memory_order_relaxed))
+                hits.fetch_add(1, std::memory_order_relaxed);
+
+            return true;
+        }
+    }
+
+    if (counting.load(std::memory_order_relaxed))
+        misses.fetch_add(1, std::memory_order_relaxed);
+
+    return false;
+}
+
+void CoefficientCache::store(const Key& key, const Designs& designs) noexcept
+{
+    const auto keyWords = toWords(key);
+    const auto hash = getHash(keyWords);
+    const auto bucket = (int)(hash % (juce::uint32)numBuckets);
+
+    // An empty way if there is one, otherwise one picked by the rest of the hash.
+    auto way = (int)((hash / (juce::uint32)numBuckets) % (juce::uint32)numWays);
+
+    for (int i = 0; i < numWays; ++i)
+    {
+        if (slots[(size_t)(bucket * numWays + i)].sequence.load(std::memory_order_relaxed) == 0)
+        {
+            way = i;
+            break;
+        }
+    }
+
+    auto& slot = slots[(size_t)(bucket * numWays + way)];
+    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+
+    if ((sequence & 1) != 0
+        || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire))
+        return;
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < (size_t)keySize; ++i)
+        slot.words[i].store(keyWords[i], std::memory_order_relaxed);
+
+    auto* input = designs.front().data();
+
+    for (size_t i = 0; i < (size_t)key.numSections * 6; ++i)
+        slot.words[keySize + i].store(bitCast<juce::uint32>(input[i]), std::memory_order_relaxed);
+
+    // Skip zero when the counter wraps, it means empty.
+    slot.sequence.store(sequence + 2 == 0 ? 2 : sequence + 2, std::memory_order_release);
+}
+
+CoefficientCache::Statistics CoefficientCache::getStatistics() const noexcept
+{
+    return { hits.load(), misses.load() };
+}
+
+void CoefficientCache::resetStatistics() noexcept
+{
+    hits = 0;
+    misses = 0;
+}
+
+void CoefficientCache::clear() noexcept
+{
+    for (auto& slot : slots)
+        slot.sequence.store(0);
+}
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    A process-wide cache of filter designs, shared by every instance of the
+    plug-in.
+
+    Sessions tend to run the same template on many tracks at the same sample
+    rate, and every instance redesigns its filters once per block. With the
+    cache, the first instance designs a band and the rest copy the result.
+
+    Entries are stored inline in a fixed table of slots, each guarded by a
+    sequence counter: a writer makes the counter odd, writes, and makes it
+    even again, and a reader keeps what it copied only if the counter was even
+    and unchanged across the copy. Lookups never lock, block or allocate, and
+    an evicted entry is simply overwritten in place, so there is never anything
+    to reclaim. A writer that finds its slot busy skips the store; the design
+    is cached the next time round.
+
+    Keys are the exact design inputs, so a hit returns exactly what a fresh
+    design would.
+*/
+class CoefficientCache
+{
+public:
+    enum class Shape : juce::uint32
+    {
+        Peak,
+        HighPass,
+        LowPass
+    };
+
+    struct Key
+    {
+        Shape shape{ Shape::Peak };
+        int numSections{ 1 };
+        float freq{ 0 }, quality{ 0 }, gainInDecibels{ 0 };
+        double sampleRate{ 0 };
+    };
+
+    static constexpr int maxSections = 8;
+
+    /** Unnormalised { b0, b1, b2, a0, a1, a2 }, as FilterCascade::Design. */
+    using Design = std::array<float, 6>;
+    using Designs = std::array<Design, maxSections>;
+
+    struct Statistics
+    {
+        juce::uint64 hits{ 0 }, misses{ 0 };
+
+        double getHitRate() const noexcept
+        {
+            auto lookups = hits + misses;
+            return lookups > 0 ? (double)hits / (double)lookups : 0.0;
+        }
+    };
+
+    //==============================================================================
+    /** The one cache every instance in the process shares. */
+    static CoefficientCache& getInstance();
+
+    /** Fills the first key.numSections designs, from the cache if they're in
+        it, otherwise by calling makeDesigns(designs) and storing the result.
+    */
+    template <typename MakeDesigns>
+    void getDesigns(const Key& key, Designs& designs, MakeDesigns&& makeDesigns) noexcept
+    {
+        jassert(key.numSections > 0 && key.numSections <= maxSections);
+
+        if (enabled.load(std::memory_order_relaxed) && find(key, designs))
+            return;
+
+        makeDesigns(designs);
+
+        if (enabled.load(std::memory_order_relaxed))
+            store(key, designs);
+    }
+
+    //==============================================================================
+    /** Switches the cache off for comparisons; every lookup then designs afresh. */
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled.store(shouldBeEnabled); }
+    bool isEnabled() const noexcept { return enabled.load(); }
+
+    /** Hits and misses are only counted while this is on, which is off by
+        default. Every instance's audio thread would otherwise write the same
+        two counters on every lookup, so it's for benchmarks, not sessions.
+    */
+    void setCounting(bool shouldCount) noexcept { counting.store(shouldCount); }
+
+    Statistics getStatistics() const noexcept;
+    void resetStatistics() noexcept;
+
+    /** Empties every slot. Only for benchmarks, with no audio running. */
+    void clear() noexcept;
+
+private:
+    CoefficientCache() = default;
+
+    static constexpr int keySize = 7;
+    static constexpr int numWays = 4;
+    static constexpr int numBuckets = 256;
+
+    using KeyWords = std::array<juce::uint32, keySize>;
+
+    struct alignas(64) Slot
+    {
+        // Zero means empty, odd means a write is in progress.
+        std::atomic<juce::uint32> sequence{ 0 };
+        std::array<std::atomic<juce::uint32>, keySize + maxSections * 6> words{};
+    };
+
+    static KeyWords toWords(const Key& key) noexcept;
+    static juce::uint32 getHash(const KeyWords& words) noexcept;
+
+    bool find(const Key& key, Designs& designs) noexcept;
+    void store(const Key& key, const Designs& designs) noexcept;
+
+    std::array<Slot, numWays * numBuckets> slots;
+
+    // Only benchmarks write these, so during a session lookups just read the line.
+    std::atomic<bool> enabled{ true }, counting{ false };
+
+    // Kept apart from the slots so counting doesn't fight over their cache lines.
+    alignas(64) std::atomic<juce::uint64> hits{ 0 };
+    alignas(64) std::atomic<juce::uint64> misses{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(CoefficientCache)
+};
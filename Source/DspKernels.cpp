@@ -0,0 +1,766 @@
+/*
+  ==============================================================================
+
+    DspKernels.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "DspKernels.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+#if JUCE_ARM && (defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64))
+ #include <arm_neon.h>
+ #define TMEQ_HAS_NEON 1
+#else
+ #define TMEQ_HAS_NEON 0
+#endif
+
+// GCC and Clang only emit instructions beyond the build's baseline inside
+// functions that ask for them. MSVC emits any intrinsic anywhere.
+#if JUCE_GCC || JUCE_CLANG
+ #define TMEQ_TARGET(isa) __attribute__((target(isa)))
+#else
+ #define TMEQ_TARGET(isa)
+#endif
+
+namespace DspKernels
+{
+    FrequencyGrid::FrequencyGrid(const std::vector<double>& frequencies, double sampleRate)
+    {
+        jassert(sampleRate > 0);
+
+        for (auto* values : { &cosW, &sinW, &cos2W, &sin2W })
+            values->reserve(frequencies.size());
+
+        for (auto frequency : frequencies)
+        {
+            auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+
+            cosW.push_back(std::cos(w));
+            sinW.push_back(std::sin(w));
+            cos2W.push_back(std::cos(2.0 * w));
+            sin2W.push_back(std::sin(2.0 * w));
+        }
+    }
+
+    namespace
+    {
+        void snapState(StereoSection& section, const float* z1, const float* z2) noexcept
+        {
+            for (size_t lane = 0; lane < 2; ++lane)
+            {
+                auto v1 = z1[lane], v2 = z2[lane];
+                juce::dsp::util::snapToZero(v1); section.z1[lane] = v1;
+                juce::dsp::util::snapToZero(v2); section.z2[lane] = v2;
+            }
+        }
+
+        //==============================================================================
+        namespace scalar
+        {
+            void crossfade(float* output, const float* previous, size_t numSamples, int fadePosition, float step) noexcept
+            {
+                for (size_t n = 0; n < numSamples; ++n)
+                {
+                    auto gain = juce::jmin(1.f, (float)(fadePosition + (int)n) * step);
+                    output[n] = previous[n] + gain * (output[n] - previous[n]);
+                }
+            }
+
+            inline double magnitudeAt(const FrequencyGrid& grid, const double* c, size_t i) noexcept
+            {
+                // H(z) at z^-1 = cos w - j sin w; the signs of the imaginary parts drop out.
+                auto nr = c[0] + c[1] * grid.cosW[i] + c[2] * grid.cos2W[i];
+                auto ni = c[1] * grid.sinW[i] + c[2] * grid.sin2W[i];
+                auto dr = 1.0 + c[3] * grid.cosW[i] + c[4] * grid.cos2W[i];
+                auto di = c[3] * grid.sinW[i] + c[4] * grid.sin2W[i];
+
+                return std::sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+            }
+
+            void accumulateMagnitudes(const FrequencyGrid& grid, const double* c, double* magnitudes) noexcept
+            {
+                for (size_t i = 0; i < grid.size(); ++i)
+                    magnitudes[i] *= magnitudeAt(grid, c, i);
+            }
+
+            void measureLevels(const float* left, const float* right, size_t numSamples, LevelSums& sums) noexcept
+            {
+                sums = {};
+
+                for (size_t n = 0; n < numSamples; ++n)
+                {
+                    sums.peak[0] = juce::jmax(sums.peak[0], std::abs(left[n]));
+                    sums.peak[1] = juce::jmax(sums.peak[1], std::abs(right[n]));
+                    sums.squares[0] += left[n] * left[n];
+                    sums.squares[1] += right[n] * right[n];
+                    sums.product += left[n] * right[n];
+                }
+            }
+
+            // Adds the samples a vector loop left over to its sums.
+            inline void measureRemainder(const float* left, const float* right, size_t numSamples, LevelSums& sums) noexcept
+            {
+                LevelSums rest;
+                measureLevels(left, right, numSamples, rest);
+
+                for (size_t ch = 0; ch < 2; ++ch)
+                {
+                    sums.peak[ch] = juce::jmax(sums.peak[ch], rest.peak[ch]);
+                    sums.squares[ch] += rest.squares[ch];
+                }
+
+                sums.product += rest.product;
+            }
+
+            constexpr Table table{ nullptr, crossfade, accumulateMagnitudes, measureLevels };
+        }
+
+       #if JUCE_INTEL
+        //==============================================================================
+        // Both channels sit in lanes 0 and 1 of a __m128. Four samples are
+        // loaded per channel, transposed into four [L, R] pairs, run through
+        // the recursion one after the other and transposed back.
+        namespace sse2
+        {
+            struct Recursion
+            {
+                __m128 b0, b1, b2, a1, a2, z1, z2;
+            };
+
+            TMEQ_TARGET("sse2") inline Recursion loadRecursion(const StereoSection& s) noexcept
+            {
+                return { _mm_setr_ps(s.b0[0], s.b0[1], 0.f, 0.f), _mm_setr_ps(s.b1[0], s.b1[1], 0.f, 0.f),
+                         _mm_setr_ps(s.b2[0], s.b2[1], 0.f, 0.f), _mm_setr_ps(s.a1[0], s.a1[1], 0.f, 0.f),
+                         _mm_setr_ps(s.a2[0], s.a2[1], 0.f, 0.f), _mm_setr_ps(s.z1[0], s.z1[1], 0.f, 0.f),
+                         _mm_setr_ps(s.z2[0], s.z2[1], 0.f, 0.f) };
+            }
+
+            // [x0 + x1, x0 - x1]: M/S encode (times 0.5) and decode.
+            TMEQ_TARGET("sse2") inline __m128 sumAndDifference(__m128 x) noexcept
+            {
+                const auto swapped = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 2, 0, 1));
+                return _mm_add_ps(swapped, _mm_mul_ps(x, _mm_setr_ps(1.f, -1.f, 1.f, -1.f)));
+            }
+
+            // Same operation order as FilterCascade::processStereoSection.
+            template <bool EncodeInput, bool DecodeOutput>
+            TMEQ_TARGET("sse2") inline __m128 filter(Recursion& r, __m128 x) noexcept
+            {
+                if constexpr (EncodeInput)
+                    x = _mm_mul_ps(sumAndDifference(x), _mm_set1_ps(0.5f));
+
+                const auto output = _mm_add_ps(_mm_mul_ps(x, r.b0), r.z1);
+                r.z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, r.b1), _mm_mul_ps(output, r.a1)), r.z2);
+                r.z2 = _mm_sub_ps(_mm_mul_ps(x, r.b2), _mm_mul_ps(output, r.a2));
+
+                if constexpr (DecodeOutput)
+                    return sumAndDifference(output);
+                else
+                    return output;
+            }
+
+            // The same recursion with fused multiply-adds.
+            template <bool EncodeInput, bool DecodeOutput>
+            TMEQ_TARGET("avx2,fma") inline __m128 filterFused(Recursion& r, __m128 x) noexcept
+            {
+                if constexpr (EncodeInput)
+                    x = _mm_mul_ps(sumAndDifference(x), _mm_set1_ps(0.5f));
+
+                const auto output = _mm_fmadd_ps(x, r.b0, r.z1);
+                r.z1 = _mm_fnmadd_ps(output, r.a1, _mm_fmadd_ps(x, r.b1, r.z2));
+                r.z2 = _mm_fnmadd_ps(output, r.a2, _mm_mul_ps(x, r.b2));
+
+                if constexpr (DecodeOutput)
+                    return sumAndDifference(output);
+                else
+                    return output;
+            }
+
+            // Four samples of each channel are transposed into four [L, R]
+            // pairs, run through the recursion one after the other and
+            // transposed back. Spelled out once for each target, because GCC
+            // and Clang only inline the per-sample step into a function built
+            // for the same instruction set.
+           #define TMEQ_STEREO_SECTION(name, isa, step)                                                         \
+            template <bool EncodeInput, bool DecodeOutput>                                                   \
+            TMEQ_TARGET(isa) void name(StereoSection& section, const float* const* src, float* const* dst,  \
+                size_t numSamples) noexcept                                                                  \
+            {                                                                                                \
+                auto r = loadRecursion(section);                                                             \
+                size_t n = 0;                                                                                \
+                                                                                                             \
+                for (; n + 4 <= numSamples; n += 4)                                                          \
+                {                                                                                            \
+                    const auto left = _mm_loadu_ps(src[0] + n), right = _mm_loadu_ps(src[1] + n);            \
+                    const auto lo = _mm_unpacklo_ps(left, right), hi = _mm_unpackhi_ps(left, right);         \
+                                                                                                             \
+                    const auto y0 = step<EncodeInput, DecodeOutput>(r, lo);                                  \
+                    const auto y1 = step<EncodeInput, DecodeOutput>(r, _mm_movehl_ps(lo, lo));               \
+                    const auto y2 = step<EncodeInput, DecodeOutput>(r, hi);                                  \
+                    const auto y3 = step<EncodeInput, DecodeOutput>(r, _mm_movehl_ps(hi, hi));               \
+                                                                                                             \
+                    const auto y01 = _mm_movelh_ps(y0, y1), y23 = _mm_movelh_ps(y2, y3);                     \
+                    _mm_storeu_ps(dst[0] + n, _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0)));            \
+                    _mm_storeu_ps(dst[1] + n, _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(3, 1, 3, 1)));            \
+                }                                                                                            \
+                                                                                                             \
+                for (; n < numSamples; ++n)                                                                  \
+                {                                                                                            \
+                    const auto y = step<EncodeInput, DecodeOutput>(r, _mm_setr_ps(src[0][n], src[1][n], 0.f, 0.f)); \
+                    dst[0][n] = _mm_cvtss_f32(y);                                                            \
+                    dst[1][n] = _mm_cvtss_f32(_mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 2, 0, 1)));                \
+                }                                                                                            \
+                                                                                                             \
+                alignas(16) float z1[4], z2[4];                                                              \
+                _mm_store_ps(z1, r.z1);                                                                      \
+                _mm_store_ps(z2, r.z2);                                                                      \
+                snapState(section, z1, z2);                                                                  \
+            }
+
+            TMEQ_STEREO_SECTION(section, "sse2", filter)
+            TMEQ_STEREO_SECTION(sectionFused, "avx2,fma", filterFused)
+
+           #undef TMEQ_STEREO_SECTION
+
+            void processStereoSection(StereoSection& s, const float* const* src, float* const* dst,
+                size_t numSamples, bool encode, bool decode) noexcept
+            {
+                if (encode && decode)  section<true, true>(s, src, dst, numSamples);
+                else if (encode)       section<true, false>(s, src, dst, numSamples);
+                else if (decode)       section<false, true>(s, src, dst, numSamples);
+                else                   section<false, false>(s, src, dst, numSamples);
+            }
+
+            void processStereoSectionFused(StereoSection& s, const float* const* src, float* const* dst,
+                size_t numSamples, bool encode, bool decode) noexcept
+            {
+                if (encode && decode)  sectionFused<true, true>(s, src, dst, numSamples);
+                else if (encode)       sectionFused<true, false>(s, src, dst, numSamples);
+                else if (decode)       sectionFused<false, true>(s, src, dst, numSamples);
+                else                   sectionFused<false, false>(s, src, dst, numSamples);
+            }
+
+            TMEQ_TARGET("sse2") void crossfade(float* output, const float* previous, size_t numSamples,
+                int fadePosition, float step) noexcept
+            {
+                const auto one = _mm_set1_ps(1.f);
+                const auto steps = _mm_set1_ps(step);
+                auto position = _mm_add_epi32(_mm_set1_epi32(fadePosition), _mm_setr_epi32(0, 1, 2, 3));
+
+                size_t n = 0;
+
+                for (; n + 4 <= numSamples; n += 4)
+                {
+                    const auto gain = _mm_min_ps(one, _mm_mul_ps(_mm_cvtepi32_ps(position), steps));
+                    const auto before = _mm_loadu_ps(previous + n);
+                    const auto after = _mm_loadu_ps(output + n);
+
+                    _mm_storeu_ps(output + n, _mm_add_ps(before, _mm_mul_ps(gain, _mm_sub_ps(after, before))));
+                    position = _mm_add_epi32(position, _mm_set1_epi32(4));
+                }
+
+                scalar::crossfade(output + n, previous + n, numSamples - n, fadePosition + (int)n, step);
+            }
+
+            TMEQ_TARGET("sse2") void accumulateMagnitudes(const FrequencyGrid& grid, const double* c, double* magnitudes) noexcept
+            {
+                const auto b0 = _mm_set1_pd(c[0]), b1 = _mm_set1_pd(c[1]), b2 = _mm_set1_pd(c[2]);
+                const auto a1 = _mm_set1_pd(c[3]), a2 = _mm_set1_pd(c[4]), one = _mm_set1_pd(1.0);
+
+                size_t i = 0;
+
+                for (; i + 2 <= grid.size(); i += 2)
+                {
+                    const auto c1 = _mm_loadu_pd(grid.cosW.data() + i), s1 = _mm_loadu_pd(grid.sinW.data() + i);
+                    const auto c2 = _mm_loadu_pd(grid.cos2W.data() + i), s2 = _mm_loadu_pd(grid.sin2W.data() + i);
+
+                    const auto nr = _mm_add_pd(_mm_add_pd(b0, _mm_mul_pd(b1, c1)), _mm_mul_pd(b2, c2));
+                    const auto ni = _mm_add_pd(_mm_mul_pd(b1, s1), _mm_mul_pd(b2, s2));
+                    const auto dr = _mm_add_pd(_mm_add_pd(one, _mm_mul_pd(a1, c1)), _mm_mul_pd(a2, c2));
+                    const auto di = _mm_add_pd(_mm_mul_pd(a1, s1), _mm_mul_pd(a2, s2));
+
+                    const auto ratio = _mm_div_pd(_mm_add_pd(_mm_mul_pd(nr, nr), _mm_mul_pd(ni, ni)),
+                                                  _mm_add_pd(_mm_mul_pd(dr, dr), _mm_mul_pd(di, di)));
+
+                    _mm_storeu_pd(magnitudes + i, _mm_mul_pd(_mm_loadu_pd(magnitudes + i), _mm_sqrt_pd(ratio)));
+                }
+
+                for (; i < grid.size(); ++i)
+                    magnitudes[i] *= scalar::magnitudeAt(grid, c, i);
+            }
+
+            TMEQ_TARGET("sse2") inline float horizontalSum(__m128 x) noexcept
+            {
+                const auto pairs = _mm_add_ps(x, _mm_movehl_ps(x, x));
+                return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+            }
+
+            TMEQ_TARGET("sse2") inline float horizontalMax(__m128 x) noexcept
+            {
+                const auto pairs = _mm_max_ps(x, _mm_movehl_ps(x, x));
+                return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+            }
+
+            TMEQ_TARGET("sse2") void measureLevels(const float* left, const float* right, size_t numSamples, LevelSums& sums) noexcept
+            {
+                const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+                auto peakL = _mm_setzero_ps(), peakR = _mm_setzero_ps();
+                auto squaresL = _mm_setzero_ps(), squaresR = _mm_setzero_ps(), product = _mm_setzero_ps();
+
+                size_t n = 0;
+
+                for (; n + 4 <= numSamples; n += 4)
+                {
+                    const auto l = _mm_loadu_ps(left + n), r = _mm_loadu_ps(right + n);
+
+                    peakL = _mm_max_ps(peakL, _mm_and_ps(l, absMask));
+                    peakR = _mm_max_ps(peakR, _mm_and_ps(r, absMask));
+                    squaresL = _mm_add_ps(squaresL, _mm_mul_ps(l, l));
+                    squaresR = _mm_add_ps(squaresR, _mm_mul_ps(r, r));
+                    product = _mm_add_ps(product, _mm_mul_ps(l, r));
+                }
+
+                sums = { { horizontalMax(peakL), horizontalMax(peakR) },
+                         { horizontalSum(squaresL), horizontalSum(squaresR) },
+                         horizontalSum(product) };
+
+                scalar::measureRemainder(left + n, right + n, numSamples - n, sums);
+            }
+
+            constexpr Table table{ processStereoSection, crossfade, accumulateMagnitudes, measureLevels };
+        }
+
+        //==============================================================================
+        namespace avx2
+        {
+            TMEQ_TARGET("avx2,fma") void crossfade(float* output, const float* previous, size_t numSamples,
+                int fadePosition, float step) noexcept
+            {
+                const auto one = _mm256_set1_ps(1.f);
+                const auto steps = _mm256_set1_ps(step);
+                auto position = _mm256_add_epi32(_mm256_set1_epi32(fadePosition), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+                size_t n = 0;
+
+                for (; n + 8 <= numSamples; n += 8)
+                {
+                    const auto gain = _mm256_min_ps(one, _mm256_mul_ps(_mm256_cvtepi32_ps(position), steps));
+                    const auto before = _mm256_loadu_ps(previous + n);
+                    const auto after = _mm256_loadu_ps(output + n);
+
+                    _mm256_storeu_ps(output + n, _mm256_add_ps(before, _mm256_mul_ps(gain, _mm256_sub_ps(after, before))));
+                    position = _mm256_add_epi32(position, _mm256_set1_epi32(8));
+                }
+
+                scalar::crossfade(output + n, previous + n, numSamples - n, fadePosition + (int)n, step);
+            }
+
+            TMEQ_TARGET("avx2,fma") void accumulateMagnitudes(const FrequencyGrid& grid, const double* c, double* magnitudes) noexcept
+            {
+                const auto b0 = _mm256_set1_pd(c[0]), b1 = _mm256_set1_pd(c[1]), b2 = _mm256_set1_pd(c[2]);
+                const auto a1 = _mm256_set1_pd(c[3]), a2 = _mm256_set1_pd(c[4]), one = _mm256_set1_pd(1.0);
+
+                size_t i = 0;
+
+                for (; i + 4 <= grid.size(); i += 4)
+                {
+                    const auto c1 = _mm256_loadu_pd(grid.cosW.data() + i), s1 = _mm256_loadu_pd(grid.sinW.data() + i);
+                    const auto c2 = _mm256_loadu_pd(grid.cos2W.data() + i), s2 = _mm256_loadu_pd(grid.sin2W.data() + i);
+
+                    const auto nr = _mm256_fmadd_pd(b2, c2, _mm256_fmadd_pd(b1, c1, b0));
+                    const auto ni = _mm256_fmadd_pd(b2, s2, _mm256_mul_pd(b1, s1));
+                    const auto dr = _mm256_fmadd_pd(a2, c2, _mm256_fmadd_pd(a1, c1, one));
+                    const auto di = _mm256_fmadd_pd(a2, s2, _mm256_mul_pd(a1, s1));
+
+                    const auto ratio = _mm256_div_pd(_mm256_fmadd_pd(nr, nr, _mm256_mul_pd(ni, ni)),
+                                                     _mm256_fmadd_pd(dr, dr, _mm256_mul_pd(di, di)));
+
+                    _mm256_storeu_pd(magnitudes + i, _mm256_mul_pd(_mm256_loadu_pd(magnitudes + i), _mm256_sqrt_pd(ratio)));
+                }
+
+                for (; i < grid.size(); ++i)
+                    magnitudes[i] *= scalar::magnitudeAt(grid, c, i);
+            }
+
+            TMEQ_TARGET("avx2,fma") inline float horizontalSum(__m256 x) noexcept
+            {
+                return sse2::horizontalSum(_mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1)));
+            }
+
+            TMEQ_TARGET("avx2,fma") inline float horizontalMax(__m256 x) noexcept
+            {
+                return sse2::horizontalMax(_mm_max_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1)));
+            }
+
+            TMEQ_TARGET("avx2,fma") void measureLevels(const float* left, const float* right, size_t numSamples, LevelSums& sums) noexcept
+            {
+                const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+                auto peakL = _mm256_setzero_ps(), peakR = _mm256_setzero_ps();
+                auto squaresL = _mm256_setzero_ps(), squaresR = _mm256_setzero_ps(), product = _mm256_setzero_ps();
+
+                size_t n = 0;
+
+                for (; n + 8 <= numSamples; n += 8)
+                {
+                    const auto l = _mm256_loadu_ps(left + n), r = _mm256_loadu_ps(right + n);
+
+                    peakL = _mm256_max_ps(peakL, _mm256_and_ps(l, absMask));
+                    peakR = _mm256_max_ps(peakR, _mm256_and_ps(r, absMask));
+                    squaresL = _mm256_fmadd_ps(l, l, squaresL);
+                    squaresR = _mm256_fmadd_ps(r, r, squaresR);
+                    product = _mm256_fmadd_ps(l, r, product);
+                }
+
+                sums = { { horizontalMax(peakL), horizontalMax(peakR) },
+                         { horizontalSum(squaresL), horizontalSum(squaresR) },
+                         horizontalSum(product) };
+
+                scalar::measureRemainder(left + n, right + n, numSamples - n, sums);
+            }
+
+            constexpr Table table{ sse2::processStereoSectionFused, crossfade, accumulateMagnitudes, measureLevels };
+        }
+
+        //==============================================================================
+        namespace avx512
+        {
+            TMEQ_TARGET("avx512f") void crossfade(float* output, const float* previous, size_t numSamples,
+                int fadePosition, float step) noexcept
+            {
+                const auto one = _mm512_set1_ps(1.f);
+                const auto steps = _mm512_set1_ps(step);
+                auto position = _mm512_add_epi32(_mm512_set1_epi32(fadePosition),
+                    _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+
+                size_t n = 0;
+
+                for (; n + 16 <= numSamples; n += 16)
+                {
+                    const auto gain = _mm512_min_ps(one, _mm512_mul_ps(_mm512_cvtepi32_ps(position), steps));
+                    const auto before = _mm512_loadu_ps(previous + n);
+                    const auto after = _mm512_loadu_ps(output + n);
+
+                    _mm512_storeu_ps(output + n, _mm512_add_ps(before, _mm512_mul_ps(gain, _mm512_sub_ps(after, before))));
+                    position = _mm512_add_epi32(position, _mm512_set1_epi32(16));
+                }
+
+                scalar::crossfade(output + n, previous + n, numSamples - n, fadePosition + (int)n, step);
+            }
+
+            TMEQ_TARGET("avx512f") void accumulateMagnitudes(const FrequencyGrid& grid, const double* c, double* magnitudes) noexcept
+            {
+                const auto b0 = _mm512_set1_pd(c[0]), b1 = _mm512_set1_pd(c[1]), b2 = _mm512_set1_pd(c[2]);
+                const auto a1 = _mm512_set1_pd(c[3]), a2 = _mm512_set1_pd(c[4]), one = _mm512_set1_pd(1.0);
+
+                size_t i = 0;
+
+                for (; i + 8 <= grid.size(); i += 8)
+                {
+                    const auto c1 = _mm512_loadu_pd(grid.cosW.data() + i), s1 = _mm512_loadu_pd(grid.sinW.data() + i);
+                    const auto c2 = _mm512_loadu_pd(grid.cos2W.data() + i), s2 = _mm512_loadu_pd(grid.sin2W.data() + i);
+
+                    const auto nr = _mm512_fmadd_pd(b2, c2, _mm512_fmadd_pd(b1, c1, b0));
+                    const auto ni = _mm512_fmadd_pd(b2, s2, _mm512_mul_pd(b1, s1));
+                    const auto dr = _mm512_fmadd_pd(a2, c2, _mm512_fmadd_pd(a1, c1, one));
+                    const auto di = _mm512_fmadd_pd(a2, s2, _mm512_mul_pd(a1, s1));
+
+                    const auto ratio = _mm512_div_pd(_mm512_fmadd_pd(nr, nr, _mm512_mul_pd(ni, ni)),
+                                                     _mm512_fmadd_pd(dr, dr, _mm512_mul_pd(di, di)));
+
+                    _mm512_storeu_pd(magnitudes + i, _mm512_mul_pd(_mm512_loadu_pd(magnitudes + i), _mm512_sqrt_pd(ratio)));
+                }
+
+                for (; i < grid.size(); ++i)
+                    magnitudes[i] *= scalar::magnitudeAt(grid, c, i);
+            }
+
+            // No wider biquad: see the notes in DspKernels.h. The level sums
+            // are bound by loads long before AVX2 runs out of lanes.
+            constexpr Table table{ sse2::processStereoSectionFused, crossfade, accumulateMagnitudes, avx2::measureLevels };
+        }
+       #endif
+
+       #if TMEQ_HAS_NEON
+        //==============================================================================
+        // Both channels as the two lanes of a float32x2_t, with the same
+        // transpose-four-samples scheme as the SSE2 section.
+        namespace neon
+        {
+            // [x0 + x1, x0 - x1]: M/S encode (times 0.5) and decode.
+            inline float32x2_t sumAndDifference(float32x2_t x) noexcept
+            {
+                static const float signs[2]{ 1.f, -1.f };
+                return vadd_f32(vrev64_f32(x), vmul_f32(x, vld1_f32(signs)));
+            }
+
+            template <bool EncodeInput, bool DecodeOutput>
+            void section(StereoSection& s, const float* const* src, float* const* dst, size_t numSamples) noexcept
+            {
+                const auto b0 = vld1_f32(s.b0), b1 = vld1_f32(s.b1), b2 = vld1_f32(s.b2);
+                const auto a1 = vld1_f32(s.a1), a2 = vld1_f32(s.a2);
+                auto z1 = vld1_f32(s.z1), z2 = vld1_f32(s.z2);
+                const auto half = vdup_n_f32(0.5f);
+
+                auto filter = [&](float32x2_t x) noexcept
+                {
+                    if constexpr (EncodeInput)
+                        x = vmul_f32(sumAndDifference(x), half);
+
+                    // Same operation order as FilterCascade::processStereoSection.
+                    auto y = vadd_f32(vmul_f32(x, b0), z1);
+                    z1 = vadd_f32(vsub_f32(vmul_f32(x, b1), vmul_f32(y, a1)), z2);
+                    z2 = vsub_f32(vmul_f32(x, b2), vmul_f32(y, a2));
+
+                    if constexpr (DecodeOutput)
+                        y = sumAndDifference(y);
+
+                    return y;
+                };
+
+                size_t n = 0;
+
+                for (; n + 4 <= numSamples; n += 4)
+                {
+                    const auto pairs = vzipq_f32(vld1q_f32(src[0] + n), vld1q_f32(src[1] + n));
+
+                    const auto y0 = filter(vget_low_f32(pairs.val[0]));
+                    const auto y1 = filter(vget_high_f32(pairs.val[0]));
+                    const auto y2 = filter(vget_low_f32(pairs.val[1]));
+                    const auto y3 = filter(vget_high_f32(pairs.val[1]));
+
+                    const auto channels = vuzpq_f32(vcombine_f32(y0, y1), vcombine_f32(y2, y3));
+                    vst1q_f32(dst[0] + n, channels.val[0]);
+                    vst1q_f32(dst[1] + n, channels.val[1]);
+                }
+
+                for (; n < numSamples; ++n)
+                {
+                    const float input[2]{ src[0][n], src[1][n] };
+                    const auto y = filter(vld1_f32(input));
+
+                    dst[0][n] = vget_lane_f32(y, 0);
+                    dst[1][n] = vget_lane_f32(y, 1);
+                }
+
+                float state1[2], state2[2];
+                vst1_f32(state1, z1);
+                vst1_f32(state2, z2);
+                snapState(s, state1, state2);
+            }
+
+            void processStereoSection(StereoSection& s, const float* const* src, float* const* dst,
+                size_t numSamples, bool encode, bool decode) noexcept
+            {
+                if (encode && decode)  section<true, true>(s, src, dst, numSamples);
+                else if (encode)       section<true, false>(s, src, dst, numSamples);
+                else if (decode)       section<false, true>(s, src, dst, numSamples);
+                else                   section<false, false>(s, src, dst, numSamples);
+            }
+
+            void crossfade(float* output, const float* previous, size_t numSamples, int fadePosition, float step) noexcept
+            {
+                const int offsets[4]{ 0, 1, 2, 3 };
+                const auto one = vdupq_n_f32(1.f);
+                const auto steps = vdupq_n_f32(step);
+                auto position = vaddq_s32(vdupq_n_s32(fadePosition), vld1q_s32(offsets));
+
+                size_t n = 0;
+
+                for (; n + 4 <= numSamples; n += 4)
+                {
+                    const auto gain = vminq_f32(one, vmulq_f32(vcvtq_f32_s32(position), steps));
+                    const auto before = vld1q_f32(previous + n);
+                    const auto after = vld1q_f32(output + n);
+
+                    vst1q_f32(output + n, vaddq_f32(before, vmulq_f32(gain, vsubq_f32(after, before))));
+                    position = vaddq_s32(position, vdupq_n_s32(4));
+                }
+
+                scalar::crossfade(output + n, previous + n, numSamples - n, fadePosition + (int)n, step);
+            }
+
+            void measureLevels(const float* left, const float* right, size_t numSamples, LevelSums& sums) noexcept
+            {
+                auto peakL = vdupq_n_f32(0.f), peakR = vdupq_n_f32(0.f);
+                auto squaresL = vdupq_n_f32(0.f), squaresR = vdupq_n_f32(0.f), product = vdupq_n_f32(0.f);
+
+                size_t n = 0;
+
+                for (; n + 4 <= numSamples; n += 4)
+                {
+                    const auto l = vld1q_f32(left + n), r = vld1q_f32(right + n);
+
+                    peakL = vmaxq_f32(peakL, vabsq_f32(l));
+                    peakR = vmaxq_f32(peakR, vabsq_f32(r));
+                    squaresL = vmlaq_f32(squaresL, l, l);
+                    squaresR = vmlaq_f32(squaresR, r, r);
+                    product = vmlaq_f32(product, l, r);
+                }
+
+                auto sum = [](float32x4_t x)
+                    {
+                        const auto pairs = vadd_f32(vget_low_f32(x), vget_high_f32(x));
+                        return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+                    };
+
+                auto max = [](float32x4_t x)
+                    {
+                        const auto pairs = vmax_f32(vget_low_f32(x), vget_high_f32(x));
+                        return vget_lane_f32(vpmax_f32(pairs, pairs), 0);
+                    };
+
+                sums = { { max(peakL), max(peakR) }, { sum(squaresL), sum(squaresR) }, sum(product) };
+
+                scalar::measureRemainder(left + n, right + n, numSamples - n, sums);
+            }
+
+           #if defined (__aarch64__) || defined (_M_ARM64)
+            void accumulateMagnitudes(const FrequencyGrid& grid, const double* c, double* magnitudes) noexcept
+            {
+                const auto b0 = vdupq_n_f64(c[0]), b1 = vdupq_n_f64(c[1]), b2 = vdupq_n_f64(c[2]);
+                const auto a1 = vdupq_n_f64(c[3]), a2 = vdupq_n_f64(c[4]), one = vdupq_n_f64(1.0);
+
+                size_t i = 0;
+
+                for (; i + 2 <= grid.size(); i += 2)
+                {
+                    const auto c1 = vld1q_f64(grid.cosW.data() + i), s1 = vld1q_f64(grid.sinW.data() + i);
+                    const auto c2 = vld1q_f64(grid.cos2W.data() + i), s2 = vld1q_f64(grid.sin2W.data() + i);
+
+                    const auto nr = vfmaq_f64(vfmaq_f64(b0, b1, c1), b2, c2);
+                    const auto ni = vfmaq_f64(vmulq_f64(b1, s1), b2, s2);
+                    const auto dr = vfmaq_f64(vfmaq_f64(one, a1, c1), a2, c2);
+                    const auto di = vfmaq_f64(vmulq_f64(a1, s1), a2, s2);
+
+                    const auto ratio = vdivq_f64(vfmaq_f64(vmulq_f64(ni, ni), nr, nr),
+                                                 vfmaq_f64(vmulq_f64(di, di), dr, dr));
+
+                    vst1q_f64(magnitudes + i, vmulq_f64(vld1q_f64(magnitudes + i), vsqrtq_f64(ratio)));
+                }
+
+                for (; i < grid.size(); ++i)
+                    magnitudes[i] *= scalar::magnitudeAt(grid, c, i);
+            }
+
+            constexpr Table table{ processStereoSection, crossfade, accumulateMagnitudes, measureLevels };
+           #else
+            // 32-bit NEON has no double precision lanes.
+            constexpr Table table{ processStereoSection, crossfade, scalar::accumulateMagnitudes, measureLevels };
+           #endif
+        }
+       #endif
+
+        //==============================================================================
+        const Table& getTable(Isa isa) noexcept
+        {
+            switch (isa)
+            {
+               #if JUCE_INTEL
+                case Isa::SSE2:   return sse2::table;
+                case Isa::AVX2:   return avx2::table;
+                case Isa::AVX512: return avx512::table;
+               #endif
+               #if TMEQ_HAS_NEON
+                case Isa::NEON:   return neon::table;
+               #endif
+                case Isa::Scalar:
+                default:          return scalar::table;
+            }
+        }
+
+        Isa chooseIsa() noexcept
+        {
+            auto forced = juce::SystemStats::getEnvironmentVariable("TRADEMARKEQ_ISA", {});
+
+            for (auto isa : allIsas)
+                if (forced.equalsIgnoreCase(getName(isa)) && isSupported(isa))
+                    return isa;
+
+            return getDetectedIsa();
+        }
+
+        struct Active
+        {
+            Active() noexcept : isa(chooseIsa()), table(&getTable(isa.load())) {}
+
+            std::atomic<Isa> isa;
+            std::atomic<const Table*> table;
+        };
+
+        Active& getActive() noexcept
+        {
+            static Active active;
+            return active;
+        }
+    }
+
+    //==============================================================================
+    const char* getName(Isa isa) noexcept
+    {
+        switch (isa)
+        {
+            case Isa::SSE2:   return "sse2";
+            case Isa::AVX2:   return "avx2";
+            case Isa::AVX512: return "avx512";
+            case Isa::NEON:   return "neon";
+            case Isa::Scalar:
+            default:          return "scalar";
+        }
+    }
+
+    bool isSupported(Isa isa) noexcept
+    {
+        switch (isa)
+        {
+           #if JUCE_INTEL
+            case Isa::SSE2:   return juce::SystemStats::hasSSE2();
+            case Isa::AVX2:   return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+            // The AVX-512 table borrows the AVX2 biquad and level kernels.
+            case Isa::AVX512: return juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX2()
+                                  && juce::SystemStats::hasFMA3();
+           #endif
+           #if TMEQ_HAS_NEON
+            case Isa::NEON:   return true;
+           #endif
+            case Isa::Scalar: return true;
+            default:          return false;
+        }
+    }
+
+    Isa getDetectedIsa() noexcept
+    {
+        for (auto isa : { Isa::AVX512, Isa::AVX2, Isa::NEON, Isa::SSE2 })
+            if (isSupported(isa))
+                return isa;
+
+        return Isa::Scalar;
+    }
+
+    Isa getActiveIsa() noexcept
+    {
+        return getActive().isa.load();
+    }
+
+    bool setActiveIsa(Isa isa) noexcept
+    {
+        if (!isSupported(isa))
+            return false;
+
+        auto& active = getActive();
+        active.isa = isa;
+        active.table = &getTable(isa);
+        return true;
+    }
+
+    const Table& get() noexcept
+    {
+        return *getActive().table.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    DspKernels.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    The innermost loops of the plug-in, built once for every instruction set
+    it can use and picked when they're first needed, from what the CPU
+    supports.
+
+    - The stereo biquad section behind FilterCascade<float>. A biquad is a
+      recursion across samples with only two channels to run side by side,
+      so the wider AVX-512 registers don't help it, and that path shares the
+      AVX2 section.
+    - The crossfade used when a recall fades from the old filters to the
+      new ones.
+    - The magnitude response the editor draws, one section at a time over
+      a whole grid of frequencies.
+
+    SSE2 and NEON keep the operation order of the portable loops, so SSE2
+    matches them bit for bit. AVX2 and AVX-512 use fused multiply-adds, which
+    round differently in the last bits.
+
+    Setting the TRADEMARKEQ_ISA environment variable to scalar, sse2, avx2,
+    avx512 or neon forces that path, if the CPU has it. setActiveIsa() does
+    the same from code, for tests and benchmarks.
+*/
+namespace DspKernels
+{
+    enum class Isa
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512,
+        NEON
+    };
+
+    constexpr Isa allIsas[]{ Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512, Isa::NEON };
+
+    const char* getName(Isa isa) noexcept;
+
+    bool isSupported(Isa isa) noexcept;
+
+    /** The best instruction set this CPU supports. */
+    Isa getDetectedIsa() noexcept;
+
+    Isa getActiveIsa() noexcept;
+
+    /** Switches every kernel to another instruction set. Fails, and changes
+        nothing, if the CPU doesn't support it. Don't call it while audio is
+        running.
+    */
+    bool setActiveIsa(Isa isa) noexcept;
+
+    //==============================================================================
+    /** One biquad section for two channels, each lane with its own
+        coefficients and state, as FilterCascade stores them.
+    */
+    struct StereoSection
+    {
+        float b0[2], b1[2], b2[2], a1[2], a2[2];
+        float z1[2], z2[2];
+    };
+
+    /** cos and sin of w and 2w for a set of frequencies, so a magnitude
+        response can be evaluated section by section without any trig.
+    */
+    struct FrequencyGrid
+    {
+        FrequencyGrid() = default;
+        FrequencyGrid(const std::vector<double>& frequencies, double sampleRate);
+
+        size_t size() const noexcept { return cosW.size(); }
+
+        std::vector<double> cosW, sinW, cos2W, sin2W;
+    };
+
+    /** The peaks of a stereo block, and the sums of squares and of the
+        products of the two channels that RMS and correlation are made from.
+    */
+    struct LevelSums
+    {
+        float peak[2];
+        float squares[2];
+        float product;
+    };
+
+    struct Table
+    {
+        /** Runs one section from src to dst (which may be the same), optionally
+            converting L/R to M/S on the way in and back on the way out. Null
+            for the scalar path, which is FilterCascade's own loop.
+        */
+        void (*processStereoSection)(StereoSection& section, const float* const* src, float* const* dst,
+            size_t numSamples, bool encodeMidSide, bool decodeMidSide) noexcept;
+
+        /** output[n] = previous[n] + gain * (output[n] - previous[n]), with the
+            gain going from fadePosition * step up to 1.
+        */
+        void (*crossfade)(float* output, const float* previous, size_t numSamples,
+            int fadePosition, float step) noexcept;
+
+        /** Multiplies magnitudes[i] by |H| of one { b0, b1, b2, a1, a2 }
+            section at grid point i.
+        */
+        void (*accumulateMagnitudes)(const FrequencyGrid& grid, const double* coefficients,
+            double* magnitudes) noexcept;
+
+        /** Measures one block of a stereo pair into sums. Pass the same
+            channel twice for a mono signal.
+        */
+        void (*measureLevels)(const float* left, const float* right, size_t numSamples, LevelSums& sums) noexcept;
+    };
+
+    /** The kernels of the active instruction set. */
+    const Table& get() noexcept;
+}
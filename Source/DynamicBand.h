@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    DynamicBand.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct DynamicSettings
+{
+    bool enabled{ false };
+    float thresholdInDecibels{ 0 }, ratio{ 1.f }, attackMs{ 10.f }, releaseMs{ 100.f };
+};
+
+/**
+    The detector and gain computer for one dynamic peak band.
+
+    The detector band-passes the key signal (the band's own input, or the
+    external sidechain) around the band's frequency and follows its level.
+    Once per control interval (see controlInterval in QualityScheduler.h) the
+    level is turned into a gain offset, which pulls the band's gain down by
+    (level - threshold) * (1 - 1 / ratio).
+
+    Moving only the gain of a peak filter leaves sin(w) and cos(w) untouched,
+    so makeDesign() rebuilds the biquad from cached alpha and cos(w) terms
+    without any trig calls or allocation.
+*/
+class DynamicPeakBand
+{
+public:
+    /** Unnormalised { b0, b1, b2, a0, a1, a2 }, as IIR::ArrayCoefficients. */
+    using Design = std::array<float, 6>;
+
+    //==============================================================================
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        designedFreq = designedQuality = -1.f;
+        designedAttack = designedRelease = -1.f;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        z1.fill(0.f);
+        z2.fill(0.f);
+        envelope = 0.f;
+    }
+
+    /** Picks up new band settings. Only recomputes what actually changed. */
+    void setParameters(float freq, float quality, const DynamicSettings& settings) noexcept
+    {
+        jassert(sampleRate > 0);
+
+        if (freq != designedFreq || quality != designedQuality)
+        {
+            designedFreq = freq;
+            designedQuality = quality;
+
+            // Same terms IIR::ArrayCoefficients::makePeakFilter derives from freq and Q.
+            auto omega = juce::MathConstants<float>::twoPi * juce::jmax(freq, 2.f) / (float)sampleRate;
+            alpha = std::sin(omega) / (quality * 2.f);
+            c2 = -2.f * std::cos(omega);
+
+            auto bandPass = juce::dsp::IIR::ArrayCoefficients<float>::makeBandPass(sampleRate,
+                juce::jlimit(2.f, (float)sampleRate * 0.49f, freq),
+                quality);
+
+            auto a0Inv = 1.f / bandPass[3];
+            bp0 = bandPass[0] * a0Inv; bp1 = bandPass[1] * a0Inv; bp2 = bandPass[2] * a0Inv;
+            bpa1 = bandPass[4] * a0Inv; bpa2 = bandPass[5] * a0Inv;
+        }
+
+        if (settings.attackMs != designedAttack || settings.releaseMs != designedRelease)
+        {
+            designedAttack = settings.attackMs;
+            designedRelease = settings.releaseMs;
+
+            attackCoefficient = std::exp(-1.f / (juce::jmax(0.01f, settings.attackMs) * 0.001f * (float)sampleRate));
+            releaseCoefficient = std::exp(-1.f / (juce::jmax(0.01f, settings.releaseMs) * 0.001f * (float)sampleRate));
+        }
+
+        threshold = settings.thresholdInDecibels;
+        slope = 1.f - 1.f / juce::jmax(1.f, settings.ratio);
+    }
+
+    /** Runs the detector over the key signal and returns the gain reduction
+        in dB (zero or negative) for the block that follows.
+    */
+    float process(const juce::dsp::AudioBlock<const float>& key) noexcept
+    {
+        const auto numChannels = juce::jmin(key.getNumChannels(), z1.size());
+        const auto numSamples = key.getNumSamples();
+
+        std::array<const float*, 2> channels{};
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            channels[ch] = key.getChannelPointer(ch);
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            auto peak = 0.f;
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto input = channels[ch][n];
+                auto output = input * bp0 + z1[ch];
+
+                z1[ch] = input * bp1 - output * bpa1 + z2[ch];
+                z2[ch] = input * bp2 - output * bpa2;
+
+                peak = juce::jmax(peak, std::abs(output));
+            }
+
+            auto coefficient = peak > envelope ? attackCoefficient : releaseCoefficient;
+            envelope = peak + coefficient * (envelope - peak);
+        }
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            juce::dsp::util::snapToZero(z1[ch]);
+            juce::dsp::util::snapToZero(z2[ch]);
+        }
+
+        auto over = juce::Decibels::gainToDecibels(envelope) - threshold;
+        return over > 0.f ? -juce::jmin(maxReductionInDecibels, over * slope) : 0.f;
+    }
+
+    /** Peak filter design for the current frequency and Q at a new gain. */
+    Design makeDesign(float gainInDecibels) const noexcept
+    {
+        auto A = std::pow(10.f, gainInDecibels * (1.f / 40.f));
+        auto alphaTimesA = alpha * A;
+        auto alphaOverA = alpha / A;
+
+        return { { 1.f + alphaTimesA, c2, 1.f - alphaTimesA, 1.f + alphaOverA, c2, 1.f - alphaOverA } };
+    }
+
+private:
+    static constexpr float maxReductionInDecibels = 24.f;
+
+    double sampleRate{ 0 };
+
+    float designedFreq{ -1.f }, designedQuality{ -1.f };
+    float designedAttack{ -1.f }, designedRelease{ -1.f };
+
+    float alpha{ 0 }, c2{ 0 };
+    float bp0{ 0 }, bp1{ 0 }, bp2{ 0 }, bpa1{ 0 }, bpa2{ 0 };
+    std::array<float, 2> z1{}, z2{};
+
+    float attackCoefficient{ 0 }, releaseCoefficient{ 0 };
+    float envelope{ 0 };
+    float threshold{ 0 }, slope{ 0 };
+};
@@ -0,0 +1,681 @@
+/*
+  ==============================================================================
+
+    FilterCascade.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+/**
+    How a float FilterCascade runs its sections.
+
+    Transposed direct form II gets noisy as a section's poles close in on
+    the unit circle, which they do for low cut-offs at high sample rates: a
+    20 Hz cut at 192 kHz has poles within 0.001 of it, and in float the
+    rounding of its state comes out as hiss and a drifting response. Mixed
+    runs only the sections whose poles are that close in double, and leaves
+    everything else to the float kernels; Double runs all of them in double.
+    The coefficients stay the same in every mode.
+*/
+enum class FilterPrecision
+{
+    Float,
+    Mixed,
+    Double
+};
+
+/**
+    A cascade of up to MaxSections biquads for up to MaxChannels channels.
+
+    Coefficients and state are stored as structure-of-arrays (b0, b1, b2, a1,
+    a2, z1 and z2, each indexed by section and then channel) instead of one
+    IIR::Filter and one heap allocated Coefficients object per stage, so the
+    whole cascade is a handful of contiguous arrays that can be walked in order.
+
+    Sections are switched on and off individually, and only the ones that are
+    on get processed. That covers both uses in the plug-in: a cut filter uses
+    its first N sections, and the peak bands switch a section off when the band
+    is bypassed.
+
+    Every channel has its own coefficients, so a section can be loaded into
+    some channels and pass the others straight through. For stereo input both
+    channels run through each section in the same loop, two lanes side by
+    side, and the cascade can convert L/R to M/S on the way into its first
+    section and back on the way out of its last one.
+
+    A float cascade can run some of its sections in double, with double
+    state, as FilterPrecision describes. A section switching between the two
+    carries its state across, so changing the precision doesn't click.
+
+    It has the same prepare/process/reset interface as juce::dsp::IIR::Filter,
+    so it can sit inside a juce::dsp::ProcessorChain.
+*/
+template <typename SampleType, int MaxSections, int MaxChannels = 2>
+class FilterCascade
+{
+public:
+    using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+    using CoefficientsArray = juce::ReferenceCountedArray<Coefficients>;
+
+    /** Unnormalised second order design, laid out as { b0, b1, b2, a0, a1, a2 }
+        like the ones juce::dsp::IIR::ArrayCoefficients returns.
+    */
+    using Design = std::array<SampleType, 6>;
+
+    static constexpr int maxSections = MaxSections;
+    static constexpr int maxChannels = MaxChannels;
+
+    /** Channel mask with a bit set for every channel. */
+    static constexpr juce::uint32 allChannels = (1u << MaxChannels) - 1u;
+
+    /** In mixed precision, a section runs in double when its poles are closer
+        than this to the unit circle. The noise of a float section grows as
+        its poles close in; at this distance it's around -100 dB on white
+        noise: a second order high-pass at 220 Hz at 48 kHz, or 870 Hz at 192 kHz.
+    */
+    static constexpr double promotionDistance = 0.02;
+
+    //==============================================================================
+    void prepare(const juce::dsp::ProcessSpec& spec) noexcept
+    {
+        jassert(spec.numChannels <= (juce::uint32)MaxChannels);
+        juce::ignoreUnused(spec);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto* state : { &z1, &z2 })
+            for (auto& section : *state)
+                section.fill(SampleType(0));
+
+        for (auto* state : { &wideZ1, &wideZ2 })
+            for (auto& section : *state)
+                section.fill(0.0);
+    }
+
+    //==============================================================================
+    /** Picks which sections run in double. Only float cascades have a choice. */
+    void setPrecision(FilterPrecision newPrecision) noexcept
+    {
+        if (precision == newPrecision)
+            return;
+
+        precision = newPrecision;
+
+        for (int i = 0; i < MaxSections; ++i)
+            updatePromotion(i);
+    }
+
+    FilterPrecision getPrecision() const noexcept { return precision; }
+
+    /** Bit n is set when section n runs in double. Switched off sections count too. */
+    juce::uint32 getPromotedSections() const noexcept
+    {
+        juce::uint32 mask = 0;
+
+        for (int i = 0; i < MaxSections; ++i)
+            if (promoted[(size_t)i])
+                mask |= 1u << i;
+
+        return mask;
+    }
+
+    /** How far out the poles of 1 + a1 z^-1 + a2 z^-2 are: the modulus of a
+        complex pair, or the larger one of two real poles.
+    */
+    static double getPoleRadius(double a1, double a2) noexcept
+    {
+        const auto discriminant = a1 * a1 - 4.0 * a2;
+
+        if (discriminant < 0)
+            return std::sqrt(a2);
+
+        const auto root = std::sqrt(discriminant);
+        return juce::jmax(std::abs(-a1 + root), std::abs(-a1 - root)) * 0.5;
+    }
+
+    //==============================================================================
+    /** Copies the first numSectionsToUse designs into the cascade, switches them
+        on and switches the rest off. Sections that are switched off keep their
+        state, just like a bypassed IIR::Filter in a ProcessorChain would.
+    */
+    void setSections(const CoefficientsArray& coefficients, int numSectionsToUse,
+        juce::uint32 channelMask = allChannels) noexcept
+    {
+        numSectionsToUse = juce::jlimit(0, juce::jmin(MaxSections, coefficients.size()), numSectionsToUse);
+
+        for (int i = 0; i < numSectionsToUse; ++i)
+            setSection(i, *coefficients.getObjectPointerUnchecked(i), channelMask);
+
+        setNumSections(numSectionsToUse);
+    }
+
+    /** Switches the first numSectionsToUse sections on and the rest off. */
+    void setNumSections(int numSectionsToUse) noexcept
+    {
+        jassert(numSectionsToUse >= 0 && numSectionsToUse <= MaxSections);
+
+        for (int i = 0; i < MaxSections; ++i)
+            enabled[(size_t)i] = i < numSectionsToUse;
+
+        updateActiveSections();
+    }
+
+    /** Loads a first or second order design into a section, for the channels
+        in channelMask (bit n is channel n). The other channels pass through.
+    */
+    void setSection(int index, const Coefficients& design, juce::uint32 channelMask = allChannels) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(index, MaxSections));
+
+        auto* c = design.getRawCoefficients();
+
+        switch (design.getFilterOrder())
+        {
+            case 2:  loadSection(index, channelMask, c[0], c[1], c[2], c[3], c[4]); break;
+            case 1:  loadSection(index, channelMask, c[0], c[1], SampleType(0), c[2], SampleType(0)); break;
+            default: jassertfalse; break; // the cascade only holds first and second order sections
+        }
+    }
+
+    /** Loads an unnormalised design into a section, for the channels in
+        channelMask. This doesn't allocate, so it is safe to call on the audio
+        thread.
+    */
+    void setSection(int index, const Design& design, juce::uint32 channelMask = allChannels) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(index, MaxSections));
+
+        // Normalised the same way IIR::Coefficients does it.
+        const auto a0 = design[3];
+        const auto a0Inv = a0 != SampleType(0) ? SampleType(1) / a0 : SampleType(0);
+
+        loadSection(index, channelMask, design[0] * a0Inv, design[1] * a0Inv, design[2] * a0Inv,
+            design[4] * a0Inv, design[5] * a0Inv);
+    }
+
+    /** Loads an unnormalised design into one channel of a section, leaving
+        the other channels as they are, so each channel can run a design of
+        its own in the same pass. nullptr passes the channel through.
+    */
+    void setChannelSection(int index, int channel, const Design* design) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(index, MaxSections));
+        jassert(juce::isPositiveAndBelow(channel, MaxChannels));
+
+        if (design == nullptr)
+        {
+            storeChannel((size_t)index, (size_t)channel, SampleType(1), SampleType(0), SampleType(0), SampleType(0), SampleType(0));
+        }
+        else
+        {
+            const auto& d = *design;
+            const auto a0Inv = d[3] != SampleType(0) ? SampleType(1) / d[3] : SampleType(0);
+
+            storeChannel((size_t)index, (size_t)channel, d[0] * a0Inv, d[1] * a0Inv, d[2] * a0Inv, d[4] * a0Inv, d[5] * a0Inv);
+        }
+
+        updatePromotion(index);
+    }
+
+    void setSectionEnabled(int index, bool shouldBeEnabled) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(index, MaxSections));
+
+        if (enabled[(size_t)index] != shouldBeEnabled)
+        {
+            enabled[(size_t)index] = shouldBeEnabled;
+            updateActiveSections();
+        }
+    }
+
+    bool isSectionEnabled(int index) const noexcept { return enabled[(size_t)index]; }
+
+    int getNumActiveSections() const noexcept { return numActiveSections; }
+
+    /** Copies the coefficients, enabled sections and M/S setting of another
+        cascade, keeping this one's filter state and precision. The other one
+        can have another sample type, so a double cascade can run what was
+        designed for a float one.
+    */
+    template <typename OtherSampleType>
+    void copyCoefficientsFrom(const FilterCascade<OtherSampleType, MaxSections, MaxChannels>& other) noexcept
+    {
+        for (size_t s = 0; s < (size_t)MaxSections; ++s)
+        {
+            for (size_t ch = 0; ch < (size_t)MaxChannels; ++ch)
+            {
+                b0[s][ch] = (SampleType)other.b0[s][ch];
+                b1[s][ch] = (SampleType)other.b1[s][ch];
+                b2[s][ch] = (SampleType)other.b2[s][ch];
+                a1[s][ch] = (SampleType)other.a1[s][ch];
+                a2[s][ch] = (SampleType)other.a2[s][ch];
+            }
+        }
+
+        enabled = other.enabled;
+        activeSections = other.activeSections;
+        numActiveSections = other.numActiveSections;
+
+        encodeMidSide = other.encodeMidSide;
+        decodeMidSide = other.decodeMidSide;
+
+        for (int i = 0; i < MaxSections; ++i)
+            updatePromotion(i);
+    }
+
+    /** Makes a stereo cascade convert L/R to M/S before its first section
+        and/or back to L/R after its last one. The conversion is folded into
+        the filter loops, so it costs no extra pass over the buffer. It is
+        ignored for anything but two channels, and when nothing is active.
+    */
+    void setMidSide(bool shouldEncodeInput, bool shouldDecodeOutput) noexcept
+    {
+        encodeMidSide = shouldEncodeInput;
+        decodeMidSide = shouldDecodeOutput;
+    }
+
+    //==============================================================================
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        static_assert(std::is_same_v<typename ProcessContext::SampleType, SampleType>,
+            "The sample-type of the FilterCascade must match the sample-type supplied to this process callback");
+
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+
+        const auto numChannels = outputBlock.getNumChannels();
+        const auto numSamples = outputBlock.getNumSamples();
+
+        jassert(inputBlock.getNumChannels() == numChannels);
+        jassert(inputBlock.getNumSamples() == numSamples);
+        jassert(numChannels <= (size_t)MaxChannels);
+
+        if (context.isBypassed || numActiveSections == 0)
+        {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom(inputBlock);
+
+            return;
+        }
+
+        if constexpr (MaxChannels >= 2)
+        {
+            if (numChannels == 2)
+            {
+                processStereo(inputBlock, outputBlock, numSamples);
+                return;
+            }
+        }
+
+        for (size_t ch = 0; ch < juce::jmin(numChannels, (size_t)MaxChannels); ++ch)
+        {
+            const SampleType* src = inputBlock.getChannelPointer(ch);
+            auto* dst = outputBlock.getChannelPointer(ch);
+
+            for (int i = 0; i < numActiveSections; ++i)
+            {
+                processSection(activeSections[(size_t)i], ch, src, dst, numSamples);
+                src = dst;
+            }
+        }
+    }
+
+    //==============================================================================
+    /** Returns the magnitude of the active sections of one channel. */
+    double getMagnitudeForFrequency(double frequency, double sampleRate, size_t channel = 0) const noexcept
+    {
+        jassert(sampleRate > 0);
+        jassert(frequency >= 0 && frequency <= sampleRate * 0.5);
+        jassert(channel < (size_t)MaxChannels);
+
+        const auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const std::complex<double> e1 = std::polar(1.0, -w);
+        const std::complex<double> e2 = e1 * e1;
+
+        double magnitude = 1.0;
+
+        for (int i = 0; i < numActiveSections; ++i)
+        {
+            auto s = (size_t)activeSections[(size_t)i];
+
+            auto numerator = (double)b0[s][channel] + (double)b1[s][channel] * e1 + (double)b2[s][channel] * e2;
+            auto denominator = 1.0 + (double)a1[s][channel] * e1 + (double)a2[s][channel] * e2;
+
+            magnitude *= std::abs(numerator / denominator);
+        }
+
+        return magnitude;
+    }
+
+    /** Multiplies magnitudes[i] by the magnitude of the active sections of one
+        channel at every point of a frequency grid. Much cheaper than calling
+        getMagnitudeForFrequency() for each point when drawing a whole curve.
+    */
+    void accumulateMagnitudes(const DspKernels::FrequencyGrid& grid, double* magnitudes, size_t channel = 0) const noexcept
+    {
+        jassert(channel < (size_t)MaxChannels);
+
+        const auto& kernels = DspKernels::get();
+
+        for (int i = 0; i < numActiveSections; ++i)
+        {
+            auto s = (size_t)activeSections[(size_t)i];
+
+            const double coefficients[]{ (double)b0[s][channel], (double)b1[s][channel], (double)b2[s][channel],
+                                         (double)a1[s][channel], (double)a2[s][channel] };
+
+            kernels.accumulateMagnitudes(grid, coefficients, magnitudes);
+        }
+    }
+
+private:
+    template <typename, int, int>
+    friend class FilterCascade;
+
+    //==============================================================================
+    void loadSection(int index, juce::uint32 channelMask,
+        SampleType nb0, SampleType nb1, SampleType nb2, SampleType na1, SampleType na2) noexcept
+    {
+        for (size_t ch = 0; ch < (size_t)MaxChannels; ++ch)
+        {
+            // Channels that aren't in the mask get b0 = 1 and everything else 0.
+            if ((channelMask & (1u << ch)) != 0)
+                storeChannel((size_t)index, ch, nb0, nb1, nb2, na1, na2);
+            else
+                storeChannel((size_t)index, ch, SampleType(1), SampleType(0), SampleType(0), SampleType(0), SampleType(0));
+        }
+
+        updatePromotion(index);
+    }
+
+    void storeChannel(size_t s, size_t ch,
+        SampleType nb0, SampleType nb1, SampleType nb2, SampleType na1, SampleType na2) noexcept
+    {
+        b0[s][ch] = nb0;
+        b1[s][ch] = nb1;
+        b2[s][ch] = nb2;
+        a1[s][ch] = na1;
+        a2[s][ch] = na2;
+    }
+
+    bool shouldPromote(int index) const noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            if (precision != FilterPrecision::Mixed)
+                return precision == FilterPrecision::Double;
+
+            auto s = (size_t)index;
+
+            for (size_t ch = 0; ch < (size_t)MaxChannels; ++ch)
+                if (getPoleRadius((double)a1[s][ch], (double)a2[s][ch]) > 1.0 - promotionDistance)
+                    return true;
+
+            return false;
+        }
+        else
+        {
+            juce::ignoreUnused(index);
+            return false;
+        }
+    }
+
+    // Moves a section's state over when it changes precision.
+    void updatePromotion(int index) noexcept
+    {
+        auto s = (size_t)index;
+        auto promote = shouldPromote(index);
+
+        if (promote == promoted[s])
+            return;
+
+        for (size_t ch = 0; ch < (size_t)MaxChannels; ++ch)
+        {
+            if (promote)
+            {
+                wideZ1[s][ch] = (double)z1[s][ch];
+                wideZ2[s][ch] = (double)z2[s][ch];
+            }
+            else
+            {
+                z1[s][ch] = (SampleType)wideZ1[s][ch];
+                z2[s][ch] = (SampleType)wideZ2[s][ch];
+            }
+        }
+
+        promoted[s] = promote;
+    }
+
+    template <typename StateType>
+    auto& getState1() noexcept
+    {
+        if constexpr (std::is_same_v<StateType, SampleType>)
+            return z1;
+        else
+            return wideZ1;
+    }
+
+    template <typename StateType>
+    auto& getState2() noexcept
+    {
+        if constexpr (std::is_same_v<StateType, SampleType>)
+            return z2;
+        else
+            return wideZ2;
+    }
+
+    void updateActiveSections() noexcept
+    {
+        numActiveSections = 0;
+
+        for (int i = 0; i < MaxSections; ++i)
+            if (enabled[(size_t)i])
+                activeSections[(size_t)numActiveSections++] = i;
+    }
+
+    void processSection(int section, size_t ch, const SampleType* src, SampleType* dst, size_t numSamples) noexcept
+    {
+        if (promoted[(size_t)section])
+            processSection<double>(section, ch, src, dst, numSamples);
+        else
+            processSection<SampleType>(section, ch, src, dst, numSamples);
+    }
+
+    // Transposed direct form II, the same recursion IIR::Filter uses for
+    // order 2, with the arithmetic and state in StateType.
+    template <typename StateType>
+    void processSection(int section, size_t ch, const SampleType* src, SampleType* dst, size_t numSamples) noexcept
+    {
+        auto s = (size_t)section;
+        auto& state1 = getState1<StateType>();
+        auto& state2 = getState2<StateType>();
+
+        const auto cb0 = (StateType)b0[s][ch], cb1 = (StateType)b1[s][ch], cb2 = (StateType)b2[s][ch];
+        const auto ca1 = (StateType)a1[s][ch], ca2 = (StateType)a2[s][ch];
+        auto lv1 = state1[s][ch], lv2 = state2[s][ch];
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            auto input = (StateType)src[n];
+            auto output = (input * cb0) + lv1;
+            dst[n] = (SampleType)output;
+
+            lv1 = (input * cb1) - (output * ca1) + lv2;
+            lv2 = (input * cb2) - (output * ca2);
+        }
+
+        juce::dsp::util::snapToZero(lv1); state1[s][ch] = lv1;
+        juce::dsp::util::snapToZero(lv2); state2[s][ch] = lv2;
+    }
+
+    template <typename InputBlock, typename OutputBlock>
+    void processStereo(const InputBlock& inputBlock, OutputBlock& outputBlock, size_t numSamples) noexcept
+    {
+        const SampleType* src[2]{ inputBlock.getChannelPointer(0), inputBlock.getChannelPointer(1) };
+        SampleType* dst[2]{ outputBlock.getChannelPointer(0), outputBlock.getChannelPointer(1) };
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            if (auto* kernel = DspKernels::get().processStereoSection)
+            {
+                processStereoWithKernel(kernel, src, dst, numSamples);
+                return;
+            }
+        }
+
+        for (int i = 0; i < numActiveSections; ++i)
+        {
+            auto section = activeSections[(size_t)i];
+            auto encode = encodeMidSide && i == 0;
+            auto decode = decodeMidSide && i == numActiveSections - 1;
+
+            if (promoted[(size_t)section])
+                processStereoSection<double>(section, src, dst, numSamples, encode, decode);
+            else
+                processStereoSection<SampleType>(section, src, dst, numSamples, encode, decode);
+
+            src[0] = dst[0];
+            src[1] = dst[1];
+        }
+    }
+
+    template <typename StateType>
+    void processStereoSection(int section, const SampleType* const* src, SampleType* const* dst, size_t numSamples,
+        bool encode, bool decode) noexcept
+    {
+        if (encode && decode)  processStereoSection<StateType, true, true>(section, src, dst, numSamples);
+        else if (encode)       processStereoSection<StateType, true, false>(section, src, dst, numSamples);
+        else if (decode)       processStereoSection<StateType, false, true>(section, src, dst, numSamples);
+        else                   processStereoSection<StateType, false, false>(section, src, dst, numSamples);
+    }
+
+    // The same walk through the sections, with each one run by a kernel built
+    // for the CPU's instruction set.
+    template <typename Kernel>
+    void processStereoWithKernel(Kernel kernel, const float* const* source, float* const* dst, size_t numSamples) noexcept
+    {
+        const float* src[2]{ source[0], source[1] };
+        DspKernels::StereoSection section;
+
+        for (int i = 0; i < numActiveSections; ++i)
+        {
+            auto s = (size_t)activeSections[(size_t)i];
+            auto encode = encodeMidSide && i == 0;
+            auto decode = decodeMidSide && i == numActiveSections - 1;
+
+            // The kernels are float only.
+            if (promoted[s])
+            {
+                processStereoSection<double>((int)s, src, dst, numSamples, encode, decode);
+
+                src[0] = dst[0];
+                src[1] = dst[1];
+                continue;
+            }
+
+            for (size_t lane = 0; lane < 2; ++lane)
+            {
+                section.b0[lane] = b0[s][lane]; section.b1[lane] = b1[s][lane]; section.b2[lane] = b2[s][lane];
+                section.a1[lane] = a1[s][lane]; section.a2[lane] = a2[s][lane];
+                section.z1[lane] = z1[s][lane]; section.z2[lane] = z2[s][lane];
+            }
+
+            kernel(section, src, dst, numSamples, encode, decode);
+
+            for (size_t lane = 0; lane < 2; ++lane)
+            {
+                z1[s][lane] = section.z1[lane];
+                z2[s][lane] = section.z2[lane];
+            }
+
+            src[0] = dst[0];
+            src[1] = dst[1];
+        }
+    }
+
+    // The same recursion as processSection(), with both channels as two lanes
+    // of one loop. Each lane has its own coefficients, so linked, L/R and M/S
+    // settings all cost the same.
+    template <typename StateType, bool EncodeInput, bool DecodeOutput>
+    void processStereoSection(int section, const SampleType* const* src, SampleType* const* dst, size_t numSamples) noexcept
+    {
+        auto s = (size_t)section;
+        auto& state1 = getState1<StateType>();
+        auto& state2 = getState2<StateType>();
+
+        const StateType cb0[2]{ (StateType)b0[s][0], (StateType)b0[s][1] };
+        const StateType cb1[2]{ (StateType)b1[s][0], (StateType)b1[s][1] };
+        const StateType cb2[2]{ (StateType)b2[s][0], (StateType)b2[s][1] };
+        const StateType ca1[2]{ (StateType)a1[s][0], (StateType)a1[s][1] };
+        const StateType ca2[2]{ (StateType)a2[s][0], (StateType)a2[s][1] };
+        StateType lv1[2]{ state1[s][0], state1[s][1] }, lv2[2]{ state2[s][0], state2[s][1] };
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            StateType input[2]{ (StateType)src[0][n], (StateType)src[1][n] };
+
+            if constexpr (EncodeInput)
+            {
+                auto left = input[0], right = input[1];
+                input[0] = (left + right) * StateType(0.5);
+                input[1] = (left - right) * StateType(0.5);
+            }
+
+            StateType output[2];
+
+            for (size_t lane = 0; lane < 2; ++lane)
+            {
+                output[lane] = (input[lane] * cb0[lane]) + lv1[lane];
+                lv1[lane] = (input[lane] * cb1[lane]) - (output[lane] * ca1[lane]) + lv2[lane];
+                lv2[lane] = (input[lane] * cb2[lane]) - (output[lane] * ca2[lane]);
+            }
+
+            if constexpr (DecodeOutput)
+            {
+                dst[0][n] = (SampleType)(output[0] + output[1]);
+                dst[1][n] = (SampleType)(output[0] - output[1]);
+            }
+            else
+            {
+                dst[0][n] = (SampleType)output[0];
+                dst[1][n] = (SampleType)output[1];
+            }
+        }
+
+        for (size_t lane = 0; lane < 2; ++lane)
+        {
+            juce::dsp::util::snapToZero(lv1[lane]); state1[s][lane] = lv1[lane];
+            juce::dsp::util::snapToZero(lv2[lane]); state2[s][lane] = lv2[lane];
+        }
+    }
+
+    //==============================================================================
+    using SectionArray = std::array<std::array<SampleType, MaxChannels>, MaxSections>;
+
+    SectionArray b0{}, b1{}, b2{}, a1{}, a2{};
+    SectionArray z1{}, z2{};
+
+    // The state of promoted sections.
+    using WideSectionArray = std::array<std::array<double, MaxChannels>, MaxSections>;
+    WideSectionArray wideZ1{}, wideZ2{};
+
+    FilterPrecision precision{ FilterPrecision::Float };
+    std::array<bool, MaxSections> promoted{};
+
+    std::array<bool, MaxSections> enabled{};
+    std::array<int, MaxSections> activeSections{};
+    int numActiveSections{ 0 };
+
+    bool encodeMidSide{ false }, decodeMidSide{ false };
+};
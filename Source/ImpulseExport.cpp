@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    ImpulseExport.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "ImpulseExport.h"
+
+namespace ImpulseExport
+{
+    namespace
+    {
+        // The linear phase design samples the magnitude this many times more
+        // finely than the impulse is long, so what wraps round is negligible.
+        constexpr int oversampling = 4;
+
+        constexpr float kaiserBeta = 8.f;
+
+        /** A chain designed at the sample rate, with each channel's filters
+            left in the channel they work on instead of converting to and
+            from M/S around them.
+        */
+        void designChain(EqChain& chain, const ChainSettings& settings, double sampleRate, int maximumBlockSize)
+        {
+            chain.prepare({ sampleRate, (juce::uint32)maximumBlockSize, 2 });
+
+            updateEqChain(chain, settings, sampleRate);
+            updateChannelMode(chain, ChannelMode::LeftRight);
+        }
+
+        /** Drops the second channel when it's the same as the first. */
+        void makeMonoIfSame(juce::AudioBuffer<float>& impulse)
+        {
+            const auto numSamples = (size_t)impulse.getNumSamples();
+
+            if (std::equal(impulse.getReadPointer(0), impulse.getReadPointer(0) + numSamples, impulse.getReadPointer(1)))
+                impulse.setSize(1, impulse.getNumSamples(), true);
+        }
+
+        juce::File withSuffix(const juce::File& file, const juce::String& suffix)
+        {
+            return file.getSiblingFile(file.getFileNameWithoutExtension() + suffix + file.getFileExtension());
+        }
+    }
+
+    juce::AudioBuffer<float> renderMinimumPhase(const ChainSettings& settings, int length, double sampleRate)
+    {
+        length = juce::jlimit(minLength, maxLength, length);
+
+        EqChain chain;
+        designChain(chain, settings, sampleRate, length);
+
+        juce::AudioBuffer<float> impulse(2, length);
+        impulse.clear();
+        impulse.setSample(0, 0, 1.f);
+        impulse.setSample(1, 0, 1.f);
+
+        juce::dsp::AudioBlock<float> block(impulse);
+        chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+        // Half a cosine over the last eighth.
+        const auto fadeLength = length / 8;
+
+        for (int n = 0; n < fadeLength; ++n)
+        {
+            const auto gain = 0.5f + 0.5f * std::cos(juce::MathConstants<float>::pi * (float)(n + 1) / (float)fadeLength);
+
+            for (int ch = 0; ch < impulse.getNumChannels(); ++ch)
+                impulse.setSample(ch, length - fadeLength + n, impulse.getSample(ch, length - fadeLength + n) * gain);
+        }
+
+        makeMonoIfSame(impulse);
+        return impulse;
+    }
+
+    juce::AudioBuffer<float> renderLinearPhase(const ChainSettings& settings, int length, double sampleRate)
+    {
+        length = juce::jlimit(minLength, maxLength, length);
+
+        EqChain chain;
+        designChain(chain, settings, sampleRate, length);
+
+        auto fftOrder = 1;
+
+        while ((1 << fftOrder) < length * oversampling)
+            ++fftOrder;
+
+        const auto fftSize = 1 << fftOrder;
+        const auto numBins = fftSize / 2 + 1;
+
+        std::vector<double> frequencies((size_t)numBins);
+
+        for (int k = 0; k < numBins; ++k)
+            frequencies[(size_t)k] = k * sampleRate / fftSize;
+
+        const DspKernels::FrequencyGrid grid(frequencies, sampleRate);
+
+        juce::dsp::FFT fft(fftOrder);
+        std::vector<std::complex<float>> spectrum((size_t)fftSize), output((size_t)fftSize);
+        std::vector<double> magnitudes((size_t)numBins);
+
+        std::vector<float> window((size_t)length);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t)length,
+            juce::dsp::WindowingFunction<float>::kaiser, false, kaiserBeta);
+
+        // Centred in the impulse, so it's symmetric whether the length is odd or even.
+        const auto delay = (length - 1) * 0.5;
+
+        juce::AudioBuffer<float> impulse(2, length);
+
+        for (int ch = 0; ch < impulse.getNumChannels(); ++ch)
+        {
+            std::fill(magnitudes.begin(), magnitudes.end(), 1.0);
+            accumulateMagnitudes(chain, grid, magnitudes.data(), (size_t)ch);
+
+            for (int k = 0; k < numBins; ++k)
+            {
+                const auto phase = -juce::MathConstants<double>::twoPi * k * delay / fftSize;
+                spectrum[(size_t)k] = std::polar((float)magnitudes[(size_t)k], (float)phase);
+            }
+
+            for (int k = numBins; k < fftSize; ++k)
+                spectrum[(size_t)k] = std::conj(spectrum[(size_t)(fftSize - k)]);
+
+            // The inverse transform is scaled by 1 / fftSize already.
+            fft.perform(spectrum.data(), output.data(), true);
+
+            auto* samples = impulse.getWritePointer(ch);
+
+            for (int n = 0; n < length; ++n)
+                samples[n] = output[(size_t)n].real() * window[(size_t)n];
+        }
+
+        makeMonoIfSame(impulse);
+        return impulse;
+    }
+
+    bool writeImpulse(const juce::AudioBuffer<float>& impulse, double sampleRate, const juce::File& file, Format format)
+    {
+        file.deleteFile();
+
+        auto stream = file.createOutputStream();
+
+        if (stream == nullptr)
+            return false;
+
+        if (format == Format::RawFloat)
+        {
+            for (int n = 0; n < impulse.getNumSamples(); ++n)
+                for (int ch = 0; ch < impulse.getNumChannels(); ++ch)
+                    if (!stream->writeFloat(impulse.getSample(ch, n)))
+                        return false;
+
+            stream->flush();
+            return stream->getStatus().wasOk();
+        }
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+            (unsigned int)impulse.getNumChannels(), 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        // The writer owns the stream now.
+        stream.release();
+
+        return writer->writeFromAudioSampleBuffer(impulse, 0, impulse.getNumSamples());
+    }
+
+    const char* getFileExtension(Format format) noexcept
+    {
+        return format == Format::RawFloat ? ".raw" : ".wav";
+    }
+
+    Result exportImpulses(const ChainSettings& settings, const Options& options, const juce::File& file)
+    {
+        Result result;
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        const auto both = options.phase == Phase::Both;
+
+        auto write = [&](const juce::AudioBuffer<float>& impulse, const juce::File& destination)
+            {
+                if (writeImpulse(impulse, options.sampleRate, destination, options.format))
+                    result.files.add(destination);
+                else
+                    result.error = "Can't write " + destination.getFullPathName();
+            };
+
+        if (options.phase != Phase::Linear)
+            write(renderMinimumPhase(settings, options.length, options.sampleRate),
+                both ? withSuffix(file, "-minimum") : file);
+
+        if (options.phase != Phase::Minimum && result.wasOk())
+            write(renderLinearPhase(settings, options.length, options.sampleRate),
+                both ? withSuffix(file, "-linear") : file);
+
+        result.seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        return result;
+    }
+}
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    ImpulseExport.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+/**
+    The EQ curve as FIR filters, for systems that only take convolution: a
+    minimum phase impulse, a linear phase one, or both.
+
+    The minimum phase impulse is the filter chain itself run on an impulse,
+    the same cascades and coefficients the processor uses. Every peak and cut
+    the plug-in designs is minimum phase already, so it's exact up to its
+    length, and only the last eighth fades out to soften the truncation.
+
+    The linear phase impulse has the chain's magnitude response and nothing
+    else but a delay of half its length. The magnitude is sampled on an FFT
+    grid four times the impulse's length, turned into a symmetric impulse by
+    an inverse FFT, and cut to length with a Kaiser window.
+
+    Both are designed at the sample rate asked for, whatever the processor
+    runs at. Dynamic bands and modulation are taken at their static settings,
+    and auto-gain is left out. Each channel's filters make a channel of the
+    impulse, left and right or, in M/S mode, mid and side, and when both
+    channels run the same filters the impulse is mono.
+*/
+namespace ImpulseExport
+{
+    enum class Phase
+    {
+        Minimum,
+        Linear,
+        Both
+    };
+
+    enum class Format
+    {
+        Wav,
+        RawFloat
+    };
+
+    constexpr int minLength = 64, maxLength = 1 << 18;
+
+    struct Options
+    {
+        int length{ 8192 };
+        double sampleRate{ 48000.0 };
+        Phase phase{ Phase::Minimum };
+        Format format{ Format::Wav };
+    };
+
+    juce::AudioBuffer<float> renderMinimumPhase(const ChainSettings& settings, int length, double sampleRate);
+
+    juce::AudioBuffer<float> renderLinearPhase(const ChainSettings& settings, int length, double sampleRate);
+
+    /** Writes a 32 bit float WAV file, or raw little-endian 32 bit floats with the channels interleaved. */
+    bool writeImpulse(const juce::AudioBuffer<float>& impulse, double sampleRate, const juce::File& file, Format format);
+
+    /** ".wav" or ".raw". */
+    const char* getFileExtension(Format format) noexcept;
+
+    struct Result
+    {
+        juce::Array<juce::File> files;
+        juce::String error;
+        double seconds{ 0 };
+
+        bool wasOk() const noexcept { return error.isEmpty(); }
+    };
+
+    /** Renders what the options ask for and writes it to file. With both
+        phases there are two files, named with "-minimum" and "-linear" on the
+        end. Any thread.
+    */
+    Result exportImpulses(const ChainSettings& settings, const Options& options, const juce::File& file);
+}
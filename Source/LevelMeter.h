@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    LevelMeter.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+/**
+    Peak and RMS of each channel plus the correlation between the two,
+    measured block by block on the audio thread.
+
+    Each block goes through one DspKernels::measureLevels() pass, which gets
+    the peaks and the sums of squares and products in a single vectorised
+    read of the samples. The peak holds the loudest sample and falls at
+    peakFallDecibelsPerSecond; RMS and correlation are averaged over about
+    rmsSeconds.
+
+    The readings are published as one snapshot behind a sequence counter
+    (a seqlock), so a reader on another thread always gets all of them from
+    the same block without the audio thread ever waiting.
+*/
+class LevelMeter
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    /** What the meter reports for digital silence, in dBFS. */
+    static constexpr float silence = -100.f;
+
+    struct Levels
+    {
+        // dBFS
+        std::array<float, maxChannels> peak{ silence, silence }, rms{ silence, silence };
+
+        // From -1 (out of phase) to +1 (mono); 0 while there's nothing to compare.
+        float correlation{ 0 };
+
+        bool operator==(const Levels& other) const noexcept
+        {
+            return peak == other.peak && rms == other.rms && correlation == other.correlation;
+        }
+
+        bool operator!=(const Levels& other) const noexcept { return !operator==(other); }
+    };
+
+    //==============================================================================
+    void prepare(double newSampleRate, int newNumChannels) noexcept
+    {
+        jassert(newSampleRate > 0);
+
+        sampleRate = newSampleRate;
+        numChannels = juce::jlimit(1, maxChannels, newNumChannels);
+        peakFallPerSample = std::pow(10.0, -peakFallDecibelsPerSecond / (20.0 * sampleRate));
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        peakGains.fill(0.0);
+        meanSquares.fill(0.0);
+        meanProduct = 0.0;
+
+        current = {};
+        publish();
+    }
+
+    void process(const juce::dsp::AudioBlock<const float>& block) noexcept
+    {
+        const auto numSamples = block.getNumSamples();
+        const auto channels = juce::jmin(block.getNumChannels(), (size_t)numChannels);
+
+        if (numSamples == 0 || channels == 0)
+            return;
+
+        // A mono signal is measured as a pair of identical channels.
+        auto* left = block.getChannelPointer(0);
+        auto* right = block.getChannelPointer(channels - 1);
+
+        DspKernels::LevelSums sums;
+        DspKernels::get().measureLevels(left, right, numSamples, sums);
+
+        const auto fall = std::pow(peakFallPerSample, (double)numSamples);
+        const auto smoothing = 1.0 - std::exp(-(double)numSamples / (rmsSeconds * sampleRate));
+
+        for (size_t ch = 0; ch < (size_t)maxChannels; ++ch)
+        {
+            peakGains[ch] = juce::jmax((double)sums.peak[ch], peakGains[ch] * fall);
+            meanSquares[ch] += (sums.squares[ch] / numSamples - meanSquares[ch]) * smoothing;
+        }
+
+        meanProduct += (sums.product / numSamples - meanProduct) * smoothing;
+
+        for (size_t ch = 0; ch < (size_t)maxChannels; ++ch)
+        {
+            current.peak[ch] = toDecibels(peakGains[ch]);
+            current.rms[ch] = toDecibels(std::sqrt(meanSquares[ch]));
+        }
+
+        const auto power = std::sqrt(meanSquares[0] * meanSquares[1]);
+        current.correlation = power > 1.0e-10 ? (float)juce::jlimit(-1.0, 1.0, meanProduct / power) : 0.f;
+
+        publish();
+    }
+
+    /** The latest readings. Audio thread only. */
+    const Levels& getCurrentLevels() const noexcept { return current; }
+
+    /** The latest readings, all from the same block, for any thread. */
+    Levels getLevels() const noexcept
+    {
+        for (;;)
+        {
+            const auto before = sequence.load(std::memory_order_acquire);
+
+            // Odd while the audio thread is halfway through a snapshot.
+            if ((before & 1) != 0)
+                continue;
+
+            Levels levels;
+
+            for (size_t ch = 0; ch < (size_t)maxChannels; ++ch)
+            {
+                levels.peak[ch] = published[ch].load(std::memory_order_relaxed);
+                levels.rms[ch] = published[maxChannels + ch].load(std::memory_order_relaxed);
+            }
+
+            levels.correlation = published[2 * maxChannels].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return levels;
+        }
+    }
+
+private:
+    static constexpr double peakFallDecibelsPerSecond = 20.0, rmsSeconds = 0.3;
+
+    static float toDecibels(double gain) noexcept
+    {
+        return juce::Decibels::gainToDecibels((float)gain, silence);
+    }
+
+    void publish() noexcept
+    {
+        const auto start = sequence.load(std::memory_order_relaxed);
+
+        sequence.store(start + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t ch = 0; ch < (size_t)maxChannels; ++ch)
+        {
+            published[ch].store(current.peak[ch], std::memory_order_relaxed);
+            published[maxChannels + ch].store(current.rms[ch], std::memory_order_relaxed);
+        }
+
+        published[2 * maxChannels].store(current.correlation, std::memory_order_relaxed);
+
+        sequence.store(start + 2, std::memory_order_release);
+    }
+
+    double sampleRate{ 44100.0 };
+    int numChannels{ maxChannels };
+    double peakFallPerSample{ 1.0 };
+
+    std::array<double, maxChannels> peakGains{}, meanSquares{};
+    double meanProduct{ 0 };
+
+    Levels current;
+
+    // Peaks, then RMS values, then the correlation.
+    std::array<std::atomic<float>, 2 * maxChannels + 1> published{};
+    std::atomic<juce::uint32> sequence{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(LevelMeter)
+};
@@ -0,0 +1,405 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterCascade.h"
+
+/**
+    An ITU-R BS.1770 loudness meter that runs on the audio thread, block by
+    block, without allocating.
+
+    The input is K-weighted by a two section FilterCascade, so stereo signals
+    go through the same vectorised biquad kernel as the EQ. The weighted
+    energy is summed into 100 ms steps, and the last 30 steps sit in a ring:
+    the momentary loudness is the mean of the last 4 (400 ms), the short-term
+    loudness the mean of all 30 (3 s), or of as many as there are so far.
+
+    Every step also closes a 400 ms gating block. Integrated loudness gates
+    those at -70 LUFS and then 10 LU below their own mean. Instead of keeping
+    every block, the blocks are counted into 0.1 LU wide bins together with
+    their energy, so the integrated value is exact up to where the relative
+    gate falls inside a bin, however long the meter runs.
+
+    True peak is the largest absolute value of the signal upsampled to at
+    least 192 kHz by a 12 tap per phase polyphase interpolator, as BS.1770
+    Annex 2 suggests, since the last reset.
+
+    The audio thread reads the values it needs straight from the meter; every
+    other thread reads getReadings().
+*/
+class LoudnessMeter
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    /** What the meter reports while it has nothing to measure. */
+    static constexpr float silence = -100.f;
+
+    /** Gating blocks below this don't count towards the integrated loudness. */
+    static constexpr float absoluteGate = -70.f;
+
+    struct Readings
+    {
+        float momentary{ silence }, shortTerm{ silence }, integrated{ silence }; // LUFS
+        float truePeak{ silence }; // dBTP
+
+        bool operator==(const Readings& other) const noexcept
+        {
+            return momentary == other.momentary && shortTerm == other.shortTerm
+                && integrated == other.integrated && truePeak == other.truePeak;
+        }
+
+        bool operator!=(const Readings& other) const noexcept { return !operator==(other); }
+    };
+
+    /** The K-weighting filter as two unnormalised designs: the high shelf
+        modelling the head, then the RLB high-pass. BS.1770 only lists
+        coefficients for 48 kHz, so these come from the analog prototypes
+        those were derived from, which match them exactly at 48 kHz.
+    */
+    static std::array<FilterCascade<float, 2>::Design, 2> makeKWeighting(double sampleRate) noexcept
+    {
+        using Design = FilterCascade<float, 2>::Design;
+        const auto pi = juce::MathConstants<double>::pi;
+
+        auto shelfK = std::tan(pi * 1681.974450955533 / sampleRate);
+        auto shelfQ = 0.7071752369554196;
+        auto vh = std::pow(10.0, 3.999843853973347 / 20.0);
+        auto vb = std::pow(vh, 0.4996667741545416);
+
+        auto highPassK = std::tan(pi * 38.13547087602444 / sampleRate);
+        auto highPassQ = 0.5003270373238773;
+
+        return
+        {
+            Design{ (float)(vh + vb * shelfK / shelfQ + shelfK * shelfK),
+                    (float)(2.0 * (shelfK * shelfK - vh)),
+                    (float)(vh - vb * shelfK / shelfQ + shelfK * shelfK),
+                    (float)(1.0 + shelfK / shelfQ + shelfK * shelfK),
+                    (float)(2.0 * (shelfK * shelfK - 1.0)),
+                    (float)(1.0 - shelfK / shelfQ + shelfK * shelfK) },
+
+            // b = { 1, -2, 1 } with a normalised denominator, as BS.1770 gives it.
+            Design{ 1.f, -2.f, 1.f, 1.f,
+                    (float)(2.0 * (highPassK * highPassK - 1.0) / (1.0 + highPassK / highPassQ + highPassK * highPassK)),
+                    (float)((1.0 - highPassK / highPassQ + highPassK * highPassK) / (1.0 + highPassK / highPassQ + highPassK * highPassK)) }
+        };
+    }
+
+    //==============================================================================
+    void prepare(double newSampleRate, int maximumBlockSize, int newNumChannels)
+    {
+        jassert(newSampleRate > 0);
+
+        sampleRate = newSampleRate;
+        numChannels = juce::jlimit(1, maxChannels, newNumChannels);
+
+        auto designs = makeKWeighting(sampleRate);
+
+        for (int i = 0; i < (int)designs.size(); ++i)
+            kWeighting.setSection(i, designs[(size_t)i]);
+
+        kWeighting.setNumSections((int)designs.size());
+        kWeighting.prepare({ sampleRate, (juce::uint32)maximumBlockSize, (juce::uint32)numChannels });
+
+        weighted.setSize(numChannels, juce::jmax(1, maximumBlockSize));
+        stepLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+
+        prepareTruePeak();
+        reset();
+    }
+
+    /** Starts measuring from scratch. Audio thread only; other threads call
+        requestReset().
+    */
+    void reset() noexcept
+    {
+        kWeighting.reset();
+
+        stepEnergy = 0.0;
+        samplesInStep = 0;
+        steps.fill(0.0);
+        nextStep = numSteps = 0;
+
+        gatedCounts.fill(0);
+        gatedEnergies.fill(0.0);
+
+        for (auto& channel : history)
+            channel.fill(0.f);
+
+        historyPosition = 0;
+        truePeakGain = 0.f;
+
+        current = {};
+        publish();
+    }
+
+    /** Asks the audio thread to reset the meter before its next block. */
+    void requestReset() noexcept { resetRequested.store(true); }
+
+    /** Measures a block. Blocks longer than the one prepare() was told about
+        are measured in pieces.
+    */
+    void process(const juce::dsp::AudioBlock<const float>& block) noexcept
+    {
+        if (resetRequested.exchange(false))
+            reset();
+
+        const auto channels = juce::jmin(block.getNumChannels(), (size_t)numChannels);
+        const auto chunkLength = (size_t)weighted.getNumSamples();
+
+        if (channels == 0)
+            return;
+
+        for (size_t start = 0; start < block.getNumSamples(); start += chunkLength)
+        {
+            auto length = juce::jmin(chunkLength, block.getNumSamples() - start);
+            auto input = block.getSubsetChannelBlock(0, channels).getSubBlock(start, length);
+            auto output = juce::dsp::AudioBlock<float>(weighted).getSubsetChannelBlock(0, channels).getSubBlock(0, length);
+
+            kWeighting.process(juce::dsp::ProcessContextNonReplacing<float>(input, output));
+
+            measureTruePeak(input);
+            accumulate(output);
+        }
+    }
+
+    /** The latest readings. Audio thread only. */
+    const Readings& getCurrentReadings() const noexcept { return current; }
+
+    /** The latest readings, for any thread. */
+    Readings getReadings() const noexcept
+    {
+        return { momentary.load(std::memory_order_relaxed),
+                 shortTerm.load(std::memory_order_relaxed),
+                 integrated.load(std::memory_order_relaxed),
+                 truePeak.load(std::memory_order_relaxed) };
+    }
+
+    static float energyToLoudness(double energy) noexcept
+    {
+        return energy > 0.0 ? juce::jmax(silence, (float)(-0.691 + 10.0 * std::log10(energy))) : silence;
+    }
+
+private:
+    static constexpr int stepsPerMomentary = 4, stepsPerShortTerm = 30;
+    static constexpr float relativeGate = -10.f;
+
+    // 0.1 LU bins from the absolute gate up to +10 LUFS. Louder blocks share the top bin.
+    static constexpr float binsPerLU = 10.f;
+    static constexpr int numBins = 800;
+
+    static constexpr int tapsPerPhase = 12, maxOversampling = 4;
+
+    void accumulate(const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        const auto numSamples = block.getNumSamples();
+
+        for (size_t start = 0; start < numSamples;)
+        {
+            auto length = juce::jmin(numSamples - start, (size_t)(stepLength - samplesInStep));
+
+            for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+            {
+                auto* samples = block.getChannelPointer(ch) + start;
+                float sum = 0.f;
+
+                for (size_t i = 0; i < length; ++i)
+                    sum += samples[i] * samples[i];
+
+                // Both channels of a stereo pair have a weight of 1.
+                stepEnergy += sum;
+            }
+
+            samplesInStep += (int)length;
+            start += length;
+
+            if (samplesInStep == stepLength)
+                finishStep();
+        }
+    }
+
+    void finishStep() noexcept
+    {
+        steps[(size_t)nextStep] = stepEnergy / stepLength;
+        nextStep = (nextStep + 1) % stepsPerShortTerm;
+        numSteps = juce::jmin(numSteps + 1, stepsPerShortTerm);
+
+        stepEnergy = 0.0;
+        samplesInStep = 0;
+
+        if (numSteps < stepsPerMomentary)
+            return;
+
+        auto momentaryEnergy = meanOfLastSteps(stepsPerMomentary);
+
+        current.momentary = energyToLoudness(momentaryEnergy);
+        current.shortTerm = energyToLoudness(meanOfLastSteps(numSteps));
+
+        if (current.momentary > absoluteGate)
+        {
+            auto bin = juce::jlimit(0, numBins - 1, (int)((current.momentary - absoluteGate) * binsPerLU));
+            ++gatedCounts[(size_t)bin];
+            gatedEnergies[(size_t)bin] += momentaryEnergy;
+        }
+
+        current.integrated = measureIntegrated();
+        current.truePeak = juce::Decibels::gainToDecibels(truePeakGain, silence);
+
+        publish();
+    }
+
+    double meanOfLastSteps(int count) const noexcept
+    {
+        double sum = 0.0;
+
+        for (int i = 1; i <= count; ++i)
+            sum += steps[(size_t)((nextStep - i + stepsPerShortTerm) % stepsPerShortTerm)];
+
+        return sum / count;
+    }
+
+    float measureIntegrated() const noexcept
+    {
+        auto meanAbove = [this](int firstBin)
+            {
+                double energy = 0.0;
+                juce::int64 count = 0;
+
+                for (int bin = firstBin; bin < numBins; ++bin)
+                {
+                    energy += gatedEnergies[(size_t)bin];
+                    count += gatedCounts[(size_t)bin];
+                }
+
+                return count > 0 ? energy / (double)count : 0.0;
+            };
+
+        auto ungated = meanAbove(0);
+
+        if (ungated <= 0.0)
+            return silence;
+
+        auto gate = energyToLoudness(ungated) + relativeGate;
+        auto firstBin = juce::jlimit(0, numBins - 1, juce::roundToInt((gate - absoluteGate) * binsPerLU));
+
+        return energyToLoudness(meanAbove(firstBin));
+    }
+
+    void publish() noexcept
+    {
+        momentary.store(current.momentary, std::memory_order_relaxed);
+        shortTerm.store(current.shortTerm, std::memory_order_relaxed);
+        integrated.store(current.integrated, std::memory_order_relaxed);
+        truePeak.store(current.truePeak, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    void prepareTruePeak() noexcept
+    {
+        oversampling = sampleRate < 96000.0 ? 4 : (sampleRate < 192000.0 ? 2 : 1);
+
+        const auto numTaps = tapsPerPhase * oversampling;
+        const auto centre = (numTaps - 1) * 0.5;
+
+        // A Hann windowed sinc with its cutoff at the original Nyquist
+        // frequency, split into one short filter per output phase. Each
+        // phase is normalised so DC passes at unity gain.
+        for (int phase = 0; phase < oversampling; ++phase)
+        {
+            auto& coefficients = phases[(size_t)phase];
+            double sum = 0.0;
+
+            for (int tap = 0; tap < tapsPerPhase; ++tap)
+            {
+                auto n = tap * oversampling + phase;
+                auto x = (n - centre) / oversampling;
+                auto sinc = x == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                auto window = 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * (n + 0.5) / numTaps);
+
+                // Stored oldest sample first, to line up with the history.
+                coefficients[(size_t)(tapsPerPhase - 1 - tap)] = (float)(sinc * window);
+                sum += sinc * window;
+            }
+
+            for (auto& c : coefficients)
+                c = (float)(c / sum);
+        }
+    }
+
+    void measureTruePeak(const juce::dsp::AudioBlock<const float>& block) noexcept
+    {
+        auto position = historyPosition;
+        auto peak = truePeakGain;
+
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+        {
+            auto& channelHistory = history[ch];
+            auto* samples = block.getChannelPointer(ch);
+            position = historyPosition;
+
+            for (size_t i = 0; i < block.getNumSamples(); ++i)
+            {
+                // Every sample goes in twice, tapsPerPhase apart, so the last
+                // tapsPerPhase samples are always contiguous.
+                channelHistory[(size_t)position] = channelHistory[(size_t)(position + tapsPerPhase)] = samples[i];
+                position = (position + 1) % tapsPerPhase;
+
+                auto* window = channelHistory.data() + position;
+                peak = juce::jmax(peak, std::abs(samples[i]));
+
+                for (int phase = 0; phase < oversampling; ++phase)
+                {
+                    auto& coefficients = phases[(size_t)phase];
+                    float sum = 0.f;
+
+                    for (int tap = 0; tap < tapsPerPhase; ++tap)
+                        sum += coefficients[(size_t)tap] * window[tap];
+
+                    peak = juce::jmax(peak, std::abs(sum));
+                }
+            }
+        }
+
+        historyPosition = position;
+        truePeakGain = peak;
+    }
+
+    //==============================================================================
+    double sampleRate{ 0 };
+    int numChannels{ maxChannels };
+
+    FilterCascade<float, 2> kWeighting;
+    juce::AudioBuffer<float> weighted;
+
+    int stepLength{ 1 }, samplesInStep{ 0 };
+    double stepEnergy{ 0 };
+
+    std::array<double, stepsPerShortTerm> steps{};
+    int nextStep{ 0 }, numSteps{ 0 };
+
+    std::array<juce::int64, numBins> gatedCounts{};
+    std::array<double, numBins> gatedEnergies{};
+
+    int oversampling{ 1 };
+    std::array<std::array<float, tapsPerPhase>, maxOversampling> phases{};
+    std::array<std::array<float, 2 * tapsPerPhase>, maxChannels> history{};
+    int historyPosition{ 0 };
+    float truePeakGain{ 0 };
+
+    Readings current;
+
+    std::atomic<float> momentary{ silence }, shortTerm{ silence }, integrated{ silence }, truePeak{ silence };
+    std::atomic<bool> resetRequested{ false };
+
+    JUCE_DECLARE_NON_COPYABLE(LoudnessMeter)
+};
@@ -0,0 +1,963 @@
+/*
+  ==============================================================================
+
+    MatchEq.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "MatchEq.h"
+
+namespace
+{
+    // A full scale sine peaks at fftSize / 4 through a Hann window.
+    constexpr double powerScale = (4.0 / SpectrumAverage::fftSize) * (4.0 / SpectrumAverage::fftSize);
+
+    // About five seconds at 48 kHz, so a song makes a few dozen chunks to share out.
+    constexpr int framesPerChunk = 64;
+
+    constexpr float minimumDecibels = -200.f;
+}
+
+SpectrumAverage::FrameAnalyser::FrameAnalyser() :
+    fftData((size_t)fftSize * 2, 0.f)
+{
+}
+
+void SpectrumAverage::FrameAnalyser::addFrame(SpectrumAverage& average, const float* samples)
+{
+    jassert(!average.power.empty());
+
+    std::copy_n(samples, fftSize, fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    for (size_t k = 0; k < average.power.size(); ++k)
+        average.power[k] += (double)fftData[k] * (double)fftData[k];
+
+    ++average.numFrames;
+}
+
+SpectrumAverage::SpectrumAverage(double newSampleRate) :
+    sampleRate(newSampleRate),
+    power((size_t)fftSize / 2 + 1, 0.0)
+{
+}
+
+double SpectrumAverage::getSeconds() const noexcept
+{
+    if (numFrames == 0 || sampleRate <= 0)
+        return 0.0;
+
+    return (double)((numFrames - 1) * hopSize + fftSize) / sampleRate;
+}
+
+void SpectrumAverage::merge(const SpectrumAverage& other)
+{
+    if (other.numFrames == 0)
+        return;
+
+    if (numFrames == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    jassert(other.sampleRate == sampleRate);
+
+    for (size_t k = 0; k < power.size(); ++k)
+        power[k] += other.power[k];
+
+    numFrames += other.numFrames;
+}
+
+void SpectrumAverage::reset()
+{
+    std::fill(power.begin(), power.end(), 0.0);
+    numFrames = 0;
+}
+
+std::vector<float> SpectrumAverage::getLevels(const std::vector<double>& frequencies, double octaves) const
+{
+    std::vector<float> levels(frequencies.size(), minimumDecibels);
+
+    if (numFrames == 0)
+        return levels;
+
+    const auto lastBin = fftSize / 2;
+    const auto binsPerHertz = (double)fftSize / sampleRate;
+    const auto halfWidth = std::pow(2.0, octaves * 0.5);
+    const auto scale = powerScale / (double)numFrames;
+
+    std::vector<double> sums(power.size() + 1, 0.0);
+    std::partial_sum(power.begin(), power.end(), sums.begin() + 1);
+
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
+        const auto centre = frequencies[i] * binsPerHertz;
+        const auto first = juce::jmax(1, (int)std::ceil(centre / halfWidth));
+        const auto last = juce::jmin(lastBin, (int)std::floor(centre * halfWidth));
+
+        double mean;
+
+        if (last >= first)
+        {
+            mean = (sums[(size_t)last + 1] - sums[(size_t)first]) / (double)(last - first + 1);
+        }
+        else
+        {
+            const auto position = juce::jlimit(0.0, (double)lastBin - 1.0, centre);
+            const auto bin = (size_t)position;
+
+            mean = power[bin] + (power[bin + 1] - power[bin]) * (position - (double)bin);
+        }
+
+        levels[i] = (float)juce::jmax((double)minimumDecibels, 10.0 * std::log10(mean * scale + 1.0e-30));
+    }
+
+    return levels;
+}
+
+SpectrumAverage SpectrumAverage::fromFile(const juce::File& file, juce::ThreadPool& pool,
+    std::function<bool()> shouldStop)
+{
+    // Shared with the pool's jobs, which can outlive this call by a moment:
+    // a job that starts late finds every chunk taken and returns.
+    struct Work
+    {
+        juce::OwnedArray<juce::AudioFormatReader> readers;
+        std::vector<SpectrumAverage> averages;
+
+        juce::int64 numFrames{ 0 };
+        int numChunks{ 0 };
+        std::atomic<int> nextChunk{ 0 }, chunksDone{ 0 };
+
+        std::function<bool()> shouldStop;
+        std::atomic<bool> stopped{ false };
+        juce::WaitableEvent finished;
+
+        void run(int worker)
+        {
+            auto& reader = *readers[worker];
+            auto& average = averages[(size_t)worker];
+
+            FrameAnalyser analyser;
+            juce::AudioBuffer<float> buffer(juce::jmax(1, (int)reader.numChannels), (framesPerChunk - 1) * hopSize + fftSize);
+            std::vector<float> mono((size_t)buffer.getNumSamples());
+
+            for (auto chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+            {
+                if (!stopped && shouldStop && shouldStop())
+                    stopped = true;
+
+                // Once stopped, the remaining chunks are only counted off.
+                if (!stopped)
+                {
+                    const auto firstFrame = (juce::int64)chunk * framesPerChunk;
+                    const auto frames = (int)juce::jmin((juce::int64)framesPerChunk, numFrames - firstFrame);
+                    const auto length = (frames - 1) * hopSize + fftSize;
+
+                    // Anything past the end of the file reads as silence.
+                    reader.read(&buffer, 0, length, firstFrame * hopSize, true, true);
+
+                    const auto gain = 1.f / (float)buffer.getNumChannels();
+                    juce::FloatVectorOperations::copyWithMultiply(mono.data(), buffer.getReadPointer(0), gain, length);
+
+                    for (int channel = 1; channel < buffer.getNumChannels(); ++channel)
+                        juce::FloatVectorOperations::addWithMultiply(mono.data(), buffer.getReadPointer(channel), gain, length);
+
+                    for (int frame = 0; frame < frames; ++frame)
+                        analyser.addFrame(average, mono.data() + frame * hopSize);
+                }
+
+                if (++chunksDone == numChunks)
+                    finished.signal();
+            }
+        }
+    };
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    auto work = std::make_shared<Work>();
+
+    for (int i = 0; i < pool.getNumThreads() + 1; ++i)
+    {
+        auto* reader = formats.createReaderFor(file);
+
+        if (reader == nullptr)
+            break;
+
+        work->readers.add(reader);
+    }
+
+    if (work->readers.isEmpty())
+        return {};
+
+    const auto& first = *work->readers.getFirst();
+
+    if (first.lengthInSamples <= 0 || first.sampleRate <= 0)
+        return {};
+
+    // A file shorter than a frame is one frame, padded with silence.
+    work->numFrames = juce::jmax((juce::int64)1, (first.lengthInSamples - fftSize) / hopSize + 1);
+    work->numChunks = (int)((work->numFrames + framesPerChunk - 1) / framesPerChunk);
+    work->shouldStop = std::move(shouldStop);
+    work->averages.assign((size_t)work->readers.size(), SpectrumAverage(first.sampleRate));
+
+    const auto numJobs = juce::jmin(work->readers.size(), work->numChunks) - 1;
+
+    for (int i = 1; i <= numJobs; ++i)
+        pool.addJob([work, i] { work->run(i); });
+
+    work->run(0);
+    work->finished.wait();
+
+    if (work->stopped)
+        return {};
+
+    SpectrumAverage result(first.sampleRate);
+
+    for (const auto& average : work->averages)
+        result.merge(average);
+
+    return result;
+}
+
+//==============================================================================
+
+MatchEqTarget makeMatchEqTarget(const SpectrumAverage& reference, const SpectrumAverage& input)
+{
+    MatchEqTarget target;
+
+    if (reference.getNumFrames() == 0 || input.getNumFrames() == 0)
+        return target;
+
+    // Up to 20 kHz, or as far as both sample rates reach.
+    const auto top = juce::jmin(20000.0, 0.45 * juce::jmin(reference.getSampleRate(), input.getSampleRate()));
+    const auto numPoints = (int)std::floor(std::log2(top / 20.0) * MatchEqTarget::pointsPerOctave) + 1;
+
+    for (int i = 0; i < numPoints; ++i)
+        target.frequencies.push_back(20.0 * std::pow(2.0, i / MatchEqTarget::pointsPerOctave));
+
+    auto referenceLevels = reference.getLevels(target.frequencies, MatchEqTarget::smoothingOctaves);
+    auto inputLevels = input.getLevels(target.frequencies, MatchEqTarget::smoothingOctaves);
+
+    const auto referenceFloor = *std::max_element(referenceLevels.begin(), referenceLevels.end()) - MatchEqTarget::maxRangeDecibels;
+    const auto inputFloor = *std::max_element(inputLevels.begin(), inputLevels.end()) - MatchEqTarget::maxRangeDecibels;
+
+    std::vector<float> measured;
+
+    for (size_t i = 0; i < target.frequencies.size(); ++i)
+    {
+        const auto weight = inputLevels[i] > inputFloor ? 1.f : 0.f;
+
+        // Where the reference has nothing, a cut as deep as its range will do.
+        target.decibels.push_back(juce::jmax(referenceLevels[i], referenceFloor) - inputLevels[i]);
+        target.weights.push_back(weight);
+        target.ceilings.push_back(referenceLevels[i] <= referenceFloor);
+
+        if (weight > 0 && !target.ceilings.back())
+            measured.push_back(target.decibels.back());
+    }
+
+    if (measured.empty())
+        return {};
+
+    // The median rather than the mean, so a deep cut at one end doesn't tilt everything else.
+    auto middle = measured.begin() + (std::ptrdiff_t)(measured.size() / 2);
+    std::nth_element(measured.begin(), middle, measured.end());
+
+    for (auto& decibels : target.decibels)
+        decibels -= *middle;
+
+    return target;
+}
+
+namespace
+{
+    // The overall level, the two cut frequencies, then frequency, gain and Q
+    // of every band. Frequencies and Qs are log2 of the real thing, so a step
+    // is the same size anywhere in the range.
+    enum FitParameter
+    {
+        offsetParameter,
+        lowCutParameter,
+        highCutParameter,
+        firstPeakParameter
+    };
+
+    constexpr int numFitParameters = firstPeakParameter + 3 * numPeakBands;
+
+    using FitVector = std::array<double, numFitParameters>;
+
+    // What a dB of band gain costs against a dB of error across the whole
+    // spectrum, so neighbouring bands don't settle on a boost and a cut that
+    // mostly cancel out.
+    constexpr double gainPenalty = 0.03;
+
+    // A cut has to take this much off the error to be worth keeping.
+    constexpr double cutBenefit = 0.02;
+
+    constexpr int maxIterations = 100;
+
+    const double decibelsPerNeper = 10.0 / std::log(10.0);
+    const double ln2 = std::log(2.0);
+
+    struct FitProblem
+    {
+        const MatchEqTarget& target;
+        double sampleRate;
+
+        // Butterworth orders, two per section.
+        int lowCutOrder, highCutOrder;
+        bool lowCutIn{ true }, highCutIn{ true };
+
+        // Every point's weight over the total, square rooted, so the cost is
+        // the weighted mean squared error.
+        std::vector<double> rowWeights;
+
+        FitVector lower{}, upper{};
+
+        size_t getNumRows() const noexcept { return target.frequencies.size() + numPeakBands; }
+
+        /** The cost at x. With residuals and jacobian, also each point's and
+            band's residual and its derivative by every parameter.
+        */
+        double evaluate(const FitVector& x, std::vector<double>* residuals = nullptr,
+            std::vector<FitVector>* jacobian = nullptr) const;
+
+        /** The weighted RMS error at x, leaving out the gain penalty. */
+        double getError(const FitVector& x) const;
+    };
+
+    // A cut's attenuation in dB, bilinear Butterworth of the given order,
+    // at tan(pi f / fs), and its derivative by the log2 of its frequency.
+    struct CutResponse
+    {
+        double decibels, derivative;
+    };
+
+    CutResponse getCutResponse(bool highPass, int order, double cutoff, double warped, double sampleRate)
+    {
+        const auto angle = juce::MathConstants<double>::pi * cutoff / sampleRate;
+        const auto warpedCutoff = std::tan(angle);
+
+        // |H|^2 = 1 / (1 + r^2N), where r is the cutoff over the frequency,
+        // both warped, for a high pass, and the other way up for a low pass.
+        const auto logRatio = highPass ? std::log(warpedCutoff / warped) : std::log(warped / warpedCutoff);
+        const auto u = 2.0 * order * logRatio;
+
+        // log(1 + e^u) and its slope, without overflowing for steep cuts far out.
+        const auto softPlus = u > 30.0 ? u + std::log1p(std::exp(-u)) : std::log1p(std::exp(u));
+        const auto slope = 1.0 / (1.0 + std::exp(-u));
+
+        // d log(tan(pi fc / fs)) / d log2(fc)
+        const auto logCutoffSlope = 2.0 * angle * ln2 / std::sin(2.0 * angle);
+
+        return { -decibelsPerNeper * softPlus,
+                 -decibelsPerNeper * slope * 2.0 * order * (highPass ? logCutoffSlope : -logCutoffSlope) };
+    }
+
+    double FitProblem::evaluate(const FitVector& x, std::vector<double>* residuals, std::vector<FitVector>* jacobian) const
+    {
+        using juce::MathConstants;
+
+        // Each band as the terms of the RBJ peak filter the processor uses,
+        // b = { 1 + alpha A, c2, 1 - alpha A }, a = { 1 + alpha / A, c2, 1 - alpha / A },
+        // and their derivatives by the band's three parameters.
+        struct Peak
+        {
+            double alphaA, alphaOverA, c2;
+            std::array<double, 3> dAlphaA, dAlphaOverA, dC2;
+        };
+
+        std::array<Peak, numPeakBands> peaks;
+
+        for (int band = 0; band < numPeakBands; ++band)
+        {
+            const auto* p = x.data() + firstPeakParameter + 3 * band;
+            const auto frequency = std::exp2(p[0]);
+            const auto quality = std::exp2(p[2]);
+
+            const auto A = std::pow(10.0, p[1] / 40.0);
+            const auto omega = MathConstants<double>::twoPi * frequency / sampleRate;
+            const auto s = std::sin(omega), c = std::cos(omega);
+            const auto alpha = s / (2.0 * quality);
+
+            auto& peak = peaks[(size_t)band];
+            peak.alphaA = alpha * A;
+            peak.alphaOverA = alpha / A;
+            peak.c2 = -2.0 * c;
+
+            // By log2 frequency, gain in dB and log2 Q.
+            const auto dOmega = omega * ln2;
+            const auto dLogA = std::log(10.0) / 40.0;
+
+            peak.dAlphaA = { A * c / (2.0 * quality) * dOmega, peak.alphaA * dLogA, -peak.alphaA * ln2 };
+            peak.dAlphaOverA = { c / (2.0 * quality * A) * dOmega, -peak.alphaOverA * dLogA, -peak.alphaOverA * ln2 };
+            peak.dC2 = { 2.0 * s * dOmega, 0.0, 0.0 };
+        }
+
+        const auto lowCutFrequency = std::exp2(x[lowCutParameter]);
+        const auto highCutFrequency = std::exp2(x[highCutParameter]);
+
+        if (residuals != nullptr)
+            residuals->assign(getNumRows(), 0.0);
+
+        if (jacobian != nullptr)
+            jacobian->assign(getNumRows(), FitVector{});
+
+        double cost = 0;
+
+        for (size_t i = 0; i < target.frequencies.size(); ++i)
+        {
+            if (rowWeights[i] == 0)
+                continue;
+
+            const auto angle = MathConstants<double>::pi * target.frequencies[i] / sampleRate;
+            const auto phi = std::sin(angle) * std::sin(angle);
+            const auto warped = std::tan(angle);
+
+            FitVector derivatives{};
+            auto model = x[offsetParameter];
+            derivatives[offsetParameter] = 1.0;
+
+            if (lowCutIn)
+            {
+                auto cut = getCutResponse(true, lowCutOrder, lowCutFrequency, warped, sampleRate);
+                model += cut.decibels;
+                derivatives[lowCutParameter] = cut.derivative;
+            }
+
+            if (highCutIn)
+            {
+                auto cut = getCutResponse(false, highCutOrder, highCutFrequency, warped, sampleRate);
+                model += cut.decibels;
+                derivatives[highCutParameter] = cut.derivative;
+            }
+
+            for (int band = 0; band < numPeakBands; ++band)
+            {
+                const auto& peak = peaks[(size_t)band];
+
+                // |B(w)|^2 in terms of phi = sin^2(w / 2), and its gradient by b0, b1 and b2.
+                auto measure = [phi](double b0, double b1, double b2, double& g0, double& g1, double& g2)
+                    {
+                        const auto sum = b0 + b1 + b2;
+
+                        g0 = 2.0 * sum - 4.0 * (b1 + 4.0 * b2) * phi + 16.0 * b2 * phi * phi;
+                        g1 = 2.0 * sum - 4.0 * (b0 + b2) * phi;
+                        g2 = 2.0 * sum - 4.0 * (4.0 * b0 + b1) * phi + 16.0 * b0 * phi * phi;
+
+                        return sum * sum - 4.0 * (b0 * b1 + 4.0 * b0 * b2 + b1 * b2) * phi + 16.0 * b0 * b2 * phi * phi;
+                    };
+
+                double n0, n1, n2, d0, d1, d2;
+                const auto numerator = measure(1.0 + peak.alphaA, peak.c2, 1.0 - peak.alphaA, n0, n1, n2);
+                const auto denominator = measure(1.0 + peak.alphaOverA, peak.c2, 1.0 - peak.alphaOverA, d0, d1, d2);
+
+                model += decibelsPerNeper * std::log(numerator / denominator);
+
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    const auto dNumerator = (n0 - n2) * peak.dAlphaA[k] + n1 * peak.dC2[k];
+                    const auto dDenominator = (d0 - d2) * peak.dAlphaOverA[k] + d1 * peak.dC2[k];
+
+                    derivatives[(size_t)(firstPeakParameter + 3 * band) + k]
+                        = decibelsPerNeper * (dNumerator / numerator - dDenominator / denominator);
+                }
+            }
+
+            // Below a ceiling is as good as on it.
+            if (target.ceilings[i] && model < target.decibels[i])
+                continue;
+
+            const auto residual = rowWeights[i] * (model - target.decibels[i]);
+            cost += residual * residual;
+
+            if (residuals != nullptr)
+                (*residuals)[i] = residual;
+
+            if (jacobian != nullptr)
+                for (size_t k = 0; k < derivatives.size(); ++k)
+                    (*jacobian)[i][k] = rowWeights[i] * derivatives[k];
+        }
+
+        for (int band = 0; band < numPeakBands; ++band)
+        {
+            const auto gainParameter = (size_t)(firstPeakParameter + 3 * band + 1);
+            const auto residual = gainPenalty * x[gainParameter];
+            const auto row = target.frequencies.size() + (size_t)band;
+
+            cost += residual * residual;
+
+            if (residuals != nullptr)
+                (*residuals)[row] = residual;
+
+            if (jacobian != nullptr)
+                (*jacobian)[row][gainParameter] = gainPenalty;
+        }
+
+        return cost;
+    }
+
+    double FitProblem::getError(const FitVector& x) const
+    {
+        std::vector<double> residuals;
+        evaluate(x, &residuals);
+
+        double sum = 0;
+
+        for (size_t i = 0; i < target.frequencies.size(); ++i)
+            sum += residuals[i] * residuals[i];
+
+        return std::sqrt(sum);
+    }
+
+    /** Solves matrix * result = result in place, by Gaussian elimination with partial pivoting. */
+    bool solve(std::array<FitVector, numFitParameters>& matrix, FitVector& result)
+    {
+        constexpr int n = numFitParameters;
+
+        for (int column = 0; column < n; ++column)
+        {
+            auto pivot = column;
+
+            for (int row = column + 1; row < n; ++row)
+                if (std::abs(matrix[(size_t)row][(size_t)column]) > std::abs(matrix[(size_t)pivot][(size_t)column]))
+                    pivot = row;
+
+            if (std::abs(matrix[(size_t)pivot][(size_t)column]) < 1.0e-300)
+                return false;
+
+            std::swap(matrix[(size_t)column], matrix[(size_t)pivot]);
+            std::swap(result[(size_t)column], result[(size_t)pivot]);
+
+            for (int row = column + 1; row < n; ++row)
+            {
+                const auto factor = matrix[(size_t)row][(size_t)column] / matrix[(size_t)column][(size_t)column];
+
+                for (int k = column; k < n; ++k)
+                    matrix[(size_t)row][(size_t)k] -= factor * matrix[(size_t)column][(size_t)k];
+
+                result[(size_t)row] -= factor * result[(size_t)column];
+            }
+        }
+
+        for (int row = n - 1; row >= 0; --row)
+        {
+            auto sum = result[(size_t)row];
+
+            for (int k = row + 1; k < n; ++k)
+                sum -= matrix[(size_t)row][(size_t)k] * result[(size_t)k];
+
+            result[(size_t)row] = sum / matrix[(size_t)row][(size_t)row];
+        }
+
+        return true;
+    }
+
+    /** Levenberg-Marquardt from x, kept within the problem's bounds, moving
+        only the free parameters. Returns the number of iterations.
+    */
+    int fitLeastSquares(const FitProblem& problem, FitVector& x, const std::array<bool, numFitParameters>& free, double& cost)
+    {
+        std::vector<double> residuals;
+        std::vector<FitVector> jacobian;
+
+        auto lambda = 1.0e-3;
+        cost = problem.evaluate(x);
+
+        int iteration = 0;
+
+        while (iteration < maxIterations)
+        {
+            ++iteration;
+            problem.evaluate(x, &residuals, &jacobian);
+
+            // The normal equations, J'J and J'r.
+            std::array<FitVector, numFitParameters> normal{};
+            FitVector gradient{};
+
+            for (size_t row = 0; row < residuals.size(); ++row)
+            {
+                const auto& derivatives = jacobian[row];
+
+                for (size_t j = 0; j < (size_t)numFitParameters; ++j)
+                {
+                    if (!free[j] || derivatives[j] == 0)
+                        continue;
+
+                    gradient[j] += derivatives[j] * residuals[row];
+
+                    for (size_t k = j; k < (size_t)numFitParameters; ++k)
+                        if (free[k])
+                            normal[j][k] += derivatives[j] * derivatives[k];
+                }
+            }
+
+            for (size_t j = 0; j < (size_t)numFitParameters; ++j)
+                for (size_t k = 0; k < j; ++k)
+                    normal[j][k] = normal[k][j];
+
+            auto improvement = -1.0;
+
+            while (lambda < 1.0e10)
+            {
+                auto damped = normal;
+                FitVector step{};
+
+                for (size_t j = 0; j < (size_t)numFitParameters; ++j)
+                {
+                    // A fixed parameter's row and column are empty, so it only needs a 1 on the diagonal.
+                    if (free[j])
+                        damped[j][j] += lambda * (normal[j][j] + 1.0e-9);
+                    else
+                        damped[j][j] = 1.0;
+
+                    step[j] = -gradient[j];
+                }
+
+                if (solve(damped, step))
+                {
+                    auto next = x;
+
+                    for (size_t j = 0; j < (size_t)numFitParameters; ++j)
+                        if (free[j])
+                            next[j] = juce::jlimit(problem.lower[j], problem.upper[j], x[j] + step[j]);
+
+                    const auto nextCost = problem.evaluate(next);
+
+                    if (nextCost < cost)
+                    {
+                        improvement = cost - nextCost;
+                        x = next;
+                        cost = nextCost;
+                        lambda = juce::jmax(lambda / 3.0, 1.0e-12);
+                        break;
+                    }
+                }
+
+                lambda *= 4.0;
+            }
+
+            if (improvement < 1.0e-9 + 1.0e-6 * cost)
+                break;
+        }
+
+        return iteration;
+    }
+
+    /** Puts the bands, one at a time, where the fit so far is furthest off,
+        with the gain that closes the gap there and a Q of 1. Of the bands
+        that reach that point, the one whose default frequency is closest
+        takes it, and bands left over stay flat.
+    */
+    void placeBands(const FitProblem& problem, FitVector& x)
+    {
+        const auto& frequencies = problem.target.frequencies;
+
+        std::array<bool, numPeakBands> placed{};
+        std::vector<double> residuals;
+
+        for (int n = 0; n < numPeakBands; ++n)
+        {
+            problem.evaluate(x, &residuals);
+
+            auto bestBand = -1;
+            size_t bestPoint = 0;
+            double bestError = 0.5;
+
+            for (size_t i = 0; i < frequencies.size(); ++i)
+            {
+                if (problem.rowWeights[i] == 0)
+                    continue;
+
+                const auto error = residuals[i] / problem.rowWeights[i];
+
+                if (std::abs(error) <= std::abs(bestError))
+                    continue;
+
+                const auto position = std::log2(frequencies[i]);
+                auto closest = std::numeric_limits<double>::max();
+
+                for (int band = 0; band < numPeakBands; ++band)
+                {
+                    const auto first = (size_t)(firstPeakParameter + 3 * band);
+                    const auto distance = std::abs(std::log2((double)peakBands[band].defaultFreq) - position);
+
+                    if (!placed[(size_t)band] && problem.lower[first] <= position && position <= problem.upper[first]
+                        && distance < closest)
+                    {
+                        closest = distance;
+                        bestBand = band;
+                        bestPoint = i;
+                        bestError = error;
+                    }
+                }
+            }
+
+            if (bestBand < 0)
+                break;
+
+            const auto first = (size_t)(firstPeakParameter + 3 * bestBand);
+
+            placed[(size_t)bestBand] = true;
+            x[first] = std::log2(frequencies[bestPoint]);
+            x[first + 1] = juce::jlimit(-12.0, 12.0, -bestError);
+            x[first + 2] = 0.0;
+        }
+    }
+}
+
+MatchEqFit fitMatchEq(const MatchEqTarget& target, const ChainSettings& current, double sampleRate)
+{
+    MatchEqFit fit;
+    fit.settings = current;
+
+    if (target.isEmpty() || sampleRate <= 0)
+        return fit;
+
+    FitProblem problem{ target, sampleRate,
+        2 * getNumCutSections(current.lowCutSlope), 2 * getNumCutSections(current.highCutSlope) };
+
+    // Nothing above what the sample rate can carry counts.
+    const auto totalWeight = std::accumulate(target.weights.begin(), target.weights.end(), 0.0);
+
+    for (size_t i = 0; i < target.frequencies.size(); ++i)
+        problem.rowWeights.push_back(target.frequencies[i] < 0.45 * sampleRate && totalWeight > 0
+            ? std::sqrt(target.weights[i] / totalWeight) : 0.0);
+
+    const auto topFrequency = juce::jmin(20000.0, 0.45 * sampleRate);
+
+    problem.lower[offsetParameter] = -100.0;
+    problem.upper[offsetParameter] = 100.0;
+
+    for (auto parameter : { lowCutParameter, highCutParameter })
+    {
+        problem.lower[(size_t)parameter] = std::log2(20.0);
+        problem.upper[(size_t)parameter] = std::log2(topFrequency);
+    }
+
+    // Each cut starts where the target first gets within 3 dB of the middle,
+    // coming in from its end of the spectrum.
+    FitVector start{};
+    start[lowCutParameter] = problem.lower[lowCutParameter];
+    start[highCutParameter] = problem.upper[highCutParameter];
+
+    for (size_t i = 0; i < target.frequencies.size(); ++i)
+    {
+        if (problem.rowWeights[i] > 0 && target.decibels[i] > -3.f)
+        {
+            start[lowCutParameter] = juce::jlimit(problem.lower[lowCutParameter], problem.upper[lowCutParameter],
+                std::log2(target.frequencies[i]));
+            break;
+        }
+    }
+
+    for (auto i = target.frequencies.size(); i-- > 0;)
+    {
+        if (problem.rowWeights[i] > 0 && target.decibels[i] > -3.f)
+        {
+            start[highCutParameter] = juce::jlimit(problem.lower[highCutParameter], problem.upper[highCutParameter],
+                std::log2(target.frequencies[i]));
+            break;
+        }
+    }
+
+    // The bands start out flat, at their default frequencies, until placeBands() moves them.
+    for (int band = 0; band < numPeakBands; ++band)
+    {
+        const auto& info = peakBands[band];
+        const auto first = (size_t)(firstPeakParameter + 3 * band);
+        const auto maxFreq = juce::jmin((double)info.maxFreq, topFrequency);
+
+        problem.lower[first] = std::log2((double)info.minFreq);
+        problem.upper[first] = std::log2(juce::jmax((double)info.minFreq, maxFreq));
+        problem.lower[first + 1] = -12.0;
+        problem.upper[first + 1] = 12.0;
+        problem.lower[first + 2] = std::log2(0.1);
+        problem.upper[first + 2] = std::log2(10.0);
+
+        start[first] = juce::jlimit(problem.lower[first], problem.upper[first], std::log2((double)info.defaultFreq));
+    }
+
+    // Flat, apart from the best overall level.
+    {
+        double mean = 0;
+
+        for (size_t i = 0; i < target.frequencies.size(); ++i)
+            mean += problem.rowWeights[i] * problem.rowWeights[i] * target.decibels[i];
+
+        double variance = 0;
+
+        for (size_t i = 0; i < target.frequencies.size(); ++i)
+            variance += problem.rowWeights[i] * problem.rowWeights[i] * juce::square(target.decibels[i] - mean);
+
+        fit.errorBefore = (float)std::sqrt(variance);
+        start[offsetParameter] = mean;
+    }
+
+    // Without cuts, then with each and both, a cut only making it in when it pays for itself.
+    FitVector best{};
+    auto bestCost = std::numeric_limits<double>::max();
+    bool lowCutIn = false, highCutIn = false;
+
+    for (auto cuts : { 0, 1, 2, 3 })
+    {
+        problem.lowCutIn = (cuts & 1) != 0;
+        problem.highCutIn = (cuts & 2) != 0;
+
+        // The level and the cuts first, then the bands on what they leave,
+        // then everything together.
+        std::array<bool, numFitParameters> free{};
+        free[offsetParameter] = true;
+        free[lowCutParameter] = problem.lowCutIn;
+        free[highCutParameter] = problem.highCutIn;
+
+        auto x = start;
+        double cost;
+        fit.iterations += fitLeastSquares(problem, x, free, cost);
+
+        placeBands(problem, x);
+
+        std::fill(free.begin() + firstPeakParameter, free.end(), true);
+        fit.iterations += fitLeastSquares(problem, x, free, cost);
+
+        if (cost < bestCost * (1.0 - cutBenefit))
+        {
+            best = x;
+            bestCost = cost;
+            lowCutIn = problem.lowCutIn;
+            highCutIn = problem.highCutIn;
+        }
+    }
+
+    problem.lowCutIn = lowCutIn;
+    problem.highCutIn = highCutIn;
+    fit.errorAfter = (float)problem.getError(best);
+
+    auto& settings = fit.settings;
+
+    settings.lowCutBypassed = !lowCutIn;
+    settings.highCutBypassed = !highCutIn;
+
+    if (lowCutIn)
+        settings.lowCutFreq = (float)std::exp2(best[lowCutParameter]);
+
+    if (highCutIn)
+        settings.highCutFreq = (float)std::exp2(best[highCutParameter]);
+
+    for (int band = 0; band < numPeakBands; ++band)
+    {
+        const auto first = (size_t)(firstPeakParameter + 3 * band);
+        auto& peak = settings.peaks[(size_t)band];
+
+        peak.freq = (float)std::exp2(best[first]);
+        peak.gainInDecibels = std::abs(best[first + 1]) < 0.25 ? 0.f : (float)best[first + 1];
+        peak.quality = (float)std::exp2(best[first + 2]);
+        peak.bypassed = false;
+    }
+
+    return fit;
+}
+
+//==============================================================================
+
+MatchEqAnalyser::MatchEqAnalyser(SpectrumFifo& source, const juce::File& referenceFile) :
+    juce::Thread("Match EQ"),
+    fifo(source),
+    reference(referenceFile),
+    pool(juce::jmax(1, juce::SystemStats::getNumCpus() - 1)),
+    history((size_t)SpectrumAverage::fftSize, 0.f),
+    incoming((size_t)SpectrumAverage::hopSize, 0.f)
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+MatchEqAnalyser::~MatchEqAnalyser()
+{
+    stopThread(4000);
+    pool.removeAllJobs(true, 4000);
+}
+
+MatchEqTarget MatchEqAnalyser::getTarget() const
+{
+    const juce::ScopedLock sl(lock);
+
+    if (inputAverage.getNumFrames() < minInputFrames)
+        return {};
+
+    return makeMatchEqTarget(referenceAverage, inputAverage);
+}
+
+double MatchEqAnalyser::getInputSeconds() const
+{
+    const juce::ScopedLock sl(lock);
+    return inputAverage.getSeconds();
+}
+
+void MatchEqAnalyser::run()
+{
+    auto loaded = SpectrumAverage::fromFile(reference, pool, [this] { return threadShouldExit(); });
+
+    if (loaded.getNumFrames() == 0)
+    {
+        state = State::Failed;
+        return;
+    }
+
+    {
+        const juce::ScopedLock sl(lock);
+        referenceAverage = std::move(loaded);
+    }
+
+    // What came in while the reference was loading is thrown away, so the
+    // average starts from where the fifo is now.
+    fifo.discard();
+    state = State::Listening;
+
+    SpectrumAverage average;
+    int hopsInHistory = 0;
+
+    while (!threadShouldExit())
+    {
+        const auto sampleRate = fifo.getSampleRate();
+
+        // A new sample rate means new bins, so it starts over.
+        if (sampleRate != average.getSampleRate())
+        {
+            average = SpectrumAverage(sampleRate);
+            hopsInHistory = 0;
+            numIncoming = 0;
+        }
+
+        constexpr auto hop = SpectrumAverage::hopSize;
+        numIncoming += fifo.pull(incoming.data() + numIncoming, hop - numIncoming);
+
+        if (numIncoming < hop)
+        {
+            wait(20);
+            continue;
+        }
+
+        std::copy(history.begin() + hop, history.end(), history.begin());
+        std::copy(incoming.begin(), incoming.end(), history.end() - hop);
+        numIncoming = 0;
+
+        // Only whole frames of audio, never the silence history starts with.
+        if (++hopsInHistory < SpectrumAverage::fftSize / hop)
+            continue;
+
+        frameAnalyser.addFrame(average, history.data());
+
+        if (average.getNumFrames() % framesPerUpdate == 0)
+        {
+            const juce::ScopedLock sl(lock);
+            inputAverage = average;
+        }
+    }
+}
@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    MatchEq.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+/**
+    The long-term average spectrum of some audio: the mean power in every bin
+    of Hann windowed FFT frames, overlapping by half, of the audio summed to
+    mono.
+
+    Frames don't depend on each other, so averages of different stretches of
+    audio can be worked out side by side and merged afterwards, which is how
+    fromFile() gets through a whole song in a fraction of a second.
+*/
+class SpectrumAverage
+{
+public:
+    static constexpr int fftOrder = 13, fftSize = 1 << fftOrder, hopSize = fftSize / 2;
+
+    /** The FFT and scratch space for adding frames. Each thread needs its own. */
+    class FrameAnalyser
+    {
+    public:
+        FrameAnalyser();
+
+        /** Adds the fftSize samples starting at samples as one more frame. */
+        void addFrame(SpectrumAverage& average, const float* samples);
+
+    private:
+        juce::dsp::FFT fft{ fftOrder };
+        juce::dsp::WindowingFunction<float> window{ (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+        std::vector<float> fftData;
+    };
+
+    SpectrumAverage() = default;
+    explicit SpectrumAverage(double sampleRate);
+
+    double getSampleRate() const noexcept { return sampleRate; }
+    juce::int64 getNumFrames() const noexcept { return numFrames; }
+
+    /** Roughly how much audio went into it. */
+    double getSeconds() const noexcept;
+
+    /** Adds the frames of another average of audio at the same sample rate. */
+    void merge(const SpectrumAverage& other);
+
+    void reset();
+
+    /** The mean level at each frequency in dB, where a full scale sine reads
+        0 dB, of the bins within octaves / 2 either side of it. Narrower than a
+        bin, it's interpolated between the nearest two.
+    */
+    std::vector<float> getLevels(const std::vector<double>& frequencies, double octaves) const;
+
+    /** The average of a whole audio file.
+
+        The file is cut into chunks of frames, and jobs on the pool work
+        through them alongside the calling thread, each with a reader of its
+        own. The calling thread takes chunks too, so this never waits on a
+        pool that's busy, or on itself when it's called from one of the
+        pool's jobs. Empty if the file can't be read, or if shouldStop returns
+        true before it's done.
+    */
+    static SpectrumAverage fromFile(const juce::File& file, juce::ThreadPool& pool,
+        std::function<bool()> shouldStop = {});
+
+private:
+    double sampleRate{ 0 };
+    juce::int64 numFrames{ 0 };
+
+    // Summed over every frame, fftSize / 2 + 1 bins.
+    std::vector<double> power;
+};
+
+/**
+    What a match EQ aims for: the reference's level minus the input's, on a
+    grid of log spaced frequencies, smoothed over a third of an octave.
+
+    Where the input is more than maxRangeDecibels below its loudest, there's
+    nothing to measure, and the weight is 0. Where the reference is that far
+    below its own loudest, the target is only a ceiling: anything at least as
+    deep will do. The level difference across the whole spectrum is the
+    auto-gain stage's business, so the median is taken off.
+*/
+struct MatchEqTarget
+{
+    static constexpr double pointsPerOctave = 12.0, smoothingOctaves = 1.0 / 3.0;
+    static constexpr float maxRangeDecibels = 60.f;
+
+    std::vector<double> frequencies;
+    std::vector<float> decibels, weights;
+    std::vector<bool> ceilings;
+
+    bool isEmpty() const noexcept { return frequencies.empty(); }
+};
+
+MatchEqTarget makeMatchEqTarget(const SpectrumAverage& reference, const SpectrumAverage& input);
+
+struct MatchEqFit
+{
+    ChainSettings settings;
+
+    // The weighted RMS difference from the target in dB, flat and with the fit.
+    float errorBefore{ 0 }, errorAfter{ 0 };
+
+    int iterations{ 0 };
+};
+
+/** The low cut, peak bands and high cut that bring the input's spectrum
+    closest to the reference's.
+
+    The bands are fitted to the target by Levenberg-Marquardt least squares,
+    with the derivatives of every filter's magnitude response in dB worked
+    out analytically, from the same designs the processor uses. Frequencies
+    and Qs are fitted in octaves, within each band's range, and every cut is
+    tried both in and bypassed, keeping it only when it earns its place.
+    Everything else in current, the slopes, routing, dynamics and so on, is
+    left as it is.
+*/
+MatchEqFit fitMatchEq(const MatchEqTarget& target, const ChainSettings& current, double sampleRate);
+
+/**
+    Collects what a match EQ needs while audio plays: the average spectrum of
+    a reference file, analysed once in the background, then the running
+    average of the input that a SpectrumFifo delivers, for as long as it
+    exists.
+*/
+class MatchEqAnalyser : private juce::Thread
+{
+public:
+    enum class State
+    {
+        LoadingReference,
+        Listening,
+        Failed
+    };
+
+    /** Starts analysing the reference, and after that, reading from the fifo. */
+    MatchEqAnalyser(SpectrumFifo& source, const juce::File& referenceFile);
+    ~MatchEqAnalyser() override;
+
+    State getState() const noexcept { return state.load(); }
+
+    const juce::File& getReferenceFile() const noexcept { return reference; }
+
+    /** The target so far. Empty until the reference is in and the input has had a few frames. */
+    MatchEqTarget getTarget() const;
+
+    /** How many seconds of input have been averaged. */
+    double getInputSeconds() const;
+
+private:
+    void run() override;
+
+    // A second of input is enough for a rough target, and it publishes a few times a second.
+    static constexpr int minInputFrames = 12, framesPerUpdate = 4;
+
+    SpectrumFifo& fifo;
+    const juce::File reference;
+
+    juce::ThreadPool pool;
+
+    // Background thread only.
+    SpectrumAverage::FrameAnalyser frameAnalyser;
+    std::vector<float> history, incoming;
+    int numIncoming{ 0 };
+
+    std::atomic<State> state{ State::LoadingReference };
+
+    juce::CriticalSection lock;
+    SpectrumAverage referenceAverage, inputAverage;
+
+    JUCE_DECLARE_NON_COPYABLE(MatchEqAnalyser)
+};
@@ -19,53 +19,68 @@ void LookAndFeel::drawRotarySlider(juce::Graphics& g,
     float rotaryEngAngle,
     juce::Slider& slider)
 {
-    using namespace juce;
+    auto bounds = juce::Rectangle<float>(x, y, width, height);
+
+    drawRotarySliderFace(g, bounds, slider.isEnabled());
 
-    auto bounds = Rectangle<float>(x, y, width, height);
+    if (auto* rswl = dynamic_cast<RotarySliderWithLabels*>(&slider))
+        drawRotarySliderPointer(g, bounds, sliderPosProportional, rotaryStartAngle, rotaryEngAngle, *rswl);
+}
 
-    auto enabled = slider.isEnabled();
+void LookAndFeel::drawRotarySliderFace(juce::Graphics& g, juce::Rectangle<float> bounds, bool enabled)
+{
+    using namespace juce;
 
     g.setColour(enabled ? Colours::purple : Colours::darkgrey);
     g.fillEllipse(bounds);
 
     g.setColour(enabled ? Colours::lightgrey : Colours::grey);
     g.drawEllipse(bounds, 1.f);
+}
 
-    if (auto* rswl = dynamic_cast<RotarySliderWithLabels*>(&slider))
-    {
-        auto center = bounds.getCentre();
+void LookAndFeel::drawRotarySliderPointer(juce::Graphics& g,
+    juce::Rectangle<float> bounds,
+    float sliderPosProportional,
+    float rotaryStartAngle,
+    float rotaryEngAngle,
+    RotarySliderWithLabels& rswl)
+{
+    using namespace juce;
 
-        Path p;
+    auto enabled = rswl.isEnabled();
+    auto center = bounds.getCentre();
 
-        Rectangle<float> r;
-        r.setLeft(center.getX() - 2);
-        r.setRight(center.getX() + 2);
-        r.setTop(bounds.getY());
-        r.setBottom(center.getY() - rswl->getTextHeight() * 1.5);
-        
-        p.addRoundedRectangle(r, 2.f);
+    Path p;
 
-        jassert(rotaryStartAngle < rotaryEngAngle);
+    Rectangle<float> r;
+    r.setLeft(center.getX() - 2);
+    r.setRight(center.getX() + 2);
+    r.setTop(bounds.getY());
+    r.setBottom(center.getY() - rswl.getTextHeight() * 1.5);
 
-        auto sliderAngRad = jmap(sliderPosProportional, 0.f, 1.f, rotaryStartAngle, rotaryEngAngle);
+    p.addRoundedRectangle(r, 2.f);
 
-        p.applyTransform(AffineTransform().rotated(sliderAngRad, center.getX(), center.getY()));
+    jassert(rotaryStartAngle < rotaryEngAngle);
 
-        g.fillPath(p);
+    auto sliderAngRad = jmap(sliderPosProportional, 0.f, 1.f, rotaryStartAngle, rotaryEngAngle);
 
-        g.setFont(rswl->getTextHeight());
-        auto text = rswl->getDisplayString();
-        auto strWidth = g.getCurrentFont().getStringWidth(text);
+    p.applyTransform(AffineTransform().rotated(sliderAngRad, center.getX(), center.getY()));
 
-        r.setSize(strWidth + 4, rswl->getTextHeight() + 2);
-        r.setCentre(bounds.getCentre());
+    g.setColour(enabled ? Colours::lightgrey : Colours::grey);
+    g.fillPath(p);
 
-        g.setColour(enabled ? Colours::black : Colours::darkgrey);
-        g.fillRect(r);
+    g.setFont(rswl.getTextHeight());
+    auto text = rswl.getDisplayString();
+    auto strWidth = g.getCurrentFont().getStringWidth(text);
 
-        g.setColour(enabled ? Colours::white : Colours::lightgrey);
-        g.drawFittedText(text, r.toNearestInt(), juce::Justification::centred, 1);
-    }
+    r.setSize(strWidth + 4, rswl.getTextHeight() + 2);
+    r.setCentre(bounds.getCentre());
+
+    g.setColour(enabled ? Colours::black : Colours::darkgrey);
+    g.fillRect(r);
+
+    g.setColour(enabled ? Colours::white : Colours::lightgrey);
+    g.drawFittedText(text, r.toNearestInt(), juce::Justification::centred, 1);
 }
 
 void LookAndFeel::drawToggleButton(juce::Graphics& g,
@@ -113,13 +128,92 @@ void LookAndFeel::drawToggleButton(juce::Graphics& g,
 }
 
 //===============================================================================
+const juce::Image& EditorResources::getLogo()
+{
+    if (!logo.isValid())
+        logo = juce::ImageFileFormat::loadFrom(BinaryData::TradeMarkMediaTechLogo10p_png,
+            BinaryData::TradeMarkMediaTechLogo10p_pngSize);
+
+    return logo;
+}
+
+juce::Image EditorResources::getLayer(const juce::String& name, int width, int height, float scale, bool opaque,
+    const std::function<void(juce::Graphics&)>& draw)
+{
+    auto pixelWidth = juce::roundToInt((float)width * scale);
+    auto pixelHeight = juce::roundToInt((float)height * scale);
+
+    if (pixelWidth <= 0 || pixelHeight <= 0)
+        return {};
+
+    const auto key = name + "@" + juce::String(pixelWidth) + "x" + juce::String(pixelHeight);
+
+    if (auto found = layers.find(key); found != layers.end())
+    {
+        found->second.lastUsed = ++numLayerUses;
+        return found->second.image;
+    }
+
+    juce::Image image(opaque ? juce::Image::PixelFormat::RGB : juce::Image::PixelFormat::ARGB,
+        pixelWidth, pixelHeight, true);
+
+    {
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale((float)pixelWidth / (float)width,
+            (float)pixelHeight / (float)height));
+
+        draw(g);
+    }
+
+    evictLayers(getSizeInBytes(image));
+
+    layers[key] = { image, ++numLayerUses };
+    layerBytes += getSizeInBytes(image);
+
+    return image;
+}
+
+size_t EditorResources::getSizeInBytes(const juce::Image& image) noexcept
+{
+    // Near enough for a budget, whatever the platform stores RGB pixels in.
+    return (size_t)image.getWidth() * (size_t)image.getHeight() * 4;
+}
+
+void EditorResources::evictLayers(size_t bytesNeeded)
+{
+    while (!layers.empty() && layerBytes + bytesNeeded > maxLayerBytes)
+    {
+        auto oldest = std::min_element(layers.begin(), layers.end(),
+            [](const auto& a, const auto& b) { return a.second.lastUsed < b.second.lastUsed; });
+
+        layerBytes -= getSizeInBytes(oldest->second.image);
+        layers.erase(oldest);
+    }
+}
+
+//===============================================================================
+namespace
+{
+    const auto knobStartAngle = juce::degreesToRadians(180.f + 45.f);
+    const auto knobEndAngle = juce::degreesToRadians(180.f - 45.f) + juce::MathConstants<float>::twoPi;
+
+    // The colour of each peak band's panel, low to high.
+    juce::Colour getBandColour(int band)
+    {
+        static const juce::Colour colours[]{ juce::Colours::red,
+            juce::Colours::orange,
+            juce::Colours::yellow,
+            juce::Colours::green,
+            juce::Colours::blue };
+
+        return colours[band % (int)std::size(colours)];
+    }
+}
+
 void RotarySliderWithLabels::paint(juce::Graphics& g)
 {
     using namespace juce;
 
-    auto startAng = degreesToRadians(180.f + 45.f);
-    auto endAng = degreesToRadians(180.f - 45.f) + MathConstants<float>::twoPi;
-
     auto range = getRange();
 
     auto sliderBounds = getSliderBounds();
@@ -130,15 +224,35 @@ void RotarySliderWithLabels::paint(juce::Graphics& g)
     g.setColour(Colours::yellow);
     g.drawRect(sliderBounds);*/
 
-    getLookAndFeel().drawRotarySlider(g,
-        sliderBounds.getX(),
-        sliderBounds.getY(),
-        sliderBounds.getWidth(),
-        sliderBounds.getHeight(),
+    // The face and the labels only change with the size, the labels and the
+    // enabled state, so sliders that share all three share one image of them.
+    String layerName("Knob");
+    layerName << (isEnabled() ? "/on" : "/off");
+
+    for (auto& label : labels)
+        layerName << "/" << label.pos << ":" << label.label;
+
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    auto face = resources->getLayer(layerName, getWidth(), getHeight(), scale, false,
+        [this](Graphics& layer) { drawFace(layer); });
+
+    g.drawImage(face, getLocalBounds().toFloat());
+
+    resources->lookAndFeel.drawRotarySliderPointer(g,
+        sliderBounds.toFloat(),
         jmap(getValue(), range.getStart(), range.getEnd(), 0.0, 1.0),
-        startAng,
-        endAng,
+        knobStartAngle,
+        knobEndAngle,
         *this);
+}
+
+void RotarySliderWithLabels::drawFace(juce::Graphics& g)
+{
+    using namespace juce;
+
+    auto sliderBounds = getSliderBounds();
+
+    resources->lookAndFeel.drawRotarySliderFace(g, sliderBounds.toFloat(), isEnabled());
 
     auto center = sliderBounds.toFloat().getCentre();
     auto radius = sliderBounds.getWidth() * 0.5f;
@@ -153,7 +267,7 @@ void RotarySliderWithLabels::paint(juce::Graphics& g)
         jassert(0.f <= pos);
         jassert(pos <= 1.f);
 
-        auto ang = jmap(pos, 0.f, 1.f, startAng, endAng);
+        auto ang = jmap(pos, 0.f, 1.f, knobStartAngle, knobEndAngle);
 
         auto c = center.getPointOnCircumference(radius + getTextHeight() * 0.5f + 1, ang);
 
@@ -234,6 +348,15 @@ HeaderComponent::~HeaderComponent()
 }
 
 void HeaderComponent::paint (juce::Graphics& g)
+{
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    auto header = resources->getLayer("Header", getWidth(), getHeight(), scale, true,
+        [this](juce::Graphics& layer) { drawHeader(layer); });
+
+    g.drawImage(header, getLocalBounds().toFloat());
+}
+
+void HeaderComponent::drawHeader(juce::Graphics& g)
 {
     using namespace juce;
 
@@ -251,10 +374,7 @@ void HeaderComponent::paint (juce::Graphics& g)
 
     auto logoArea = bounds.removeFromRight(bounds.getWidth() * .2);
 
-    logo = juce::ImageCache::getFromMemory(BinaryData::TradeMarkMediaTechLogo10p_png,
-        BinaryData::TradeMarkMediaTechLogo10p_pngSize);
-
-    g.drawImageWithin(logo, 
+    g.drawImageWithin(resources->getLogo(),
         0,
         0,
         logoArea.getWidth(),
@@ -278,6 +398,11 @@ ResponseCurveComponent::ResponseCurveComponent(TradeMarkEQAudioProcessor& p) : a
         param->addListener(this);
     }
 
+    audioProcessor.addChangeListener(this);
+
+    // paint() covers every pixel, so nothing behind needs redrawing with it.
+    setOpaque(true);
+
     updateChain();
 
     startTimerHz(60);
@@ -290,14 +415,76 @@ ResponseCurveComponent::~ResponseCurveComponent()
     {
         param->removeListener(this);
     }
+
+    audioProcessor.removeChangeListener(this);
+
+    setSpectrogramVisible(false);
+    setDetectingResonances(false);
+    stopMatching();
+    setComparedInstance(-1);
 }
 void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue)
+{
+    // A bulk update sends one change message when it's done.
+    if (audioProcessor.isApplyingParameterValues())
+        return;
+
+    parametersChanged.set(true);
+}
+
+void ResponseCurveComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
     parametersChanged.set(true);
 }
 
 void ResponseCurveComponent::timerCallback()
 {
+    auto level = audioProcessor.getQualityScheduler().getPublishedLevel();
+
+    if (level != qualityLevel)
+    {
+        qualityLevel = level;
+        repaint();
+    }
+
+    // The meters only move every 100 ms, and only their corner gets redrawn.
+    auto input = audioProcessor.getInputLoudness();
+    auto output = audioProcessor.getOutputLoudness();
+    auto gain = audioProcessor.getAutoGainDecibels();
+
+    if (input != inputLoudness || output != outputLoudness || gain != autoGainDecibels)
+    {
+        inputLoudness = input;
+        outputLoudness = output;
+        autoGainDecibels = gain;
+        repaint(getLoudnessArea());
+    }
+
+    if (updateSpectrogram())
+        repaint(getAnalysisArea());
+
+    // The detector only moves a few times a second.
+    if (resonanceDetector != nullptr && ++resonanceTicks % 15 == 0)
+    {
+        auto suggestions = audioProcessor.suggestNotches(resonanceDetector->getResonances());
+        auto statistics = resonanceDetector->getStatistics();
+
+        if (suggestions != notchSuggestions || statistics.cpuShare != resonanceStatistics.cpuShare)
+        {
+            notchSuggestions = std::move(suggestions);
+            resonanceStatistics = statistics;
+            repaint(getAnalysisArea());
+        }
+    }
+
+    // The input average barely moves from one tick to the next.
+    if (matchAnalyser != nullptr && ++matchTicks % 15 == 0)
+        updateMatchTarget();
+
+    // The shared spectra are updated 15 times a second.
+    if (compareSubscription != nullptr && ++compareTicks % 4 == 0)
+        updateComparison();
+
     if (parametersChanged.compareAndSetBool(false, true))
     {
         DBG("params changed");
@@ -309,286 +496,1131 @@ void ResponseCurveComponent::timerCallback()
     }
 }
 
-void ResponseCurveComponent::updateChain()
+namespace
 {
-    auto chainSettings = getChainSettings(audioProcessor.apvts);
+    /** One point per pixel column, log spaced from 20 Hz to 20 kHz. */
+    DspKernels::FrequencyGrid makeFrequencyGrid(int width, double sampleRate)
+    {
+        std::vector<double> frequencies;
+
+        for (int i = 0; i < width; ++i)
+            frequencies.push_back(juce::mapToLog10(double(i) / double(width), 20.0, 20000.0));
+
+        return { frequencies, sampleRate };
+    }
+
+    // The response of one channel (left/mid or right/side) across the area,
+    // one point per grid frequency, +-12 dB top to bottom.
+    juce::Path makeResponseCurve(const EqChain& chain, size_t channel, const DspKernels::FrequencyGrid& grid,
+        juce::Rectangle<int> responseArea)
+    {
+        using namespace juce;
+
+        if (grid.size() == 0)
+            return {};
+
+        // Section by section over the whole grid, so the inner loops run on
+        // the widest vectors the CPU has.
+        std::vector<double> mags(grid.size(), 1.0);
+        accumulateMagnitudes(chain, grid, mags.data(), channel);
 
-    monoChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-    monoChain.setBypassed<ChainPositions::LowPeak>(chainSettings.lowPeakBypassed);
-    monoChain.setBypassed<ChainPositions::MidLowPeak>(chainSettings.midlowPeakBypassed);
-    monoChain.setBypassed<ChainPositions::MidPeak>(chainSettings.midPeakBypassed);
-    monoChain.setBypassed<ChainPositions::MidHighPeak>(chainSettings.midhighPeakBypassed);
-    monoChain.setBypassed<ChainPositions::HighPeak>(chainSettings.highPeakBypassed);
-    monoChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+        const double outputMin = responseArea.getBottom();
+        const double outputMax = responseArea.getY();
+        auto map = [outputMin, outputMax](double input)
+            {
+                return jmap(input, -12.0, 12.0, outputMin, outputMax);
+            };
 
-    auto lowPeakCoefficients = makeLowPeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::LowPeak>().coefficients, lowPeakCoefficients);
-    auto midlowPeakCoefficients = makeMidLowPeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::MidLowPeak>().coefficients, midlowPeakCoefficients);
-    auto midPeakCoefficients = makeMidPeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::MidPeak>().coefficients, midPeakCoefficients);
-    auto midhighPeakCoefficients = makeMidHighPeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::MidHighPeak>().coefficients, midhighPeakCoefficients);
-    auto highPeakCoefficients = makeHighPeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::HighPeak>().coefficients, highPeakCoefficients);
+        Path responsiveCurve;
 
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
+        for (size_t i = 0; i < mags.size(); ++i)
+        {
+            auto y = map(Decibels::gainToDecibels(mags[i]));
 
-    updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+            if (i == 0)
+                responsiveCurve.startNewSubPath(responseArea.getX(), y);
+            else
+                responsiveCurve.lineTo(responseArea.getX() + (int)i, y);
+        }
 
+        return responsiveCurve;
+    }
 }
 
-void ResponseCurveComponent::paint(juce::Graphics& g)
+void ResponseCurveComponent::updateChain()
 {
-    using namespace juce;
+    auto chainSettings = getChainSettings(audioProcessor.apvts);
+    auto sampleRate = audioProcessor.getSampleRate();
 
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll(Colours::black);
+    auto isRouted = [](ChannelRouting routing) { return routing != ChannelRouting::Both; };
 
-    g.drawImage(background, getLocalBounds().toFloat());
+    // Unlinked channels don't use the routing, and each get a curve of their own.
+    channelsDiffer = !chainSettings.channelsLinked
+        || isRouted(chainSettings.lowCutChannels) || isRouted(chainSettings.highCutChannels)
+        || std::any_of(chainSettings.peaks.begin(), chainSettings.peaks.end(),
+            [&](const PeakSettings& peak) { return isRouted(peak.channels); });
 
-    auto responseArea = getAnalysisArea(); 
+    // Only needed while the curves are measured, so it doesn't have to stay around.
+    EqChain chain;
+    updateEqChain(chain, chainSettings, sampleRate);
 
-    auto w = responseArea.getWidth();
+    auto responseArea = getAnalysisArea();
+    auto grid = makeFrequencyGrid(responseArea.getWidth(), sampleRate);
 
-    auto& lowcut = monoChain.get<ChainPositions::LowCut>();
-    auto& lowpeak = monoChain.get<ChainPositions::LowPeak>();
-    auto& midlowpeak = monoChain.get<ChainPositions::MidLowPeak>();
-    auto& midpeak = monoChain.get<ChainPositions::MidPeak>();
-    auto& midhighpeak = monoChain.get<ChainPositions::MidHighPeak>();
-    auto& highpeak = monoChain.get<ChainPositions::HighPeak>();
-    auto& highcut = monoChain.get<ChainPositions::HighCut>();
+    responseCurves[0] = makeResponseCurve(chain, 0, grid, responseArea);
+    responseCurves[1] = channelsDiffer ? makeResponseCurve(chain, 1, grid, responseArea) : juce::Path();
+}
 
-    auto sampleRate = audioProcessor.getSampleRate();
+void ResponseCurveComponent::paint(juce::Graphics& g)
+{
+    using namespace juce;
 
-    std::vector<double> mags;
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
 
-    mags.resize(w);
+    if (spectrogram != nullptr)
+        drawSpectrogram(g, scale);
 
-    for (int i = 0; i < w; ++i)
     {
-        double mag = 1.f;
-        auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
+        Graphics::ScopedSaveState state(g);
 
-        if (!monoChain.isBypassed<ChainPositions::LowPeak>())
-            mag *= lowpeak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!monoChain.isBypassed<ChainPositions::MidLowPeak>())
-            mag *= midlowpeak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!monoChain.isBypassed<ChainPositions::MidPeak>())
-            mag *= midpeak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!monoChain.isBypassed<ChainPositions::MidHighPeak>())
-            mag *= midhighpeak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!monoChain.isBypassed<ChainPositions::HighPeak>())
-            mag *= highpeak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
+        // The spectrogram covers the analysis area, so the grid is only needed around it.
+        if (spectrogram != nullptr)
+            g.excludeClipRegion(getAnalysisArea());
 
-        if (!monoChain.isBypassed<ChainPositions::LowCut>())
-        {
-            if (!lowcut.isBypassed<0>())
-                mag *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!lowcut.isBypassed<1>())
-                mag *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!lowcut.isBypassed<2>())
-                mag *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!lowcut.isBypassed<3>())
-                mag *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
+        // (Our component is opaque, so we must completely fill the background with a solid colour)
+        g.fillAll(Colours::black);
 
-        if (!monoChain.isBypassed<ChainPositions::HighCut>())
-        {
-            if (!highcut.isBypassed<0>())
-                mag *= highcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!highcut.isBypassed<1>())
-                mag *= highcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!highcut.isBypassed<2>())
-                mag *= highcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!highcut.isBypassed<3>())
-                mag *= highcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
+        // Every editor is the same size, so they all end up sharing one grid.
+        auto background = resources->getLayer("ResponseGrid", getWidth(), getHeight(), scale, true,
+            [this](Graphics& layer) { drawBackground(layer); });
 
-        mags[i] = Decibels::gainToDecibels(mag);
+        g.drawImage(background, getLocalBounds().toFloat());
     }
 
-    Path responsiveCurve;
+    if (compareSubscription != nullptr)
+        drawComparison(g);
 
-    const double outputMin = responseArea.getBottom();
-    const double outputMax = responseArea.getY();
-    auto map = [outputMin, outputMax](double input)
-        {
-            return jmap(input, -12.0, 12.0, outputMin, outputMax);
-        };
+    if (channelsDiffer)
+    {
+        g.setColour(Colours::orange);
+        g.strokePath(responseCurves[1], PathStrokeType(2.f));
+    }
 
-    responsiveCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
+    g.setColour(Colours::white);
+    g.strokePath(responseCurves[0], PathStrokeType(2.f));
 
-    for (size_t i = 1; i < mags.size(); ++i)
+    // Only worth mentioning when the CPU has pushed the quality down.
+    if (qualityLevel != QualityScheduler::Level::Full)
     {
-        responsiveCurve.lineTo(responseArea.getX() + i, map(mags[i]));
+        g.setColour(Colours::orange);
+        g.setFont(10.f);
+        g.drawText(String("CPU: ") + QualityScheduler::getName(qualityLevel) + " quality",
+            getAnalysisArea().reduced(4).removeFromBottom(12), Justification::bottomLeft);
     }
 
-    g.setColour(Colours::white);
-    g.strokePath(responsiveCurve, PathStrokeType(2.f));
+    if (resonanceDetector != nullptr)
+        drawNotchSuggestions(g);
+
+    if (matchAnalyser != nullptr)
+        drawMatchTarget(g);
 
+    drawLoudness(g);
 }
 
 void ResponseCurveComponent::resized()
 {
-    using namespace juce;
-    background = Image(Image::PixelFormat::RGB, getWidth(), getHeight(), true);
-
-    Graphics g(background);
+    updateChain();
+}
 
-    Array<float> freqs
-    {
-        20, /*30, 40,*/ 50, 100,
-        200, /*300, 400,*/ 500, 1000,
-        2000, /*3000, 4000,*/ 5000, 10000,
-        20000
-    };
+void ResponseCurveComponent::mouseDoubleClick(const juce::MouseEvent&)
+{
+    audioProcessor.resetLoudness();
+}
 
-    auto renderArea = getAnalysisArea();
-    auto left = renderArea.getX();
-    auto right = renderArea.getRight();
-    auto top = renderArea.getY();
-    auto bottom = renderArea.getBottom();
-    auto width = renderArea.getWidth();
+void ResponseCurveComponent::mouseUp(const juce::MouseEvent& event)
+{
+    if (event.mouseWasDraggedSinceMouseDown() || event.getNumberOfClicks() > 1)
+        return;
 
-    Array<float> xs;
-    for (auto f : freqs)
+    for (const auto& notch : notchSuggestions)
     {
-        auto normX = mapFromLog10(f, 20.f, 20000.f);
-        xs.add(left + width * normX);
+        if (getNotchMarkerArea(notch).expanded(2).contains(event.getPosition()))
+        {
+            audioProcessor.applyNotches({ notch });
+            return;
+        }
     }
+}
 
-    g.setColour(Colours::dimgrey);
-    
-    for (auto x : xs)
-    {
-        g.drawVerticalLine(x, float(top), float(bottom));
-    }
+void ResponseCurveComponent::setDetectingResonances(bool shouldDetect)
+{
+    if (shouldDetect == isDetectingResonances())
+        return;
 
-    Array<float> gain
-    {
-        -12, -6, 0, 6, 12
-    };
+    auto& tap = audioProcessor.getResonanceTap();
 
-    for (auto gDB : gain)
+    if (shouldDetect)
     {
-        auto y = jmap(gDB, -12.f, 12.f, float(bottom), float(top));
-        
-        g.setColour(gDB == 0.f ? Colour(0u, 172u, 1u) : Colours::darkgrey);
-        g.drawHorizontalLine(y, left, right);
+        resonanceDetector = std::make_unique<ResonanceDetector>(tap);
+        tap.setEnabled(true);
     }
-
-    g.setColour(Colours::lightgrey);
-    const int fontHeight = 10;
-    g.setFont(fontHeight);
-
-    for (int i = 0; i < freqs.size(); ++i)
+    else
     {
-        auto f = freqs[i];
-        auto x = xs[i];
-
-        bool addK = false;
-        String str;
-        if (f > 999.f)
-        {
-            addK = true;
-            f /= 1000.f;
-        }
+        tap.setEnabled(false);
+        resonanceDetector.reset();
+    }
 
-        str << f;
-        if (addK)
-            str << "k";
-        str << "Hz";
+    notchSuggestions.clear();
+    resonanceStatistics = {};
+    repaint();
+}
 
-        auto textWidth = g.getCurrentFont().getStringWidth(str);
+juce::Rectangle<int> ResponseCurveComponent::getNotchMarkerArea(const NotchSuggestion& notch)
+{
+    auto area = getAnalysisArea();
+    auto x = area.getX() + juce::roundToInt(area.getWidth() * juce::mapFromLog10(notch.frequency, 20.f, 20000.f));
 
-        Rectangle<int> r;
-        r.setSize(textWidth, fontHeight);
-        r.setCentre(x, 0);
-        r.setY(1);
+    return { x - 6, area.getY(), 12, 24 };
+}
 
-        g.drawFittedText(str, r, juce::Justification::centred, 1);
+void ResponseCurveComponent::drawNotchSuggestions(juce::Graphics& g)
+{
+    using namespace juce;
 
-    }
+    g.setFont(10.f);
 
-    for (auto gDB : gain)
+    // A marker in the colour of the band that would take it, pointing down
+    // at the resonance, with the cut underneath.
+    for (const auto& notch : notchSuggestions)
     {
-        auto y = jmap(gDB, -12.f, 12.f, float(bottom), float(top));
+        auto area = getNotchMarkerArea(notch).toFloat();
+        auto triangle = area.removeFromTop(10.f);
 
-        String str;
-        if (gDB > 0)
-            str << "+";
-        str << gDB;
+        Path marker;
+        marker.addTriangle(triangle.getTopLeft(), triangle.getTopRight(), { triangle.getCentreX(), triangle.getBottom() });
 
-        auto textWidth = g.getCurrentFont().getStringWidth(str);
+        g.setColour(getBandColour(notch.band));
+        g.fillPath(marker);
 
-        Rectangle<int> r;
-        r.setSize(textWidth, fontHeight);
-        r.setX(getWidth() - textWidth);
-        r.setCentre(r.getCentreX(), y);
+        g.drawText(String(notch.gainInDecibels, 1), area.withSizeKeepingCentre(40.f, area.getHeight()),
+            Justification::centredTop);
+    }
 
-        g.setColour(gDB == 0.f ? Colour(0u, 172u, 1u) : Colours::lightgrey);
+    g.setColour(Colours::lightgrey);
+    g.drawText("Resonances: " + String((int)notchSuggestions.size()) + ", click to notch, "
+        + String(resonanceStatistics.cpuShare * 100.0, 2) + "% CPU",
+        getAnalysisArea().reduced(4).removeFromBottom(12), Justification::bottomRight);
+}
 
-        g.drawFittedText(str, r, juce::Justification::centred, 1);
+void ResponseCurveComponent::startMatching(const juce::File& reference)
+{
+    stopMatching();
 
-        //str.clear();
-        //str << (gDB - 12.f);
+    auto& tap = audioProcessor.getMatchTap();
 
-        r.setX(1);
-        textWidth = g.getCurrentFont().getStringWidth(str);
-        r.setSize(textWidth, fontHeight);
-        g.setColour(gDB == 0.f ? Colour(0u, 172u, 1u) : Colours::lightgrey);
-        g.drawFittedText(str, r, juce::Justification::centred, 1);
+    matchAnalyser = std::make_unique<MatchEqAnalyser>(tap, reference);
+    tap.setEnabled(true);
 
-    }
+    updateMatchTarget();
 }
 
-juce::Rectangle<int> ResponseCurveComponent::getRenderArea()
+void ResponseCurveComponent::stopMatching()
 {
-    auto bounds = getLocalBounds();
-
-    //bounds.reduce(10, //JUCE_LIVE_CONSTANT(5), 
-    //    8 //JUCE_LIVE_CONSTANT(5)
-    //    );
+    if (!isMatching())
+        return;
 
-    bounds.removeFromTop(12);
-    bounds.removeFromBottom(2);
-    bounds.removeFromLeft(20);
-    bounds.removeFromRight(20);
+    audioProcessor.getMatchTap().setEnabled(false);
+    matchAnalyser.reset();
 
-    return bounds;
+    matchTarget = {};
+    matchCurve.clear();
+    matchStatus.clear();
+    repaint(getAnalysisArea());
 }
 
-juce::Rectangle<int> ResponseCurveComponent::getAnalysisArea()
+bool ResponseCurveComponent::applyMatch()
 {
-    auto bounds = getRenderArea();
+    if (!isMatching() || matchTarget.isEmpty())
+        return false;
 
-    bounds.removeFromTop(4);
+    auto sampleRate = audioProcessor.getSampleRate();
+    auto fit = fitMatchEq(matchTarget, getChainSettings(audioProcessor.apvts), sampleRate > 0 ? sampleRate : 48000.0);
+
+    audioProcessor.applyMatch(fit.settings);
+    stopMatching();
+
+    return true;
+}
+
+void ResponseCurveComponent::updateMatchTarget()
+{
+    using namespace juce;
+
+    const auto name = matchAnalyser->getReferenceFile().getFileName();
+    String status;
+
+    switch (matchAnalyser->getState())
+    {
+        case MatchEqAnalyser::State::LoadingReference:
+            status = "Match: analysing " + name;
+            break;
+
+        case MatchEqAnalyser::State::Failed:
+            status = "Match: can't read " + name;
+            break;
+
+        case MatchEqAnalyser::State::Listening:
+            matchTarget = matchAnalyser->getTarget();
+            status = "Match: " + String(roundToInt(matchAnalyser->getInputSeconds())) + " s of input against " + name
+                + (matchTarget.isEmpty() ? ", play something" : "");
+            break;
+    }
+
+    // The target where there's something to measure, +-12 dB top to bottom like the response.
+    auto area = getAnalysisArea().toFloat();
+    Path curve;
+    bool drawing = false;
+
+    for (size_t i = 0; i < matchTarget.frequencies.size(); ++i)
+    {
+        if (matchTarget.weights[i] == 0)
+        {
+            drawing = false;
+            continue;
+        }
+
+        auto x = area.getX() + area.getWidth() * mapFromLog10((float)matchTarget.frequencies[i], 20.f, 20000.f);
+        auto y = jmap(jlimit(-12.f, 12.f, matchTarget.decibels[i]), -12.f, 12.f, area.getBottom(), area.getY());
+
+        if (drawing)
+            curve.lineTo(x, y);
+        else
+            curve.startNewSubPath(x, y);
+
+        drawing = true;
+    }
+
+    if (status != matchStatus || curve != matchCurve)
+    {
+        matchStatus = status;
+        matchCurve = std::move(curve);
+        repaint(getAnalysisArea());
+    }
+}
+
+void ResponseCurveComponent::drawMatchTarget(juce::Graphics& g)
+{
+    using namespace juce;
+
+    Path dashed;
+    const float dashes[]{ 4.f, 3.f };
+    PathStrokeType(1.5f).createDashedStroke(dashed, matchCurve, dashes, (int)std::size(dashes));
+
+    g.setColour(Colours::skyblue);
+    g.fillPath(dashed);
+
+    g.setFont(10.f);
+    g.drawText(matchStatus, getAnalysisArea().reduced(4).removeFromTop(12), Justification::topLeft);
+}
+
+void ResponseCurveComponent::setComparedInstance(int slot)
+{
+    if (slot == comparedSlot)
+        return;
+
+    comparedSlot = slot;
+
+    if (slot < 0)
+    {
+        compareSubscription.reset();
+        ownSpectrum.clear();
+        comparedSpectrum.clear();
+        maskedRanges.clear();
+        compareStatus.clear();
+        repaint(getAnalysisArea());
+        return;
+    }
+
+    if (compareSubscription == nullptr)
+        compareSubscription = std::make_unique<SpectrumRegistry::Subscription>(audioProcessor.getSpectrumRegistry());
+
+    updateComparison();
+}
+
+void ResponseCurveComponent::updateComparison()
+{
+    using namespace juce;
+
+    auto& registry = audioProcessor.getSpectrumRegistry();
+    const auto name = registry.getName(comparedSlot);
+
+    // The other instance has gone.
+    if (name.isEmpty())
+    {
+        setComparedInstance(-1);
+        return;
+    }
+
+    auto area = getAnalysisArea().toFloat();
+
+    auto getX = [&](double proportion) { return area.getX() + area.getWidth() * (float)proportion; };
+
+    // The same -100 to 0 dBFS from bottom to top for both, so they can be
+    // compared. A filled one is closed along the bottom.
+    auto makeSpectrum = [&](const SpectrumRegistry::Levels& levels, bool filled)
+        {
+            auto getY = [&](size_t band)
+                {
+                    return jmap(levels[band], SpectrumRegistry::minimumDecibels, 0.f, area.getBottom(), area.getY());
+                };
+
+            Path spectrum;
+
+            if (filled)
+            {
+                spectrum.startNewSubPath(area.getBottomLeft());
+                spectrum.lineTo(area.getX(), getY(0));
+            }
+            else
+            {
+                spectrum.startNewSubPath(area.getX(), getY(0));
+            }
+
+            for (size_t i = 0; i < levels.size(); ++i)
+                spectrum.lineTo(getX(((double)i + 0.5) / SpectrumRegistry::numBands), getY(i));
+
+            spectrum.lineTo(area.getRight(), getY(levels.size() - 1));
+
+            if (filled)
+            {
+                spectrum.lineTo(area.getBottomRight());
+                spectrum.closeSubPath();
+            }
+
+            return spectrum;
+        };
+
+    SpectrumRegistry::Levels own, other;
+    const auto hasOwn = registry.getLevels(audioProcessor.getSpectrumSlot(), own);
+    const auto hasOther = registry.getLevels(comparedSlot, other);
+
+    ownSpectrum = hasOwn ? makeSpectrum(own, false) : Path();
+    comparedSpectrum = hasOther ? makeSpectrum(other, true) : Path();
+    maskedRanges.clear();
+
+    if (hasOwn && hasOther)
+    {
+        auto masked = SpectrumRegistry::getMaskedBands(own, other);
+
+        // One shaded range for every run of masked bands.
+        for (int i = 0; i < SpectrumRegistry::numBands; ++i)
+        {
+            if (!masked[(size_t)i])
+                continue;
+
+            auto end = i;
+
+            while (end + 1 < SpectrumRegistry::numBands && masked[(size_t)end + 1])
+                ++end;
+
+            maskedRanges.push_back({ getX((double)i / SpectrumRegistry::numBands),
+                getX((double)(end + 1) / SpectrumRegistry::numBands) });
+            i = end;
+        }
+
+        compareStatus = "Masking with " + name + ": " + String((int)maskedRanges.size())
+            + (maskedRanges.size() == 1 ? " region" : " regions");
+    }
+    else
+    {
+        compareStatus = "Comparing with " + name + ", play something";
+    }
+
+    repaint(getAnalysisArea());
+}
+
+void ResponseCurveComponent::drawComparison(juce::Graphics& g)
+{
+    using namespace juce;
+
+    auto area = getAnalysisArea().toFloat();
+
+    g.setColour(Colours::red.withAlpha(0.2f));
+
+    for (const auto& range : maskedRanges)
+        g.fillRect(Rectangle<float>::leftTopRightBottom(range.getStart(), area.getY(), range.getEnd(), area.getBottom()));
+
+    g.setColour(Colours::mediumpurple.withAlpha(0.35f));
+    g.fillPath(comparedSpectrum);
+
+    g.setColour(Colours::lightgreen.withAlpha(0.6f));
+    g.strokePath(ownSpectrum, PathStrokeType(1.f));
+
+    g.setColour(Colours::lightgrey);
+    g.setFont(10.f);
+    g.drawText(compareStatus, area.reduced(4.f).removeFromBottom(24.f).removeFromTop(12.f), Justification::centred);
+}
+
+void ResponseCurveComponent::setSpectrogramVisible(bool shouldBeVisible)
+{
+    if (shouldBeVisible == isSpectrogramVisible())
+        return;
+
+    auto& fifo = audioProcessor.getSpectrumFifo();
+
+    if (shouldBeVisible)
+    {
+        spectrogram = std::make_unique<SpectrogramAnalyser>(fifo);
+        fifo.setEnabled(true);
+    }
+    else
+    {
+        fifo.setEnabled(false);
+        spectrogram.reset();
+        spectrogramImage = {};
+    }
+
+    repaint();
+}
+
+namespace
+{
+    /** Black through blue, purple, orange and yellow to white, one colour per level. */
+    const std::array<juce::PixelARGB, 256>& getSpectrogramPalette()
+    {
+        static const auto palette = []
+            {
+                juce::ColourGradient gradient(juce::Colours::black, 0.f, 0.f, juce::Colours::white, 1.f, 0.f, false);
+                gradient.addColour(0.35, juce::Colour(20u, 10u, 90u));
+                gradient.addColour(0.6, juce::Colours::purple);
+                gradient.addColour(0.8, juce::Colours::orange);
+                gradient.addColour(0.92, juce::Colours::yellow);
+
+                std::array<juce::PixelARGB, 256> table;
+                gradient.createLookupTable(table.data(), (int)table.size());
+                return table;
+            }();
+
+        return palette;
+    }
+
+    template <typename PixelType>
+    void writeSpectrogramRow(juce::Image::BitmapData& pixels, const std::vector<juce::uint8>& levels)
+    {
+        const auto& palette = getSpectrogramPalette();
+        auto* line = pixels.getLinePointer(0);
+
+        for (int x = 0; x < pixels.width; ++x)
+            reinterpret_cast<PixelType*>(line + x * pixels.pixelStride)->set(palette[levels[(size_t)x]]);
+    }
+}
+
+bool ResponseCurveComponent::updateSpectrogram()
+{
+    if (spectrogram == nullptr || !spectrogramImage.isValid())
+        return false;
+
+    const auto width = spectrogramImage.getWidth();
+    const auto height = spectrogramImage.getHeight();
+    auto updated = false;
+
+    while (spectrogram->popRow(spectrogramLevels.data(), width))
+    {
+        spectrogramRow = (spectrogramRow + height - 1) % height;
+
+        // Only the new row is touched, straight in the image's own pixels.
+        juce::Image::BitmapData pixels(spectrogramImage, 0, spectrogramRow, width, 1,
+            juce::Image::BitmapData::writeOnly);
+
+        if (pixels.pixelFormat == juce::Image::PixelFormat::RGB)
+            writeSpectrogramRow<juce::PixelRGB>(pixels, spectrogramLevels);
+        else
+            writeSpectrogramRow<juce::PixelARGB>(pixels, spectrogramLevels);
+
+        updated = true;
+    }
+
+    return updated;
+}
+
+void ResponseCurveComponent::drawSpectrogram(juce::Graphics& g, float scale)
+{
+    using namespace juce;
+
+    // One row per physical pixel, so the image never has to be resampled.
+    auto pixelArea = (getAnalysisArea().toFloat() * scale).getSmallestIntegerContainer();
+    auto width = jmin(pixelArea.getWidth(), SpectrogramAnalyser::maxRowWidth);
+    auto height = pixelArea.getHeight();
+
+    if (width <= 0 || height <= 0)
+        return;
+
+    if (spectrogramImage.getWidth() != width || spectrogramImage.getHeight() != height)
+    {
+        spectrogramImage = Image(Image::PixelFormat::RGB, width, height, true);
+        spectrogramRow = 0;
+        spectrogramLevels.resize((size_t)width);
+        spectrogram->setRowWidth(width);
+    }
+
+    // Back in physical pixels the image lands one to one on the screen, which
+    // keeps each piece a straight copy. The rows from the newest to the
+    // bottom of the image go at the top, and the rest follow underneath.
+    Graphics::ScopedSaveState state(g);
+    g.addTransform(AffineTransform::scale(1.f / scale));
+
+    auto newest = height - spectrogramRow;
+    g.drawImageAt(spectrogramImage.getClippedImage({ 0, spectrogramRow, width, newest }),
+        pixelArea.getX(), pixelArea.getY());
+
+    if (spectrogramRow > 0)
+        g.drawImageAt(spectrogramImage.getClippedImage({ 0, 0, width, spectrogramRow }),
+            pixelArea.getX(), pixelArea.getY() + newest);
+}
+
+namespace
+{
+    juce::String formatLoudness(float value)
+    {
+        return value > LoudnessMeter::silence ? juce::String(value, 1) : juce::String("-inf");
+    }
+}
+
+void ResponseCurveComponent::drawLoudness(juce::Graphics& g)
+{
+    using namespace juce;
+
+    auto area = getLoudnessArea();
+
+    g.setColour(Colours::lightgrey);
+    g.setFont(10.f);
+
+    auto drawLine = [&](const String& text)
+        {
+            g.drawText(text, area.removeFromTop(12), Justification::topRight);
+        };
+
+    drawLine("In  M " + formatLoudness(inputLoudness.momentary)
+        + "  S " + formatLoudness(inputLoudness.shortTerm)
+        + "  I " + formatLoudness(inputLoudness.integrated) + " LUFS");
+
+    drawLine("Out  M " + formatLoudness(outputLoudness.momentary)
+        + "  S " + formatLoudness(outputLoudness.shortTerm)
+        + "  I " + formatLoudness(outputLoudness.integrated) + " LUFS");
+
+    drawLine("TP " + formatLoudness(outputLoudness.truePeak) + " dBTP");
+
+    if (autoGainDecibels != 0.f)
+        drawLine("Auto gain " + String(autoGainDecibels, 1) + " dB");
+}
+
+void ResponseCurveComponent::drawBackground(juce::Graphics& g)
+{
+    using namespace juce;
+
+    Array<float> freqs
+    {
+        20, /*30, 40,*/ 50, 100,
+        200, /*300, 400,*/ 500, 1000,
+        2000, /*3000, 4000,*/ 5000, 10000,
+        20000
+    };
+
+    auto renderArea = getAnalysisArea();
+    auto left = renderArea.getX();
+    auto right = renderArea.getRight();
+    auto top = renderArea.getY();
+    auto bottom = renderArea.getBottom();
+    auto width = renderArea.getWidth();
+
+    Array<float> xs;
+    for (auto f : freqs)
+    {
+        auto normX = mapFromLog10(f, 20.f, 20000.f);
+        xs.add(left + width * normX);
+    }
+
+    g.setColour(Colours::dimgrey);
+    
+    for (auto x : xs)
+    {
+        g.drawVerticalLine(x, float(top), float(bottom));
+    }
+
+    Array<float> gain
+    {
+        -12, -6, 0, 6, 12
+    };
+
+    for (auto gDB : gain)
+    {
+        auto y = jmap(gDB, -12.f, 12.f, float(bottom), float(top));
+        
+        g.setColour(gDB == 0.f ? Colour(0u, 172u, 1u) : Colours::darkgrey);
+        g.drawHorizontalLine(y, left, right);
+    }
+
+    g.setColour(Colours::lightgrey);
+    const int fontHeight = 10;
+    g.setFont(fontHeight);
+
+    for (int i = 0; i < freqs.size(); ++i)
+    {
+        auto f = freqs[i];
+        auto x = xs[i];
+
+        bool addK = false;
+        String str;
+        if (f > 999.f)
+        {
+            addK = true;
+            f /= 1000.f;
+        }
+
+        str << f;
+        if (addK)
+            str << "k";
+        str << "Hz";
+
+        auto textWidth = g.getCurrentFont().getStringWidth(str);
+
+        Rectangle<int> r;
+        r.setSize(textWidth, fontHeight);
+        r.setCentre(x, 0);
+        r.setY(1);
+
+        g.drawFittedText(str, r, juce::Justification::centred, 1);
+
+    }
+
+    for (auto gDB : gain)
+    {
+        auto y = jmap(gDB, -12.f, 12.f, float(bottom), float(top));
+
+        String str;
+        if (gDB > 0)
+            str << "+";
+        str << gDB;
+
+        auto textWidth = g.getCurrentFont().getStringWidth(str);
+
+        Rectangle<int> r;
+        r.setSize(textWidth, fontHeight);
+        r.setX(getWidth() - textWidth);
+        r.setCentre(r.getCentreX(), y);
+
+        g.setColour(gDB == 0.f ? Colour(0u, 172u, 1u) : Colours::lightgrey);
+
+        g.drawFittedText(str, r, juce::Justification::centred, 1);
+
+        //str.clear();
+        //str << (gDB - 12.f);
+
+        r.setX(1);
+        textWidth = g.getCurrentFont().getStringWidth(str);
+        r.setSize(textWidth, fontHeight);
+        g.setColour(gDB == 0.f ? Colour(0u, 172u, 1u) : Colours::lightgrey);
+        g.drawFittedText(str, r, juce::Justification::centred, 1);
+
+    }
+}
+
+juce::Rectangle<int> ResponseCurveComponent::getRenderArea()
+{
+    auto bounds = getLocalBounds();
+
+    //bounds.reduce(10, //JUCE_LIVE_CONSTANT(5), 
+    //    8 //JUCE_LIVE_CONSTANT(5)
+    //    );
+
+    bounds.removeFromTop(12);
+    bounds.removeFromBottom(2);
+    bounds.removeFromLeft(20);
+    bounds.removeFromRight(20);
+
+    return bounds;
+}
+
+juce::Rectangle<int> ResponseCurveComponent::getAnalysisArea()
+{
+    auto bounds = getRenderArea();
+
+    bounds.removeFromTop(4);
     bounds.removeFromBottom(4);
 
-    return bounds;
+    return bounds;
+}
+
+juce::Rectangle<int> ResponseCurveComponent::getLoudnessArea()
+{
+    return getAnalysisArea().reduced(4).removeFromRight(220).removeFromTop(48);
+}
+
+//==============================================================================
+namespace
+{
+    constexpr float meterMinimumDecibels = -60.f, meterMaximumDecibels = 6.f;
+}
+
+LevelMeterComponent::LevelMeterComponent(TradeMarkEQAudioProcessor& p) : audioProcessor(p)
+{
+    setOpaque(true);
+    startTimerHz(30);
+}
+
+void LevelMeterComponent::timerCallback()
+{
+    auto geometry = layOut(audioProcessor.getInputLevels(), audioProcessor.getOutputLevels());
+
+    if (!(geometry == drawn))
+    {
+        drawn = geometry;
+        repaint();
+    }
+}
+
+LevelMeterComponent::Geometry LevelMeterComponent::layOut(const LevelMeter::Levels& input,
+    const LevelMeter::Levels& output)
+{
+    Geometry geometry;
+
+    for (size_t ch = 0; ch < 2; ++ch)
+    {
+        geometry.peak[ch] = getLevelY(input.peak[ch]);
+        geometry.rms[ch] = getLevelY(input.rms[ch]);
+        geometry.peak[2 + ch] = getLevelY(output.peak[ch]);
+        geometry.rms[2 + ch] = getLevelY(output.rms[ch]);
+    }
+
+    auto area = getCorrelationArea();
+    geometry.correlation = juce::roundToInt(juce::jmap(output.correlation, -1.f, 1.f,
+        (float)area.getX(), (float)area.getRight() - 3.f));
+
+    return geometry;
+}
+
+void LevelMeterComponent::paint(juce::Graphics& g)
+{
+    using namespace juce;
+
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    auto background = resources->getLayer("LevelMeterScale", getWidth(), getHeight(), scale, true,
+        [this](Graphics& layer) { drawBackground(layer); });
+
+    g.drawImage(background, getLocalBounds().toFloat());
+
+    const auto zeroY = getLevelY(0.f);
+
+    for (int bar = 0; bar < 4; ++bar)
+    {
+        auto area = getBarArea(bar);
+        auto rms = drawn.rms[(size_t)bar];
+        auto peak = drawn.peak[(size_t)bar];
+
+        g.setColour(Colour(0u, 172u, 1u));
+        g.fillRect(area.withTop(rms));
+
+        if (peak < area.getBottom())
+        {
+            g.setColour(peak < zeroY ? Colours::red : Colours::white);
+            g.fillRect(area.withTop(peak).withHeight(2));
+        }
+    }
+
+    auto correlation = getCorrelationArea();
+
+    g.setColour(drawn.correlation < correlation.getCentreX() - 1 ? Colours::orange : Colour(0u, 172u, 1u));
+    g.fillRect(correlation.withX(drawn.correlation).withWidth(3));
+}
+
+juce::Rectangle<int> LevelMeterComponent::getBarArea(int bar)
+{
+    // Two groups, input and output, of two bars each.
+    auto area = getLocalBounds().reduced(4);
+    area.removeFromTop(12);
+    area.removeFromBottom(16);
+
+    auto group = bar < 2 ? area.removeFromLeft(area.getWidth() / 2) : area.removeFromRight(area.getWidth() / 2);
+    group.reduce(3, 0);
+
+    auto width = (group.getWidth() - 2) / 2;
+    return bar % 2 == 0 ? group.withWidth(width) : group.withTrimmedLeft(group.getWidth() - width);
+}
+
+juce::Rectangle<int> LevelMeterComponent::getCorrelationArea()
+{
+    return getLocalBounds().reduced(4).removeFromBottom(8).reduced(3, 0);
+}
+
+int LevelMeterComponent::getLevelY(float decibels)
+{
+    auto area = getBarArea(0);
+
+    return juce::roundToInt(juce::jmap(juce::jlimit(meterMinimumDecibels, meterMaximumDecibels, decibels),
+        meterMinimumDecibels, meterMaximumDecibels, (float)area.getBottom(), (float)area.getY()));
+}
+
+void LevelMeterComponent::drawBackground(juce::Graphics& g)
+{
+    using namespace juce;
+
+    g.fillAll(Colours::black);
+
+    for (int bar = 0; bar < 4; ++bar)
+    {
+        g.setColour(Colour(0xff202020));
+        g.fillRect(getBarArea(bar));
+    }
+
+    auto left = getBarArea(0).getX();
+    auto right = getBarArea(3).getRight();
+
+    for (auto gDB : { 0.f, -6.f, -12.f, -24.f, -48.f })
+    {
+        g.setColour(gDB == 0.f ? Colour(0u, 172u, 1u) : Colours::darkgrey);
+        g.drawHorizontalLine(getLevelY(gDB), (float)left, (float)right);
+    }
+
+    g.setColour(Colours::lightgrey);
+    g.setFont(10.f);
+
+    auto labels = getLocalBounds().reduced(4).removeFromTop(12);
+    g.drawText("IN", labels.removeFromLeft(labels.getWidth() / 2), Justification::centred);
+    g.drawText("OUT", labels, Justification::centred);
+
+    auto correlation = getCorrelationArea();
+
+    g.setColour(Colour(0xff202020));
+    g.fillRect(correlation);
+
+    g.setColour(Colours::darkgrey);
+    g.drawVerticalLine(correlation.getCentreX(), (float)correlation.getY() - 2.f, (float)correlation.getBottom() + 2.f);
+}
+
+//==============================================================================
+namespace
+{
+    juce::String getFrequencyLabel(float hz)
+    {
+        if (hz < 1000.f)
+            return juce::String(juce::roundToInt(hz)) + "Hz";
+
+        return juce::String(hz / 1000.f, std::fmod(hz, 1000.f) == 0.f ? 0 : 1) + "kHz";
+    }
+}
+
+BandDetailComponent::Knob::Knob(APVTS& apvts, const juce::String& parameterID, const juce::String& knobTitle,
+    const juce::String& unitSuffix) :
+    title(knobTitle),
+    slider(*apvts.getParameter(parameterID), unitSuffix),
+    attachment(apvts, parameterID, slider)
+{
+}
+
+BandDetailComponent::BandDetailComponent(juce::AudioProcessorValueTreeState& apvts, int band)
+{
+    // The "Right / Side" row is the second channel's own settings, which
+    // only apply while the channels are unlinked.
+    secondBypassButton.setClickingTogglesState(true);
+
+    if (band == lowCut || band == highCut)
+    {
+        const juce::String cut(band == lowCut ? "LowCut" : "HighCut");
+
+        auto& modulation = addRow("Modulation");
+        addChoiceBox(modulation, modSourceBox, apvts, cut + " Mod Source");
+        addKnob(modulation, apvts, cut + " Mod Rate", "Rate", "Hz");
+        addKnob(modulation, apvts, cut + " Mod Freq", "Freq", "oct");
+
+        auto& channels = addRow("Channels");
+        addChoiceBox(channels, channelsBox, apvts, cut + " Channels");
+        addChoiceBox(channels, channelModeBox, apvts, "Channel Mode");
+        addChoiceBox(channels, channelLinkBox, apvts, "Channel Link");
+
+        auto& second = addRow("Right / Side");
+        addControl(second, secondBypassButton);
+        addChoiceBox(second, secondSteepBox, apvts, cut + " Steep Slope 2");
+        addKnob(second, apvts, cut + " Freq 2", "Freq", "Hz");
+        addKnob(second, apvts, cut + " Slope 2", "Slope", "");
+
+        secondBypassAttachment = std::make_unique<APVTS::ButtonAttachment>(apvts, cut + " Bypassed 2", secondBypassButton);
+    }
+    else
+    {
+        auto& ids = getPeakParameterIDs(band);
+
+        auto& dynamics = addRow("Dynamics");
+        addControl(dynamics, dynamicButton);
+        addControl(dynamics, sidechainButton);
+        addKnob(dynamics, apvts, ids.threshold, "Threshold", "dB");
+        addKnob(dynamics, apvts, ids.ratio, "Ratio", ":1");
+        addKnob(dynamics, apvts, ids.attack, "Attack", "ms");
+        addKnob(dynamics, apvts, ids.release, "Release", "ms");
+
+        dynamicButton.setClickingTogglesState(true);
+        sidechainButton.setClickingTogglesState(true);
+
+        dynamicAttachment = std::make_unique<APVTS::ButtonAttachment>(apvts, ids.dynamic, dynamicButton);
+        sidechainAttachment = std::make_unique<APVTS::ButtonAttachment>(apvts, "Dynamic Sidechain", sidechainButton);
+
+        auto& modulation = addRow("Modulation");
+        addChoiceBox(modulation, modSourceBox, apvts, ids.modSource);
+        addKnob(modulation, apvts, ids.modRate, "Rate", "Hz");
+        addKnob(modulation, apvts, ids.modFreq, "Freq", "oct");
+        addKnob(modulation, apvts, ids.modGain, "Gain", "dB");
+        addKnob(modulation, apvts, ids.modQuality, "Q", "oct");
+
+        auto& channels = addRow("Channels");
+        addChoiceBox(channels, channelsBox, apvts, ids.channels);
+        addChoiceBox(channels, channelModeBox, apvts, "Channel Mode");
+        addChoiceBox(channels, channelLinkBox, apvts, "Channel Link");
+
+        auto& second = addRow("Right / Side");
+        addControl(second, secondBypassButton);
+        addKnob(second, apvts, ids.secondFreq, "Freq", "Hz");
+        addKnob(second, apvts, ids.secondGain, "Gain", "dB");
+        addKnob(second, apvts, ids.secondQuality, "Q", "");
+
+        secondBypassAttachment = std::make_unique<APVTS::ButtonAttachment>(apvts, ids.secondBypassed, secondBypassButton);
+    }
+
+    auto numKnobs = 0;
+
+    for (auto* row : rows)
+        numKnobs = juce::jmax(numKnobs, row->knobs.size());
+
+    setSize(controlWidth + numKnobs * knobWidth, rows.size() * rowHeight);
+}
+
+void BandDetailComponent::show(juce::AudioProcessorValueTreeState& apvts, int band, juce::Component& button)
+{
+    if (auto* editor = button.findParentComponentOfClass<juce::AudioProcessorEditor>())
+        juce::CallOutBox::launchAsynchronously(std::make_unique<BandDetailComponent>(apvts, band),
+            editor->getLocalArea(&button, button.getLocalBounds()), editor);
+}
+
+BandDetailComponent::Row& BandDetailComponent::addRow(const juce::String& title)
+{
+    auto* row = rows.add(new Row());
+    row->title = title;
+    return *row;
+}
+
+void BandDetailComponent::addKnob(Row& row, APVTS& apvts, const juce::String& parameterID, const juce::String& title,
+    const juce::String& unitSuffix)
+{
+    auto* knob = row.knobs.add(new Knob(apvts, parameterID, title, unitSuffix));
+    addAndMakeVisible(knob->slider);
+}
+
+void BandDetailComponent::addChoiceBox(Row& row, juce::ComboBox& box, APVTS& apvts, const juce::String& parameterID)
+{
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(parameterID)))
+    {
+        for (int i = 0; i < choice->choices.size(); ++i)
+            box.addItem(choice->choices[i], i + 1);
+    }
+
+    boxAttachments.push_back(std::make_unique<APVTS::ComboBoxAttachment>(apvts, parameterID, box));
+    addControl(row, box);
+}
+
+void BandDetailComponent::addControl(Row& row, juce::Component& control)
+{
+    row.controls.push_back(&control);
+    addAndMakeVisible(control);
+}
+
+void BandDetailComponent::paint(juce::Graphics& g)
+{
+    using namespace juce;
+
+    g.fillAll(Colours::black);
+    g.setFont((float)titleHeight - 2.f);
+
+    for (int i = 0; i < rows.size(); ++i)
+    {
+        auto* row = rows[i];
+        auto area = getLocalBounds().withY(i * rowHeight).withHeight(rowHeight);
+
+        if (i > 0)
+        {
+            g.setColour(Colours::darkgrey);
+            g.drawHorizontalLine(area.getY(), 0.f, (float)getWidth());
+        }
+
+        g.setColour(Colours::lightgrey);
+        g.drawFittedText(row->title, area.removeFromLeft(controlWidth).removeFromTop(titleHeight + 4).reduced(4, 2),
+            Justification::centredLeft, 1);
+
+        for (auto* knob : row->knobs)
+            g.drawFittedText(knob->title, area.removeFromLeft(knobWidth).removeFromTop(titleHeight + 4).reduced(2),
+                Justification::centred, 1);
+    }
+}
+
+void BandDetailComponent::resized()
+{
+    for (int i = 0; i < rows.size(); ++i)
+    {
+        auto* row = rows[i];
+        auto area = getLocalBounds().withY(i * rowHeight).withHeight(rowHeight);
+
+        auto controlArea = area.removeFromLeft(controlWidth).reduced(4);
+        controlArea.removeFromTop(titleHeight);
+
+        for (auto* control : row->controls)
+            control->setBounds(controlArea.removeFromTop(24).reduced(0, 2));
+
+        for (auto* knob : row->knobs)
+            knob->slider.setBounds(area.removeFromLeft(knobWidth).withTrimmedTop(titleHeight + 4).reduced(2));
+    }
+}
+
+//==============================================================================
+PeakBandControls::PeakBandControls(juce::AudioProcessorValueTreeState& apvts, int band) :
+    freqSlider(*apvts.getParameter(getPeakParameterIDs(band).freq), "Hz"),
+    gainSlider(*apvts.getParameter(getPeakParameterIDs(band).gain), "dB"),
+    qualitySlider(*apvts.getParameter(getPeakParameterIDs(band).quality), ""),
+    freqSliderAttachment(apvts, getPeakParameterIDs(band).freq, freqSlider),
+    gainSliderAttachment(apvts, getPeakParameterIDs(band).gain, gainSlider),
+    qualitySliderAttachment(apvts, getPeakParameterIDs(band).quality, qualitySlider),
+    bypassButtonAttachment(apvts, getPeakParameterIDs(band).bypassed, bypassButton)
+{
+    auto& info = peakBands[band];
+
+    freqSlider.labels.add({ 0.f, getFrequencyLabel(info.minFreq) });
+    freqSlider.labels.add({ 1.f, getFrequencyLabel(info.maxFreq) });
+    gainSlider.labels.add({ 0.f, "-12dB" });
+    gainSlider.labels.add({ 1.f, "12dB" });
+    qualitySlider.labels.add({ 0.f, "0.1" });
+    qualitySlider.labels.add({ 1.f, "10.0" });
+
+    bypassButton.onClick = [this]()
+        {
+            auto bypassed = bypassButton.getToggleState();
+
+            freqSlider.setEnabled(!bypassed);
+            gainSlider.setEnabled(!bypassed);
+            qualitySlider.setEnabled(!bypassed);
+        };
+
+    moreButton.onClick = [this, &apvts, band]() { BandDetailComponent::show(apvts, band, moreButton); };
+}
+
+void PeakBandControls::setBounds(juce::Rectangle<int> area)
+{
+    auto buttonArea = area.removeFromTop(25);
+    moreButton.setBounds(buttonArea.removeFromRight(44).reduced(2));
+    bypassButton.setBounds(buttonArea);
+    freqSlider.setBounds(area.removeFromTop(area.getHeight() * 0.33));
+    gainSlider.setBounds(area.removeFromTop(area.getHeight() * 0.5));
+    qualitySlider.setBounds(area);
 }
 
 //==============================================================================
 TradeMarkEQAudioProcessorEditor::TradeMarkEQAudioProcessorEditor(TradeMarkEQAudioProcessor& p)
     : AudioProcessorEditor(&p), audioProcessor(p),
-    lowPeakFreqSlider(*audioProcessor.apvts.getParameter("LowPeak Freq"), "Hz"),
-    lowPeakGainSlider(*audioProcessor.apvts.getParameter("LowPeak Gain"), "dB"),
-    lowPeakQualitySlider(*audioProcessor.apvts.getParameter("LowPeak Quality"), ""),
-    midlowPeakFreqSlider(*audioProcessor.apvts.getParameter("MidLowPeak Freq"), "Hz"),
-    midlowPeakGainSlider(*audioProcessor.apvts.getParameter("MidLowPeak Gain"), "dB"),
-    midlowPeakQualitySlider(*audioProcessor.apvts.getParameter("MidLowPeak Quality"), ""),
-    midPeakFreqSlider(*audioProcessor.apvts.getParameter("MidPeak Freq"), "Hz"),
-    midPeakGainSlider(*audioProcessor.apvts.getParameter("MidPeak Gain"), "dB"),
-    midPeakQualitySlider(*audioProcessor.apvts.getParameter("MidPeak Quality"), ""),
-    midhighPeakFreqSlider(*audioProcessor.apvts.getParameter("MidHighPeak Freq"), "Hz"),
-    midhighPeakGainSlider(*audioProcessor.apvts.getParameter("MidHighPeak Gain"), "dB"),
-    midhighPeakQualitySlider(*audioProcessor.apvts.getParameter("MidHighPeak Quality"), ""),
-    highPeakFreqSlider(*audioProcessor.apvts.getParameter("HighPeak Freq"), "Hz"),
-    highPeakGainSlider(*audioProcessor.apvts.getParameter("HighPeak Gain"), "dB"),
-    highPeakQualitySlider(*audioProcessor.apvts.getParameter("HighPeak Quality"), ""),
     lowCutFreqSlider(*audioProcessor.apvts.getParameter("LowCut Freq"), "Hz"),
     highCutFreqSlider(*audioProcessor.apvts.getParameter("HighCut Freq"), "Hz"),
     lowCutSlopeSlider(*audioProcessor.apvts.getParameter("LowCut Slope"), "dB/Oct"),
@@ -596,72 +1628,21 @@ TradeMarkEQAudioProcessorEditor::TradeMarkEQAudioProcessorEditor(TradeMarkEQAudi
 
     headerComponent(audioProcessor.apvts),
     responseCurveComponent(audioProcessor),
+    levelMeterComponent(audioProcessor),
 
-    lowPeakFreqSliderAttachment(audioProcessor.apvts, "LowPeak Freq", lowPeakFreqSlider),
-    lowPeakGainSliderAttachment(audioProcessor.apvts, "LowPeak Gain", lowPeakGainSlider),
-    lowPeakQualitySliderAttachment(audioProcessor.apvts, "LowPeak Quality", lowPeakQualitySlider),
-    midlowPeakFreqSliderAttachment(audioProcessor.apvts, "MidLowPeak Freq", midlowPeakFreqSlider),
-    midlowPeakGainSliderAttachment(audioProcessor.apvts, "MidLowPeak Gain", midlowPeakGainSlider),
-    midlowPeakQualitySliderAttachment(audioProcessor.apvts, "MidLowPeak Quality", midlowPeakQualitySlider),
-    midPeakFreqSliderAttachment(audioProcessor.apvts, "MidPeak Freq", midPeakFreqSlider),
-    midPeakGainSliderAttachment(audioProcessor.apvts, "MidPeak Gain", midPeakGainSlider),
-    midPeakQualitySliderAttachment(audioProcessor.apvts, "MidPeak Quality", midPeakQualitySlider),
-    midhighPeakFreqSliderAttachment(audioProcessor.apvts, "MidHighPeak Freq", midhighPeakFreqSlider),
-    midhighPeakGainSliderAttachment(audioProcessor.apvts, "MidHighPeak Gain", midhighPeakGainSlider),
-    midhighPeakQualitySliderAttachment(audioProcessor.apvts, "MidHighPeak Quality", midhighPeakQualitySlider),
-    highPeakFreqSliderAttachment(audioProcessor.apvts, "HighPeak Freq", highPeakFreqSlider),
-    highPeakGainSliderAttachment(audioProcessor.apvts, "HighPeak Gain", highPeakGainSlider),
-    highPeakQualitySliderAttachment(audioProcessor.apvts, "HighPeak Quality", highPeakQualitySlider),
     lowCutFreqSliderAttachment(audioProcessor.apvts, "LowCut Freq", lowCutFreqSlider),
     highCutFreqSliderAttachment(audioProcessor.apvts, "HighCut Freq", highCutFreqSlider),
     lowCutSlopeSliderAttachment(audioProcessor.apvts, "LowCut Slope", lowCutSlopeSlider),
     highCutSlopeSliderAttachment(audioProcessor.apvts, "HighCut Slope", highCutSlopeSlider),
 
     lowcutBypassButtonAttachment(audioProcessor.apvts, "LowCut Bypassed", lowcutBypassButton),
-    lowpeakBypassButtonAttachment(audioProcessor.apvts, "LowPeak Bypassed", lowpeakBypassButton),
-    midlowpeakBypassButtonAttachment(audioProcessor.apvts, "MidLowPeak Bypassed", midlowpeakBypassButton),
-    midpeakBypassButtonAttachment(audioProcessor.apvts, "MidPeak Bypassed", midpeakBypassButton),
-    midhighpeakBypassButtonAttachment(audioProcessor.apvts, "MidHighPeak Bypassed", midhighpeakBypassButton),
-    highpeakBypassButtonAttachment(audioProcessor.apvts, "HighPeak Bypassed", highpeakBypassButton),
     highcutBypassButtonAttachment(audioProcessor.apvts, "HighCut Bypassed", highcutBypassButton)
 {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
 
-    lowPeakFreqSlider.labels.add({ 0.f, "20Hz" });
-    lowPeakFreqSlider.labels.add({ 1.f, "500Hz" });
-    lowPeakGainSlider.labels.add({ 0.f, "-12dB" });
-    lowPeakGainSlider.labels.add({ 1.f, "12dB" });
-    lowPeakQualitySlider.labels.add({ 0.f, "0.1" });
-    lowPeakQualitySlider.labels.add({ 1.f, "10.0" });
-
-    midlowPeakFreqSlider.labels.add({ 0.f, "40Hz" });
-    midlowPeakFreqSlider.labels.add({ 1.f, "1kHz" });
-    midlowPeakGainSlider.labels.add({ 0.f, "-12dB" });
-    midlowPeakGainSlider.labels.add({ 1.f, "12dB" });
-    midlowPeakQualitySlider.labels.add({ 0.f, "0.1" });
-    midlowPeakQualitySlider.labels.add({ 1.f, "10.0" });
-
-    midPeakFreqSlider.labels.add({ 0.f, "125Hz" });
-    midPeakFreqSlider.labels.add({ 1.f, "8kHz" });
-    midPeakGainSlider.labels.add({ 0.f, "-12dB" });
-    midPeakGainSlider.labels.add({ 1.f, "12dB" });
-    midPeakQualitySlider.labels.add({ 0.f, "0.1" });
-    midPeakQualitySlider.labels.add({ 1.f, "10.0" });
-
-    midhighPeakFreqSlider.labels.add({ 0.f, "200Hz" });
-    midhighPeakFreqSlider.labels.add({ 1.f, "18kHz" });
-    midhighPeakGainSlider.labels.add({ 0.f, "-12dB" });
-    midhighPeakGainSlider.labels.add({ 1.f, "12dB" });
-    midhighPeakQualitySlider.labels.add({ 0.f, "0.1" });
-    midhighPeakQualitySlider.labels.add({ 1.f, "10.0" });
-
-    highPeakFreqSlider.labels.add({ 0.f, "2kHz" });
-    highPeakFreqSlider.labels.add({ 1.f, "20kHz" });
-    highPeakGainSlider.labels.add({ 0.f, "-12dB" });
-    highPeakGainSlider.labels.add({ 1.f, "12dB" });
-    highPeakQualitySlider.labels.add({ 0.f, "0.1" });
-    highPeakQualitySlider.labels.add({ 1.f, "10.0" });
+    for (int i = 0; i < numPeakBands; ++i)
+        peakBandControls.add(new PeakBandControls(audioProcessor.apvts, i));
 
     lowCutFreqSlider.labels.add({ 0.f, "20Hz" });
     lowCutFreqSlider.labels.add({ 1.f, "20kHz" });
@@ -669,149 +1650,217 @@ TradeMarkEQAudioProcessorEditor::TradeMarkEQAudioProcessorEditor(TradeMarkEQAudi
     highCutFreqSlider.labels.add({ 0.f, "20Hz" });
     highCutFreqSlider.labels.add({ 1.f, "20kHz" });
 
-    lowCutSlopeSlider.labels.add({ 0.f, "6" });
-    lowCutSlopeSlider.labels.add({ 1.f, "24" });
+    lowCutSlopeSlider.labels.add({ 0.f, "12" });
+    lowCutSlopeSlider.labels.add({ 1.f, "48" });
 
-    highCutSlopeSlider.labels.add({ 0.f, "6" });
-    highCutSlopeSlider.labels.add({ 1.f, "24" });
+    highCutSlopeSlider.labels.add({ 0.f, "12" });
+    highCutSlopeSlider.labels.add({ 1.f, "48" });
 
     for (auto* comp : getComps())
     {
         addAndMakeVisible(comp);
     }
 
-    lowpeakBypassButton.setLookAndFeel(&lnf);
-    midlowpeakBypassButton.setLookAndFeel(&lnf);
-    midpeakBypassButton.setLookAndFeel(&lnf);
-    midhighpeakBypassButton.setLookAndFeel(&lnf);
-    highpeakBypassButton.setLookAndFeel(&lnf);
-    lowcutBypassButton.setLookAndFeel(&lnf);
-    highcutBypassButton.setLookAndFeel(&lnf);
+    for (auto* band : peakBandControls)
+        band->bypassButton.setLookAndFeel(&resources->lookAndFeel);
+
+    lowcutBypassButton.setLookAndFeel(&resources->lookAndFeel);
+    highcutBypassButton.setLookAndFeel(&resources->lookAndFeel);
 
     auto safePtr = juce::Component::SafePointer<TradeMarkEQAudioProcessorEditor>(this);
-    lowpeakBypassButton.onClick = [safePtr]()
+    for (auto* control : std::initializer_list<juce::Button*>{ &lowcutBypassButton, &highcutBypassButton })
+    {
+        control->onClick = [safePtr]()
+            {
+                if (auto* comp = safePtr.getComponent())
+                    comp->updateCutControls();
+            };
+    }
+
+    for (auto [box, id] : { std::pair{ &lowCutSteepBox, "LowCut Steep Slope" },
+                            std::pair{ &highCutSteepBox, "HighCut Steep Slope" } })
+    {
+        if (auto* steep = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter(id)))
         {
-            if (auto* comp = safePtr.getComponent())
+            box->addItem("Steeper: Off", 1);
+
+            for (int i = 1; i < steep->choices.size(); ++i)
+                box->addItem(steep->choices[i], i + 1);
+        }
+
+        box->onChange = [safePtr]()
             {
-                auto bypassed = comp->lowpeakBypassButton.getToggleState();
+                if (auto* comp = safePtr.getComponent())
+                    comp->updateCutControls();
+            };
+    }
 
-                comp->lowPeakFreqSlider.setEnabled(!bypassed);
-                comp->lowPeakGainSlider.setEnabled(!bypassed);
-                comp->lowPeakQualitySlider.setEnabled(!bypassed);
-            }
-        };
+    for (auto [button, band] : { std::pair{ &lowCutMoreButton, BandDetailComponent::lowCut },
+                                 std::pair{ &highCutMoreButton, BandDetailComponent::highCut } })
+    {
+        button->onClick = [safePtr, button = button, band = band]()
+            {
+                if (auto* comp = safePtr.getComponent())
+                    BandDetailComponent::show(comp->audioProcessor.apvts, band, *button);
+            };
+    }
+
+    lowCutSteepAttachment = std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, "LowCut Steep Slope", lowCutSteepBox);
+    highCutSteepAttachment = std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, "HighCut Steep Slope", highCutSteepBox);
 
-    midlowpeakBypassButton.onClick = [safePtr]()
+    updateCutControls();
+
+
+    auto& presetManager = audioProcessor.getPresetManager();
+
+    presetBox.setTextWhenNothingSelected("Preset");
+    presetBox.onChange = [safePtr]()
         {
             if (auto* comp = safePtr.getComponent())
             {
-                auto bypassed = comp->midlowpeakBypassButton.getToggleState();
+                auto index = comp->presetBox.getSelectedItemIndex();
 
-                comp->midlowPeakFreqSlider.setEnabled(!bypassed);
-                comp->midlowPeakGainSlider.setEnabled(!bypassed);
-                comp->midlowPeakQualitySlider.setEnabled(!bypassed);
+                if (index >= 0 && index != comp->audioProcessor.getPresetManager().getCurrentPreset())
+                    comp->audioProcessor.getPresetManager().loadPreset(index);
             }
         };
 
-    midpeakBypassButton.onClick = [safePtr]()
+    savePresetButton.onClick = [safePtr]()
         {
             if (auto* comp = safePtr.getComponent())
             {
-                auto bypassed = comp->midpeakBypassButton.getToggleState();
-
-                comp->midPeakFreqSlider.setEnabled(!bypassed);
-                comp->midPeakGainSlider.setEnabled(!bypassed);
-                comp->midPeakQualitySlider.setEnabled(!bypassed);
+                auto& manager = comp->audioProcessor.getPresetManager();
+                manager.addPreset("User " + juce::String(manager.getNumPresets() + 1));
+                comp->refreshPresetControls();
             }
         };
 
-    midhighpeakBypassButton.onClick = [safePtr]()
-        {
-            if (auto* comp = safePtr.getComponent())
+    snapshotAButton.setClickingTogglesState(true);
+    snapshotBButton.setClickingTogglesState(true);
+    snapshotAButton.setRadioGroupId(1);
+    snapshotBButton.setRadioGroupId(1);
+
+    for (auto [button, snapshot] : { std::pair{ &snapshotAButton, PresetManager::Snapshot::A },
+                                     std::pair{ &snapshotBButton, PresetManager::Snapshot::B } })
+    {
+        button->onClick = [safePtr, snapshot = snapshot]()
             {
-                auto bypassed = comp->midhighpeakBypassButton.getToggleState();
+                if (auto* comp = safePtr.getComponent())
+                {
+                    comp->audioProcessor.getPresetManager().switchToSnapshot(snapshot);
+                    comp->refreshPresetControls();
+                }
+            };
+    }
 
-                comp->midhighPeakFreqSlider.setEnabled(!bypassed);
-                comp->midhighPeakGainSlider.setEnabled(!bypassed);
-                comp->midhighPeakQualitySlider.setEnabled(!bypassed);
-            }
+    copySnapshotButton.onClick = [safePtr]()
+        {
+            if (auto* comp = safePtr.getComponent())
+                comp->audioProcessor.getPresetManager().copyToOtherSnapshot();
         };
 
-    highpeakBypassButton.onClick = [safePtr]()
+    crossfadeButton.setToggleState(presetManager.isCrossfadeEnabled(), juce::dontSendNotification);
+    crossfadeButton.onClick = [safePtr]()
         {
             if (auto* comp = safePtr.getComponent())
-            {
-                auto bypassed = comp->highpeakBypassButton.getToggleState();
-
-                comp->highPeakFreqSlider.setEnabled(!bypassed);
-                comp->highPeakGainSlider.setEnabled(!bypassed);
-                comp->highPeakQualitySlider.setEnabled(!bypassed);
-            }
+                comp->audioProcessor.getPresetManager().setCrossfadeEnabled(comp->crossfadeButton.getToggleState());
         };
 
-    lowcutBypassButton.onClick = [safePtr]()
+    refreshPresetControls();
+
+    if (auto* autoGain = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Auto Gain")))
+    {
+        for (int i = 0; i < autoGain->choices.size(); ++i)
+            autoGainBox.addItem("Auto gain: " + autoGain->choices[i], i + 1);
+    }
+
+    autoGainAttachment = std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, "Auto Gain", autoGainBox);
+
+    resonanceButton.setClickingTogglesState(true);
+    resonanceButton.onClick = [safePtr]()
         {
             if (auto* comp = safePtr.getComponent())
-            {
-                auto bypassed = comp->lowcutBypassButton.getToggleState();
-
-                comp->lowCutFreqSlider.setEnabled(!bypassed);
-                comp->lowCutSlopeSlider.setEnabled(!bypassed);
-            }
+                comp->responseCurveComponent.setDetectingResonances(comp->resonanceButton.getToggleState());
         };
 
-    highcutBypassButton.onClick = [safePtr]()
+    matchButton.onClick = [safePtr]()
         {
             if (auto* comp = safePtr.getComponent())
-            {
-                auto bypassed = comp->highcutBypassButton.getToggleState();
+                comp->showMatchOptions();
+        };
 
-                comp->highCutFreqSlider.setEnabled(!bypassed);
-                comp->highCutSlopeSlider.setEnabled(!bypassed);
-            }
+    compareButton.onClick = [safePtr]()
+        {
+            if (auto* comp = safePtr.getComponent())
+                comp->showCompareOptions();
         };
 
+    if (audioProcessor.getSampleRate() > 0)
+        exportOptions.sampleRate = audioProcessor.getSampleRate();
 
+    exportButton.onClick = [safePtr]()
+        {
+            if (auto* comp = safePtr.getComponent())
+                comp->showExportOptions();
+        };
+
+    spectrogramButton.setClickingTogglesState(true);
+    spectrogramButton.onClick = [safePtr]()
+        {
+            if (auto* comp = safePtr.getComponent())
+                comp->responseCurveComponent.setSpectrogramVisible(comp->spectrogramButton.getToggleState());
+        };
 
     setSize(550, 500);
+
+    audioProcessor.addChangeListener(this);
+    showStateError();
 }
 
 TradeMarkEQAudioProcessorEditor::~TradeMarkEQAudioProcessorEditor()
 {
-    lowpeakBypassButton.setLookAndFeel(nullptr);
-    midlowpeakBypassButton.setLookAndFeel(nullptr);
-    midpeakBypassButton.setLookAndFeel(nullptr);
-    midhighpeakBypassButton.setLookAndFeel(nullptr);
-    highpeakBypassButton.setLookAndFeel(nullptr);
+    audioProcessor.removeChangeListener(this);
+
+    for (auto* band : peakBandControls)
+        band->bypassButton.setLookAndFeel(nullptr);
+
     lowcutBypassButton.setLookAndFeel(nullptr);
     highcutBypassButton.setLookAndFeel(nullptr);
 }
 
 //==============================================================================
 void TradeMarkEQAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    // Nothing in here moves, so it's drawn once per size and scale.
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    auto panels = resources->getLayer("EditorPanels", getWidth(), getHeight(), scale, true,
+        [this](juce::Graphics& layer) { drawPanels(layer); });
+
+    g.drawImage(panels, getLocalBounds().toFloat());
+}
+
+void TradeMarkEQAudioProcessorEditor::drawPanels(juce::Graphics& g)
 {
     using namespace juce;
 
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll(Colours::black);
 
+    // The preset controls share the header's row.
+    g.setColour(Colours::lightgrey);
+    g.fillRect(getLocalBounds().removeFromTop(getHeight() * 0.1));
+
     auto bounds = getLocalBounds();
     bounds.removeFromTop(bounds.getHeight() * 0.33);
     bounds.removeFromBottom(bounds.getHeight() * 0.35);
 
-    Array<Colour> colours{ Colours::red,
-        Colours::orange,
-        Colours::yellow,
-        Colours::green,
-        Colours::blue };
-
     auto colourPeakArea = bounds.reduced(2.0f).withWidth(bounds.getWidth() - 4);
-    auto colourArea = colourPeakArea.withWidth(colourPeakArea.getWidth() / (float)colours.size());
+    auto colourArea = colourPeakArea.withWidth(colourPeakArea.getWidth() / (float)numPeakBands);
 
-    for (auto colour : colours)
+    for (int i = 0; i < numPeakBands; ++i)
     {
 
-        g.setColour(colour);
+        g.setColour(getBandColour(i));
         g.fillRect(colourArea);
 
         colourArea.translate(colourArea.getWidth() + 2, 0.0f);
@@ -830,59 +1879,54 @@ void TradeMarkEQAudioProcessorEditor::resized()
 
     auto labelArea = bounds.removeFromTop(bounds.getHeight() * 0.1);
 
+    auto presetArea = labelArea.removeFromRight(labelArea.getWidth() * 0.55).reduced(4, 12);
+
+    crossfadeButton.setBounds(presetArea.removeFromRight(55));
+    copySnapshotButton.setBounds(presetArea.removeFromRight(40));
+    snapshotBButton.setBounds(presetArea.removeFromRight(22));
+    snapshotAButton.setBounds(presetArea.removeFromRight(22));
+    savePresetButton.setBounds(presetArea.removeFromRight(40));
+    presetBox.setBounds(presetArea);
+
     headerComponent.setBounds(labelArea);
 
     float hRatio = 25.f / 100.f; // JUCE_LIVE_CONSTANT(33) / 100.f;
     auto responseArea = bounds.removeFromTop(bounds.getHeight() * hRatio);
 
+    levelMeterComponent.setBounds(responseArea.removeFromRight(72));
     responseCurveComponent.setBounds(responseArea);
 
     bounds.removeFromTop(5); //Creates space between response curve and sliders
 
     auto peakArea = bounds.removeFromTop(bounds.getHeight() * 0.65);
 
-    auto lowPeakArea = peakArea.removeFromLeft(peakArea.getWidth() * 0.2);
-    lowpeakBypassButton.setBounds(lowPeakArea.removeFromTop(25));
-    lowPeakFreqSlider.setBounds(lowPeakArea.removeFromTop(lowPeakArea.getHeight() * 0.33));
-    lowPeakGainSlider.setBounds(lowPeakArea.removeFromTop(lowPeakArea.getHeight() * 0.5));
-    lowPeakQualitySlider.setBounds(lowPeakArea);
-
-    auto midlowPeakArea = peakArea.removeFromLeft(peakArea.getWidth() * 0.25);
-    midlowpeakBypassButton.setBounds(midlowPeakArea.removeFromTop(25));
-    midlowPeakFreqSlider.setBounds(midlowPeakArea.removeFromTop(midlowPeakArea.getHeight() * 0.33));
-    midlowPeakGainSlider.setBounds(midlowPeakArea.removeFromTop(midlowPeakArea.getHeight() * 0.5));
-    midlowPeakQualitySlider.setBounds(midlowPeakArea);
-
-    auto midPeakArea = peakArea.removeFromLeft(peakArea.getWidth() * 0.33);
-    midpeakBypassButton.setBounds(midPeakArea.removeFromTop(25));
-    midPeakFreqSlider.setBounds(midPeakArea.removeFromTop(midPeakArea.getHeight() * 0.33));
-    midPeakGainSlider.setBounds(midPeakArea.removeFromTop(midPeakArea.getHeight() * 0.5));
-    midPeakQualitySlider.setBounds(midPeakArea);
-
-    auto midhighPeakArea = peakArea.removeFromLeft(peakArea.getWidth() * 0.5);
-    midhighpeakBypassButton.setBounds(midhighPeakArea.removeFromTop(25));
-    midhighPeakFreqSlider.setBounds(midhighPeakArea.removeFromTop(midhighPeakArea.getHeight() * 0.33));
-    midhighPeakGainSlider.setBounds(midhighPeakArea.removeFromTop(midhighPeakArea.getHeight() * 0.5));
-    midhighPeakQualitySlider.setBounds(midhighPeakArea);
-
-    auto highPeakArea = peakArea.removeFromLeft(peakArea.getWidth());
-    highpeakBypassButton.setBounds(highPeakArea.removeFromTop(25));
-    highPeakFreqSlider.setBounds(highPeakArea.removeFromTop(highPeakArea.getHeight() * 0.33));
-    highPeakGainSlider.setBounds(highPeakArea.removeFromTop(highPeakArea.getHeight() * 0.5));
-    highPeakQualitySlider.setBounds(highPeakArea);
+    for (int i = 0; i < peakBandControls.size(); ++i)
+        peakBandControls[i]->setBounds(peakArea.removeFromLeft(peakArea.getWidth() / (peakBandControls.size() - i)));
 
     auto lowCutArea = bounds.removeFromLeft(bounds.getWidth() * 0.5);
     auto highCutArea = bounds.removeFromRight(bounds.getWidth());
 
-    lowcutBypassButton.setBounds(lowCutArea.removeFromTop(25));
+    auto lowCutButtonArea = lowCutArea.removeFromTop(25);
+    exportButton.setBounds(lowCutButtonArea.removeFromRight(60).reduced(2));
+    matchButton.setBounds(lowCutButtonArea.removeFromRight(60).reduced(2));
+    autoGainBox.setBounds(lowCutButtonArea.removeFromRight(130).reduced(2));
+    lowcutBypassButton.setBounds(lowCutButtonArea);
     lowCutFreqSlider.setBounds(lowCutArea.removeFromLeft(lowCutArea.getWidth() * 0.5));
-    lowCutArea.removeFromTop(lowCutArea.getHeight() * 0.33);
+    auto lowCutSteepArea = lowCutArea.removeFromTop(lowCutArea.getHeight() * 0.33).reduced(4, 6);
+    lowCutMoreButton.setBounds(lowCutSteepArea.removeFromRight(44));
+    lowCutSteepBox.setBounds(lowCutSteepArea.withTrimmedRight(2));
     lowCutArea.removeFromRight(lowCutArea.getWidth() * 0.33);
     lowCutSlopeSlider.setBounds(lowCutArea);
 
-    highcutBypassButton.setBounds(highCutArea.removeFromTop(25));
+    auto highCutButtonArea = highCutArea.removeFromTop(25);
+    compareButton.setBounds(highCutButtonArea.removeFromRight(70).reduced(2));
+    spectrogramButton.setBounds(highCutButtonArea.removeFromRight(90).reduced(2));
+    resonanceButton.setBounds(highCutButtonArea.removeFromRight(90).reduced(2));
+    highcutBypassButton.setBounds(highCutButtonArea);
     highCutFreqSlider.setBounds(highCutArea.removeFromRight(highCutArea.getWidth() * 0.5));
-    highCutArea.removeFromTop(highCutArea.getHeight() * 0.33);
+    auto highCutSteepArea = highCutArea.removeFromTop(highCutArea.getHeight() * 0.33).reduced(4, 6);
+    highCutMoreButton.setBounds(highCutSteepArea.removeFromRight(44));
+    highCutSteepBox.setBounds(highCutSteepArea.withTrimmedRight(2));
     highCutArea.removeFromLeft(highCutArea.getWidth() * 0.33);
     highCutSlopeSlider.setBounds(highCutArea);
 
@@ -890,43 +1934,279 @@ void TradeMarkEQAudioProcessorEditor::resized()
 
 }
 
-std::vector<juce::Component*> TradeMarkEQAudioProcessorEditor::getComps()
+void TradeMarkEQAudioProcessorEditor::updateCutControls()
+{
+    for (auto [bypassButton, steepBox, freqSlider, slopeSlider] : {
+        std::tuple{ &lowcutBypassButton, &lowCutSteepBox, &lowCutFreqSlider, &lowCutSlopeSlider },
+        std::tuple{ &highcutBypassButton, &highCutSteepBox, &highCutFreqSlider, &highCutSlopeSlider } })
+    {
+        auto bypassed = bypassButton->getToggleState();
+
+        freqSlider->setEnabled(!bypassed);
+        steepBox->setEnabled(!bypassed);
+
+        // A steeper slope overrides the slope knob.
+        slopeSlider->setEnabled(!bypassed && steepBox->getSelectedItemIndex() <= 0);
+    }
+}
+
+void TradeMarkEQAudioProcessorEditor::refreshPresetControls()
+{
+    auto& presetManager = audioProcessor.getPresetManager();
+
+    presetBox.clear(juce::dontSendNotification);
+
+    for (int i = 0; i < presetManager.getNumPresets(); ++i)
+        presetBox.addItem(presetManager.getPresetName(i), i + 1);
+
+    presetBox.setSelectedItemIndex(presetManager.getCurrentPreset(), juce::dontSendNotification);
+
+    auto isA = presetManager.getActiveSnapshot() == PresetManager::Snapshot::A;
+    snapshotAButton.setToggleState(isA, juce::dontSendNotification);
+    snapshotBButton.setToggleState(!isA, juce::dontSendNotification);
+}
+
+void TradeMarkEQAudioProcessorEditor::showMatchOptions()
+{
+    auto safePtr = juce::Component::SafePointer<TradeMarkEQAudioProcessorEditor>(this);
+
+    if (!responseCurveComponent.isMatching())
+    {
+        matchChooser = std::make_unique<juce::FileChooser>("Choose a reference to match", juce::File(),
+            "*.wav;*.aif;*.aiff;*.flac;*.ogg;*.mp3");
+
+        matchChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+            [safePtr](const juce::FileChooser& chooser)
+            {
+                auto* comp = safePtr.getComponent();
+                auto reference = chooser.getResult();
+
+                if (comp != nullptr && reference.existsAsFile())
+                    comp->responseCurveComponent.startMatching(reference);
+            });
+
+        return;
+    }
+
+    juce::PopupMenu menu;
+    menu.addItem(1, "Apply match", responseCurveComponent.hasMatchTarget());
+    menu.addItem(2, "Stop matching");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&matchButton),
+        [safePtr](int result)
+        {
+            if (auto* comp = safePtr.getComponent())
+            {
+                if (result == 1)
+                    comp->responseCurveComponent.applyMatch();
+                else if (result == 2)
+                    comp->responseCurveComponent.stopMatching();
+            }
+        });
+}
+
+void TradeMarkEQAudioProcessorEditor::showCompareOptions()
+{
+    auto safePtr = juce::Component::SafePointer<TradeMarkEQAudioProcessorEditor>(this);
+
+    const auto compared = responseCurveComponent.getComparedInstance();
+    const auto ownSlot = audioProcessor.getSpectrumSlot();
+
+    juce::PopupMenu menu;
+    menu.addItem(1, "Off", true, compared < 0);
+    menu.addSeparator();
+
+    auto entries = audioProcessor.getSpectrumRegistry().getEntries();
+
+    // Items are numbered from the slot, past the "Off" item.
+    for (const auto& entry : entries)
+        if (entry.slot != ownSlot)
+            menu.addItem(entry.slot + 2, entry.name, ownSlot >= 0, entry.slot == compared);
+
+    if (entries.size() < 2)
+        menu.addItem(SpectrumRegistry::maxInstances + 2, "No other instances", false);
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&compareButton),
+        [safePtr](int result)
+        {
+            auto* comp = safePtr.getComponent();
+
+            if (comp != nullptr && result > 0)
+                comp->responseCurveComponent.setComparedInstance(result - 2);
+        });
+}
+
+void TradeMarkEQAudioProcessorEditor::showExportOptions()
 {
-    return
+    using ImpulseExport::Phase;
+
+    auto safePtr = juce::Component::SafePointer<TradeMarkEQAudioProcessorEditor>(this);
+
+    static constexpr Phase phases[]{ Phase::Minimum, Phase::Linear, Phase::Both };
+    static constexpr const char* phaseNames[]{ "Minimum phase", "Linear phase", "Both" };
+    static constexpr int lengths[]{ 1024, 2048, 4096, 8192, 16384, 32768, 65536 };
+    static constexpr double sampleRates[]{ 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+
+    // Every choice has an item ID of its own: a hundred per submenu plus its index.
+    enum
     {
-        &lowPeakFreqSlider,
-        &lowPeakGainSlider,
-        &lowPeakQualitySlider,
+        exportWav = 1,
+        exportRaw,
+        phaseItems = 100,
+        lengthItems = 200,
+        sampleRateItems = 300
+    };
+
+    juce::PopupMenu phaseMenu, lengthMenu, sampleRateMenu;
+
+    for (int i = 0; i < (int)std::size(phases); ++i)
+        phaseMenu.addItem(phaseItems + i, phaseNames[i], true, exportOptions.phase == phases[i]);
+
+    for (int i = 0; i < (int)std::size(lengths); ++i)
+        lengthMenu.addItem(lengthItems + i, juce::String(lengths[i]) + " samples", true, exportOptions.length == lengths[i]);
+
+    for (int i = 0; i < (int)std::size(sampleRates); ++i)
+        sampleRateMenu.addItem(sampleRateItems + i, juce::String(sampleRates[i] / 1000.0, 1) + " kHz", true,
+            exportOptions.sampleRate == sampleRates[i]);
+
+    juce::PopupMenu menu;
+    menu.addSubMenu("Phase", phaseMenu);
+    menu.addSubMenu("Length", lengthMenu);
+    menu.addSubMenu("Sample rate", sampleRateMenu);
+    menu.addSeparator();
+    menu.addItem(exportWav, "Export WAV...");
+    menu.addItem(exportRaw, "Export raw float...");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&exportButton),
+        [safePtr](int result)
+        {
+            auto* comp = safePtr.getComponent();
+
+            if (comp == nullptr || result == 0)
+                return;
+
+            auto& options = comp->exportOptions;
+
+            if (result == exportWav)
+                comp->exportImpulse(ImpulseExport::Format::Wav);
+            else if (result == exportRaw)
+                comp->exportImpulse(ImpulseExport::Format::RawFloat);
+            else if (result >= sampleRateItems)
+                options.sampleRate = sampleRates[result - sampleRateItems];
+            else if (result >= lengthItems)
+                options.length = lengths[result - lengthItems];
+            else if (result >= phaseItems)
+                options.phase = phases[result - phaseItems];
+        });
+}
+
+void TradeMarkEQAudioProcessorEditor::exportImpulse(ImpulseExport::Format format)
+{
+    auto safePtr = juce::Component::SafePointer<TradeMarkEQAudioProcessorEditor>(this);
+    const auto extension = juce::String(ImpulseExport::getFileExtension(format));
+
+    exportChooser = std::make_unique<juce::FileChooser>("Export the EQ curve as an impulse",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("TradeMarkEQ" + extension),
+        "*" + extension);
 
-        &midlowPeakFreqSlider,
-        &midlowPeakGainSlider,
-        &midlowPeakQualitySlider,
+    exportChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+        | juce::FileBrowserComponent::warnAboutOverwriting,
+        [safePtr, format, extension](const juce::FileChooser& chooser)
+        {
+            auto* comp = safePtr.getComponent();
+            auto file = chooser.getResult();
+
+            if (comp == nullptr || file == juce::File())
+                return;
+
+            auto options = comp->exportOptions;
+            options.format = format;
+
+            auto settings = getChainSettings(comp->audioProcessor.apvts);
+            file = file.withFileExtension(extension);
+
+            // Rendering takes milliseconds, but writing can take longer, so
+            // neither holds up the message thread.
+            juce::Thread::launch([safePtr, settings, options, file]
+                {
+                    auto result = ImpulseExport::exportImpulses(settings, options, file);
+
+                    juce::MessageManager::callAsync([safePtr, result]
+                        {
+                            if (auto* comp = safePtr.getComponent())
+                            {
+                                auto message = result.wasOk()
+                                    ? "Wrote " + result.files.getFirst().getFileName()
+                                        + (result.files.size() > 1 ? " and " + result.files.getLast().getFileName() : juce::String())
+                                        + " in " + juce::String(result.seconds * 1000.0, 1) + " ms"
+                                    : result.error;
+
+                                juce::AlertWindow::showMessageBoxAsync(result.wasOk() ? juce::MessageBoxIconType::InfoIcon
+                                    : juce::MessageBoxIconType::WarningIcon, "Export", message, {}, comp);
+                            }
+                        });
+                });
+        });
+}
+
+void TradeMarkEQAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    showStateError();
+}
+
+void TradeMarkEQAudioProcessorEditor::showStateError()
+{
+    auto error = audioProcessor.takeStateError();
 
-        &midPeakFreqSlider,
-        &midPeakGainSlider,
-        &midPeakQualitySlider,
+    if (error.isNotEmpty())
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Saved settings",
+            "The saved settings couldn't be restored, so the current ones were kept.\n\n" + error, {}, this);
+}
 
-        &midhighPeakFreqSlider,
-        &midhighPeakGainSlider,
-        &midhighPeakQualitySlider,
+std::vector<juce::Component*> TradeMarkEQAudioProcessorEditor::getComps()
+{
+    std::vector<juce::Component*> comps;
 
-        &highPeakFreqSlider,
-        &highPeakGainSlider,
-        &highPeakQualitySlider,
+    for (auto* band : peakBandControls)
+    {
+        comps.push_back(&band->freqSlider);
+        comps.push_back(&band->gainSlider);
+        comps.push_back(&band->qualitySlider);
+        comps.push_back(&band->bypassButton);
+        comps.push_back(&band->moreButton);
+    }
 
+    for (auto* comp : std::initializer_list<juce::Component*>{
         &lowCutFreqSlider,
         &highCutFreqSlider,
         &lowCutSlopeSlider,
         &highCutSlopeSlider,
         &responseCurveComponent,
+        &levelMeterComponent,
         &headerComponent,
 
         &lowcutBypassButton,
-        &lowpeakBypassButton,
-        &midlowpeakBypassButton,
-        &midpeakBypassButton,
-        &midhighpeakBypassButton,
-        &highpeakBypassButton,
-        &highcutBypassButton
-    };
+        &highcutBypassButton,
+
+        &presetBox,
+        &savePresetButton,
+        &snapshotAButton,
+        &snapshotBButton,
+        &copySnapshotButton,
+        &crossfadeButton,
+        &autoGainBox,
+        &lowCutSteepBox,
+        &highCutSteepBox,
+        &lowCutMoreButton,
+        &highCutMoreButton,
+        &spectrogramButton,
+        &resonanceButton,
+        &matchButton,
+        &compareButton,
+        &exportButton })
+    {
+        comps.push_back(comp);
+    }
+
+    return comps;
 }
@@ -10,6 +10,10 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "MatchEq.h"
+#include "ImpulseExport.h"
+
+struct RotarySliderWithLabels;
 
 struct LookAndFeel : juce::LookAndFeel_V4
 {
@@ -20,12 +24,69 @@ struct LookAndFeel : juce::LookAndFeel_V4
         float rotaryEndAngle,
         juce::Slider&) override;
 
+    // drawRotarySlider() in two layers: the face doesn't move, so it can be
+    // cached, and the pointer and value readout follow the value.
+    void drawRotarySliderFace(juce::Graphics&, juce::Rectangle<float> bounds, bool enabled);
+
+    void drawRotarySliderPointer(juce::Graphics&,
+        juce::Rectangle<float> bounds,
+        float sliderPosProportional,
+        float rotaryStartAngle,
+        float rotaryEndAngle,
+        RotarySliderWithLabels&);
+
     void drawToggleButton(juce::Graphics& g,
         juce::ToggleButton& toggleButton,
         bool shouldDrawButtonAsHighlighted,
         bool shouldDrawButtonAsDown) override;
 };
 
+/**
+    Read-only resources every open editor shares, held through a
+    juce::SharedResourcePointer. They're created with the first editor and
+    freed with the last one, so an instance without an editor open carries
+    none of them.
+*/
+struct EditorResources
+{
+    LookAndFeel lookAndFeel;
+
+    /** The header logo, decoded the first time it's asked for. */
+    const juce::Image& getLogo();
+
+    /** An image of width x height logical pixels at the given scale factor,
+        which draw() renders, in logical coordinates, the first time it's asked
+        for. Later calls with the same name, size and scale return the same
+        pixels, so don't draw into them. Layers that aren't opaque start out
+        transparent.
+
+        Layers are kept up to maxLayerBytes in all, and the ones used least
+        recently go first, so editors moving between displays and scale
+        factors don't pile up layers nobody draws any more.
+    */
+    juce::Image getLayer(const juce::String& name, int width, int height, float scale, bool opaque,
+        const std::function<void(juce::Graphics&)>& draw);
+
+private:
+    static constexpr size_t maxLayerBytes = 64 * 1024 * 1024;
+
+    struct Layer
+    {
+        juce::Image image;
+        juce::uint64 lastUsed{ 0 };
+    };
+
+    juce::Image logo;
+    std::map<juce::String, Layer> layers;
+    juce::uint64 numLayerUses{ 0 };
+    size_t layerBytes{ 0 };
+
+    static size_t getSizeInBytes(const juce::Image& image) noexcept;
+
+    /** Drops the least recently used layers until bytesNeeded more would fit. */
+    void evictLayers(size_t bytesNeeded);
+};
+
 struct RotarySliderWithLabels : juce::Slider
 {
     RotarySliderWithLabels(juce::RangedAudioParameter& rap, const juce::String& unitSuffix) :
@@ -34,7 +95,10 @@ struct RotarySliderWithLabels : juce::Slider
         param(&rap),
         suffix(unitSuffix)
     {
-        setLookAndFeel(&lnf);
+        setLookAndFeel(&resources->lookAndFeel);
+
+        // Nothing here changes on hover, so only value changes repaint.
+        setRepaintsOnMouseActivity(false);
     }
 
     ~RotarySliderWithLabels()
@@ -56,7 +120,9 @@ struct RotarySliderWithLabels : juce::Slider
     juce::String getDisplayString() const;
 
 private:
-    LookAndFeel lnf;
+    juce::SharedResourcePointer<EditorResources> resources;
+
+    void drawFace(juce::Graphics& g);
 
     juce::RangedAudioParameter* param;
     juce::String suffix;
@@ -76,15 +142,16 @@ public:
     void resized() override;
 
 private:
+    juce::SharedResourcePointer<EditorResources> resources;
 
-    juce::Image logo;
-
+    void drawHeader(juce::Graphics& g);
 };
 
 //==============================================================================
 
 struct ResponseCurveComponent : juce::Component,
     juce::AudioProcessorParameter::Listener,
+    juce::ChangeListener,
     juce::Timer
 {
     ResponseCurveComponent(TradeMarkEQAudioProcessor&);
@@ -94,32 +161,285 @@ struct ResponseCurveComponent : juce::Component,
 
     void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override { };
 
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
     void timerCallback() override;
 
     void paint(juce::Graphics& g) override;
 
     void resized() override;
 
+    /** Restarts the integrated loudness and true peak readings. */
+    void mouseDoubleClick(const juce::MouseEvent&) override;
+
+    /** Shows a scrolling spectrogram of the output behind the curves. */
+    void setSpectrogramVisible(bool shouldBeVisible);
+
+    bool isSpectrogramVisible() const noexcept { return spectrogram != nullptr; }
+
+    /** Listens to the input for resonances and marks each one with the band
+        that would notch it out. Clicking a marker sets that band.
+    */
+    void setDetectingResonances(bool shouldDetect);
+
+    bool isDetectingResonances() const noexcept { return resonanceDetector != nullptr; }
+
+    void mouseUp(const juce::MouseEvent& event) override;
+
+    /** Averages the input against the spectrum of a reference file, and
+        draws the curve a match EQ would aim for.
+    */
+    void startMatching(const juce::File& reference);
+
+    void stopMatching();
+
+    bool isMatching() const noexcept { return matchAnalyser != nullptr; }
+
+    /** Fits the cuts and bands to the target so far, sets them and stops
+        matching. False, and nothing changes, while there's no target yet.
+    */
+    bool applyMatch();
+
+    bool hasMatchTarget() const noexcept { return !matchTarget.isEmpty(); }
+
+    /** Draws another instance's output spectrum behind this one's and shades
+        the bands where the two mask each other. -1 stops comparing.
+    */
+    void setComparedInstance(int slot);
+
+    int getComparedInstance() const noexcept { return comparedSlot; }
+
 private:
     TradeMarkEQAudioProcessor& audioProcessor;
     juce::Atomic<bool> parametersChanged{ false };
 
-    MonoChain monoChain;
+    juce::SharedResourcePointer<EditorResources> resources;
+
+    // The curve of each channel, measured in updateChain() so paint() only
+    // has to stroke them.
+    std::array<juce::Path, 2> responseCurves;
+
+    // True when some band or cut only works on one channel, so the two
+    // channels need a curve each.
+    bool channelsDiffer{ false };
+
+    QualityScheduler::Level qualityLevel{ QualityScheduler::Level::Full };
+
+    // The readings on screen, so the timer only repaints when they move.
+    LoudnessMeter::Readings inputLoudness, outputLoudness;
+    float autoGainDecibels{ 0 };
 
     void updateChain();
 
-    juce::Image background;
+    void drawBackground(juce::Graphics& g);
 
     juce::Rectangle<int> getRenderArea();
 
     juce::Rectangle<int> getAnalysisArea();
 
+    juce::Rectangle<int> getLoudnessArea();
+
+    void drawLoudness(juce::Graphics& g);
+
+    // Only exists while the spectrogram is showing, so the analysis thread
+    // and the feed from the audio thread stop when it's hidden.
+    std::unique_ptr<SpectrogramAnalyser> spectrogram;
+
+    // One row of levels per analysed frame, newest at the top. Rows are
+    // written in place, working up the image and wrapping round, so
+    // spectrogramRow is the newest one and nothing is ever scrolled.
+    juce::Image spectrogramImage;
+    int spectrogramRow{ 0 };
+    std::vector<juce::uint8> spectrogramLevels;
+
+    /** Copies every waiting row into the image. True if there were any. */
+    bool updateSpectrogram();
+
+    void drawSpectrogram(juce::Graphics& g, float scale);
+
+    // Like the spectrogram, only running while it's switched on.
+    std::unique_ptr<ResonanceDetector> resonanceDetector;
+    std::vector<NotchSuggestion> notchSuggestions;
+    ResonanceDetector::Statistics resonanceStatistics;
+    int resonanceTicks{ 0 };
+
+    juce::Rectangle<int> getNotchMarkerArea(const NotchSuggestion& notch);
+
+    void drawNotchSuggestions(juce::Graphics& g);
+
+    // Only running while matching.
+    std::unique_ptr<MatchEqAnalyser> matchAnalyser;
+    MatchEqTarget matchTarget;
+    juce::Path matchCurve;
+    juce::String matchStatus;
+    int matchTicks{ 0 };
+
+    void updateMatchTarget();
+
+    void drawMatchTarget(juce::Graphics& g);
+
+    // Subscribed only while comparing, so no instance analyses its output otherwise.
+    std::unique_ptr<SpectrumRegistry::Subscription> compareSubscription;
+    int comparedSlot{ -1 };
+    juce::Path ownSpectrum, comparedSpectrum;
+    std::vector<juce::Range<float>> maskedRanges;
+    juce::String compareStatus;
+    int compareTicks{ 0 };
+
+    void updateComparison();
+
+    void drawComparison(juce::Graphics& g);
+};
+
+//==============================================================================
+
+/**
+    Peak and RMS bars for each input and output channel, and the output's
+    stereo correlation underneath. The scale is a cached layer, and the bars
+    only get repainted when one of them moves by at least a pixel.
+*/
+struct LevelMeterComponent : juce::Component,
+    juce::Timer
+{
+    LevelMeterComponent(TradeMarkEQAudioProcessor&);
+
+    void timerCallback() override;
+
+    void paint(juce::Graphics& g) override;
+
+private:
+    TradeMarkEQAudioProcessor& audioProcessor;
+
+    juce::SharedResourcePointer<EditorResources> resources;
+
+    // Where everything was last drawn, in pixels: the top of each bar's peak
+    // and RMS, input left and right then output left and right, and the
+    // correlation marker.
+    struct Geometry
+    {
+        std::array<int, 4> peak{}, rms{};
+        int correlation{ 0 };
+
+        bool operator==(const Geometry& other) const noexcept
+        {
+            return peak == other.peak && rms == other.rms && correlation == other.correlation;
+        }
+    };
+
+    Geometry drawn;
+
+    Geometry layOut(const LevelMeter::Levels& input, const LevelMeter::Levels& output);
+
+    juce::Rectangle<int> getBarArea(int bar);
+
+    juce::Rectangle<int> getCorrelationArea();
+
+    int getLevelY(float decibels);
+
+    void drawBackground(juce::Graphics& g);
+};
+
+//==============================================================================
+
+/**
+    The settings of a band that don't fit on the main panel, in a call-out
+    from its "More" button. The controls are only made, and attached to the
+    parameters, while it's open.
+*/
+struct BandDetailComponent : juce::Component
+{
+    // Bands are numbered low to high: the low cut, the peak bands, the high cut.
+    static constexpr int lowCut = -1, highCut = numPeakBands;
+
+    BandDetailComponent(juce::AudioProcessorValueTreeState& apvts, int band);
+
+    /** Opens a band's call-out from the button that asked for it. The
+        call-out is a child of the editor, so it can't outlive the
+        parameters it's attached to.
+    */
+    static void show(juce::AudioProcessorValueTreeState& apvts, int band, juce::Component& button);
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    using APVTS = juce::AudioProcessorValueTreeState;
+
+    struct Knob
+    {
+        Knob(APVTS& apvts, const juce::String& parameterID, const juce::String& knobTitle, const juce::String& unitSuffix);
+
+        juce::String title;
+        RotarySliderWithLabels slider;
+        APVTS::SliderAttachment attachment;
+    };
+
+    // A titled row of knobs, with its buttons and boxes stacked on the left.
+    struct Row
+    {
+        juce::String title;
+        std::vector<juce::Component*> controls;
+        juce::OwnedArray<Knob> knobs;
+    };
+
+    static constexpr int rowHeight = 96, controlWidth = 100, knobWidth = 70, titleHeight = 14;
+
+    juce::OwnedArray<Row> rows;
+
+    juce::TextButton dynamicButton{ "Dynamic" },
+        sidechainButton{ "Sidechain" },
+        secondBypassButton{ "Bypass" }; // the second channel's own bypass, while unlinked
+
+    std::unique_ptr<APVTS::ButtonAttachment> dynamicAttachment,
+        sidechainAttachment,
+        secondBypassAttachment;
+
+    juce::ComboBox modSourceBox,
+        channelsBox,
+        channelModeBox,
+        channelLinkBox,
+        secondSteepBox;
+
+    // Made once each box has its items, so they can select the current one.
+    std::vector<std::unique_ptr<APVTS::ComboBoxAttachment>> boxAttachments;
+
+    Row& addRow(const juce::String& title);
+
+    void addChoiceBox(Row& row, juce::ComboBox& box, APVTS& apvts, const juce::String& parameterID);
+
+    void addKnob(Row& row, APVTS& apvts, const juce::String& parameterID, const juce::String& title, const juce::String& unitSuffix);
+
+    void addControl(Row& row, juce::Component& control);
+};
+
+struct PeakBandControls
+{
+    PeakBandControls(juce::AudioProcessorValueTreeState& apvts, int band);
+
+    RotarySliderWithLabels freqSlider,
+        gainSlider,
+        qualitySlider;
+
+    juce::ToggleButton bypassButton;
+
+    juce::TextButton moreButton{ "More" };
+
+    using APVTS = juce::AudioProcessorValueTreeState;
+
+    APVTS::SliderAttachment freqSliderAttachment,
+        gainSliderAttachment,
+        qualitySliderAttachment;
+
+    APVTS::ButtonAttachment bypassButtonAttachment;
+
+    void setBounds(juce::Rectangle<int> area);
 };
 
 //==============================================================================
 /**
 */
-class TradeMarkEQAudioProcessorEditor : public juce::AudioProcessorEditor
+class TradeMarkEQAudioProcessorEditor : public juce::AudioProcessorEditor,
+    private juce::ChangeListener
 {
 public:
     TradeMarkEQAudioProcessorEditor (TradeMarkEQAudioProcessor&);
@@ -134,27 +454,12 @@ private:
     // access the processor object that created it.
     TradeMarkEQAudioProcessor& audioProcessor;
 
-    RotarySliderWithLabels 
-        lowPeakFreqSlider,
-        lowPeakGainSlider,
-        lowPeakQualitySlider,
-
-        midlowPeakFreqSlider,
-        midlowPeakGainSlider,
-        midlowPeakQualitySlider,
-
-        midPeakFreqSlider,
-        midPeakGainSlider,
-        midPeakQualitySlider,
+    // Declared first so the shared look and feel outlives every component using it.
+    juce::SharedResourcePointer<EditorResources> resources;
 
-        midhighPeakFreqSlider,
-        midhighPeakGainSlider,
-        midhighPeakQualitySlider,
-
-        highPeakFreqSlider,
-        highPeakGainSlider,
-        highPeakQualitySlider,
+    juce::OwnedArray<PeakBandControls> peakBandControls;
 
+    RotarySliderWithLabels
         lowCutFreqSlider,
         highCutFreqSlider,
         lowCutSlopeSlider,
@@ -164,56 +469,82 @@ private:
 
     ResponseCurveComponent responseCurveComponent;
 
+    LevelMeterComponent levelMeterComponent;
+
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
 
-    Attachment 
-        lowPeakFreqSliderAttachment,
-        lowPeakGainSliderAttachment,
-        lowPeakQualitySliderAttachment,
-
-        midlowPeakFreqSliderAttachment,
-        midlowPeakGainSliderAttachment,
-        midlowPeakQualitySliderAttachment,
-
-        midPeakFreqSliderAttachment,
-        midPeakGainSliderAttachment,
-        midPeakQualitySliderAttachment,
-
-        midhighPeakFreqSliderAttachment,
-        midhighPeakGainSliderAttachment,
-        midhighPeakQualitySliderAttachment,
-
-        highPeakFreqSliderAttachment,
-        highPeakGainSliderAttachment,
-        highPeakQualitySliderAttachment,
-
+    Attachment
         lowCutFreqSliderAttachment,
         highCutFreqSliderAttachment,
         lowCutSlopeSliderAttachment,
         highCutSlopeSliderAttachment;
 
-    juce::ToggleButton lowcutBypassButton, 
-        lowpeakBypassButton, 
-        midlowpeakBypassButton,
-        midpeakBypassButton,
-        midhighpeakBypassButton,
-        highpeakBypassButton,
+    juce::ToggleButton lowcutBypassButton,
         highcutBypassButton;
 
     using ButtonAttachment = APVTS::ButtonAttachment;
 
     ButtonAttachment lowcutBypassButtonAttachment,
-        lowpeakBypassButtonAttachment,
-        midlowpeakBypassButtonAttachment,
-        midpeakBypassButtonAttachment,
-        midhighpeakBypassButtonAttachment,
-        highpeakBypassButtonAttachment,
         highcutBypassButtonAttachment;
 
-    std::vector<juce::Component*> getComps();
+    juce::ComboBox presetBox;
+
+    juce::TextButton savePresetButton{ "Save" },
+        snapshotAButton{ "A" },
+        snapshotBButton{ "B" },
+        copySnapshotButton{ "Copy" };
+
+    juce::ToggleButton crossfadeButton{ "Fade" };
+
+    juce::ComboBox autoGainBox;
+
+    juce::ComboBox lowCutSteepBox,
+        highCutSteepBox;
+
+    juce::TextButton lowCutMoreButton{ "More" },
+        highCutMoreButton{ "More" };
+
+    juce::TextButton spectrogramButton{ "Spectrogram" },
+        resonanceButton{ "Resonances" },
+        matchButton{ "Match" },
+        compareButton{ "Compare" },
+        exportButton{ "Export" };
+
+    std::unique_ptr<juce::FileChooser> matchChooser, exportChooser;
+
+    // Kept between exports, so the next one starts from the same choices.
+    ImpulseExport::Options exportOptions;
+
+    // Made once autoGainBox has its items, so it can select the current one.
+    std::unique_ptr<APVTS::ComboBoxAttachment> autoGainAttachment,
+        lowCutSteepAttachment,
+        highCutSteepAttachment;
 
-    LookAndFeel lnf;
+    void refreshPresetControls();
+
+    /** Greys out what a bypass or a steep slope leaves without effect. */
+    void updateCutControls();
+
+    /** Asks for a reference to match, or, while matching, whether to apply it. */
+    void showMatchOptions();
+
+    /** Lists the other instances in the process to compare this one with. */
+    void showCompareOptions();
+
+    /** Picks the phase, length and sample rate of an impulse export, and starts one. */
+    void showExportOptions();
+
+    /** Asks where to save, then renders and writes the impulse on a thread of its own. */
+    void exportImpulse(ImpulseExport::Format format);
+
+    /** Tells the user when the processor couldn't restore a saved session. */
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void showStateError();
+
+    void drawPanels(juce::Graphics& g);
+
+    std::vector<juce::Component*> getComps();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TradeMarkEQAudioProcessorEditor)
 };
@@ -8,6 +8,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "StateFormat.h"
 
 //==============================================================================
 TradeMarkEQAudioProcessor::TradeMarkEQAudioProcessor()
@@ -18,6 +19,9 @@ TradeMarkEQAudioProcessor::TradeMarkEQAudioProcessor()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
+                      #endif
                      #endif
                        )
 #endif
@@ -26,6 +30,7 @@ TradeMarkEQAudioProcessor::TradeMarkEQAudioProcessor()
 
 TradeMarkEQAudioProcessor::~TradeMarkEQAudioProcessor()
 {
+    spectrumRegistry->leave(spectrumSlot);
 }
 
 //==============================================================================
@@ -68,28 +73,35 @@ double TradeMarkEQAudioProcessor::getTailLengthSeconds() const
 
 int TradeMarkEQAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    // The preset bank always has at least the factory presets, and some hosts
+    // don't cope very well if you tell them there are 0 programs.
+    return juce::jmax(1, presetManager.getNumPresets());
 }
 
 int TradeMarkEQAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return juce::jmax(0, presetManager.getCurrentPreset());
 }
 
 void TradeMarkEQAudioProcessor::setCurrentProgram (int index)
 {
+    presetManager.loadPreset(index);
 }
 
 const juce::String TradeMarkEQAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return presetManager.getPresetName(index);
 }
 
 void TradeMarkEQAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
 }
 
+void TradeMarkEQAudioProcessor::updateTrackProperties (const TrackProperties& properties)
+{
+    spectrumRegistry->setName(spectrumSlot, properties.name);
+}
+
 //==============================================================================
 void TradeMarkEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
@@ -100,12 +112,57 @@ void TradeMarkEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
 
     spec.maximumBlockSize = samplesPerBlock;
 
-    spec.numChannels = 1;
+    spec.numChannels = getTotalNumOutputChannels();
 
     spec.sampleRate = sampleRate;
 
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    chain.prepare(spec);
+    fadeChain.prepare(spec);
+
+    fadeBuffer.setSize((int)spec.numChannels, samplesPerBlock);
+
+    // Hosts set the precision before they prepare, so the double engine only
+    // takes memory when it's going to be used.
+    const auto doublePrecision = isUsingDoublePrecision();
+
+    doubleChain.prepare(spec);
+    doubleFadeChain.prepare(spec);
+    doubleFadeBuffer.setSize(doublePrecision ? (int)spec.numChannels : 0, doublePrecision ? samplesPerBlock : 0);
+    // A few kilobytes, so it's there whichever precision the host ends up
+    // calling processBlock with.
+    analysisBuffer.setSize(numAnalysisChannels, samplesPerBlock);
+    fadeLength = juce::roundToInt(sampleRate * crossfadeSeconds);
+    fadeSamplesRemaining = 0;
+
+    blockSettings = getChainSettings(apvts);
+    holdingRecall = false;
+
+    for (auto& band : dynamicBands)
+        band.prepare(sampleRate);
+
+    for (auto& modulator : peakModulators)
+        modulator.prepare(sampleRate);
+
+    lowCutModulator.prepare(sampleRate);
+    highCutModulator.prepare(sampleRate);
+    envelopeFollower.prepare(sampleRate);
+
+    qualityScheduler.prepare(sampleRate);
+    automation.prepare();
+
+    const auto numMeteredChannels = juce::jmin((int)spec.numChannels, LoudnessMeter::maxChannels);
+    inputLoudness.prepare(sampleRate, samplesPerBlock, numMeteredChannels);
+    outputLoudness.prepare(sampleRate, samplesPerBlock, numMeteredChannels);
+    autoGain.prepare(sampleRate);
+    prepareLoudnessEstimate(sampleRate);
+
+    inputLevels.prepare(sampleRate, numMeteredChannels);
+    outputLevels.prepare(sampleRate, numMeteredChannels);
+
+    spectrumFifo.prepare(sampleRate);
+    resonanceTap.prepare(sampleRate);
+    matchTap.prepare(sampleRate);
+    spectrumRegistry->prepare(spectrumSlot, sampleRate);
 
     updateFilters();
 
@@ -136,6 +193,17 @@ bool TradeMarkEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // The sidechain only feeds the dynamic band detectors, which look at up to two channels.
+    if (layouts.inputBuses.size() > 1)
+    {
+        auto sidechain = layouts.getChannelSet(true, 1);
+
+        if (!sidechain.isDisabled()
+         && sidechain != juce::AudioChannelSet::mono()
+         && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
    #endif
 
     return true;
@@ -144,8 +212,76 @@ bool TradeMarkEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 #endif
 
 void TradeMarkEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+
+    qualityScheduler.setNonRealtime(isNonRealtime());
+    QualityScheduler::ScopedBlock timing(qualityScheduler, buffer.getNumSamples());
+
+    processSegments(buffer);
+}
+
+void TradeMarkEQAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+
+    qualityScheduler.setNonRealtime(isNonRealtime());
+    QualityScheduler::ScopedBlock timing(qualityScheduler, buffer.getNumSamples());
+
+    // The float copies for the meters only have room for the block size the
+    // host promised, so anything longer goes through in pieces. Without
+    // prepareToPlay() there's no room at all, and processSamples() leaves the
+    // meters out rather than running one sample at a time.
+    const auto maximumLength = analysisBuffer.getNumSamples();
+
+    if (maximumLength == 0 || buffer.getNumSamples() <= maximumLength)
+    {
+        processSegments(buffer);
+        return;
+    }
+
+    for (int start = 0; start < buffer.getNumSamples(); start += maximumLength)
+    {
+        juce::AudioBuffer<double> piece(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start,
+            juce::jmin(maximumLength, buffer.getNumSamples() - start));
+
+        processSegments(piece);
+    }
+}
+
+bool TradeMarkEQAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename SampleType>
+void TradeMarkEQAudioProcessor::processSegments(juce::AudioBuffer<SampleType>& buffer)
+{
+    const auto numSegments = automation.beginBlock(buffer.getNumSamples());
+
+    if (numSegments == 1)
+    {
+        automation.applySegment(0);
+        processSamples(buffer);
+        return;
+    }
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        const auto segment = automation.applySegment(i);
+
+        juce::AudioBuffer<SampleType> piece(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+            segment.start, segment.length);
+
+        processSamples(piece);
+    }
+}
+
+template <typename SampleType>
+void TradeMarkEQAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -158,22 +294,634 @@ void TradeMarkEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    const auto& chainSettings = updateBlockSettings();
+
+    // A recall hands over coefficients that were designed on the message
+    // thread, so there's nothing to redesign until it's finished.
+    if (!holdingRecall)
+        updateFilters(chainSettings);
+
+    updatePrecision();
+
+    // The double engine runs whatever the float chain was designed with.
+    if constexpr (std::is_same_v<SampleType, double>)
+        copyCoefficients(doubleChain, chain);
+
+    auto mainBuffer = getBusBuffer(buffer, true, 0);
+    juce::dsp::AudioBlock<SampleType> block(mainBuffer);
+
+    // Everything that reads a float copy of a double block sits it out if
+    // the copy wouldn't fit.
+    auto hasFloatCopy = true;
+
+    if constexpr (std::is_same_v<SampleType, double>)
+        hasFloatCopy = (size_t)analysisBuffer.getNumSamples() >= block.getNumSamples();
+
+    const auto analysis = hasFloatCopy && qualityScheduler.getSettings().analysis;
+
+    auto needsControlRate = false;
+
+    for (int i = 0; i < numPeakBands; ++i)
+    {
+        auto& peak = chainSettings.peaks[(size_t)i];
+        needsControlRate = needsControlRate
+            || (!chainSettings.isPeakBypassed(i) && (peak.dynamics.enabled || peak.modulation.isActive()));
+    }
+
+    needsControlRate = hasFloatCopy
+        && (needsControlRate
+            || (!chainSettings.isLowCutBypassed() && chainSettings.lowCutModulation.isActive())
+            || (!chainSettings.isHighCutBypassed() && chainSettings.highCutModulation.isActive()));
+
+    // What the meters and detectors read, which is a copy when the block is double.
+    juce::dsp::AudioBlock<const float> dryInput;
+
+    if (analysis || needsControlRate)
+        dryInput = getFloatBlock(block, 0);
+
+    if (analysis)
+    {
+        inputLevels.process(dryInput);
+        inputLoudness.process(dryInput);
+        resonanceTap.push(dryInput);
+        matchTap.push(dryInput);
+    }
+
+    // While a recall crossfades, the outgoing filters need their own copy of the dry input.
+    auto& currentFadeBuffer = getFadeBuffer<SampleType>();
+    juce::dsp::AudioBlock<SampleType> fadeBlock;
+
+    if (fadeSamplesRemaining > 0)
+    {
+        fadeBlock = juce::dsp::AudioBlock<SampleType>(currentFadeBuffer)
+            .getSubsetChannelBlock(0, juce::jmin(block.getNumChannels(), (size_t)currentFadeBuffer.getNumChannels()))
+            .getSubBlock(0, juce::jmin(block.getNumSamples(), (size_t)currentFadeBuffer.getNumSamples()));
+
+        fadeBlock.copyFrom(block);
+    }
+
+    if (needsControlRate)
+    {
+        processAtControlRate(buffer, block, dryInput, chainSettings);
+    }
+    else
+    {
+        juce::dsp::ProcessContextReplacing<SampleType> context(block);
+        getChain<SampleType>().process(context);
+    }
+
+    if (fadeSamplesRemaining > 0)
+        mixCrossfade(block, fadeBlock);
+
+    // The output meter sits before the auto-gain stage and the rest after
+    // it. A double block is copied to float once, before the stage, which
+    // then scales the copy along with the block.
+    juce::dsp::AudioBlock<const float> output;
+
+    if (analysis)
+    {
+        output = getFloatBlock(block, 0);
+        outputLoudness.process(output);
+    }
+
+    updateAutoGain(chainSettings, (int)block.getNumSamples());
+
+    if constexpr (std::is_same_v<SampleType, double>)
+    {
+        if (analysis)
+        {
+            auto copy = juce::dsp::AudioBlock<float>(analysisBuffer)
+                .getSubsetChannelBlock(0, output.getNumChannels())
+                .getSubBlock(0, output.getNumSamples());
+
+            autoGain.process(block, copy);
+        }
+        else
+        {
+            autoGain.process(block);
+        }
+    }
+    else
+    {
+        autoGain.process(block);
+    }
+
+    if (analysis)
+    {
+        outputLevels.process(output);
+        spectrumFifo.push(output);
+        spectrumRegistry->push(spectrumSlot, output);
+    }
+}
+
+template <typename SampleType>
+juce::dsp::AudioBlock<const float> TradeMarkEQAudioProcessor::getFloatBlock(const juce::dsp::AudioBlock<SampleType>& block,
+    int firstChannel) noexcept
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        juce::ignoreUnused(firstChannel);
+        return block;
+    }
+    else
+    {
+        const auto numChannels = juce::jmin(block.getNumChannels(), (size_t)juce::jmax(0, analysisBuffer.getNumChannels() - firstChannel));
+        const auto numSamples = juce::jmin(block.getNumSamples(), (size_t)analysisBuffer.getNumSamples());
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* source = block.getChannelPointer(ch);
+            auto* destination = analysisBuffer.getWritePointer(firstChannel + (int)ch);
+
+            for (size_t n = 0; n < numSamples; ++n)
+                destination[n] = (float)source[n];
+        }
+
+        return juce::dsp::AudioBlock<const float>(analysisBuffer)
+            .getSubsetChannelBlock((size_t)firstChannel, numChannels)
+            .getSubBlock(0, numSamples);
+    }
+}
+
+const ChainSettings& TradeMarkEQAudioProcessor::updateBlockSettings()
+{
+    // The message thread only holds this lock while it hands over a recall,
+    // and a failed try means one is on its way. Until it lands, the previous
+    // block's settings are the last complete ones.
+    const juce::SpinLock::ScopedTryLockType lock(recallLock);
+
+    if (!lock.isLocked())
+        return blockSettings;
+
+    if (holdingRecall && !recallInProgress.load())
+        holdingRecall = false;
+
+    if (pendingRecall.ready)
+    {
+        if (pendingRecall.crossfade && fadeLength > 0 && qualityScheduler.getSettings().crossfadeRecalls)
+        {
+            if (isUsingDoublePrecision())
+                doubleFadeChain = doubleChain;
+            else
+                fadeChain = chain;
+
+            fadeSamplesRemaining = fadeLength;
+        }
+
+        copyCoefficients(chain, pendingRecall.chain);
+        blockSettings = pendingRecall.settings;
+        pendingRecall.ready = false;
+
+        // The parameters are still being moved one at a time, so ignore
+        // them until the message thread says they're all there.
+        holdingRecall = true;
+    }
+
+    // Scheduled automation moves a copy of the parameters, not the
+    // parameters themselves.
+    if (!holdingRecall)
+        blockSettings = automation.isHoldingValues() ? getChainSettings(apvts, automation.getValues())
+                                                     : getChainSettings(apvts);
+
+    return blockSettings;
+}
+
+template <typename SampleType>
+void TradeMarkEQAudioProcessor::mixCrossfade(juce::dsp::AudioBlock<SampleType>& block, juce::dsp::AudioBlock<SampleType>& fadeBlock)
+{
+    juce::dsp::ProcessContextReplacing<SampleType> context(fadeBlock);
+    getFadeChain<SampleType>().process(context);
+
+    const auto numSamples = fadeBlock.getNumSamples();
+    const auto fadeStart = fadeLength - fadeSamplesRemaining;
+    const auto step = SampleType(1) / (SampleType)fadeLength;
+    const auto& kernels = DspKernels::get();
+
+    for (size_t ch = 0; ch < fadeBlock.getNumChannels(); ++ch)
+    {
+        auto* output = block.getChannelPointer(ch);
+        const auto* previous = fadeBlock.getChannelPointer(ch);
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            kernels.crossfade(output, previous, numSamples, fadeStart, step);
+        }
+        else
+        {
+            // The same fade as the kernels', which only come in float.
+            for (size_t n = 0; n < numSamples; ++n)
+            {
+                auto gain = juce::jmin(SampleType(1), (SampleType)(fadeStart + (int)n) * step);
+                output[n] = previous[n] + gain * (output[n] - previous[n]);
+            }
+        }
+    }
+
+    // A block longer than the host promised in prepareToPlay ends the fade early.
+    fadeSamplesRemaining = numSamples < block.getNumSamples()
+        ? 0
+        : juce::jmax(0, fadeSamplesRemaining - (int)numSamples);
+}
+
+namespace
+{
+    // Moves a frequency by a number of octaves, keeping it inside the audible
+    // range and below Nyquist.
+    float modulateFrequency(float freq, float octaves, double sampleRate)
+    {
+        return juce::jlimit(20.f, juce::jmin(20000.f, (float)sampleRate * 0.49f), freq * std::exp2(octaves));
+    }
+
+    // Applies one modulation value to a band's frequency, gain and Q. Returns
+    // true if the frequency or Q moved, so the caller knows whether the cheap
+    // gain-only redesign is still valid.
+    bool modulatePeak(PeakSettings& peak, float value, double sampleRate)
+    {
+        auto& modulation = peak.modulation;
+
+        peak.gainInDecibels = juce::jlimit(-24.f, 24.f, peak.gainInDecibels + value * modulation.gainDepthDecibels);
+
+        if (modulation.freqDepthOctaves == 0.f && modulation.qualityDepthOctaves == 0.f)
+            return false;
+
+        peak.freq = modulateFrequency(peak.freq, value * modulation.freqDepthOctaves, sampleRate);
+        peak.quality = juce::jlimit(0.05f, 20.f, peak.quality * std::exp2(value * modulation.qualityDepthOctaves));
+
+        return true;
+    }
+
+    CutChannel getCutChannel(const ChannelSettings& settings, CutType type) noexcept
+    {
+        if (type == CutType::HighPass)
+            return { settings.lowCutFreq, settings.lowCutSlope, settings.lowCutBypassed };
+
+        return { settings.highCutFreq, settings.highCutSlope, settings.highCutBypassed };
+    }
+
+    // Moves a cut's frequency by a number of octaves, on both channels alike
+    // when they're unlinked.
+    void updateModulatedCut(CutFilter& cutFilter, CutType type, ChannelRouting channels,
+        const ChainSettings& chainSettings, float octaves, double sampleRate)
+    {
+        auto first = getCutChannel(chainSettings, type);
+        first.frequency = modulateFrequency(first.frequency, octaves, sampleRate);
+
+        if (chainSettings.channelsLinked)
+        {
+            updateCutFilter(cutFilter, type, first.frequency, first.slope, sampleRate, channels);
+            return;
+        }
+
+        auto second = getCutChannel(chainSettings.secondChannel, type);
+        second.frequency = modulateFrequency(second.frequency, octaves, sampleRate);
+
+        updateCutFilter(cutFilter, type, first, second, sampleRate);
+    }
+
+    // Loads an unlinked band, each channel's design in its own lane of the
+    // same section. A channel whose band is bypassed passes through.
+    void loadUnlinkedPeak(PeakFilters& peakFilters, int index,
+        const PeakSettings& first, const PeakFilters::Design& firstDesign,
+        const PeakSettings& second, const PeakFilters::Design& secondDesign) noexcept
+    {
+        peakFilters.setChannelSection(index, 0, first.bypassed ? nullptr : &firstDesign);
+        peakFilters.setChannelSection(index, 1, second.bypassed ? nullptr : &secondDesign);
+        peakFilters.setSectionEnabled(index, !(first.bypassed && second.bypassed));
+    }
+}
+
+template <typename SampleType>
+void TradeMarkEQAudioProcessor::processAtControlRate(juce::AudioBuffer<SampleType>& buffer,
+    juce::dsp::AudioBlock<SampleType>& block,
+    const juce::dsp::AudioBlock<const float>& input,
+    const ChainSettings& chainSettings)
+{
+    // The detectors listen to the dry input unless the external sidechain is
+    // switched on and the host has actually connected it.
+    auto key = input;
+
+    auto sidechainBuffer = getBusBuffer(buffer, true, 1);
+    auto* sidechainBus = getBus(true, 1);
+
+    if (chainSettings.externalSidechain
+        && sidechainBus != nullptr
+        && sidechainBus->isEnabled()
+        && sidechainBuffer.getNumChannels() > 0)
+    {
+        key = getFloatBlock(juce::dsp::AudioBlock<SampleType>(sidechainBuffer), 2);
+    }
+
+    for (int i = 0; i < numPeakBands; ++i)
+    {
+        auto& peak = chainSettings.peaks[(size_t)i];
+        dynamicBands[(size_t)i].setParameters(peak.freq, peak.quality, peak.dynamics);
+    }
+
+    auto& peaks = chain.get<ChainPositions::Peaks>();
+    const auto numSamples = block.getNumSamples();
+    const auto sampleRate = getSampleRate();
+    const auto interval = (size_t)qualityScheduler.getSettings().controlInterval;
+
+    for (size_t start = 0; start < numSamples; start += interval)
+    {
+        auto length = juce::jmin(interval, numSamples - start);
+        auto subBlock = block.getSubBlock(start, length);
+        auto keyBlock = key.getSubBlock(start, length);
+
+        // Envelope modulation follows the dry input, whatever the detectors listen to.
+        auto envelope = envelopeFollower.process(input.getSubBlock(start, length));
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            auto peak = chainSettings.peaks[(size_t)i];
+            auto secondPeak = chainSettings.secondChannel.peaks[(size_t)i];
+            auto isModulated = peak.modulation.isActive();
+            auto unlinked = !chainSettings.channelsLinked;
+
+            if (chainSettings.isPeakBypassed(i) || !(peak.dynamics.enabled || isModulated))
+                continue;
+
+            auto& band = dynamicBands[(size_t)i];
+            auto reshaped = false;
+
+            // Unlinked, the second channel's band moves with the first's: the
+            // same modulation, and the gain its detector, tuned to the first
+            // channel's band, asks for.
+            if (isModulated)
+            {
+                auto value = peakModulators[(size_t)i].advance(peak.modulation, (int)length, envelope);
+                reshaped = modulatePeak(peak, value, sampleRate);
+
+                if (unlinked)
+                    modulatePeak(secondPeak, value, sampleRate);
+            }
+
+            if (peak.dynamics.enabled)
+            {
+                auto gain = band.process(keyBlock);
+                peak.gainInDecibels += gain;
+                secondPeak.gainInDecibels += gain;
+            }
+
+            // The dynamic band caches the unmodulated frequency and Q, so it can
+            // only do the gain-only redesign while those haven't moved.
+            auto design = reshaped || !peak.dynamics.enabled ? makePeakFilter(peak, sampleRate)
+                                                             : band.makeDesign(peak.gainInDecibels);
+
+            if (unlinked)
+                loadUnlinkedPeak(peaks, i, peak, design, secondPeak, makePeakFilter(secondPeak, sampleRate));
+            else
+                peaks.setSection(i, design, getChannelMask(peak.channels));
+        }
+
+        if (!chainSettings.isLowCutBypassed() && chainSettings.lowCutModulation.isActive())
+        {
+            auto& modulation = chainSettings.lowCutModulation;
+            auto value = lowCutModulator.advance(modulation, (int)length, envelope);
+
+            updateModulatedCut(chain.get<ChainPositions::LowCut>(), CutType::HighPass, chainSettings.lowCutChannels,
+                chainSettings, value * modulation.freqDepthOctaves, sampleRate);
+        }
+
+        if (!chainSettings.isHighCutBypassed() && chainSettings.highCutModulation.isActive())
+        {
+            auto& modulation = chainSettings.highCutModulation;
+            auto value = highCutModulator.advance(modulation, (int)length, envelope);
+
+            updateModulatedCut(chain.get<ChainPositions::HighCut>(), CutType::LowPass, chainSettings.highCutChannels,
+                chainSettings, value * modulation.freqDepthOctaves, sampleRate);
+        }
+
+        if constexpr (std::is_same_v<SampleType, double>)
+            copyCoefficients(doubleChain, chain);
+
+        juce::dsp::ProcessContextReplacing<SampleType> context(subBlock);
+        getChain<SampleType>().process(context);
+    }
+}
+
+void TradeMarkEQAudioProcessor::updateAutoGain(const ChainSettings& chainSettings, int numSamples) noexcept
+{
+    switch (chainSettings.autoGain)
+    {
+        case AutoGainMode::Measured:
+        {
+            auto& input = inputLoudness.getCurrentReadings();
+            auto& output = outputLoudness.getCurrentReadings();
+
+            // Through silence, and while the meters are off, the last
+            // correction stays where it was.
+            if (input.shortTerm > LoudnessMeter::absoluteGate && output.shortTerm > LoudnessMeter::absoluteGate)
+                autoGain.setTargetDecibels(input.shortTerm - output.shortTerm);
+
+            samplesUntilEstimate = 0;
+            break;
+        }
+
+        case AutoGainMode::Estimated:
+        {
+            // Modulated and dynamic bands move the curve, so it's estimated
+            // again every so often rather than only on parameter changes.
+            samplesUntilEstimate -= numSamples;
+
+            if (samplesUntilEstimate <= 0)
+            {
+                samplesUntilEstimate = juce::roundToInt(getSampleRate() * estimateIntervalSeconds);
+                autoGain.setTargetDecibels(-estimateLoudnessChange());
+            }
+
+            break;
+        }
+
+        case AutoGainMode::Off:
+        default:
+            autoGain.setTargetDecibels(0.f);
+            samplesUntilEstimate = 0;
+            break;
+    }
+}
+
+void TradeMarkEQAudioProcessor::prepareLoudnessEstimate(double sampleRate)
+{
+    // Log spaced, so equal weights give every octave the same energy, like
+    // pink noise. The K-weighting on top turns energy into loudness.
+    constexpr int numPoints = 64;
+    const auto top = juce::jmin(20000.0, sampleRate * 0.45);
+
+    std::vector<double> frequencies;
+
+    for (int i = 0; i < numPoints; ++i)
+        frequencies.push_back(juce::mapToLog10((i + 0.5) / numPoints, 20.0, top));
+
+    estimateGrid = DspKernels::FrequencyGrid(frequencies, sampleRate);
+
+    FilterCascade<float, 2> kWeighting;
+    auto designs = LoudnessMeter::makeKWeighting(sampleRate);
+
+    for (int i = 0; i < (int)designs.size(); ++i)
+        kWeighting.setSection(i, designs[(size_t)i]);
+
+    kWeighting.setNumSections((int)designs.size());
+
+    estimateWeights.assign(numPoints, 1.0);
+    kWeighting.accumulateMagnitudes(estimateGrid, estimateWeights.data());
+
+    for (auto& weight : estimateWeights)
+        weight *= weight;
+
+    estimateMagnitudes.assign(numPoints, 1.0);
+    samplesUntilEstimate = 0;
+}
+
+float TradeMarkEQAudioProcessor::estimateLoudnessChange() noexcept
+{
+    const auto numChannels = juce::jmin(getTotalNumOutputChannels(), 2);
+    double weighted = 0.0, total = 0.0;
+
+    // In M/S the two channels are mid and side, which is close enough for
+    // an estimate.
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        std::fill(estimateMagnitudes.begin(), estimateMagnitudes.end(), 1.0);
+        accumulateMagnitudes(chain, estimateGrid, estimateMagnitudes.data(), (size_t)ch);
+
+        for (size_t i = 0; i < estimateMagnitudes.size(); ++i)
+        {
+            weighted += estimateWeights[i] * estimateMagnitudes[i] * estimateMagnitudes[i];
+            total += estimateWeights[i];
+        }
+    }
+
+    if (total <= 0.0)
+        return 0.f;
+
+    return weighted > 0.0 ? (float)(10.0 * std::log10(weighted / total)) : -AutoGain::maxDecibels;
+}
+
+LoudnessMeter::Readings TradeMarkEQAudioProcessor::getOutputLoudness() const noexcept
+{
+    auto readings = outputLoudness.getReadings();
+    auto offset = autoGain.getDecibels();
+
+    // Only exact for a constant gain, which a correction that moves slowly
+    // compared with the meter's windows is close to.
+    for (auto* value : { &readings.momentary, &readings.shortTerm, &readings.integrated, &readings.truePeak })
+        if (*value > LoudnessMeter::silence)
+            *value += offset;
+
+    return readings;
+}
+
+void TradeMarkEQAudioProcessor::resetLoudness() noexcept
+{
+    inputLoudness.requestReset();
+    outputLoudness.requestReset();
+}
+
+std::vector<NotchSuggestion> TradeMarkEQAudioProcessor::suggestNotches(
+    const std::vector<ResonanceTracker::Resonance>& resonances)
+{
     auto chainSettings = getChainSettings(apvts);
 
-    updateFilters();
+    std::array<bool, numPeakBands> inUse;
+
+    for (size_t i = 0; i < inUse.size(); ++i)
+    {
+        const auto& peak = chainSettings.peaks[i];
+        inUse[i] = !peak.bypassed && (peak.gainInDecibels != 0.f || peak.dynamics.enabled || peak.modulation.isActive());
+    }
+
+    std::vector<NotchSuggestion> suggestions;
+
+    for (const auto& resonance : resonances)
+    {
+        auto octavesTo = [&](float frequency) { return std::abs(std::log2(resonance.frequency / frequency)); };
+
+        auto alreadyCut = std::any_of(chainSettings.peaks.begin(), chainSettings.peaks.end(), [&](const PeakSettings& peak)
+            {
+                return !peak.bypassed && peak.gainInDecibels < 0.f && octavesTo(peak.freq) < 1.f / 6.f;
+            });
+
+        if (alreadyCut)
+            continue;
+
+        auto band = -1;
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            const auto& info = peakBands[i];
 
-    juce::dsp::AudioBlock<float> block(buffer);
+            if (inUse[(size_t)i] || resonance.frequency < info.minFreq || resonance.frequency > info.maxFreq)
+                continue;
 
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
+            if (band < 0 || octavesTo(info.defaultFreq) < octavesTo(peakBands[band].defaultFreq))
+                band = i;
+        }
 
-    juce::dsp::ProcessContextReplacing<float>leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float>rightContext(rightBlock);
+        if (band < 0)
+            continue;
 
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+        inUse[(size_t)band] = true;
 
+        NotchSuggestion notch;
+        notch.band = band;
+        notch.frequency = std::round(resonance.frequency);
+        notch.quality = juce::jlimit(0.1f, 10.f, std::round(resonance.quality * 20.f) / 20.f);
 
+        // Cut by as much as it stands out, in the gain parameter's half dB steps.
+        notch.gainInDecibels = -juce::jlimit(0.5f, 12.f, std::round(resonance.prominence * 2.f) / 2.f);
+
+        suggestions.push_back(notch);
+    }
+
+    return suggestions;
+}
+
+void TradeMarkEQAudioProcessor::applyNotches(const std::vector<NotchSuggestion>& notches)
+{
+    auto values = getParameterValues();
+
+    for (const auto& notch : notches)
+    {
+        const auto& ids = getPeakParameterIDs(notch.band);
+
+        setParameterValue(values, ids.freq, notch.frequency);
+        setParameterValue(values, ids.quality, notch.quality);
+        setParameterValue(values, ids.gain, notch.gainInDecibels);
+        setParameterValue(values, ids.bypassed, 0.f);
+    }
+
+    recallParameterValues(values, true);
+}
+
+void TradeMarkEQAudioProcessor::applyMatch(const ChainSettings& matched)
+{
+    auto values = getParameterValues();
+
+    setParameterValue(values, "LowCut Freq", matched.lowCutFreq);
+    setParameterValue(values, "LowCut Bypassed", matched.lowCutBypassed ? 1.f : 0.f);
+    setParameterValue(values, "HighCut Freq", matched.highCutFreq);
+    setParameterValue(values, "HighCut Bypassed", matched.highCutBypassed ? 1.f : 0.f);
+
+    for (int i = 0; i < numPeakBands; ++i)
+    {
+        const auto& ids = getPeakParameterIDs(i);
+        const auto& peak = matched.peaks[(size_t)i];
+
+        setParameterValue(values, ids.freq, peak.freq);
+        setParameterValue(values, ids.gain, peak.gainInDecibels);
+        setParameterValue(values, ids.quality, peak.quality);
+        setParameterValue(values, ids.bypassed, peak.bypassed ? 1.f : 0.f);
+    }
+
+    recallParameterValues(values, true);
+}
+
+void TradeMarkEQAudioProcessor::setParameterValue(std::vector<float>& normalisedValues,
+    const juce::String& parameterID, float value) const
+{
+    if (auto* parameter = apvts.getParameter(parameterID))
+        normalisedValues[(size_t)parameter->getParameterIndex()] = parameter->convertTo0to1(value);
 }
 
 //==============================================================================
@@ -195,8 +943,7 @@ void TradeMarkEQAudioProcessor::getStateInformation (juce::MemoryBlock& destData
     // You could do that either as raw data, or use the XML or ValueTree classes
     // as intermediaries to make it easy to save and load complex data.
 
-    juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    StateFormat::write(getParameters(), destData);
 }
 
 void TradeMarkEQAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
@@ -204,166 +951,543 @@ void TradeMarkEQAudioProcessor::setStateInformation (const void* data, int sizeI
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
 
-    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (tree.isValid())
+    std::vector<float> values;
+    auto result = StateFormat::read(data, sizeInBytes, getParameters(), apvts.state.getType(), values);
+
+    if (result.wasOk())
+    {
+        recallParameterValues(values, false);
+        return;
+    }
+
+    // The parameters keep what they had. Say so, rather than let the session
+    // come back with different settings and no word why.
+    juce::Logger::writeToLog("TradeMark EQ couldn't restore its settings: " + result.getErrorMessage());
+
     {
-        apvts.replaceState(tree);
-        updateFilters();
+        const juce::ScopedLock lock(stateErrorLock);
+        stateError = result.getErrorMessage();
     }
+
+    sendChangeMessage();
 }
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
+juce::String TradeMarkEQAudioProcessor::takeStateError()
+{
+    const juce::ScopedLock lock(stateErrorLock);
+    return std::exchange(stateError, {});
+}
+
+std::vector<float> TradeMarkEQAudioProcessor::getParameterValues() const
 {
-    ChainSettings settings;
+    std::vector<float> values;
+
+    for (auto* parameter : getParameters())
+        values.push_back(parameter->getValue());
+
+    return values;
+}
+
+void TradeMarkEQAudioProcessor::recallParameterValues(const std::vector<float>& normalisedValues, bool crossfade)
+{
+    auto settings = getChainSettings(apvts, normalisedValues);
+    auto sampleRate = getSampleRate();
+
+    recallInProgress = true;
 
-    settings.lowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
-    settings.highCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
+    if (sampleRate > 0)
+    {
+        // Designed here, so the audio thread only has to copy coefficients.
+        EqChain designed;
+        updateEqChain(designed, settings, sampleRate);
 
-    settings.lowPeakFreq = apvts.getRawParameterValue("LowPeak Freq")->load();
-    settings.lowPeakGainInDecibels = apvts.getRawParameterValue("LowPeak Gain")->load();
-    settings.lowPeakQuality = apvts.getRawParameterValue("LowPeak Quality")->load();
+        const juce::SpinLock::ScopedLockType lock(recallLock);
 
-    settings.midlowPeakFreq = apvts.getRawParameterValue("MidLowPeak Freq")->load();
-    settings.midlowPeakGainInDecibels = apvts.getRawParameterValue("MidLowPeak Gain")->load();
-    settings.midlowPeakQuality = apvts.getRawParameterValue("MidLowPeak Quality")->load();
+        pendingRecall.settings = settings;
+        pendingRecall.chain = designed;
+        pendingRecall.crossfade = crossfade;
+        pendingRecall.ready = true;
+    }
 
-    settings.midPeakFreq = apvts.getRawParameterValue("MidPeak Freq")->load();
-    settings.midPeakGainInDecibels = apvts.getRawParameterValue("MidPeak Gain")->load();
-    settings.midPeakQuality = apvts.getRawParameterValue("MidPeak Quality")->load();
+    applyParameterValues(normalisedValues);
 
-    settings.midhighPeakFreq = apvts.getRawParameterValue("MidHighPeak Freq")->load();
-    settings.midhighPeakGainInDecibels = apvts.getRawParameterValue("MidHighPeak Gain")->load();
-    settings.midhighPeakQuality = apvts.getRawParameterValue("MidHighPeak Quality")->load();
+    recallInProgress = false;
+}
 
-    settings.highPeakFreq = apvts.getRawParameterValue("HighPeak Freq")->load();
-    settings.highPeakGainInDecibels = apvts.getRawParameterValue("HighPeak Gain")->load();
-    settings.highPeakQuality = apvts.getRawParameterValue("HighPeak Quality")->load();
+void TradeMarkEQAudioProcessor::applyParameterValues(const std::vector<float>& normalisedValues)
+{
+    const auto& parameters = getParameters();
+    jassert((int)normalisedValues.size() == parameters.size());
 
-    settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue("LowCut Slope")->load());
-    settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("HighCut Slope")->load());
+    applyingParameterValues = true;
 
-    settings.lowCutBypassed = apvts.getRawParameterValue("LowCut Bypassed")->load() > 0.5f;
-    settings.lowPeakBypassed = apvts.getRawParameterValue("LowPeak Bypassed")->load() > 0.5f;
-    settings.midlowPeakBypassed = apvts.getRawParameterValue("MidLowPeak Bypassed")->load() > 0.5f;
-    settings.midPeakBypassed = apvts.getRawParameterValue("MidPeak Bypassed")->load() > 0.5f;
-    settings.midhighPeakBypassed = apvts.getRawParameterValue("MidHighPeak Bypassed")->load() > 0.5f;
-    settings.highPeakBypassed = apvts.getRawParameterValue("HighPeak Bypassed")->load() > 0.5f;
-    settings.highCutBypassed = apvts.getRawParameterValue("HighCut Bypassed")->load() > 0.5f;
+    for (int i = 0; i < juce::jmin(parameters.size(), (int)normalisedValues.size()); ++i)
+    {
+        auto* parameter = parameters.getUnchecked(i);
+        auto value = normalisedValues[(size_t)i];
+
+        // The APVTS picks the new value up through the parameter's listener,
+        // and flushes it into apvts.state on its own timer.
+        if (parameter->getValue() != value)
+            parameter->setValueNotifyingHost(value);
+    }
 
-    return settings;
+    applyingParameterValues = false;
+
+    sendChangeMessage();
+}
+
+const PeakParameterIDs& getPeakParameterIDs(int band)
+{
+    static const auto ids = []
+    {
+        std::array<PeakParameterIDs, numPeakBands> result;
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            juce::String name(peakBands[i].name);
+            result[(size_t)i] = { name + " Freq", name + " Gain", name + " Quality", name + " Bypassed", name + " Channels",
+                name + " Freq 2", name + " Gain 2", name + " Quality 2", name + " Bypassed 2",
+                name + " Dynamic", name + " Threshold", name + " Ratio", name + " Attack", name + " Release",
+                name + " Mod Source", name + " Mod Rate", name + " Mod Freq", name + " Mod Gain", name + " Mod Quality" };
+        }
+
+        return result;
+    }();
+
+    jassert(juce::isPositiveAndBelow(band, numPeakBands));
+    return ids[(size_t)band];
 }
 
-Coefficients makeLowPeakFilter(const ChainSettings& chainSettings, double sampleRate)
+namespace
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-        chainSettings.lowPeakFreq,
-        chainSettings.lowPeakQuality,
-        juce::Decibels::decibelsToGain(chainSettings.lowPeakGainInDecibels));
+    // Cuts have no gain or Q to modulate, so they pass empty IDs for those.
+    template <typename GetValue>
+    ModulationSettings readModulationSettings(GetValue&& get,
+        juce::StringRef sourceID, juce::StringRef rateID, juce::StringRef freqID,
+        juce::StringRef gainID = {}, juce::StringRef qualityID = {})
+    {
+        ModulationSettings settings;
 
+        settings.source = static_cast<ModSource>(get(sourceID));
+        settings.rateHz = get(rateID);
+        settings.freqDepthOctaves = get(freqID);
+
+        if (gainID.isNotEmpty())
+            settings.gainDepthDecibels = get(gainID);
+
+        if (qualityID.isNotEmpty())
+            settings.qualityDepthOctaves = get(qualityID);
+
+        return settings;
+    }
+
+    // Builds the settings from get(parameterID), which returns the plain value
+    // of a parameter, so they can come from the live parameters or a snapshot.
+    // The IDs go in as StringRefs, so the literals never become Strings and
+    // nothing here allocates on the audio thread.
+    template <typename GetValue>
+    ChainSettings readChainSettings(GetValue&& get)
+    {
+        ChainSettings settings;
+
+        settings.lowCutFreq = get("LowCut Freq");
+        settings.highCutFreq = get("HighCut Freq");
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            auto& ids = getPeakParameterIDs(i);
+            auto& peak = settings.peaks[(size_t)i];
+
+            peak.freq = get(ids.freq);
+            peak.gainInDecibels = get(ids.gain);
+            peak.quality = get(ids.quality);
+            peak.bypassed = get(ids.bypassed) > 0.5f;
+            peak.channels = static_cast<ChannelRouting>(get(ids.channels));
+
+            peak.dynamics.enabled = get(ids.dynamic) > 0.5f;
+            peak.dynamics.thresholdInDecibels = get(ids.threshold);
+            peak.dynamics.ratio = get(ids.ratio);
+            peak.dynamics.attackMs = get(ids.attack);
+            peak.dynamics.releaseMs = get(ids.release);
+
+            peak.modulation = readModulationSettings(get, ids.modSource, ids.modRate, ids.modFreq, ids.modGain, ids.modQuality);
+        }
+
+        settings.lowCutSlope = getCutSlope(get("LowCut Slope"), get("LowCut Steep Slope"));
+        settings.highCutSlope = getCutSlope(get("HighCut Slope"), get("HighCut Steep Slope"));
+
+        settings.lowCutBypassed = get("LowCut Bypassed") > 0.5f;
+        settings.highCutBypassed = get("HighCut Bypassed") > 0.5f;
+
+        settings.externalSidechain = get("Dynamic Sidechain") > 0.5f;
+
+        settings.channelMode = static_cast<ChannelMode>(get("Channel Mode"));
+        settings.lowCutChannels = static_cast<ChannelRouting>(get("LowCut Channels"));
+        settings.highCutChannels = static_cast<ChannelRouting>(get("HighCut Channels"));
+
+        settings.lowCutModulation = readModulationSettings(get, "LowCut Mod Source", "LowCut Mod Rate", "LowCut Mod Freq");
+        settings.highCutModulation = readModulationSettings(get, "HighCut Mod Source", "HighCut Mod Rate", "HighCut Mod Freq");
+
+        settings.autoGain = static_cast<AutoGainMode>(get("Auto Gain"));
+
+        settings.channelsLinked = get("Channel Link") < 0.5f;
+
+        auto& second = settings.secondChannel;
+
+        second.lowCutFreq = get("LowCut Freq 2");
+        second.highCutFreq = get("HighCut Freq 2");
+
+        for (int i = 0; i < numPeakBands; ++i)
+        {
+            auto& ids = getPeakParameterIDs(i);
+            auto& peak = second.peaks[(size_t)i];
+
+            // Everything but the shape is shared with the first channel.
+            peak = settings.peaks[(size_t)i];
+            peak.freq = get(ids.secondFreq);
+            peak.gainInDecibels = get(ids.secondGain);
+            peak.quality = get(ids.secondQuality);
+            peak.bypassed = get(ids.secondBypassed) > 0.5f;
+        }
+
+        second.lowCutSlope = getCutSlope(get("LowCut Slope 2"), get("LowCut Steep Slope 2"));
+        second.highCutSlope = getCutSlope(get("HighCut Slope 2"), get("HighCut Steep Slope 2"));
+
+        second.lowCutBypassed = get("LowCut Bypassed 2") > 0.5f;
+        second.highCutBypassed = get("HighCut Bypassed 2") > 0.5f;
+
+        return settings;
+    }
 }
-Coefficients makeMidLowPeakFilter(const ChainSettings& chainSettings, double sampleRate)
+
+ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-        chainSettings.midlowPeakFreq,
-        chainSettings.midlowPeakQuality,
-        juce::Decibels::decibelsToGain(chainSettings.midlowPeakGainInDecibels));
+    return readChainSettings([&](juce::StringRef id)
+        {
+            return apvts.getRawParameterValue(id)->load();
+        });
 }
-Coefficients makeMidPeakFilter(const ChainSettings& chainSettings, double sampleRate)
+
+ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts, const std::vector<float>& normalisedValues)
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-        chainSettings.midPeakFreq,
-        chainSettings.midPeakQuality,
-        juce::Decibels::decibelsToGain(chainSettings.midPeakGainInDecibels));
+    return readChainSettings([&](juce::StringRef id)
+        {
+            auto* parameter = apvts.getParameter(id);
+            auto index = parameter->getParameterIndex();
+
+            jassert(juce::isPositiveAndBelow(index, (int)normalisedValues.size()));
+            return parameter->convertFrom0to1(normalisedValues[(size_t)index]);
+        });
 }
-Coefficients makeMidHighPeakFilter(const ChainSettings& chainSettings, double sampleRate)
+
+PeakFilters::Design makePeakFilter(const PeakSettings& peakSettings, double sampleRate)
+{
+    return juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(sampleRate,
+        peakSettings.freq,
+        peakSettings.quality,
+        juce::Decibels::decibelsToGain(peakSettings.gainInDecibels));
+}
+
+namespace
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-        chainSettings.midhighPeakFreq,
-        chainSettings.midhighPeakQuality,
-        juce::Decibels::decibelsToGain(chainSettings.midhighPeakGainInDecibels));
+    static_assert(std::is_same<CutFilter::Design, CoefficientCache::Design>::value
+        && CutFilter::maxSections <= CoefficientCache::maxSections,
+        "cut designs have to fit in the coefficient cache");
+
+    void makeCutDesigns(CutType type, float frequency, int numSections, double sampleRate,
+        CoefficientCache::Designs& designs) noexcept
+    {
+        // 1 / Q of each section, the same values FilterDesign's Butterworth
+        // method uses, for every possible number of sections.
+        static const auto inverseQs = []
+        {
+            std::array<std::array<float, CutFilter::maxSections>, CutFilter::maxSections + 1> result{};
+
+            for (int sections = 1; sections <= CutFilter::maxSections; ++sections)
+                for (int i = 0; i < sections; ++i)
+                    result[(size_t)sections][(size_t)i] = (float)(2.0 * std::cos((2.0 * i + 1.0)
+                        * juce::MathConstants<double>::pi / (4.0 * sections)));
+
+            return result;
+        }();
+
+        // The same terms as IIR::ArrayCoefficients::makeHighPass and makeLowPass.
+        auto n = std::tan(juce::MathConstants<float>::pi * frequency / (float)sampleRate);
+
+        if (type == CutType::LowPass)
+            n = 1.f / n;
+
+        const auto nSquared = n * n;
+
+        for (int i = 0; i < numSections; ++i)
+        {
+            auto invQ = inverseQs[(size_t)numSections][(size_t)i];
+            auto c1 = 1.f / (1.f + invQ * n + nSquared);
+            auto a2 = c1 * (1.f - invQ * n + nSquared);
+
+            if (type == CutType::HighPass)
+                designs[(size_t)i] = { { c1, -2.f * c1, c1, 1.f, c1 * 2.f * (nSquared - 1.f), a2 } };
+            else
+                designs[(size_t)i] = { { c1, 2.f * c1, c1, 1.f, c1 * 2.f * (1.f - nSquared), a2 } };
+        }
+    }
+
+    void loadCutDesigns(CutFilter& cutFilter, const CoefficientCache::Designs& designs, int numSections,
+        ChannelRouting channels) noexcept
+    {
+        const auto channelMask = getChannelMask(channels);
+
+        for (int i = 0; i < numSections; ++i)
+            cutFilter.setSection(i, designs[(size_t)i], channelMask);
+
+        cutFilter.setNumSections(numSections);
+    }
+
+    // Each channel's designs in its own lane. A channel with fewer sections
+    // passes through the rest.
+    void loadUnlinkedCutDesigns(CutFilter& cutFilter, const CoefficientCache::Designs& firstDesigns, int numFirst,
+        const CoefficientCache::Designs& secondDesigns, int numSecond) noexcept
+    {
+        const auto numSections = juce::jmax(numFirst, numSecond);
+
+        for (int i = 0; i < numSections; ++i)
+        {
+            cutFilter.setChannelSection(i, 0, i < numFirst ? &firstDesigns[(size_t)i] : nullptr);
+            cutFilter.setChannelSection(i, 1, i < numSecond ? &secondDesigns[(size_t)i] : nullptr);
+        }
+
+        cutFilter.setNumSections(numSections);
+    }
+
+    // makeCutDesigns() through the shared cache. Only for settings that sit
+    // still; modulated cuts would fill the cache with designs nobody reuses.
+    int getCachedCutDesigns(CutType type, float frequency, const Slope& slope, double sampleRate,
+        CoefficientCache::Designs& designs)
+    {
+        CoefficientCache::Key key;
+        key.shape = type == CutType::HighPass ? CoefficientCache::Shape::HighPass : CoefficientCache::Shape::LowPass;
+        key.numSections = getNumCutSections(slope);
+        key.freq = frequency;
+        key.sampleRate = sampleRate;
+
+        CoefficientCache::getInstance().getDesigns(key, designs, [&](CoefficientCache::Designs& fresh)
+            {
+                makeCutDesigns(type, frequency, key.numSections, sampleRate, fresh);
+            });
+
+        return key.numSections;
+    }
+
+    void updateCachedCutFilter(CutFilter& cutFilter, CutType type, const ChainSettings& chainSettings,
+        ChannelRouting channels, double sampleRate)
+    {
+        const auto first = getCutChannel(chainSettings, type);
+
+        CoefficientCache::Designs designs;
+        auto numSections = getCachedCutDesigns(type, first.frequency, first.slope, sampleRate, designs);
+
+        if (chainSettings.channelsLinked)
+        {
+            loadCutDesigns(cutFilter, designs, numSections, channels);
+            return;
+        }
+
+        const auto second = getCutChannel(chainSettings.secondChannel, type);
+
+        CoefficientCache::Designs secondDesigns;
+        auto numSecond = getCachedCutDesigns(type, second.frequency, second.slope, sampleRate, secondDesigns);
+
+        loadUnlinkedCutDesigns(cutFilter, designs, first.bypassed ? 0 : numSections,
+            secondDesigns, second.bypassed ? 0 : numSecond);
+    }
+
+    void getCachedPeakDesign(const PeakSettings& peak, double sampleRate, CoefficientCache::Designs& designs)
+    {
+        CoefficientCache::Key key;
+        key.freq = peak.freq;
+        key.quality = peak.quality;
+        key.gainInDecibels = peak.gainInDecibels;
+        key.sampleRate = sampleRate;
+
+        CoefficientCache::getInstance().getDesigns(key, designs, [&](CoefficientCache::Designs& fresh)
+            {
+                fresh[0] = makePeakFilter(peak, sampleRate);
+            });
+    }
 }
-Coefficients makeHighPeakFilter(const ChainSettings& chainSettings, double sampleRate)
+
+void updatePeakFilters(PeakFilters& peakFilters, const ChainSettings& chainSettings, double sampleRate)
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-        chainSettings.highPeakFreq,
-        chainSettings.highPeakQuality,
-        juce::Decibels::decibelsToGain(chainSettings.highPeakGainInDecibels));
+    CoefficientCache::Designs designs, secondDesigns;
+
+    for (int i = 0; i < numPeakBands; ++i)
+    {
+        auto& peak = chainSettings.peaks[(size_t)i];
+        getCachedPeakDesign(peak, sampleRate, designs);
+
+        if (chainSettings.channelsLinked)
+        {
+            peakFilters.setSection(i, designs[0], getChannelMask(peak.channels));
+            peakFilters.setSectionEnabled(i, !peak.bypassed);
+            continue;
+        }
+
+        auto& secondPeak = chainSettings.secondChannel.peaks[(size_t)i];
+        getCachedPeakDesign(secondPeak, sampleRate, secondDesigns);
+
+        loadUnlinkedPeak(peakFilters, i, peak, designs[0], secondPeak, secondDesigns[0]);
+    }
 }
 
-void TradeMarkEQAudioProcessor::updatePeakFilters(const ChainSettings& chainSettings)
+void updateCutFilter(CutFilter& cutFilter, CutType type, float frequency, const Slope& slope, double sampleRate,
+    ChannelRouting channels)
 {
-    auto lowPeakCoefficients = makeLowPeakFilter(chainSettings, getSampleRate());
-    leftChain.setBypassed<ChainPositions::LowPeak>(chainSettings.lowPeakBypassed);
-    rightChain.setBypassed<ChainPositions::LowPeak>(chainSettings.lowPeakBypassed);
-    updateCoefficients(leftChain.get<ChainPositions::LowPeak>().coefficients, lowPeakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::LowPeak>().coefficients, lowPeakCoefficients);
+    const auto numSections = getNumCutSections(slope);
 
-    auto midlowPeakCoefficients = makeMidLowPeakFilter(chainSettings, getSampleRate());
-    leftChain.setBypassed<ChainPositions::MidLowPeak>(chainSettings.midlowPeakBypassed);
-    rightChain.setBypassed<ChainPositions::MidLowPeak>(chainSettings.midlowPeakBypassed);
-    updateCoefficients(leftChain.get<ChainPositions::MidLowPeak>().coefficients, midlowPeakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::MidLowPeak>().coefficients, midlowPeakCoefficients);
+    CoefficientCache::Designs designs;
+    makeCutDesigns(type, frequency, numSections, sampleRate, designs);
+    loadCutDesigns(cutFilter, designs, numSections, channels);
+}
 
-    auto midPeakCoefficients = makeMidPeakFilter(chainSettings, getSampleRate());
-    leftChain.setBypassed<ChainPositions::MidPeak>(chainSettings.midPeakBypassed);
-    rightChain.setBypassed<ChainPositions::MidPeak>(chainSettings.midPeakBypassed);
-    updateCoefficients(leftChain.get<ChainPositions::MidPeak>().coefficients, midPeakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::MidPeak>().coefficients, midPeakCoefficients);
+void updateCutFilter(CutFilter& cutFilter, CutType type, const CutChannel& first, const CutChannel& second,
+    double sampleRate)
+{
+    const auto numFirst = getNumCutSections(first.slope), numSecond = getNumCutSections(second.slope);
 
-    auto midhighPeakCoefficients = makeMidHighPeakFilter(chainSettings, getSampleRate());
-    leftChain.setBypassed<ChainPositions::MidHighPeak>(chainSettings.midhighPeakBypassed);
-    rightChain.setBypassed<ChainPositions::MidHighPeak>(chainSettings.midhighPeakBypassed);
-    updateCoefficients(leftChain.get<ChainPositions::MidHighPeak>().coefficients, midhighPeakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::MidHighPeak>().coefficients, midhighPeakCoefficients);
+    CoefficientCache::Designs firstDesigns, secondDesigns;
+    makeCutDesigns(type, first.frequency, numFirst, sampleRate, firstDesigns);
+    makeCutDesigns(type, second.frequency, numSecond, sampleRate, secondDesigns);
 
-    auto highPeakCoefficients = makeHighPeakFilter(chainSettings, getSampleRate());
-    leftChain.setBypassed<ChainPositions::HighPeak>(chainSettings.highPeakBypassed);
-    rightChain.setBypassed<ChainPositions::HighPeak>(chainSettings.highPeakBypassed);
-    updateCoefficients(leftChain.get<ChainPositions::HighPeak>().coefficients, highPeakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::HighPeak>().coefficients, highPeakCoefficients);
+    loadUnlinkedCutDesigns(cutFilter, firstDesigns, first.bypassed ? 0 : numFirst,
+        secondDesigns, second.bypassed ? 0 : numSecond);
 }
 
-void updateCoefficients(Coefficients& old, const Coefficients& replacements)
+void updateChannelMode(EqChain& chain, ChannelMode mode)
 {
-    *old = *replacements;
+    auto& lowCut = chain.get<ChainPositions::LowCut>();
+    auto& peaks = chain.get<ChainPositions::Peaks>();
+    auto& highCut = chain.get<ChainPositions::HighCut>();
+
+    // Bypassed or empty filters just copy their input, so the conversion has
+    // to ride on the ones that actually run.
+    const bool active[]
+    {
+        !chain.isBypassed<ChainPositions::LowCut>() && lowCut.getNumActiveSections() > 0,
+        peaks.getNumActiveSections() > 0,
+        !chain.isBypassed<ChainPositions::HighCut>() && highCut.getNumActiveSections() > 0
+    };
+
+    int first = -1, last = -1;
+
+    if (mode == ChannelMode::MidSide)
+    {
+        for (int i = 0; i < (int)std::size(active); ++i)
+        {
+            if (active[i])
+            {
+                if (first < 0)
+                    first = i;
+
+                last = i;
+            }
+        }
+    }
+
+    lowCut.setMidSide(first == ChainPositions::LowCut, last == ChainPositions::LowCut);
+    peaks.setMidSide(first == ChainPositions::Peaks, last == ChainPositions::Peaks);
+    highCut.setMidSide(first == ChainPositions::HighCut, last == ChainPositions::HighCut);
 }
 
-void TradeMarkEQAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings)
+void updateEqChain(EqChain& chain, const ChainSettings& chainSettings, double sampleRate)
 {
-    auto cutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
+    chain.setBypassed<ChainPositions::LowCut>(chainSettings.isLowCutBypassed());
+    chain.setBypassed<ChainPositions::HighCut>(chainSettings.isHighCutBypassed());
+
+    updateCachedCutFilter(chain.get<ChainPositions::LowCut>(), CutType::HighPass, chainSettings,
+        chainSettings.lowCutChannels, sampleRate);
+    updatePeakFilters(chain.get<ChainPositions::Peaks>(), chainSettings, sampleRate);
+    updateCachedCutFilter(chain.get<ChainPositions::HighCut>(), CutType::LowPass, chainSettings,
+        chainSettings.highCutChannels, sampleRate);
+
+    updateChannelMode(chain, chainSettings.channelMode);
+}
 
-    leftChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-    rightChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
+void accumulateMagnitudes(const EqChain& chain, const DspKernels::FrequencyGrid& grid, double* magnitudes,
+    size_t channel)
+{
+    chain.get<ChainPositions::Peaks>().accumulateMagnitudes(grid, magnitudes, channel);
 
-    auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-    auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
+    if (!chain.isBypassed<ChainPositions::LowCut>())
+        chain.get<ChainPositions::LowCut>().accumulateMagnitudes(grid, magnitudes, channel);
 
-    updateCutFilter(leftLowCut, cutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(rightLowCut, cutCoefficients, chainSettings.lowCutSlope);
+    if (!chain.isBypassed<ChainPositions::HighCut>())
+        chain.get<ChainPositions::HighCut>().accumulateMagnitudes(grid, magnitudes, channel);
 }
 
-void TradeMarkEQAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings)
+namespace
 {
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
+    template <typename Chain>
+    void copyChainCoefficients(Chain& destination, const EqChain& source)
+    {
+        destination.template setBypassed<ChainPositions::LowCut>(source.isBypassed<ChainPositions::LowCut>());
+        destination.template setBypassed<ChainPositions::HighCut>(source.isBypassed<ChainPositions::HighCut>());
 
-    leftChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-    rightChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+        destination.template get<ChainPositions::LowCut>().copyCoefficientsFrom(source.get<ChainPositions::LowCut>());
+        destination.template get<ChainPositions::Peaks>().copyCoefficientsFrom(source.get<ChainPositions::Peaks>());
+        destination.template get<ChainPositions::HighCut>().copyCoefficientsFrom(source.get<ChainPositions::HighCut>());
+    }
+}
 
-    auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
+void copyCoefficients(EqChain& destination, const EqChain& source)
+{
+    copyChainCoefficients(destination, source);
+}
 
-    updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-    updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+void copyCoefficients(DoubleEqChain& destination, const EqChain& source)
+{
+    copyChainCoefficients(destination, source);
 }
 
 void TradeMarkEQAudioProcessor::updateFilters()
 {
-    auto chainSettings = getChainSettings(apvts);
+    updateFilters(getChainSettings(apvts));
+}
+
+void TradeMarkEQAudioProcessor::updateFilters(const ChainSettings& chainSettings)
+{
+    updateEqChain(chain, chainSettings, getSampleRate());
+}
 
-    updateLowCutFilters(chainSettings);
-    updatePeakFilters(chainSettings);
-    updateHighCutFilters(chainSettings);
+void TradeMarkEQAudioProcessor::updatePrecision() noexcept
+{
+    if (isUsingDoublePrecision())
+    {
+        constexpr auto allCut = (1u << CutFilter::maxSections) - 1u, allPeaks = (1u << PeakFilters::maxSections) - 1u;
+        promotedSections.store(allCut | (allPeaks << 8) | (allCut << 16), std::memory_order_relaxed);
+        return;
+    }
+
+    const auto precision = filterPrecision.load();
+
+    for (auto* target : { &chain, &fadeChain })
+    {
+        target->get<ChainPositions::LowCut>().setPrecision(precision);
+        target->get<ChainPositions::Peaks>().setPrecision(precision);
+        target->get<ChainPositions::HighCut>().setPrecision(precision);
+    }
 
+    // Dynamic and modulated bands can move in and out of double within the
+    // block; what the filters start it with is close enough for a readout.
+    promotedSections.store(chain.get<ChainPositions::LowCut>().getPromotedSections()
+        | (chain.get<ChainPositions::Peaks>().getPromotedSections() << 8)
+        | (chain.get<ChainPositions::HighCut>().getPromotedSections() << 16), std::memory_order_relaxed);
+}
+
+TradeMarkEQAudioProcessor::PromotedSections TradeMarkEQAudioProcessor::getPromotedSections() const noexcept
+{
+    const auto packed = promotedSections.load(std::memory_order_relaxed);
+    return { packed & 0xff, (packed >> 8) & 0xff, (packed >> 16) & 0xff };
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout TradeMarkEQAudioProcessor::createParameterLayout()
@@ -384,121 +1508,200 @@ juce::AudioProcessorValueTreeState::ParameterLayout TradeMarkEQAudioProcessor::c
             juce::NormalisableRange<float>(20.f, 20000.f, 1.f, .5f),
             20000.f));
 
-    //Low Peak
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("LowPeak Freq",
-            "LowPeak Freq",
-            juce::NormalisableRange<float>(20.f, 500.f, 1.f, .5f),
-            100.f));
+    //Peaks
+    for (int i = 0; i < numPeakBands; ++i)
+    {
+        auto& band = peakBands[i];
+        auto& ids = getPeakParameterIDs(i);
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.freq,
+                ids.freq,
+                juce::NormalisableRange<float>(band.minFreq, band.maxFreq, 1.f, .5f),
+                band.defaultFreq));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.gain,
+                ids.gain,
+                juce::NormalisableRange<float>(-12.f, 12.f, 0.5f, 1.f),
+                0.0f));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.quality,
+                ids.quality,
+                juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
+                1.f));
+    }
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("LowPeak Gain",
-            "LowPeak Gain",
-            juce::NormalisableRange<float>(-12.f, 12.f, 0.5f, 1.f),
-            0.0f));
+    juce::StringArray stringArray;
+    for (auto dbPerOct : { 12, 24, 36, 48 })
+    {
+        juce::String str;
+        str << dbPerOct;
+        str << " db/Oct";
+        stringArray.add(str);
+    }
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("LowPeak Quality",
-            "LowPeak Quality",
-            juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
-            1.f));
+    //HPF & LPF Slopes
+    layout.add(std::make_unique < juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", stringArray, 0));
+    layout.add(std::make_unique < juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", stringArray, 0));
 
-    //Mid Low Peak
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("MidLowPeak Freq",
-            "MidLowPeak Freq",
-            juce::NormalisableRange<float>(40.f, 1000.f, 1.f, .5f),
-            300.f));
+    layout.add(std::make_unique<juce::AudioParameterBool>("LowCut Bypassed", "LowCut Bypassed", false));
+    for (int i = 0; i < numPeakBands; ++i)
+    {
+        auto& ids = getPeakParameterIDs(i);
+        layout.add(std::make_unique<juce::AudioParameterBool>(ids.bypassed, ids.bypassed, false));
+    }
+    layout.add(std::make_unique<juce::AudioParameterBool>("HighCut Bypassed", "HighCut Bypassed", false));
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("MidLowPeak Gain",
-            "MidLowPeak Gain",
-            juce::NormalisableRange<float>(-12.f, 12.f, 0.5f, 1.f),
-            0.0f));
+    //Dynamics, added after the original parameters so their indices don't move
+    for (int i = 0; i < numPeakBands; ++i)
+    {
+        auto& ids = getPeakParameterIDs(i);
+
+        layout.add(std::make_unique<juce::AudioParameterBool>(ids.dynamic, ids.dynamic, false));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.threshold,
+                ids.threshold,
+                juce::NormalisableRange<float>(-60.f, 0.f, 0.5f, 1.f),
+                0.f));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.ratio,
+                ids.ratio,
+                juce::NormalisableRange<float>(1.f, 20.f, 0.1f, .5f),
+                2.f));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.attack,
+                ids.attack,
+                juce::NormalisableRange<float>(0.1f, 200.f, 0.1f, .5f),
+                10.f));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.release,
+                ids.release,
+                juce::NormalisableRange<float>(5.f, 2000.f, 1.f, .5f),
+                150.f));
+    }
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("MidLowPeak Quality",
-            "MidLowPeak Quality",
-            juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
-            1.f));
+    layout.add(std::make_unique<juce::AudioParameterBool>("Dynamic Sidechain", "Dynamic Sidechain", false));
 
-    //Mid Peak
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("MidPeak Freq",
-            "MidPeak Freq",
-            juce::NormalisableRange<float>(125.f, 8000.f, 1.f, .5f),
-            1000.f));
+    //Modulation
+    const juce::StringArray modSources{ "Off", "LFO", "Envelope" };
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("MidPeak Gain",
-            "MidPeak Gain",
-            juce::NormalisableRange<float>(-12.f, 12.f, 0.5f, 1.f),
-            0.0f));
+    auto addModulation = [&](const juce::String& sourceID, const juce::String& rateID, const juce::String& freqID)
+    {
+        layout.add(std::make_unique<juce::AudioParameterChoice>(sourceID, sourceID, modSources, 0));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (rateID,
+                rateID,
+                juce::NormalisableRange<float>(0.01f, 20.f, 0.01f, .3f),
+                1.f));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (freqID,
+                freqID,
+                juce::NormalisableRange<float>(-4.f, 4.f, 0.01f, 1.f),
+                0.f));
+    };
+
+    for (int i = 0; i < numPeakBands; ++i)
+    {
+        auto& ids = getPeakParameterIDs(i);
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("MidPeak Quality",
-            "MidPeak Quality",
-            juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
-            1.f));
+        addModulation(ids.modSource, ids.modRate, ids.modFreq);
 
-    //Mid High Peak
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("MidHighPeak Freq",
-            "MidHighPeak Freq",
-            juce::NormalisableRange<float>(200.f, 18000.f, 1.f, .5f),
-            5000.f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.modGain,
+                ids.modGain,
+                juce::NormalisableRange<float>(-12.f, 12.f, 0.1f, 1.f),
+                0.f));
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("MidHighPeak Gain",
-            "MidHighPeak Gain",
-            juce::NormalisableRange<float>(-12.f, 12.f, 0.5f, 1.f),
-            0.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.modQuality,
+                ids.modQuality,
+                juce::NormalisableRange<float>(-2.f, 2.f, 0.01f, 1.f),
+                0.f));
+    }
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("MidHighPeak Quality",
-            "MidHighPeak Quality",
-            juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
-            1.f));
+    addModulation("LowCut Mod Source", "LowCut Mod Rate", "LowCut Mod Freq");
+    addModulation("HighCut Mod Source", "HighCut Mod Rate", "HighCut Mod Freq");
 
-    //High Peak
-    layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("HighPeak Freq",
-            "HighPeak Freq",
-            juce::NormalisableRange<float>(2000.f, 20000.f, 1.f, .5f),
-            13000.f));
+    //Channels
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Channel Mode", "Channel Mode",
+        juce::StringArray{ "Left/Right", "Mid/Side" }, 0));
+
+    const juce::StringArray channelChoices{ "Both", "Left / Mid", "Right / Side" };
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Channels", "LowCut Channels", channelChoices, 0));
+    for (int i = 0; i < numPeakBands; ++i)
+    {
+        auto& ids = getPeakParameterIDs(i);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(ids.channels, ids.channels, channelChoices, 0));
+    }
+    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Channels", "HighCut Channels", channelChoices, 0));
+
+    //Loudness
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Auto Gain", "Auto Gain",
+        juce::StringArray{ "Off", "Measured", "Estimated" }, 0));
+
+    //Steeper slopes, kept apart so the slope choices' normalised values don't move
+    const juce::StringArray steepChoices{ "Off", "72 db/Oct", "96 db/Oct" };
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Steep Slope", "LowCut Steep Slope", steepChoices, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Steep Slope", "HighCut Steep Slope", steepChoices, 0));
+
+    //Unlinked channels, with the second channel's own cuts and bands
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Channel Link", "Channel Link",
+        juce::StringArray{ "Linked", "Unlinked" }, 0));
 
     layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("HighPeak Gain",
-            "HighPeak Gain",
-            juce::NormalisableRange<float>(-12.f, 12.f, 0.5f, 1.f),
-            0.0f));
+        ("LowCut Freq 2",
+            "LowCut Freq 2",
+            juce::NormalisableRange<float>(20.f, 20000.f, 1.f, .5f),
+            20.f));
 
     layout.add(std::make_unique<juce::AudioParameterFloat>
-        ("HighPeak Quality",
-            "HighPeak Quality",
-            juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
-            1.f));
+        ("HighCut Freq 2",
+            "HighCut Freq 2",
+            juce::NormalisableRange<float>(20.f, 20000.f, 1.f, .5f),
+            20000.f));
 
-    juce::StringArray stringArray;
-    for (int i = 0; i < 4; ++i)
+    for (int i = 0; i < numPeakBands; ++i)
     {
-        juce::String str;
-        str << (6 + i * 6);
-        str << " db/Oct";
-        stringArray.add(str);
+        auto& band = peakBands[i];
+        auto& ids = getPeakParameterIDs(i);
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.secondFreq,
+                ids.secondFreq,
+                juce::NormalisableRange<float>(band.minFreq, band.maxFreq, 1.f, .5f),
+                band.defaultFreq));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.secondGain,
+                ids.secondGain,
+                juce::NormalisableRange<float>(-12.f, 12.f, 0.5f, 1.f),
+                0.0f));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>
+            (ids.secondQuality,
+                ids.secondQuality,
+                juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
+                1.f));
+
+        layout.add(std::make_unique<juce::AudioParameterBool>(ids.secondBypassed, ids.secondBypassed, false));
     }
 
-    //HPF & LPF Slopes
-    layout.add(std::make_unique < juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", stringArray, 0));
-    layout.add(std::make_unique < juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", stringArray, 0));
-
-    layout.add(std::make_unique<juce::AudioParameterBool>("LowCut Bypassed", "LowCut Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("LowPeak Bypassed", "LowPeak Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("MidLowPeak Bypassed", "MidLowPeak Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("MidPeak Bypassed", "MidPeak Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("MidHighPeak Bypassed", "MidHighPeak Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("HighPeak Bypassed", "HighPeak Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("HighCut Bypassed", "HighCut Bypassed", false));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope 2", "LowCut Slope 2", stringArray, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope 2", "HighCut Slope 2", stringArray, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Steep Slope 2", "LowCut Steep Slope 2", steepChoices, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Steep Slope 2", "HighCut Steep Slope 2", steepChoices, 0));
+    layout.add(std::make_unique<juce::AudioParameterBool>("LowCut Bypassed 2", "LowCut Bypassed 2", false));
+    layout.add(std::make_unique<juce::AudioParameterBool>("HighCut Bypassed 2", "HighCut Bypassed 2", false));
 
     return layout;
 }
@@ -9,106 +9,261 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FilterCascade.h"
+#include "DynamicBand.h"
+#include "BandModulator.h"
+#include "PresetManager.h"
+#include "CoefficientCache.h"
+#include "DspKernels.h"
+#include "QualityScheduler.h"
+#include "LoudnessMeter.h"
+#include "LevelMeter.h"
+#include "AutoGain.h"
+#include "Spectrogram.h"
+#include "ResonanceDetector.h"
+#include "SpectrumSharing.h"
+#include "AutomationScheduler.h"
 
 enum Slope
 {
-    Slope_6,
     Slope_12,
-    Slope_18,
-    Slope_24
+    Slope_24,
+    Slope_36,
+    Slope_48,
+    Slope_72,
+    Slope_96
 };
 
-struct ChainSettings
+// Every Butterworth biquad adds 12 dB/Oct.
+inline int getNumCutSections(Slope slope)
 {
-    float lowPeakFreq{ 0 }, lowPeakGainInDecibels{ 0 }, lowPeakQuality{ 1.f };
-    float midlowPeakFreq{ 0 }, midlowPeakGainInDecibels{ 0 }, midlowPeakQuality{ 1.f };
-    float midPeakFreq{ 0 }, midPeakGainInDecibels{ 0 }, midPeakQuality{ 1.f };
-    float midhighPeakFreq{ 0 }, midhighPeakGainInDecibels{ 0 }, midhighPeakQuality{ 1.f };
-    float highPeakFreq{ 0 }, highPeakGainInDecibels{ 0 }, highPeakQuality{ 1.f };
+    static constexpr int sections[]{ 1, 2, 3, 4, 6, 8 };
+    return sections[juce::jlimit(0, (int)std::size(sections) - 1, (int)slope)];
+}
+
+// The slope choice parameters keep their original four choices, so saved
+// automation and normalised recall still land on the same slope. The steeper
+// slopes come from a choice parameter of their own, Off, 72 or 96 dB/Oct,
+// which overrides the slope when it isn't Off.
+inline Slope getCutSlope(float slopeChoice, float steepChoice)
+{
+    if (steepChoice >= 0.5f)
+        return static_cast<Slope>(juce::jlimit((int)Slope_72, (int)Slope_96, (int)Slope_72 + juce::roundToInt(steepChoice) - 1));
+
+    return static_cast<Slope>(juce::jlimit((int)Slope_12, (int)Slope_48, juce::roundToInt(slopeChoice)));
+}
+
+// How the two channels of a stereo bus are presented to the filters.
+enum class ChannelMode
+{
+    LeftRight,
+    MidSide
+};
+
+// Which of the two channels a band or cut works on: both, the first (left or
+// mid) or the second (right or side).
+enum class ChannelRouting
+{
+    Both,
+    LeftOrMid,
+    RightOrSide
+};
+
+inline juce::uint32 getChannelMask(ChannelRouting routing)
+{
+    static constexpr juce::uint32 masks[]{ 0b11, 0b01, 0b10 };
+    return masks[juce::jlimit(0, (int)std::size(masks) - 1, (int)routing)];
+}
+
+struct PeakBandInfo
+{
+    const char* name;
+    float minFreq, maxFreq, defaultFreq;
+};
+
+// The peak bands, low to high. The parameters, the DSP and the editor are all
+// built from this table. A new row is not free, though: each band's
+// parameters sit in runs in the middle of the layout, so a new band moves
+// the index of every parameter after them. That changes the state layout
+// hash (StateFormat) and the preset bank's layout hash (PresetLibrary),
+// so states and banks saved before it no longer load by position.
+inline constexpr PeakBandInfo peakBands[]
+{
+    { "LowPeak",     20.f,   500.f,   100.f   },
+    { "MidLowPeak",  40.f,   1000.f,  300.f   },
+    { "MidPeak",     125.f,  8000.f,  1000.f  },
+    { "MidHighPeak", 200.f,  18000.f, 5000.f  },
+    { "HighPeak",    2000.f, 20000.f, 13000.f },
+};
+
+constexpr int numPeakBands = (int)std::size(peakBands);
+
+struct PeakParameterIDs
+{
+    juce::String freq, gain, quality, bypassed, channels;
+
+    // The band's own settings on the second channel, used while the channels are unlinked.
+    juce::String secondFreq, secondGain, secondQuality, secondBypassed;
+
+    juce::String dynamic, threshold, ratio, attack, release;
+    juce::String modSource, modRate, modFreq, modGain, modQuality;
+};
+
+const PeakParameterIDs& getPeakParameterIDs(int band);
+
+struct PeakSettings
+{
+    float freq{ 0 }, gainInDecibels{ 0 }, quality{ 1.f };
+    bool bypassed{ false };
+    ChannelRouting channels{ ChannelRouting::Both };
+
+    DynamicSettings dynamics;
+    ModulationSettings modulation;
+};
+
+// The cuts and bands of one channel.
+struct ChannelSettings
+{
+    std::array<PeakSettings, numPeakBands> peaks;
+
     float lowCutFreq{ 0 }, highCutFreq{ 0 };
-    Slope lowCutSlope{ Slope::Slope_6 }, highCutSlope{ Slope::Slope_6 };
-
-    bool lowCutBypassed{ false }, 
-        lowPeakBypassed{ false }, 
-        midlowPeakBypassed{ false },
-        midPeakBypassed{ false },
-        midhighPeakBypassed{ false },
-        highPeakBypassed{ false },
+    Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
+
+    bool lowCutBypassed{ false },
         highCutBypassed{ false };
 };
 
+// The first channel's cuts and bands, which the second channel shares while
+// the channels are linked, and everything else.
+struct ChainSettings : ChannelSettings
+{
+    // While the channels are unlinked the second channel (right or side)
+    // runs its own frequency, gain, Q, slope and bypass from secondChannel,
+    // and the channel routing of the bands and cuts doesn't apply. Dynamics
+    // and modulation are set once per band and move both channels alike.
+    bool channelsLinked{ true };
+    ChannelSettings secondChannel;
+
+    // Whether a band or cut is bypassed on every channel, so it can drop out.
+    bool isPeakBypassed(int band) const noexcept
+    {
+        return peaks[(size_t)band].bypassed && (channelsLinked || secondChannel.peaks[(size_t)band].bypassed);
+    }
+
+    bool isLowCutBypassed() const noexcept { return lowCutBypassed && (channelsLinked || secondChannel.lowCutBypassed); }
+    bool isHighCutBypassed() const noexcept { return highCutBypassed && (channelsLinked || secondChannel.highCutBypassed); }
+
+    ChannelMode channelMode{ ChannelMode::LeftRight };
+    ChannelRouting lowCutChannels{ ChannelRouting::Both }, highCutChannels{ ChannelRouting::Both };
+
+    bool externalSidechain{ false };
+
+    ModulationSettings lowCutModulation, highCutModulation;
+
+    AutoGainMode autoGain{ AutoGainMode::Off };
+};
+
+/** The cuts and bands a channel runs: its own while the channels are
+    unlinked, the first channel's while they're linked.
+*/
+inline const ChannelSettings& getChannelSettings(const ChainSettings& chainSettings, int channel)
+{
+    return channel == 1 && !chainSettings.channelsLinked ? chainSettings.secondChannel : chainSettings;
+}
+
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
 
-using Filter = juce::dsp::IIR::Filter<float>;
+/** The settings a set of normalised values (one per parameter, in parameter
+    order) describes, without touching the parameters themselves.
+*/
+ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts, const std::vector<float>& normalisedValues);
+
+using CutFilter = FilterCascade<float, 8>;
+
+using PeakFilters = FilterCascade<float, numPeakBands>;
 
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
+using EqChain = juce::dsp::ProcessorChain<CutFilter, PeakFilters, CutFilter>;
 
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, Filter, Filter, Filter, Filter, CutFilter>;
+// The same chain in double, for hosts that mix in double. It runs the
+// coefficients the float chain was designed with.
+using DoubleEqChain = juce::dsp::ProcessorChain<FilterCascade<double, 8>, FilterCascade<double, numPeakBands>,
+    FilterCascade<double, 8>>;
 
 enum ChainPositions
 {
     LowCut,
-    LowPeak,
-    MidLowPeak,
-    MidPeak,
-    MidHighPeak,
-    HighPeak,
+    Peaks,
     HighCut
 };
 
-using Coefficients = Filter::CoefficientsPtr;
-void updateCoefficients(Coefficients& old, const Coefficients& replacements);
+PeakFilters::Design makePeakFilter(const PeakSettings& peakSettings, double sampleRate);
 
-Coefficients makeLowPeakFilter(const ChainSettings& chainSettings, double sampleRate);
-Coefficients makeMidLowPeakFilter(const ChainSettings& chainSettings, double sampleRate);
-Coefficients makeMidPeakFilter(const ChainSettings& chainSettings, double sampleRate);
-Coefficients makeMidHighPeakFilter(const ChainSettings& chainSettings, double sampleRate);
-Coefficients makeHighPeakFilter(const ChainSettings& chainSettings, double sampleRate);
+void updatePeakFilters(PeakFilters& peakFilters, const ChainSettings& chainSettings, double sampleRate);
 
-template<int Index, typename ChainType, typename CoefficientType>
-void update(ChainType& chain, const CoefficientType& coefficients)
+inline void updateCutFilter(CutFilter& cutFilter,
+    const CutFilter::CoefficientsArray& coefficients,
+    const Slope& slope,
+    ChannelRouting channels = ChannelRouting::Both)
 {
-    updateCoefficients(chain.template get<Index>().coefficients, coefficients[Index]);
-    chain.template setBypassed<Index>(false);
+    cutFilter.setSections(coefficients, getNumCutSections(slope), getChannelMask(channels));
 }
 
-template<typename ChainType, typename CoefficientType>
-void updateCutFilter(ChainType& chain,
-    const CoefficientType& coefficients,
-    const Slope& slope)
+enum class CutType
 {
-    chain.template setBypassed<0>(true);
-    chain.template setBypassed<1>(true);
-    chain.template setBypassed<2>(true);
-    chain.template setBypassed<3>(true);
+    HighPass,
+    LowPass
+};
 
-    switch (slope)
-    {
-        case Slope_24:
-        {
-            update<3>(chain, coefficients);
-        }
-        case Slope_18:
-        {
-            update<2>(chain, coefficients);
-        }
-        case Slope_12:
-        {
-            update<1>(chain, coefficients);
-        }
-        case Slope_6:
-        {
-            update<0>(chain, coefficients);
-        }
-    }
-}
+/** Designs a Butterworth cut straight into the cascade. Unlike makeLowCutFilter
+    and makeHighCutFilter this doesn't allocate, so modulated cuts can be
+    redesigned on the audio thread.
+*/
+void updateCutFilter(CutFilter& cutFilter, CutType type, float frequency, const Slope& slope, double sampleRate,
+    ChannelRouting channels = ChannelRouting::Both);
+
+/** One channel's cut, for a cascade whose channels are unlinked. */
+struct CutChannel
+{
+    float frequency;
+    Slope slope;
+    bool bypassed;
+};
+
+/** The same for unlinked channels, each with a cut of its own in its own
+    lane of the cascade. A channel whose cut is bypassed passes through, and
+    where one channel's slope is steeper the other passes through the extra
+    sections.
+*/
+void updateCutFilter(CutFilter& cutFilter, CutType type, const CutChannel& first, const CutChannel& second,
+    double sampleRate);
+
+/** Tells the first and last active filter in the chain to convert to and from
+    M/S, or clears the conversion for L/R. Call it after the filters have been
+    updated, so it knows which ones are active.
+*/
+void updateChannelMode(EqChain& chain, ChannelMode mode);
+
+/** Designs every filter in the chain, sharing designs with every other
+    instance through the CoefficientCache.
+*/
+void updateEqChain(EqChain& chain, const ChainSettings& chainSettings, double sampleRate);
+
+/** Multiplies magnitudes[i] by the chain's response, on one channel, at
+    grid point i. Bypassed cuts are left out.
+*/
+void accumulateMagnitudes(const EqChain& chain, const DspKernels::FrequencyGrid& grid, double* magnitudes,
+    size_t channel = 0);
+
+/** Copies coefficients and bypass states, but not filter state, between chains. */
+void copyCoefficients(EqChain& destination, const EqChain& source);
+void copyCoefficients(DoubleEqChain& destination, const EqChain& source);
 
 inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate)
 {
     return juce::dsp::FilterDesign<float>::
         designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq,
             sampleRate,
-            2 * (chainSettings.lowCutSlope + 1));
+            2 * getNumCutSections(chainSettings.lowCutSlope));
 }
 
 inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate)
@@ -116,13 +271,14 @@ inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleR
     return juce::dsp::FilterDesign<float>::
         designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq,
             sampleRate,
-            2 * (chainSettings.highCutSlope + 1));
+            2 * getNumCutSections(chainSettings.highCutSlope));
 }
 
 //==============================================================================
 /**
 */
-class TradeMarkEQAudioProcessor  : public juce::AudioProcessor
+class TradeMarkEQAudioProcessor  : public juce::AudioProcessor,
+                                   public juce::ChangeBroadcaster
 {
 public:
     //==============================================================================
@@ -138,6 +294,13 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    /** Hosts with a double mix engine can hand over their buffers as they
+        are. The filters then run in double; the meters and detectors still
+        work in float, on a copy.
+    */
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -158,23 +321,279 @@ public:
     const juce::String getProgramName (int index) override;
     void changeProgramName (int index, const juce::String& newName) override;
 
+    /** Names this instance after its track, for the other instances' editors. */
+    void updateTrackProperties (const TrackProperties& properties) override;
+
     //==============================================================================
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    /** Why the last setStateInformation() couldn't restore the session, and
+        clears it. Empty when it could. Message thread.
+    */
+    juce::String takeStateError();
+
+    /** The current value of every parameter, normalised, in parameter order. */
+    std::vector<float> getParameterValues() const;
+
+    /** Moves every parameter to a new set of values while audio is running.
+
+        The new coefficients are designed here, off the audio thread, and handed
+        over in one piece at the start of the next block. The audio thread
+        keeps using them, and ignores the parameters, until all of them have
+        been set, so it never sees a half-applied mix of old and new values.
+        With crossfade set, the old filters keep running for a short while and
+        the output fades from them to the new ones.
+    */
+    void recallParameterValues(const std::vector<float>& normalisedValues, bool crossfade);
+
+    /** Sets every parameter in one go, from one normalised value per
+        parameter. Only parameters that actually change are touched, the audio
+        thread picks them all up in its next block, and listeners get a single
+        change message instead of one callback per parameter.
+    */
+    void applyParameterValues(const std::vector<float>& normalisedValues);
+
+    /** True while applyParameterValues() is running. Parameter listeners can
+        ignore callbacks while this is set and wait for the change message.
+    */
+    bool isApplyingParameterValues() const noexcept { return applyingParameterValues.load(); }
+
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     juce::AudioProcessorValueTreeState apvts{ *this, nullptr,"Parameters", createParameterLayout() };
 
+    PresetManager& getPresetManager() noexcept { return presetManager; }
+
+    const QualityScheduler& getQualityScheduler() const noexcept { return qualityScheduler; }
+
+    /** The loudness going into the EQ, for any thread. */
+    LoudnessMeter::Readings getInputLoudness() const noexcept { return inputLoudness.getReadings(); }
+
+    /** The loudness coming out, after the auto-gain stage, for any thread. */
+    LoudnessMeter::Readings getOutputLoudness() const noexcept;
+
+    /** The correction the auto-gain stage applies, for any thread. */
+    float getAutoGainDecibels() const noexcept { return autoGain.getDecibels(); }
+
+    /** Restarts the integrated loudness and true peak readings. */
+    void resetLoudness() noexcept;
+
+    /** Peak, RMS and correlation going into the EQ, for any thread. */
+    LevelMeter::Levels getInputLevels() const noexcept { return inputLevels.getLevels(); }
+
+    /** Peak, RMS and correlation of the output, after the auto-gain stage, for any thread. */
+    LevelMeter::Levels getOutputLevels() const noexcept { return outputLevels.getLevels(); }
+
+    /** The output, summed to mono, for the spectrogram. Only fed while it's enabled. */
+    SpectrumFifo& getSpectrumFifo() noexcept { return spectrumFifo; }
+
+    /** The input, summed to mono, for a ResonanceDetector. Only fed while it's enabled. */
+    SpectrumFifo& getResonanceTap() noexcept { return resonanceTap; }
+
+    /** A peak band for each resonance, most prominent first, that would notch
+        it out. Bands already doing something are left alone, and so are
+        resonances a band already cuts. Of the free bands that reach a
+        resonance, the one whose default frequency is closest takes it.
+    */
+    std::vector<NotchSuggestion> suggestNotches(const std::vector<ResonanceTracker::Resonance>& resonances);
+
+    /** Sets the suggested bands in one go, crossfading to them. */
+    void applyNotches(const std::vector<NotchSuggestion>& notches);
+
+    /** The input, summed to mono, for a MatchEqAnalyser. Only fed while it's enabled. */
+    SpectrumFifo& getMatchTap() noexcept { return matchTap; }
+
+    /** Sets the cut frequencies, the cuts' bypass and every peak band's
+        frequency, gain, Q and bypass from a match EQ fit, in one bulk update
+        that crossfades to them. Nothing else in the settings is touched.
+    */
+    void applyMatch(const ChainSettings& matched);
+
+    /** Where every instance in the process publishes its output spectrum. */
+    SpectrumRegistry& getSpectrumRegistry() noexcept { return *spectrumRegistry; }
+
+    /** This instance's slot in the registry, or -1 when all of them were taken. */
+    int getSpectrumSlot() const noexcept { return spectrumSlot; }
+
+    /** Which filter sections run in double. Mixed, the default, promotes only
+        the ones whose poles are close enough to the unit circle to get noisy
+        in float. Takes effect in the next block; any thread.
+    */
+    void setFilterPrecision(FilterPrecision precision) noexcept { filterPrecision.store(precision); }
+
+    FilterPrecision getFilterPrecision() const noexcept { return filterPrecision.load(); }
+
+    /** Bit n of each is set when section n of that filter ran in double in
+        the last block. With a double host, all of them do.
+    */
+    struct PromotedSections
+    {
+        juce::uint32 lowCut{ 0 }, peaks{ 0 }, highCut{ 0 };
+    };
+
+    /** What the last block promoted, for any thread. */
+    PromotedSections getPromotedSections() const noexcept;
+
+    /** Moves a parameter, by index, to a normalised value sampleOffset
+        samples into the next block, splitting the block there rather than
+        waiting for the next one. For automation that comes with its own
+        timestamps; any thread. The audio takes the value on its sample; the
+        parameter itself keeps its value, so the host never sees the change.
+        False when the queue is full.
+    */
+    bool scheduleParameterChange(int parameterIndex, float normalisedValue, int sampleOffset) noexcept
+    {
+        return automation.schedule(parameterIndex, normalisedValue, sampleOffset);
+    }
+
 private:
 
-    MonoChain leftChain, rightChain;
+    EqChain chain;
+
+    std::array<DynamicPeakBand, numPeakBands> dynamicBands;
+
+    std::array<BandModulator, numPeakBands> peakModulators;
+    BandModulator lowCutModulator, highCutModulator;
+    EnvelopeFollower envelopeFollower;
 
-    void updatePeakFilters(const ChainSettings& chainSettings);
+    std::atomic<bool> applyingParameterValues{ false };
 
-    void updateLowCutFilters(const ChainSettings& chainSettings);
-    void updateHighCutFilters(const ChainSettings& chainSettings);
+    // Set when a saved state can't be read, until the editor shows it.
+    juce::CriticalSection stateErrorLock;
+    juce::String stateError;
+
+    PresetManager presetManager{ *this };
+
+    QualityScheduler qualityScheduler;
+
+    // After apvts, which has added the parameters by now.
+    AutomationScheduler automation{ getParameters() };
+
+    // The output meter sits before the auto-gain stage, so the measured
+    // correction compares the input with what the EQ alone made of it.
+    LoudnessMeter inputLoudness, outputLoudness;
+    AutoGain autoGain;
+
+    LevelMeter inputLevels, outputLevels;
+
+    SpectrumFifo spectrumFifo, resonanceTap, matchTap;
+
+    juce::SharedResourcePointer<SpectrumRegistry> spectrumRegistry;
+    const int spectrumSlot{ spectrumRegistry->join() };
+
+    std::atomic<FilterPrecision> filterPrecision{ FilterPrecision::Mixed };
+
+    // The low cut's sections in bits 0 to 7, the peaks' from 8 and the high cut's from 16.
+    std::atomic<juce::uint32> promotedSections{ 0 };
+
+    /** Puts a parameter's value, in its own units, into a set of normalised values. */
+    void setParameterValue(std::vector<float>& normalisedValues, const juce::String& parameterID, float value) const;
+
+    // Pink noise as log spaced points with equal weights, K-weighted, for
+    // the estimated correction. Set up in prepareToPlay().
+    DspKernels::FrequencyGrid estimateGrid;
+    std::vector<double> estimateWeights, estimateMagnitudes;
+    int samplesUntilEstimate{ 0 };
+
+    static constexpr double estimateIntervalSeconds = 0.05;
+
+    // A recall waiting for the audio thread. Written by the message thread
+    // under recallLock; the audio thread only ever try-locks it.
+    struct PendingRecall
+    {
+        ChainSettings settings;
+        EqChain chain;
+        bool crossfade{ false };
+        bool ready{ false };
+    };
+
+    juce::SpinLock recallLock;
+    PendingRecall pendingRecall;
+    std::atomic<bool> recallInProgress{ false };
+
+    // Audio thread only.
+    ChainSettings blockSettings;
+    bool holdingRecall{ false };
+
+    static constexpr double crossfadeSeconds = 0.03;
+
+    EqChain fadeChain;
+    juce::AudioBuffer<float> fadeBuffer;
+    int fadeLength{ 0 }, fadeSamplesRemaining{ 0 };
+
+    // The double engine, only set up when the host processes in double.
+    // Its coefficients are copied from chain every block.
+    DoubleEqChain doubleChain, doubleFadeChain;
+    juce::AudioBuffer<double> doubleFadeBuffer;
+
+    // Float copies of the dry input and of the sidechain, in two channels
+    // each, and later of the output, for the meters and detectors of the
+    // double engine.
+    static constexpr int numAnalysisChannels = 4;
+    juce::AudioBuffer<float> analysisBuffer;
+
+    template <typename SampleType>
+    auto& getChain() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return chain;
+        else
+            return doubleChain;
+    }
+
+    template <typename SampleType>
+    auto& getFadeChain() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return fadeChain;
+        else
+            return doubleFadeChain;
+    }
+
+    template <typename SampleType>
+    auto& getFadeBuffer() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return fadeBuffer;
+        else
+            return doubleFadeBuffer;
+    }
+
+    /** The block itself when it's float, or a float copy of it in
+        analysisBuffer from firstChannel on.
+    */
+    template <typename SampleType>
+    juce::dsp::AudioBlock<const float> getFloatBlock(const juce::dsp::AudioBlock<SampleType>& block, int firstChannel) noexcept;
+
+    /** Runs the block in the segments the automation splits it into. */
+    template <typename SampleType>
+    void processSegments(juce::AudioBuffer<SampleType>& buffer);
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
+    const ChainSettings& updateBlockSettings();
+
+    template <typename SampleType>
+    void mixCrossfade(juce::dsp::AudioBlock<SampleType>& block, juce::dsp::AudioBlock<SampleType>& fadeBlock);
+
+    template <typename SampleType>
+    void processAtControlRate(juce::AudioBuffer<SampleType>& buffer,
+        juce::dsp::AudioBlock<SampleType>& block,
+        const juce::dsp::AudioBlock<const float>& input,
+        const ChainSettings& chainSettings);
 
     void updateFilters();
+    void updateFilters(const ChainSettings& chainSettings);
+
+    void updatePrecision() noexcept;
+
+    void prepareLoudnessEstimate(double sampleRate);
+
+    /** How much the chain changes the loudness of pink noise, in dB. */
+    float estimateLoudnessChange() noexcept;
+
+    void updateAutoGain(const ChainSettings& chainSettings, int numSamples) noexcept;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TradeMarkEQAudioProcessor)
@@ -0,0 +1,422 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "PresetLibrary.h"
+#include "StateFormat.h"
+#include <numeric>
+
+namespace
+{
+    constexpr char magic[8]{ 'T', 'M', 'E', 'Q', 'B', 'A', 'N', 'K' };
+    constexpr juce::uint16 currentVersion = 1;
+
+    // Header layout
+    constexpr size_t headerSize = 64;
+    constexpr size_t versionAt = 8, numParametersAt = 10, numPresetsAt = 12, layoutHashAt = 16,
+        numTagEntriesAt = 24, recordsAt = 32, nameIndexAt = 40, tagIndexAt = 48, stringsAt = 56;
+
+    constexpr size_t recordHeaderSize = 6 * sizeof(juce::uint32);
+    constexpr size_t tagEntrySize = 3 * sizeof(juce::uint32);
+
+    juce::uint32 readUInt32(const char* p) noexcept { return juce::ByteOrder::littleEndianInt(p); }
+
+    std::string toKey(const juce::String& text)
+    {
+        return text.trim().toLowerCase().toStdString();
+    }
+
+    bool startsWith(std::string_view text, std::string_view prefix) noexcept
+    {
+        return text.substr(0, prefix.size()) == prefix;
+    }
+
+    juce::RangedAudioParameter& asRanged(juce::AudioProcessorParameter* parameter)
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        jassert(ranged != nullptr);
+        return *ranged;
+    }
+}
+
+//==============================================================================
+bool PresetLibrary::open(const juce::File& bankFile, const juce::Array<juce::AudioProcessorParameter*>& parametersToUse)
+{
+    close();
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(bankFile, juce::MemoryMappedFile::readOnly);
+    auto* bytes = static_cast<const char*>(mapped->getData());
+    auto mappedSize = mapped->getSize();
+
+    if (bytes == nullptr || mappedSize < headerSize || std::memcmp(bytes, magic, sizeof(magic)) != 0)
+        return false;
+
+    auto version = juce::ByteOrder::littleEndianShort(bytes + versionAt);
+    auto parameterCount = (int)juce::ByteOrder::littleEndianShort(bytes + numParametersAt);
+    auto presetCount = (size_t)readUInt32(bytes + numPresetsAt);
+    auto tagCount = (size_t)readUInt32(bytes + numTagEntriesAt);
+
+    if (version > currentVersion
+        || parameterCount > parametersToUse.size()
+        || juce::ByteOrder::littleEndianInt64(bytes + layoutHashAt) != StateFormat::getLayoutHash(parametersToUse, parameterCount))
+        return false;
+
+    auto records = (size_t)juce::ByteOrder::littleEndianInt64(bytes + recordsAt);
+    auto nameIndex = (size_t)juce::ByteOrder::littleEndianInt64(bytes + nameIndexAt);
+    auto tagIndex = (size_t)juce::ByteOrder::littleEndianInt64(bytes + tagIndexAt);
+    auto strings = (size_t)juce::ByteOrder::littleEndianInt64(bytes + stringsAt);
+    auto sizeOfRecord = recordHeaderSize + (size_t)parameterCount * sizeof(float);
+
+    // Every table has to fit, in order, inside the file.
+    if (records < headerSize
+        || nameIndex < records + presetCount * sizeOfRecord
+        || tagIndex < nameIndex + presetCount * sizeof(juce::uint32)
+        || strings < tagIndex + tagCount * tagEntrySize
+        || strings > mappedSize)
+        return false;
+
+    file = std::move(mapped);
+    parameters = &parametersToUse;
+    data = bytes;
+    size = mappedSize;
+
+    numPresets = (int)presetCount;
+    numParameters = parameterCount;
+    numTagEntries = (int)tagCount;
+    recordSize = sizeOfRecord;
+    recordsOffset = records;
+    nameIndexOffset = nameIndex;
+    tagIndexOffset = tagIndex;
+    stringsOffset = strings;
+
+    return true;
+}
+
+void PresetLibrary::close()
+{
+    file.reset();
+    parameters = nullptr;
+    data = nullptr;
+    size = 0;
+    numPresets = numParameters = numTagEntries = 0;
+}
+
+//==============================================================================
+PresetLibrary::Record PresetLibrary::getRecord(int index) const noexcept
+{
+    jassert(juce::isPositiveAndBelow(index, numPresets));
+
+    auto* p = data + recordsOffset + (size_t)index * recordSize;
+
+    return { readUInt32(p), readUInt32(p + 4), readUInt32(p + 8),
+             readUInt32(p + 12), readUInt32(p + 16), readUInt32(p + 20) };
+}
+
+std::string_view PresetLibrary::getString(juce::uint32 offset, juce::uint32 length) const noexcept
+{
+    // A damaged string table gives empty strings rather than reads past the end.
+    if (stringsOffset + (size_t)offset + (size_t)length > size)
+        return {};
+
+    return { data + stringsOffset + offset, (size_t)length };
+}
+
+std::string_view PresetLibrary::getNameKey(int index) const noexcept
+{
+    // Record numbers come from the indices, which a damaged bank can fill
+    // with anything, so they're checked like the string offsets are.
+    if (!juce::isPositiveAndBelow(index, numPresets))
+        return {};
+
+    auto record = getRecord(index);
+    return getString(record.keyOffset, record.keyLength);
+}
+
+juce::String PresetLibrary::getName(int index) const
+{
+    if (!juce::isPositiveAndBelow(index, numPresets))
+        return {};
+
+    auto record = getRecord(index);
+    auto name = getString(record.nameOffset, record.nameLength);
+
+    return juce::String::fromUTF8(name.data(), (int)name.size());
+}
+
+juce::StringArray PresetLibrary::getTags(int index) const
+{
+    if (!juce::isPositiveAndBelow(index, numPresets))
+        return {};
+
+    auto record = getRecord(index);
+    auto tags = getString(record.tagsOffset, record.tagsLength);
+
+    return juce::StringArray::fromLines(juce::String::fromUTF8(tags.data(), (int)tags.size()));
+}
+
+bool PresetLibrary::getValues(int index, std::vector<float>& normalisedValues) const
+{
+    if (!juce::isPositiveAndBelow(index, numPresets))
+        return false;
+
+    auto& params = *parameters;
+    auto* stored = data + recordsOffset + (size_t)index * recordSize + recordHeaderSize;
+
+    normalisedValues.resize((size_t)params.size());
+
+    for (int i = 0; i < params.size(); ++i)
+    {
+        auto& parameter = asRanged(params.getUnchecked(i));
+
+        if (i < numParameters)
+        {
+            auto bits = readUInt32(stored + (size_t)i * sizeof(float));
+
+            float plain;
+            std::memcpy(&plain, &bits, sizeof(float));
+
+            normalisedValues[(size_t)i] = parameter.convertTo0to1(plain);
+        }
+        else
+        {
+            normalisedValues[(size_t)i] = parameter.getDefaultValue();
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+std::vector<int> PresetLibrary::findByNamePrefix(const juce::String& prefix, int maxResults) const
+{
+    std::vector<int> results;
+    auto key = toKey(prefix);
+
+    auto* index = data + nameIndexOffset;
+    auto recordAt = [index](int position) { return (int)readUInt32(index + (size_t)position * sizeof(juce::uint32)); };
+
+    // Lower bound of the prefix in the sorted name index.
+    int low = 0, high = numPresets;
+
+    while (low < high)
+    {
+        auto middle = low + (high - low) / 2;
+
+        if (getNameKey(recordAt(middle)) < std::string_view(key))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    for (int position = low; position < numPresets && (int)results.size() < maxResults; ++position)
+    {
+        auto record = recordAt(position);
+
+        if (!juce::isPositiveAndBelow(record, numPresets))
+            continue;
+
+        if (!startsWith(getNameKey(record), key))
+            break;
+
+        results.push_back(record);
+    }
+
+    return results;
+}
+
+std::vector<int> PresetLibrary::findByTag(const juce::String& tag, int maxResults) const
+{
+    std::vector<int> results;
+    auto key = toKey(tag);
+
+    auto* index = data + tagIndexOffset;
+    auto entryAt = [index](int position) { return index + (size_t)position * tagEntrySize; };
+    auto tagAt = [&](int position)
+    {
+        auto* entry = entryAt(position);
+        return getString(readUInt32(entry), readUInt32(entry + 4));
+    };
+
+    int low = 0, high = numTagEntries;
+
+    while (low < high)
+    {
+        auto middle = low + (high - low) / 2;
+
+        if (tagAt(middle) < std::string_view(key))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    for (int position = low; position < numTagEntries && (int)results.size() < maxResults; ++position)
+    {
+        if (tagAt(position) != std::string_view(key))
+            break;
+
+        auto record = (int)readUInt32(entryAt(position) + 8);
+
+        if (juce::isPositiveAndBelow(record, numPresets))
+            results.push_back(record);
+    }
+
+    return results;
+}
+
+std::vector<int> PresetLibrary::search(const juce::String& text, int maxResults) const
+{
+    auto results = findByNamePrefix(text, maxResults);
+
+    std::vector<bool> found((size_t)numPresets, false);
+
+    for (auto index : results)
+        found[(size_t)index] = true;
+
+    auto add = [&](int index)
+    {
+        if (!found[(size_t)index])
+        {
+            found[(size_t)index] = true;
+            results.push_back(index);
+        }
+    };
+
+    for (auto index : findByTag(text, maxResults))
+        if ((int)results.size() < maxResults)
+            add(index);
+
+    auto key = toKey(text);
+
+    for (int i = 0; i < numPresets && (int)results.size() < maxResults; ++i)
+        if (getNameKey(i).find(key) != std::string_view::npos)
+            add(i);
+
+    return results;
+}
+
+//==============================================================================
+bool PresetLibrary::write(const juce::File& bankFile,
+    const std::vector<Entry>& entries,
+    const juce::Array<juce::AudioProcessorParameter*>& parameters)
+{
+    jassert(parameters.size() <= std::numeric_limits<juce::uint16>::max());
+
+    // Build the string table and both indices in memory first.
+    juce::MemoryOutputStream strings;
+
+    auto addString = [&strings](const std::string& text)
+    {
+        auto offset = (juce::uint32)strings.getDataSize();
+        strings.write(text.data(), text.size());
+        return std::pair{ offset, (juce::uint32)text.size() };
+    };
+
+    struct TagEntry
+    {
+        std::string key;
+        juce::uint32 offset, length, record;
+    };
+
+    std::vector<Record> records;
+    std::vector<std::string> keys;
+    std::vector<TagEntry> tagEntries;
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        auto& entry = entries[i];
+
+        auto name = addString(entry.name.toStdString());
+        auto key = addString(toKey(entry.name));
+        auto tags = addString(entry.tags.joinIntoString("\n").toStdString());
+
+        records.push_back({ name.first, name.second, key.first, key.second, tags.first, tags.second });
+        keys.push_back(toKey(entry.name));
+
+        for (auto& tag : entry.tags)
+        {
+            auto tagKey = toKey(tag);
+            auto stored = addString(tagKey);
+            tagEntries.push_back({ tagKey, stored.first, stored.second, (juce::uint32)i });
+        }
+    }
+
+    std::vector<juce::uint32> nameIndex(entries.size());
+    std::iota(nameIndex.begin(), nameIndex.end(), 0u);
+    std::stable_sort(nameIndex.begin(), nameIndex.end(), [&](auto a, auto b) { return keys[a] < keys[b]; });
+
+    std::stable_sort(tagEntries.begin(), tagEntries.end(),
+        [](const TagEntry& a, const TagEntry& b) { return a.key < b.key; });
+
+    // Then write the file in one go.
+    const auto numParameters = parameters.size();
+    const auto sizeOfRecord = recordHeaderSize + (size_t)numParameters * sizeof(float);
+
+    const auto records0 = (juce::uint64)headerSize;
+    const auto nameIndex0 = records0 + entries.size() * sizeOfRecord;
+    const auto tagIndex0 = nameIndex0 + entries.size() * sizeof(juce::uint32);
+    const auto strings0 = tagIndex0 + tagEntries.size() * tagEntrySize;
+
+    juce::TemporaryFile temp(bankFile);
+    {
+        juce::FileOutputStream out(temp.getFile());
+
+        if (!out.openedOk())
+            return false;
+
+        out.write(magic, sizeof(magic));
+        out.writeShort((short)currentVersion);
+        out.writeShort((short)numParameters);
+        out.writeInt((int)entries.size());
+        out.writeInt64((juce::int64)StateFormat::getLayoutHash(parameters, numParameters));
+        out.writeInt((int)tagEntries.size());
+        out.writeInt(0);
+        out.writeInt64((juce::int64)records0);
+        out.writeInt64((juce::int64)nameIndex0);
+        out.writeInt64((juce::int64)tagIndex0);
+        out.writeInt64((juce::int64)strings0);
+
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            auto& record = records[i];
+
+            for (auto value : { record.nameOffset, record.nameLength, record.keyOffset,
+                                record.keyLength, record.tagsOffset, record.tagsLength })
+                out.writeInt((int)value);
+
+            auto& values = entries[i].values;
+            jassert((int)values.size() == numParameters);
+
+            for (int p = 0; p < numParameters; ++p)
+            {
+                auto& parameter = asRanged(parameters.getUnchecked(p));
+                auto value = p < (int)values.size() ? values[(size_t)p] : parameter.getDefaultValue();
+
+                out.writeFloat(parameter.convertFrom0to1(value));
+            }
+        }
+
+        for (auto record : nameIndex)
+            out.writeInt((int)record);
+
+        for (auto& tag : tagEntries)
+        {
+            out.writeInt((int)tag.offset);
+            out.writeInt((int)tag.length);
+            out.writeInt((int)tag.record);
+        }
+
+        out.write(strings.getData(), strings.getDataSize());
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
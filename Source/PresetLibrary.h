@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    A read-only bank of presets in one memory-mapped file.
+
+    Opening a bank maps the file and checks its header; nothing is parsed up
+    front, so a bank of any size opens instantly. Each preset is a fixed-size
+    record holding the plain value of every parameter, which is enough to
+    rebuild every ChainSettings field, plus offsets into a UTF-8 string
+    table for its name and tags.
+
+    The file also carries two sorted indices, so most lookups are binary
+    searches over the mapped memory:
+      - record numbers sorted by lower-case name, for prefix search
+      - (lower-case tag, record) pairs sorted by tag, for tag search
+
+    Layout, all little-endian:
+
+        header       64 bytes, see PresetLibrary.cpp
+        records      numPresets x (6 x uint32 + numParameters x float32)
+        name index   numPresets x uint32
+        tag index    numTagEntries x (offset, length, record) uint32s
+        strings      UTF-8
+
+    Banks are written with write(), typically by a tool rather than the
+    plug-in. Offsets and record numbers read from a bank are checked before
+    they're followed, and entries that point outside it are skipped, so a
+    damaged or truncated bank gives fewer results rather than bad reads.
+*/
+class PresetLibrary
+{
+public:
+    struct Entry
+    {
+        juce::String name;
+        juce::StringArray tags;
+        std::vector<float> values; // normalised, one per parameter
+    };
+
+    PresetLibrary() = default;
+
+    //==============================================================================
+    /** Maps a bank file. Fails if it isn't a bank, or was written for a
+        parameter layout that doesn't match.
+    */
+    bool open(const juce::File& bankFile, const juce::Array<juce::AudioProcessorParameter*>& parameters);
+    void close();
+
+    bool isOpen() const noexcept { return file != nullptr; }
+    int getNumPresets() const noexcept { return numPresets; }
+
+    juce::String getName(int index) const;
+    juce::StringArray getTags(int index) const;
+
+    /** Reads one preset as normalised values, one per parameter. Parameters
+        the bank doesn't have get their defaults.
+    */
+    bool getValues(int index, std::vector<float>& normalisedValues) const;
+
+    //==============================================================================
+    /** Presets whose name starts with prefix, ignoring case, in name order. */
+    std::vector<int> findByNamePrefix(const juce::String& prefix, int maxResults) const;
+
+    /** Presets with the given tag, ignoring case. */
+    std::vector<int> findByTag(const juce::String& tag, int maxResults) const;
+
+    /** Name prefix matches first, then tag matches, then names that contain
+        the text anywhere. Only the last step scans every record.
+    */
+    std::vector<int> search(const juce::String& text, int maxResults) const;
+
+    //==============================================================================
+    static bool write(const juce::File& bankFile,
+        const std::vector<Entry>& entries,
+        const juce::Array<juce::AudioProcessorParameter*>& parameters);
+
+private:
+    struct Record
+    {
+        juce::uint32 nameOffset, nameLength, keyOffset, keyLength, tagsOffset, tagsLength;
+    };
+
+    Record getRecord(int index) const noexcept;
+    std::string_view getString(juce::uint32 offset, juce::uint32 length) const noexcept;
+    std::string_view getNameKey(int index) const noexcept;
+
+    std::unique_ptr<juce::MemoryMappedFile> file;
+    const juce::Array<juce::AudioProcessorParameter*>* parameters{ nullptr };
+
+    const char* data{ nullptr };
+    size_t size{ 0 };
+
+    int numPresets{ 0 }, numParameters{ 0 }, numTagEntries{ 0 };
+    size_t recordSize{ 0 };
+    size_t recordsOffset{ 0 }, nameIndexOffset{ 0 }, tagIndexOffset{ 0 }, stringsOffset{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetLibrary)
+};
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    PresetManager.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "PresetManager.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    struct ParameterValue
+    {
+        const char* id;
+        float value;
+    };
+
+    struct FactoryPreset
+    {
+        const char* name;
+        std::vector<ParameterValue> values; // plain values, everything else stays at its default
+    };
+
+    const std::vector<FactoryPreset>& getFactoryPresetTable()
+    {
+        static const std::vector<FactoryPreset> factoryPresets
+        {
+            { "Default", {} },
+            { "Low Cut 80 Hz", { { "LowCut Freq", 80.f }, { "LowCut Slope", (float)Slope_24 } } },
+            { "Vocal Presence", { { "LowCut Freq", 100.f },
+                                  { "MidLowPeak Freq", 300.f }, { "MidLowPeak Gain", -2.f },
+                                  { "MidHighPeak Freq", 4000.f }, { "MidHighPeak Gain", 3.f },
+                                  { "HighPeak Gain", 2.f } } },
+            { "Mastering Smile", { { "LowPeak Freq", 60.f }, { "LowPeak Gain", 1.5f }, { "LowPeak Quality", 0.7f },
+                                   { "HighPeak Freq", 12000.f }, { "HighPeak Gain", 1.5f }, { "HighPeak Quality", 0.7f } } },
+            { "Telephone", { { "LowCut Freq", 300.f }, { "LowCut Slope", (float)Slope_48 },
+                             { "HighCut Freq", 3400.f }, { "HighCut Slope", (float)Slope_48 },
+                             { "MidPeak Freq", 1500.f }, { "MidPeak Gain", 4.f } } },
+        };
+
+        return factoryPresets;
+    }
+}
+
+PresetManager::PresetManager(TradeMarkEQAudioProcessor& p) :
+    processor(p),
+    factoryPresets(getFactoryPresets(p))
+{
+}
+
+const std::vector<PresetManager::Preset>& PresetManager::getFactoryPresets(TradeMarkEQAudioProcessor& processor)
+{
+    // Every instance has the same parameter layout, so the first one to get
+    // here builds the values for all of them.
+    static const auto presets = [&processor]
+    {
+        std::vector<float> defaults;
+
+        for (auto* parameter : processor.getParameters())
+            defaults.push_back(parameter->getDefaultValue());
+
+        std::vector<Preset> result;
+
+        for (auto& factoryPreset : getFactoryPresetTable())
+        {
+            auto values = defaults;
+
+            for (auto& [id, value] : factoryPreset.values)
+            {
+                auto* parameter = processor.apvts.getParameter(id);
+                jassert(parameter != nullptr);
+
+                values[(size_t)parameter->getParameterIndex()] = parameter->convertTo0to1(value);
+            }
+
+            result.push_back({ factoryPreset.name, std::move(values) });
+        }
+
+        return result;
+    }();
+
+    return presets;
+}
+
+const PresetManager::Preset& PresetManager::getPreset(int index) const noexcept
+{
+    jassert(juce::isPositiveAndBelow(index, getNumPresets()));
+
+    auto numFactoryPresets = (int)factoryPresets.size();
+
+    return index < numFactoryPresets ? factoryPresets[(size_t)index]
+                                     : userPresets[(size_t)(index - numFactoryPresets)];
+}
+
+juce::String PresetManager::getPresetName(int index) const
+{
+    if (!juce::isPositiveAndBelow(index, getNumPresets()))
+        return {};
+
+    return getPreset(index).name;
+}
+
+void PresetManager::loadPreset(int index)
+{
+    if (!juce::isPositiveAndBelow(index, getNumPresets()))
+        return;
+
+    currentPreset = index;
+    processor.recallParameterValues(getPreset(index).values, crossfade);
+}
+
+void PresetManager::addPreset(const juce::String& name)
+{
+    userPresets.push_back({ name, processor.getParameterValues() });
+    currentPreset = getNumPresets() - 1;
+
+    processor.updateHostDisplay(juce::AudioProcessor::ChangeDetails().withProgramChanged(true));
+}
+
+juce::File PresetManager::getDefaultLibraryFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("TradeMark Media & Tech")
+        .getChildFile(JucePlugin_Name)
+        .getChildFile("Presets.tmeqbank");
+}
+
+bool PresetManager::openLibrary(const juce::File& bankFile)
+{
+    libraryOpened = true;
+    return library.open(bankFile, processor.getParameters());
+}
+
+PresetLibrary& PresetManager::getLibrary()
+{
+    if (!libraryOpened)
+    {
+        auto libraryFile = getDefaultLibraryFile();
+
+        if (libraryFile.existsAsFile())
+            openLibrary(libraryFile);
+
+        libraryOpened = true;
+    }
+
+    return library;
+}
+
+void PresetManager::loadLibraryPreset(int index)
+{
+    std::vector<float> values;
+
+    if (getLibrary().getValues(index, values))
+    {
+        currentPreset = -1;
+        processor.recallParameterValues(values, crossfade);
+    }
+}
+
+void PresetManager::switchToSnapshot(Snapshot snapshot)
+{
+    if (snapshot == activeSnapshot)
+        return;
+
+    auto current = processor.getParameterValues();
+    auto& target = snapshots[(size_t)snapshot];
+
+    if (target.empty())
+        target = current;
+
+    snapshots[(size_t)activeSnapshot] = std::move(current);
+    activeSnapshot = snapshot;
+    currentPreset = -1;
+
+    processor.recallParameterValues(target, crossfade);
+}
+
+void PresetManager::copyToOtherSnapshot()
+{
+    auto other = activeSnapshot == Snapshot::A ? Snapshot::B : Snapshot::A;
+    snapshots[(size_t)other] = processor.getParameterValues();
+}
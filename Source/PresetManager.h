@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    PresetManager.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetLibrary.h"
+
+class TradeMarkEQAudioProcessor;
+
+/**
+    The preset bank and the A/B snapshots.
+
+    Presets and snapshots are stored the same way as the saved state: one
+    normalised value per parameter, in parameter order. Recalling one goes
+    through TradeMarkEQAudioProcessor::recallParameterValues(), so it can
+    happen during playback without the audio thread seeing a half-loaded
+    preset.
+
+    The factory presets are built once and shared by every instance in the
+    process; each manager only owns the presets added to it.
+
+    Large collections of curves live in a PresetLibrary bank file instead of
+    the bank above. The default one is opened, which only maps it, the first
+    time the library is asked for.
+
+    Everything here runs on the message thread.
+*/
+class PresetManager
+{
+public:
+    enum class Snapshot
+    {
+        A,
+        B
+    };
+
+    explicit PresetManager(TradeMarkEQAudioProcessor& processor);
+
+    //==============================================================================
+    int getNumPresets() const noexcept { return (int)(factoryPresets.size() + userPresets.size()); }
+    juce::String getPresetName(int index) const;
+
+    /** The last preset loaded, or -1 once the settings have been changed
+        through an A/B switch.
+    */
+    int getCurrentPreset() const noexcept { return currentPreset; }
+
+    void loadPreset(int index);
+
+    /** Adds the current settings to the bank as a new preset. */
+    void addPreset(const juce::String& name);
+
+    //==============================================================================
+    Snapshot getActiveSnapshot() const noexcept { return activeSnapshot; }
+
+    /** Remembers the current settings as the active snapshot and switches to
+        the other one. A snapshot that has never been stored starts out as a
+        copy of the current settings.
+    */
+    void switchToSnapshot(Snapshot snapshot);
+
+    /** Copies the current settings into the snapshot that isn't active. */
+    void copyToOtherSnapshot();
+
+    //==============================================================================
+    /** Where the default preset library lives. */
+    static juce::File getDefaultLibraryFile();
+
+    bool openLibrary(const juce::File& bankFile);
+
+    /** The open library, opening the default one on first use. */
+    PresetLibrary& getLibrary();
+
+    void loadLibraryPreset(int index);
+
+    //==============================================================================
+    /** Whether recalls fade from the old filters to the new ones. */
+    void setCrossfadeEnabled(bool shouldCrossfade) noexcept { crossfade = shouldCrossfade; }
+    bool isCrossfadeEnabled() const noexcept { return crossfade; }
+
+private:
+    struct Preset
+    {
+        juce::String name;
+        std::vector<float> values;
+    };
+
+    static const std::vector<Preset>& getFactoryPresets(TradeMarkEQAudioProcessor& processor);
+
+    const Preset& getPreset(int index) const noexcept;
+
+    TradeMarkEQAudioProcessor& processor;
+
+    const std::vector<Preset>& factoryPresets;
+    std::vector<Preset> userPresets;
+    int currentPreset{ 0 };
+
+    PresetLibrary library;
+    bool libraryOpened{ false };
+
+    std::array<std::vector<float>, 2> snapshots;
+    Snapshot activeSnapshot{ Snapshot::A };
+
+    bool crossfade{ true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetManager)
+};
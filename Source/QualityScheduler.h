@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    QualityScheduler.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Dynamic and modulated bands get new coefficients every controlInterval
+// samples at full quality. Short enough that the steps aren't audible, long
+// enough that redesigning the filters barely shows up in the CPU profile.
+// The lower quality levels lengthen it when the CPU runs short.
+constexpr int controlInterval = 32;
+
+/**
+    Where the callbacks of every instance in the process finish within the
+    device period, shared through a SharedResourcePointer.
+
+    An instance's own processing time says little about the deadline: a
+    session near overload can be made of many instances that each take a
+    few percent. What does show it is how far into the period a callback
+    finishes, counted from the first callback of that period in the process,
+    because that includes the instances and plug-ins the host ran before it
+    on the same thread and any time the thread spent preempted. The latest
+    finish over a period is the load the whole session runs at.
+
+    A callback more than periodStartFraction of a period after the first one
+    of the current period starts the next period. Anything later than that
+    is a dropout already.
+*/
+class ProcessLoad
+{
+public:
+    static constexpr double periodStartFraction = 0.95;
+
+    /** Call at the start of a callback. Returns how long after the start of
+        its period the callback started, in seconds.
+    */
+    double callbackStarted(juce::int64 startTicks, double periodSeconds) noexcept
+    {
+        const auto periodTicks = (juce::int64)(periodSeconds * periodStartFraction
+                                               * (double)juce::Time::getHighResolutionTicksPerSecond());
+
+        auto origin = periodStart.load(std::memory_order_relaxed);
+
+        if (origin == 0 || startTicks - origin > periodTicks)
+        {
+            // Whoever loses the race gets the winner's start, a moment earlier.
+            if (periodStart.compare_exchange_strong(origin, startTicks, std::memory_order_relaxed))
+            {
+                lastPeak.store(currentPeak.exchange(0.f, std::memory_order_relaxed), std::memory_order_relaxed);
+                origin = startTicks;
+            }
+        }
+
+        return juce::Time::highResolutionTicksToSeconds(juce::jmax((juce::int64)0, startTicks - origin));
+    }
+
+    /** Call at the end of a callback with how far into the period it finished,
+        as a fraction of the period.
+    */
+    void callbackFinished(float periodLoad) noexcept
+    {
+        auto peak = currentPeak.load(std::memory_order_relaxed);
+
+        while (periodLoad > peak && !currentPeak.compare_exchange_weak(peak, periodLoad, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /** The latest finish over the last complete period, as a fraction of the period. */
+    float getLastPeriodLoad() const noexcept { return lastPeak.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<juce::int64> periodStart{ 0 };
+    std::atomic<float> currentPeak{ 0.f }, lastPeak{ 0.f };
+};
+
+//==============================================================================
+/**
+    Trades a little precision for CPU when the process gets close to its
+    deadline, instead of letting the host drop out.
+
+    Every callback is timed once, from the start of processBlock to its end,
+    and placed in the device period through the ProcessLoad every instance
+    shares. The load is the larger of how far into the period this callback
+    finished and how far the latest callback in the process finished over the
+    last period, so every instance steps down when the session as a whole
+    runs short, not only when it is expensive itself. When the smoothed load
+    stays above stepDownLoad for a while the scheduler drops one level; when
+    it stays below stepUpLoad for longer it climbs back one level. The gap
+    between the two thresholds and the different hold times keep it from
+    flapping between levels.
+
+    Offline renders always run at full quality, and stay out of the shared
+    figure.
+
+    The audio thread reads getSettings(); the editor reads
+    getPublishedLevel() and getLoad().
+*/
+class QualityScheduler
+{
+public:
+    enum class Level
+    {
+        Full,
+        Reduced,
+        Low,
+        Minimal
+    };
+
+    /** What a level trades away. */
+    struct Settings
+    {
+        /** Samples between coefficient updates of dynamic and modulated bands. */
+        int controlInterval;
+
+        /** Whether recalls fade from the old filters to the new ones, which
+            runs the whole chain twice while the fade lasts.
+        */
+        bool crossfadeRecalls;
+
+        /** Whether meters and analyzers are fed from the audio thread. */
+        bool analysis;
+    };
+
+    static const Settings& getSettings(Level level) noexcept
+    {
+        static constexpr Settings settings[]
+        {
+            { controlInterval,     true,  true  },
+            { controlInterval * 2, true,  true  },
+            { controlInterval * 4, false, true  },
+            { controlInterval * 8, false, false },
+        };
+
+        return settings[(size_t)level];
+    }
+
+    static const char* getName(Level level) noexcept
+    {
+        static constexpr const char* names[]{ "Full", "Reduced", "Low", "Minimal" };
+        return names[(size_t)level];
+    }
+
+    //==============================================================================
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        smoothedLoad = 0.0;
+        pressureSeconds = headroomSeconds = holdSeconds = 0.0;
+    }
+
+    /** Call at the start of every block, with AudioProcessor::isNonRealtime(). */
+    void setNonRealtime(bool isNonRealtime) noexcept
+    {
+        nonRealtime = isNonRealtime;
+
+        if (nonRealtime)
+            setLevel(Level::Full);
+    }
+
+    /** The settings for the current level. Audio thread only. */
+    const Settings& getSettings() const noexcept { return getSettings(level); }
+
+    Level getLevel() const noexcept { return level; }
+
+    /** The current level, for any thread. */
+    Level getPublishedLevel() const noexcept { return (Level)publishedLevel.load(std::memory_order_relaxed); }
+
+    /** The smoothed load, as a fraction of the device period, for any thread. */
+    float getLoad() const noexcept { return publishedLoad.load(std::memory_order_relaxed); }
+
+    //==============================================================================
+    /** Times one whole callback, from construction to destruction. */
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(QualityScheduler& schedulerToUse, int numSamplesInBlock) noexcept
+            : scheduler(schedulerToUse),
+              numSamples(numSamplesInBlock),
+              start(juce::Time::getHighResolutionTicks()),
+              startInPeriod(scheduler.blockStarted(numSamples, start))
+        {
+        }
+
+        ~ScopedBlock()
+        {
+            scheduler.blockFinished(numSamples, startInPeriod, juce::Time::getHighResolutionTicks() - start);
+        }
+
+    private:
+        QualityScheduler& scheduler;
+        int numSamples;
+        juce::int64 start;
+        double startInPeriod;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+private:
+    static constexpr double stepDownLoad = 0.6, stepUpLoad = 0.3;
+    static constexpr double stepDownAfterSeconds = 0.25, stepUpAfterSeconds = 3.0;
+    static constexpr double holdAfterChangeSeconds = 1.0, smoothingSeconds = 0.3;
+
+    double blockStarted(int numSamples, juce::int64 startTicks) noexcept
+    {
+        if (nonRealtime || numSamples <= 0 || sampleRate <= 0)
+            return 0.0;
+
+        return processLoad->callbackStarted(startTicks, numSamples / sampleRate);
+    }
+
+    void blockFinished(int numSamples, double startInPeriod, juce::int64 elapsedTicks) noexcept
+    {
+        if (nonRealtime || numSamples <= 0 || sampleRate <= 0)
+            return;
+
+        const auto duration = numSamples / sampleRate;
+        const auto ownLoad = (startInPeriod + juce::Time::highResolutionTicksToSeconds(elapsedTicks)) / duration;
+
+        processLoad->callbackFinished((float)ownLoad);
+        const auto load = juce::jmax(ownLoad, (double)processLoad->getLastPeriodLoad());
+
+        smoothedLoad += (load - smoothedLoad) * (1.0 - std::exp(-duration / smoothingSeconds));
+        publishedLoad.store((float)smoothedLoad, std::memory_order_relaxed);
+
+        // Give the load time to settle at a new level before judging it again.
+        if (holdSeconds > 0.0)
+        {
+            holdSeconds -= duration;
+            return;
+        }
+
+        pressureSeconds = smoothedLoad > stepDownLoad ? pressureSeconds + duration : 0.0;
+        headroomSeconds = smoothedLoad < stepUpLoad ? headroomSeconds + duration : 0.0;
+
+        if (pressureSeconds >= stepDownAfterSeconds && level != Level::Minimal)
+            setLevel((Level)((int)level + 1));
+        else if (headroomSeconds >= stepUpAfterSeconds && level != Level::Full)
+            setLevel((Level)((int)level - 1));
+    }
+
+    void setLevel(Level newLevel) noexcept
+    {
+        if (newLevel == level)
+            return;
+
+        level = newLevel;
+        publishedLevel.store((int)level, std::memory_order_relaxed);
+
+        pressureSeconds = headroomSeconds = 0.0;
+        holdSeconds = holdAfterChangeSeconds;
+    }
+
+    juce::SharedResourcePointer<ProcessLoad> processLoad;
+
+    double sampleRate{ 0 };
+    bool nonRealtime{ false };
+
+    Level level{ Level::Full };
+    double smoothedLoad{ 0 }, pressureSeconds{ 0 }, headroomSeconds{ 0 }, holdSeconds{ 0 };
+
+    std::atomic<int> publishedLevel{ (int)Level::Full };
+    std::atomic<float> publishedLoad{ 0.f };
+};
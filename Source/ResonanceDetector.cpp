@@ -0,0 +1,361 @@
+/*
+  ==============================================================================
+
+    ResonanceDetector.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "ResonanceDetector.h"
+
+void ResonanceTracker::prepare(double newSampleRate)
+{
+    jassert(newSampleRate > 0);
+
+    sampleRate = newSampleRate;
+
+    fftData.assign((size_t)fftSize * 2, 0.f);
+    average.assign((size_t)fftSize / 2 + 1, 0.f);
+    averageSums.assign(average.size() + 1, 0.0);
+    smoothed.assign(average.size(), 0.f);
+    candidates.reserve((size_t)maxCandidates);
+
+    reset();
+}
+
+void ResonanceTracker::reset()
+{
+    averaging = false;
+    tracks.fill({});
+}
+
+void ResonanceTracker::analyseFrame(const float* samples, double elapsedSeconds)
+{
+    jassert(!average.empty());
+
+    std::copy_n(samples, fftSize, fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    const auto numBins = (int)average.size();
+
+    // A full scale sine reads 0 dB through a Hann window.
+    const auto normalise = 4.f / (float)fftSize;
+    const auto smoothing = averaging ? (float)(1.0 - std::exp(-elapsedSeconds / averageSeconds)) : 1.f;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto level = juce::Decibels::gainToDecibels(fftData[(size_t)k] * normalise, -140.f);
+        average[(size_t)k] += (level - average[(size_t)k]) * smoothing;
+        averageSums[(size_t)k + 1] = averageSums[(size_t)k] + average[(size_t)k];
+    }
+
+    averaging = true;
+
+    // Smoothed over a 24th of an octave, which still resolves a Q of 24,
+    // more than a band can be set to, and flattens most of the ripple.
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto width = juce::jmax(1, (int)std::round(k * (std::exp2(1.0 / 48.0) - 1.0)));
+        const auto first = juce::jmax(0, k - width), last = juce::jmin(numBins - 1, k + width);
+
+        smoothed[(size_t)k] = (float)((averageSums[(size_t)last + 1] - averageSums[(size_t)first]) / (last - first + 1));
+    }
+
+    const auto binsPerHertz = (double)fftSize / sampleRate;
+    const auto firstBin = juce::jmax(4, (int)std::ceil(20.0 * binsPerHertz));
+    const auto lastBin = juce::jmin(numBins - 2, (int)std::floor(20000.0 * binsPerHertz));
+
+    // The bin octaves away from k, but at least minBins, so the peak's own
+    // main lobe is never all there is.
+    auto binAt = [numBins](int k, double octaves, int minBins)
+        {
+            const auto bin = (int)std::round(k * std::exp2(octaves));
+            return juce::jlimit(0, numBins - 1, octaves < 0 ? juce::jmin(k - minBins, bin) : juce::jmax(k + minBins, bin));
+        };
+
+    auto getMean = [this](int first, int last)
+        {
+            return (float)((averageSums[(size_t)last + 1] - averageSums[(size_t)first]) / (last - first + 1));
+        };
+
+    candidates.clear();
+
+    for (int k = firstBin; k <= lastBin; ++k)
+    {
+        if (!(smoothed[(size_t)k] > smoothed[(size_t)k - 1] && smoothed[(size_t)k] >= smoothed[(size_t)k + 1]))
+            continue;
+
+        // Measured against the flanks, half an octave to an octave out, which
+        // a resonance of minQuality doesn't reach and a steady tilt evens out.
+        const auto below = getMean(binAt(k, -1.0, 8), binAt(k, -0.5, 4));
+        const auto above = getMean(binAt(k, 0.5, 4), binAt(k, 1.0, 8));
+        const auto baseline = 0.5f * (below + above);
+        const auto prominence = smoothed[(size_t)k] - baseline;
+
+        if (prominence < minProminence)
+            continue;
+
+        auto candidate = measurePeak(k, baseline);
+
+        if (candidate.quality < minQuality || getFlatness(binAt(k, -0.5, 4), binAt(k, 0.5, 4)) > maxFlatness)
+            continue;
+
+        candidate.prominence = prominence;
+        candidates.push_back(candidate);
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Resonance& a, const Resonance& b) { return a.prominence > b.prominence; });
+
+    // Ripples on top of a broad resonance are the same resonance.
+    auto kept = candidates.begin();
+
+    for (auto candidate = candidates.begin(); candidate != candidates.end(); ++candidate)
+    {
+        auto inside = std::any_of(candidates.begin(), kept, [&](const Resonance& stronger)
+            {
+                return std::abs(candidate->frequency - stronger.frequency) < 0.5f * stronger.frequency / stronger.quality;
+            });
+
+        if (!inside)
+            *kept++ = *candidate;
+    }
+
+    candidates.erase(kept, candidates.end());
+
+    if ((int)candidates.size() > maxCandidates)
+        candidates.resize((size_t)maxCandidates);
+
+    updateTracks(elapsedSeconds);
+}
+
+ResonanceTracker::Resonance ResonanceTracker::measurePeak(int k, float baseline) const
+{
+    const auto numBins = (int)average.size();
+    const auto binsPerHertz = (double)fftSize / sampleRate;
+
+    // The top of a parabola through the peak and its neighbours.
+    const auto before = smoothed[(size_t)k - 1], peak = smoothed[(size_t)k], after = smoothed[(size_t)k + 1];
+    const auto curvature = before - 2.f * peak + after;
+    const auto offset = curvature < 0.f ? 0.5f * (before - after) / curvature : 0.f;
+
+    // The width comes from the area above the baseline over the whole peak,
+    // which the ripple of a noisy spectrum mostly cancels out of, where the
+    // half-height points would land on whichever ripple happened to be there.
+    auto excess = [&](int bin) { return juce::jmax(0.f, smoothed[(size_t)bin] - baseline); };
+
+    const auto height = excess(k);
+
+    if (height <= 0)
+        return {};
+
+    const auto reach = juce::jmax(4, k / 2);
+    auto area = height;
+
+    for (int bin = k - 1; bin > juce::jmax(0, k - reach) && smoothed[(size_t)bin] > baseline; --bin)
+        area += excess(bin);
+
+    for (int bin = k + 1; bin < juce::jmin(numBins, k + reach) && smoothed[(size_t)bin] > baseline; ++bin)
+        area += excess(bin);
+
+    // In dB, a peak filter's bell covers about 1.6 times its height times
+    // the bandwidth its Q describes, within 10% for the gains and Qs a band
+    // can be set to, so this is the Q of the band that would undo it.
+    const auto bandwidthInBins = area / height / 1.6f;
+
+    Resonance resonance;
+    resonance.frequency = (float)((k + offset) / binsPerHertz);
+    resonance.quality = (float)(resonance.frequency * binsPerHertz / juce::jmax(0.5f, bandwidthInBins));
+
+    return resonance;
+}
+
+float ResonanceTracker::getFlatness(int first, int last) const
+{
+    // The averages are in dB, so the log of the power is a scale away.
+    constexpr auto nepersPerDecibel = 0.1 * 2.302585092994046;
+
+    double sumOfLogs = 0, sum = 0;
+
+    for (int k = first; k <= last; ++k)
+    {
+        const auto logPower = smoothed[(size_t)k] * nepersPerDecibel;
+        sumOfLogs += logPower;
+        sum += std::exp(logPower);
+    }
+
+    const auto n = (double)(last - first + 1);
+
+    return sum > 0 ? (float)(std::exp(sumOfLogs / n) / (sum / n)) : 1.f;
+}
+
+void ResonanceTracker::updateTracks(double elapsedSeconds)
+{
+    const auto presence = (float)(1.0 - std::exp(-elapsedSeconds / persistenceSeconds));
+    const auto smoothing = (float)(1.0 - std::exp(-elapsedSeconds / averageSeconds));
+
+    for (auto& track : tracks)
+        track.matched = false;
+
+    for (const auto& candidate : candidates)
+    {
+        Track* match = nullptr;
+        auto distance = matchOctaves;
+
+        for (auto& track : tracks)
+        {
+            if (!track.active || track.matched)
+                continue;
+
+            const auto octaves = std::abs(std::log2(candidate.frequency / track.resonance.frequency));
+
+            if (octaves < distance)
+            {
+                match = &track;
+                distance = octaves;
+            }
+        }
+
+        if (match != nullptr)
+        {
+            auto& resonance = match->resonance;
+            resonance.frequency += (candidate.frequency - resonance.frequency) * smoothing;
+            resonance.quality += (candidate.quality - resonance.quality) * smoothing;
+            resonance.prominence += (candidate.prominence - resonance.prominence) * smoothing;
+        }
+        else
+        {
+            // A new track goes in a free slot, or in place of the least
+            // persistent one, as long as that one isn't a resonance yet.
+            match = &*std::min_element(tracks.begin(), tracks.end(), [](const Track& a, const Track& b)
+                {
+                    return (a.active ? a.resonance.persistence : -1.f) < (b.active ? b.resonance.persistence : -1.f);
+                });
+
+            if (match->active && match->resonance.persistence >= minPersistence)
+                continue;
+
+            *match = {};
+            match->active = true;
+            match->resonance = candidate;
+            match->resonance.persistence = 0.f;
+        }
+
+        match->matched = true;
+    }
+
+    for (auto& track : tracks)
+    {
+        if (!track.active)
+            continue;
+
+        track.seconds += elapsedSeconds;
+        track.resonance.persistence += ((track.matched ? 1.f : 0.f) - track.resonance.persistence) * presence;
+
+        // Gone once it turns up in under a tenth of the recent frames.
+        if (!track.matched && track.resonance.persistence < 0.1f)
+            track.active = false;
+    }
+}
+
+std::vector<ResonanceTracker::Resonance> ResonanceTracker::getResonances() const
+{
+    std::vector<Resonance> result;
+
+    for (const auto& track : tracks)
+        if (track.active && track.seconds >= minSeconds && track.resonance.persistence >= minPersistence)
+            result.push_back(track.resonance);
+
+    std::sort(result.begin(), result.end(),
+        [](const Resonance& a, const Resonance& b) { return a.prominence > b.prominence; });
+
+    return result;
+}
+
+//==============================================================================
+ResonanceDetector::ResonanceDetector(SpectrumFifo& source) :
+    juce::Thread("Resonance detector"),
+    fifo(source),
+    history((size_t)ResonanceTracker::fftSize, 0.f),
+    incoming((size_t)ResonanceTracker::fftSize, 0.f)
+{
+    fifo.discard();
+    startThread(juce::Thread::Priority::low);
+}
+
+ResonanceDetector::~ResonanceDetector()
+{
+    stopThread(1000);
+}
+
+std::vector<ResonanceTracker::Resonance> ResonanceDetector::getResonances() const
+{
+    const juce::ScopedLock scopedLock(lock);
+    return resonances;
+}
+
+ResonanceDetector::Statistics ResonanceDetector::getStatistics() const
+{
+    const juce::ScopedLock scopedLock(lock);
+    return statistics;
+}
+
+void ResonanceDetector::run()
+{
+    constexpr auto fftSize = ResonanceTracker::fftSize;
+
+    double preparedSampleRate = 0, frameSeconds = 1.0 / maxFramesPerSecond, secondsPerFrame = 0;
+    int samplesSinceFrame = 0;
+    juce::uint64 frames = 0;
+
+    while (!threadShouldExit())
+    {
+        const auto sampleRate = fifo.getSampleRate();
+
+        if (sampleRate != preparedSampleRate)
+        {
+            tracker.prepare(sampleRate);
+            preparedSampleRate = sampleRate;
+            samplesSinceFrame = 0;
+        }
+
+        const auto numPulled = fifo.pull(incoming.data(), fftSize);
+
+        if (numPulled == 0)
+        {
+            wait(20);
+            continue;
+        }
+
+        std::copy(history.begin() + numPulled, history.end(), history.begin());
+        std::copy_n(incoming.begin(), numPulled, history.end() - numPulled);
+        samplesSinceFrame += numPulled;
+
+        if (samplesSinceFrame < juce::roundToInt(frameSeconds * sampleRate))
+            continue;
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        tracker.analyseFrame(history.data(), samplesSinceFrame / sampleRate);
+        const auto cost = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+        samplesSinceFrame = 0;
+        secondsPerFrame = frames++ == 0 ? cost : secondsPerFrame + (cost - secondsPerFrame) * 0.1;
+
+        // A machine where frames cost more analyses less often, rather than
+        // going over the budget.
+        frameSeconds = juce::jmax(1.0 / maxFramesPerSecond, secondsPerFrame / cpuBudget);
+
+        auto found = tracker.getResonances();
+
+        const juce::ScopedLock scopedLock(lock);
+
+        resonances = std::move(found);
+        statistics.frames = frames;
+        statistics.framesPerSecond = 1.0 / frameSeconds;
+        statistics.millisecondsPerFrame = secondsPerFrame * 1000.0;
+        statistics.cpuShare = secondsPerFrame / frameSeconds;
+    }
+}
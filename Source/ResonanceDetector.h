@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    ResonanceDetector.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Spectrogram.h"
+
+/**
+    Finds narrow resonances that hold still, frame by frame.
+
+    Each frame is a Hann windowed FFT of the latest fftSize samples, averaged
+    over time on a dB scale and smoothed over a 24th of an octave. Peaks in
+    the result are candidates when they stand at least minProminence above
+    the spectrum half an octave to an octave either side, have a Q of at
+    least minQuality, and the octave around them has a spectral flatness
+    (geometric over arithmetic mean of the power) of at most maxFlatness,
+    which rules out bumps in broadband noise. Q is measured the way the peak
+    bands use it, so a resonance's Q is the Q of the band that undoes it.
+
+    Candidates are followed from frame to frame. A track's persistence is the
+    share of recent frames it turned up in, and a track that has lasted
+    minSeconds with a persistence of minPersistence counts as a resonance.
+
+    Single threaded and deterministic, so offline tools can drive it
+    directly; ResonanceDetector runs it on a background thread.
+*/
+class ResonanceTracker
+{
+public:
+    static constexpr int fftOrder = 13, fftSize = 1 << fftOrder;
+
+    struct Resonance
+    {
+        float frequency{ 0 }, quality{ 0 };
+
+        // How far it stands above the spectrum around it, in dB.
+        float prominence{ 0 };
+
+        // The share of recent frames it turned up in, 0 to 1.
+        float persistence{ 0 };
+
+        bool operator==(const Resonance& other) const noexcept
+        {
+            return frequency == other.frequency && quality == other.quality
+                && prominence == other.prominence && persistence == other.persistence;
+        }
+    };
+
+    static constexpr float minProminence = 6.f, minQuality = 2.f, maxFlatness = 0.8f;
+    static constexpr float minPersistence = 0.7f;
+    static constexpr double minSeconds = 1.5;
+
+    void prepare(double newSampleRate);
+    void reset();
+
+    /** Analyses the latest fftSize samples, elapsedSeconds of audio after the previous frame. */
+    void analyseFrame(const float* samples, double elapsedSeconds);
+
+    /** The tracks that count as resonances, most prominent first. */
+    std::vector<Resonance> getResonances() const;
+
+private:
+    static constexpr int maxTracks = 32, maxCandidates = 64;
+
+    // Time constants of the averaged spectrum and of each track's persistence.
+    static constexpr double averageSeconds = 2.0, persistenceSeconds = 1.0;
+
+    // A candidate within this of a track is the same resonance.
+    static constexpr double matchOctaves = 1.0 / 24.0;
+
+    struct Track
+    {
+        Resonance resonance;
+        double seconds{ 0 };
+        bool active{ false }, matched{ false };
+    };
+
+    /** The frequency and quality of the peak at bin k, which stands above a
+        baseline level in dB.
+    */
+    Resonance measurePeak(int k, float baseline) const;
+
+    float getFlatness(int first, int last) const;
+
+    void updateTracks(double elapsedSeconds);
+
+    double sampleRate{ 44100.0 };
+    bool averaging{ false };
+
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+
+    std::vector<float> fftData, average;
+
+    // Running sums of average, for the mean level around each bin.
+    std::vector<double> averageSums;
+
+    // The average smoothed across frequency, which peaks are picked from.
+    std::vector<float> smoothed;
+
+    std::vector<Resonance> candidates;
+    std::array<Track, maxTracks> tracks;
+};
+
+/** Peak band settings that would notch out a resonance. */
+struct NotchSuggestion
+{
+    int band{ 0 };
+    float frequency{ 0 }, quality{ 1.f }, gainInDecibels{ 0 };
+
+    bool operator==(const NotchSuggestion& other) const noexcept
+    {
+        return band == other.band && frequency == other.frequency
+            && quality == other.quality && gainInDecibels == other.gainInDecibels;
+    }
+};
+
+/**
+    Runs a ResonanceTracker on what a SpectrumFifo delivers, on a background
+    thread of its own.
+
+    The thread analyses at most maxFramesPerSecond frames, and never spends
+    more than cpuBudget of one core: it times every frame, and when frames
+    get expensive it analyses less often rather than falling behind. The
+    audio thread's only part is pushing samples into the fifo.
+*/
+class ResonanceDetector : private juce::Thread
+{
+public:
+    static constexpr double maxFramesPerSecond = 10.0;
+
+    /** The most of one core the analysis may use. */
+    static constexpr double cpuBudget = 0.01;
+
+    struct Statistics
+    {
+        juce::uint64 frames{ 0 };
+        double framesPerSecond{ 0 }, millisecondsPerFrame{ 0 };
+
+        // millisecondsPerFrame at framesPerSecond, as a share of one core.
+        double cpuShare{ 0 };
+    };
+
+    /** Starts reading from the fifo, discarding whatever was waiting in it. */
+    explicit ResonanceDetector(SpectrumFifo& source);
+    ~ResonanceDetector() override;
+
+    /** The latest resonances, most prominent first. Any thread but the audio thread. */
+    std::vector<ResonanceTracker::Resonance> getResonances() const;
+
+    Statistics getStatistics() const;
+
+private:
+    void run() override;
+
+    SpectrumFifo& fifo;
+
+    // Background thread only.
+    ResonanceTracker tracker;
+    std::vector<float> history, incoming;
+
+    juce::CriticalSection lock;
+    std::vector<ResonanceTracker::Resonance> resonances;
+    Statistics statistics;
+
+    JUCE_DECLARE_NON_COPYABLE(ResonanceDetector)
+};
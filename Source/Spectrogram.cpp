@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    Spectrogram.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "Spectrogram.h"
+
+SpectrogramAnalyser::SpectrogramAnalyser(SpectrumFifo& source) :
+    juce::Thread("Spectrogram"),
+    fifo(source),
+    history((size_t)fftSize, 0.f),
+    incoming((size_t)fftSize, 0.f),
+    fftData((size_t)fftSize * 2, 0.f),
+    rowStorage((size_t)(maxRows * maxRowWidth), 0)
+{
+    fifo.discard();
+    startThread(juce::Thread::Priority::low);
+}
+
+SpectrogramAnalyser::~SpectrogramAnalyser()
+{
+    stopThread(1000);
+}
+
+void SpectrogramAnalyser::setRowWidth(int width) noexcept
+{
+    rowWidth.store(juce::jlimit(0, maxRowWidth, width), std::memory_order_relaxed);
+}
+
+bool SpectrogramAnalyser::popRow(juce::uint8* destination, int width) noexcept
+{
+    while (rows.getNumReady() > 0)
+    {
+        int start1, size1, start2, size2;
+        rows.prepareToRead(1, start1, size1, start2, size2);
+
+        const auto matches = rowWidths[(size_t)start1] == width;
+
+        if (matches)
+            std::copy_n(rowStorage.data() + (size_t)start1 * maxRowWidth, width, destination);
+
+        rows.finishedRead(1);
+
+        if (matches)
+            return true;
+    }
+
+    return false;
+}
+
+void SpectrogramAnalyser::run()
+{
+    while (!threadShouldExit())
+    {
+        const auto sampleRate = fifo.getSampleRate();
+        const auto hop = juce::jlimit(1, fftSize, juce::roundToInt(sampleRate / rowsPerSecond));
+
+        numIncoming = juce::jmin(numIncoming, hop);
+        numIncoming += fifo.pull(incoming.data() + numIncoming, hop - numIncoming);
+
+        if (numIncoming < hop)
+        {
+            // At 60 rows a second there's a new one due every 16 ms.
+            wait(4);
+            continue;
+        }
+
+        // Slide the window on by one hop.
+        std::copy(history.begin() + hop, history.end(), history.begin());
+        std::copy_n(incoming.begin(), hop, history.end() - hop);
+        numIncoming = 0;
+
+        analyseFrame(sampleRate);
+    }
+}
+
+void SpectrogramAnalyser::analyseFrame(double sampleRate)
+{
+    const auto width = rowWidth.load(std::memory_order_relaxed);
+
+    if (width <= 0)
+        return;
+
+    if (width != (int)pixelBins.size() || sampleRate != mappedSampleRate)
+        updatePixelBins(width, sampleRate);
+
+    std::copy(history.begin(), history.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // A full scale sine peaks at fftSize / 4 through a Hann window.
+    const auto normalise = 4.f / (float)fftSize;
+    const auto toLevel = 255.f / (maximumDecibels - minimumDecibels);
+
+    for (size_t i = 0; i < pixelBins.size(); ++i)
+    {
+        const auto& bins = pixelBins[i];
+        float magnitude;
+
+        if (bins.last > bins.first)
+            magnitude = *std::max_element(fftData.begin() + bins.first, fftData.begin() + bins.last + 1);
+        else
+            magnitude = fftData[(size_t)bins.first]
+                + (fftData[(size_t)bins.first + 1] - fftData[(size_t)bins.first]) * bins.fraction;
+
+        const auto decibels = juce::Decibels::gainToDecibels(magnitude * normalise, minimumDecibels);
+        row[i] = (juce::uint8)juce::jlimit(0.f, 255.f, (decibels - minimumDecibels) * toLevel);
+    }
+
+    pushRow(row);
+}
+
+void SpectrogramAnalyser::updatePixelBins(int width, double sampleRate)
+{
+    pixelBins.resize((size_t)width);
+    row.resize((size_t)width);
+    mappedSampleRate = sampleRate;
+
+    const auto lastBin = fftSize / 2;
+    const auto binsPerHertz = (double)fftSize / sampleRate;
+
+    auto toBin = [&](double proportion)
+        {
+            return juce::jlimit(0.0, (double)lastBin, juce::mapToLog10(proportion, 20.0, 20000.0) * binsPerHertz);
+        };
+
+    for (int i = 0; i < width; ++i)
+    {
+        const auto low = toBin((double)i / width);
+        const auto high = toBin((double)(i + 1) / width);
+
+        auto& bins = pixelBins[(size_t)i];
+
+        if (high - low >= 1.0)
+        {
+            bins.first = (int)std::ceil(low);
+            bins.last = juce::jmin(lastBin, (int)std::floor(high));
+            bins.fraction = 0.f;
+        }
+        else
+        {
+            const auto centre = juce::jmin((low + high) * 0.5, (double)lastBin - 1.0);
+
+            bins.first = (int)centre;
+            bins.last = bins.first;
+            bins.fraction = (float)(centre - bins.first);
+        }
+    }
+}
+
+void SpectrogramAnalyser::pushRow(const std::vector<juce::uint8>& newRow)
+{
+    // When the message thread is busy the oldest rows wait and new ones are dropped.
+    if (rows.getFreeSpace() == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    rows.prepareToWrite(1, start1, size1, start2, size2);
+
+    std::copy(newRow.begin(), newRow.end(), rowStorage.begin() + (size_t)start1 * maxRowWidth);
+    rowWidths[(size_t)start1] = (int)newRow.size();
+
+    rows.finishedWrite(1);
+}
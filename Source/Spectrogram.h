@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    Spectrogram.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Samples on their way from the audio thread to the spectrogram, summed to
+    mono, through a single producer, single consumer ring.
+
+    Neither side ever locks or waits. While nothing is reading, push() does
+    nothing, and if the reader falls behind, whatever doesn't fit is dropped.
+
+    The ring's storage is only made the first time it's switched on, so an
+    instance whose editor never asks for it doesn't carry it. Once made it
+    stays until the fifo goes, as the audio thread may still be writing
+    when it's switched off.
+*/
+class SpectrumFifo
+{
+public:
+    static constexpr int defaultCapacity = 1 << 15;
+
+    explicit SpectrumFifo(int capacity = defaultCapacity) :
+        fifo(capacity)
+    {
+    }
+
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate.store(newSampleRate, std::memory_order_relaxed);
+    }
+
+    double getSampleRate() const noexcept { return sampleRate.load(std::memory_order_relaxed); }
+
+    /** Switches the feed on while there's a reader, making the ring's
+        storage the first time. Message thread.
+    */
+    void setEnabled(bool shouldBeEnabled)
+    {
+        if (shouldBeEnabled && samples.empty())
+            samples.resize((size_t)fifo.getTotalSize());
+
+        // Whoever sees it switched on sees the storage too.
+        enabled.store(shouldBeEnabled, std::memory_order_release);
+    }
+
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_acquire); }
+
+    /** Adds a block, summed to mono. Audio thread only. */
+    void push(const juce::dsp::AudioBlock<const float>& block) noexcept
+    {
+        const auto numChannels = (int)block.getNumChannels();
+
+        if (numChannels == 0 || !isEnabled())
+            return;
+
+        const auto numSamples = juce::jmin((int)block.getNumSamples(), fifo.getFreeSpace());
+        const auto gain = 1.f / (float)numChannels;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        for (auto [start, size, offset] : { std::tuple{ start1, size1, 0 }, std::tuple{ start2, size2, size1 } })
+        {
+            if (size <= 0)
+                continue;
+
+            auto* destination = samples.data() + start;
+            juce::FloatVectorOperations::copyWithMultiply(destination, block.getChannelPointer(0) + offset, gain, size);
+
+            for (int ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(destination, block.getChannelPointer((size_t)ch) + offset, gain, size);
+        }
+
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    /** Takes up to maxSamples of the oldest samples and returns how many it
+        took. Reader only.
+    */
+    int pull(float* destination, int maxSamples) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+
+        // Nothing's been written, so the storage may not even be there yet.
+        if (size1 + size2 == 0)
+            return 0;
+
+        std::copy_n(samples.data() + start1, size1, destination);
+        std::copy_n(samples.data() + start2, size2, destination + size1);
+
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    /** Throws away everything waiting. Reader only. */
+    void discard() noexcept { fifo.finishedRead(fifo.getNumReady()); }
+
+    /** Empties the ring. Only while neither the writer nor the reader is using it. */
+    void reset() noexcept { fifo.reset(); }
+
+private:
+    juce::AbstractFifo fifo;
+    std::vector<float> samples;
+
+    std::atomic<double> sampleRate{ 44100.0 };
+    std::atomic<bool> enabled{ false };
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrumFifo)
+};
+
+/**
+    Turns what a SpectrumFifo delivers into rows of a spectrogram on a
+    background thread, so neither the audio thread nor the message thread
+    does any FFTs.
+
+    Every 1 / rowsPerSecond seconds of audio becomes one row: a Hann windowed
+    FFT of the latest fftSize samples, resampled to one level per pixel,
+    log spaced from 20 Hz to 20 kHz. Where a pixel covers several bins it
+    takes the loudest; where it covers less than one, it interpolates. Levels
+    run from 0 for minimumDecibels to 255 for maximumDecibels, so turning
+    them into colours is a table lookup.
+
+    Finished rows wait in a second lock-free ring until the message thread
+    collects them with popRow().
+*/
+class SpectrogramAnalyser : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12, fftSize = 1 << fftOrder;
+
+    // One row per frame of a 60 Hz display.
+    static constexpr double rowsPerSecond = 60.0;
+
+    static constexpr float minimumDecibels = -100.f, maximumDecibels = 0.f;
+
+    /** The widest row, in pixels. */
+    static constexpr int maxRowWidth = 8192;
+
+    /** Starts reading from the fifo, discarding whatever was waiting in it. */
+    explicit SpectrogramAnalyser(SpectrumFifo& source);
+    ~SpectrogramAnalyser() override;
+
+    /** Makes the rows from here on width pixels wide. Any thread. */
+    void setRowWidth(int width) noexcept;
+
+    /** Copies the oldest row waiting into destination, which has room for
+        width levels. Rows of some other width are skipped, and false means
+        there's nothing left. Message thread.
+    */
+    bool popRow(juce::uint8* destination, int width) noexcept;
+
+private:
+    static constexpr int maxRows = 32;
+
+    void run() override;
+
+    void analyseFrame(double sampleRate);
+    void updatePixelBins(int width, double sampleRate);
+    void pushRow(const std::vector<juce::uint8>& row);
+
+    SpectrumFifo& fifo;
+
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+
+    // Background thread only.
+    std::vector<float> history, incoming, fftData;
+    int numIncoming{ 0 };
+
+    // Which bins each pixel reads: the loudest from first to last, or, when
+    // last is first, first and the bin above it mixed by fraction.
+    struct PixelBins
+    {
+        int first{ 0 }, last{ 0 };
+        float fraction{ 0 };
+    };
+
+    std::vector<PixelBins> pixelBins;
+    std::vector<juce::uint8> row;
+    double mappedSampleRate{ 0 };
+
+    std::atomic<int> rowWidth{ 0 };
+
+    // Finished rows, each with the width it was made for.
+    juce::AbstractFifo rows{ maxRows };
+    std::vector<juce::uint8> rowStorage;
+    std::array<int, maxRows> rowWidths{};
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrogramAnalyser)
+};
@@ -0,0 +1,370 @@
+/*
+  ==============================================================================
+
+    SpectrumSharing.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "SpectrumSharing.h"
+
+SpectrumRegistry::Subscription::Subscription(SpectrumRegistry& registryToUse) :
+    registry(registryToUse)
+{
+    registry.subscribe();
+}
+
+SpectrumRegistry::Subscription::~Subscription()
+{
+    registry.unsubscribe();
+}
+
+SpectrumRegistry::SpectrumRegistry() :
+    juce::Thread("Spectrum sharing"),
+    fftData((size_t)fftSize * 2, 0.f)
+{
+}
+
+SpectrumRegistry::~SpectrumRegistry()
+{
+    stopThread(1000);
+}
+
+int SpectrumRegistry::join()
+{
+    for (int i = 0; i < maxInstances; ++i)
+    {
+        auto expected = (int)freeSlot;
+
+        if (!states[(size_t)i].compare_exchange_strong(expected, claimingSlot, std::memory_order_acquire))
+            continue;
+
+        auto& slot = slots[(size_t)i];
+
+        if (slot == nullptr)
+            slot = std::make_unique<Slot>();
+
+        {
+            // The last owner's audio thread is done with the ring and the new
+            // one hasn't got it yet, so only the analysis could be reading it.
+            const juce::ScopedLock lock(slotLock);
+
+            slot->fifo.reset();
+            slot->generation.fetch_add(1, std::memory_order_relaxed);
+            slot->hasLevels.store(false, std::memory_order_relaxed);
+        }
+
+        slot->fifo.setEnabled(isThreadRunning());
+
+        setName(i, "TradeMarkEQ " + juce::String(i + 1));
+
+        // Everything above is seen by whoever sees the slot in use.
+        states[(size_t)i].store(usedSlot, std::memory_order_release);
+        return i;
+    }
+
+    return -1;
+}
+
+void SpectrumRegistry::leave(int slot)
+{
+    if (!juce::isPositiveAndBelow(slot, maxInstances))
+        return;
+
+    slots[(size_t)slot]->fifo.setEnabled(false);
+    slots[(size_t)slot]->hasLevels.store(false, std::memory_order_relaxed);
+
+    states[(size_t)slot].store(freeSlot, std::memory_order_release);
+}
+
+void SpectrumRegistry::setName(int slot, const juce::String& name)
+{
+    if (!juce::isPositiveAndBelow(slot, maxInstances) || name.isEmpty())
+        return;
+
+    // Cut short on a character boundary.
+    std::array<char, maxNameBytes> bytes{};
+    name.copyToUTF8(bytes.data(), bytes.size());
+
+    auto& target = *slots[(size_t)slot];
+    const auto start = target.nameSequence.load(std::memory_order_relaxed);
+
+    target.nameSequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < bytes.size(); ++i)
+        target.name[i].store(bytes[i], std::memory_order_relaxed);
+
+    target.nameSequence.store(start + 2, std::memory_order_release);
+}
+
+juce::String SpectrumRegistry::getName(int slot) const
+{
+    if (!juce::isPositiveAndBelow(slot, maxInstances)
+        || states[(size_t)slot].load(std::memory_order_acquire) != usedSlot)
+        return {};
+
+    const auto& source = *slots[(size_t)slot];
+    std::array<char, maxNameBytes> bytes;
+
+    for (;;)
+    {
+        const auto before = source.nameSequence.load(std::memory_order_acquire);
+
+        // Odd while the owner is halfway through renaming it.
+        if ((before & 1) != 0)
+            continue;
+
+        for (size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = source.name[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (source.nameSequence.load(std::memory_order_relaxed) == before)
+            break;
+    }
+
+    bytes.back() = 0;
+    return juce::String::fromUTF8(bytes.data());
+}
+
+void SpectrumRegistry::prepare(int slot, double sampleRate) noexcept
+{
+    if (juce::isPositiveAndBelow(slot, maxInstances))
+        slots[(size_t)slot]->fifo.prepare(sampleRate);
+}
+
+std::vector<SpectrumRegistry::Entry> SpectrumRegistry::getEntries() const
+{
+    std::vector<Entry> entries;
+
+    for (int i = 0; i < maxInstances; ++i)
+        if (states[(size_t)i].load(std::memory_order_acquire) == usedSlot)
+            entries.push_back({ i, getName(i) });
+
+    return entries;
+}
+
+bool SpectrumRegistry::getLevels(int slot, Levels& levels) const
+{
+    if (!juce::isPositiveAndBelow(slot, maxInstances)
+        || states[(size_t)slot].load(std::memory_order_acquire) != usedSlot)
+        return false;
+
+    const auto& source = *slots[(size_t)slot];
+
+    if (!source.hasLevels.load(std::memory_order_acquire))
+        return false;
+
+    for (;;)
+    {
+        const auto before = source.levelSequence.load(std::memory_order_acquire);
+
+        // Odd while the analysis is halfway through a snapshot.
+        if ((before & 1) != 0)
+            continue;
+
+        for (size_t i = 0; i < levels.size(); ++i)
+            levels[i] = source.levels[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (source.levelSequence.load(std::memory_order_relaxed) == before)
+            return true;
+    }
+}
+
+SpectrumRegistry::Bands SpectrumRegistry::getMaskedBands(const Levels& first, const Levels& second) noexcept
+{
+    const auto firstLoudest = *std::max_element(first.begin(), first.end());
+    const auto secondLoudest = *std::max_element(second.begin(), second.end());
+
+    Bands masked{};
+
+    for (size_t i = 0; i < masked.size(); ++i)
+        masked[i] = first[i] > minimumDecibels && second[i] > minimumDecibels
+            && first[i] >= firstLoudest - maskingRangeDecibels
+            && second[i] >= secondLoudest - maskingRangeDecibels
+            && std::abs(first[i] - second[i]) <= maskingDifferenceDecibels;
+
+    return masked;
+}
+
+double SpectrumRegistry::getBandFrequency(int band) noexcept
+{
+    return juce::mapToLog10(((double)band + 0.5) / numBands, 20.0, 20000.0);
+}
+
+void SpectrumRegistry::subscribe()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (subscribers++ > 0)
+        return;
+
+    for (int i = 0; i < maxInstances; ++i)
+        if (states[(size_t)i].load(std::memory_order_acquire) == usedSlot)
+            slots[(size_t)i]->fifo.setEnabled(true);
+
+    startThread(juce::Thread::Priority::low);
+}
+
+void SpectrumRegistry::unsubscribe()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (--subscribers > 0)
+        return;
+
+    stopThread(1000);
+
+    // Old levels would only mislead the next subscriber.
+    for (int i = 0; i < maxInstances; ++i)
+    {
+        if (states[(size_t)i].load(std::memory_order_acquire) == usedSlot)
+        {
+            slots[(size_t)i]->fifo.setEnabled(false);
+            slots[(size_t)i]->hasLevels.store(false, std::memory_order_relaxed);
+        }
+    }
+}
+
+void SpectrumRegistry::run()
+{
+    while (!threadShouldExit())
+    {
+        for (int i = 0; i < maxInstances && !threadShouldExit(); ++i)
+        {
+            const juce::ScopedLock lock(slotLock);
+
+            if (states[(size_t)i].load(std::memory_order_acquire) == usedSlot)
+                analyse(i);
+        }
+
+        // Every slot has a new frame due every 66 ms.
+        wait(10);
+    }
+
+    // Whatever's left in the rings is stale by the next subscription.
+    for (auto& analysis : analyses)
+        analysis.generation = 0;
+}
+
+void SpectrumRegistry::analyse(int index)
+{
+    auto& slot = *slots[(size_t)index];
+    auto& analysis = analyses[(size_t)index];
+
+    const auto generation = slot.generation.load(std::memory_order_relaxed);
+    const auto sampleRate = slot.fifo.getSampleRate();
+
+    // A new instance in the slot, or a new sample rate, starts over.
+    if (generation != analysis.generation || sampleRate != analysis.sampleRate)
+    {
+        if (analysis.history.empty())
+        {
+            analysis.history.resize((size_t)fftSize);
+            analysis.incoming.resize((size_t)fftSize);
+        }
+
+        std::fill(analysis.history.begin(), analysis.history.end(), 0.f);
+        analysis.numIncoming = 0;
+        analysis.started = false;
+        analysis.generation = generation;
+        analysis.sampleRate = sampleRate;
+
+        slot.fifo.discard();
+
+        const auto lastBin = fftSize / 2;
+        const auto binsPerHertz = (double)fftSize / sampleRate;
+
+        auto toBin = [&](double proportion)
+            {
+                return juce::jlimit(0.0, (double)lastBin, juce::mapToLog10(proportion, 20.0, 20000.0) * binsPerHertz);
+            };
+
+        for (size_t i = 0; i < (size_t)numBands; ++i)
+        {
+            const auto low = toBin((double)i / numBands);
+            const auto high = toBin((double)(i + 1) / numBands);
+
+            if (high - low >= 1.0)
+            {
+                analysis.firstBin[i] = (int)std::ceil(low);
+                analysis.lastBin[i] = juce::jmin(lastBin, (int)std::floor(high));
+                analysis.fraction[i] = 0.f;
+            }
+            else
+            {
+                const auto centre = juce::jmin((low + high) * 0.5, (double)lastBin - 1.0);
+
+                analysis.firstBin[i] = (int)centre;
+                analysis.lastBin[i] = analysis.firstBin[i];
+                analysis.fraction[i] = (float)(centre - analysis.firstBin[i]);
+            }
+        }
+    }
+
+    const auto hop = juce::jlimit(1, fftSize, juce::roundToInt(sampleRate / updatesPerSecond));
+
+    analysis.numIncoming += slot.fifo.pull(analysis.incoming.data() + analysis.numIncoming, hop - analysis.numIncoming);
+
+    if (analysis.numIncoming < hop)
+        return;
+
+    std::copy(analysis.history.begin() + hop, analysis.history.end(), analysis.history.begin());
+    std::copy_n(analysis.incoming.begin(), hop, analysis.history.end() - hop);
+    analysis.numIncoming = 0;
+
+    std::copy(analysis.history.begin(), analysis.history.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // A full scale sine peaks at fftSize / 4 through a Hann window.
+    const auto normalise = 4.0 / fftSize;
+    const auto smoothing = std::exp(-1.0 / (smoothingSeconds * updatesPerSecond));
+
+    Levels levels;
+
+    for (size_t i = 0; i < (size_t)numBands; ++i)
+    {
+        double power = 0;
+
+        if (analysis.lastBin[i] > analysis.firstBin[i])
+        {
+            for (auto bin = analysis.firstBin[i]; bin <= analysis.lastBin[i]; ++bin)
+                power += juce::square(fftData[(size_t)bin] * normalise);
+
+            power /= analysis.lastBin[i] - analysis.firstBin[i] + 1;
+        }
+        else
+        {
+            const auto bin = (size_t)analysis.firstBin[i];
+            power = juce::square((fftData[bin] + (fftData[bin + 1] - fftData[bin]) * analysis.fraction[i]) * normalise);
+        }
+
+        auto& smoothed = analysis.power[i];
+        smoothed = analysis.started ? smoothed * smoothing + power * (1.0 - smoothing) : power;
+
+        levels[i] = juce::jmax(minimumDecibels, 10.f * (float)std::log10(smoothed + 1e-20));
+    }
+
+    analysis.started = true;
+    publishLevels(slot, levels);
+}
+
+void SpectrumRegistry::publishLevels(Slot& slot, const Levels& levels) noexcept
+{
+    const auto start = slot.levelSequence.load(std::memory_order_relaxed);
+
+    slot.levelSequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < levels.size(); ++i)
+        slot.levels[i].store(levels[i], std::memory_order_relaxed);
+
+    slot.levelSequence.store(start + 2, std::memory_order_release);
+    slot.hasLevels.store(true, std::memory_order_release);
+}
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    SpectrumSharing.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Spectrogram.h"
+
+/**
+    A process-wide registry where every instance of the plug-in publishes a
+    coarse spectrum of its output, so an editor can show what the other
+    tracks in the session occupy and where they collide with its own.
+
+    An instance takes one of maxInstances slots with join() for as long as it
+    lives, and gives it back with leave(). Slots are claimed with a compare
+    and swap. A slot's memory is made the first time it's claimed and then
+    kept and reused by every later owner: numBands levels and a name, and a
+    ring of fifoCapacity samples from the audio thread, about 33 kB, once an
+    editor first subscribes. join()
+    empties the ring and bumps the slot's generation, which is how the
+    analysis tells a new owner from the last one.
+
+    Nothing runs while no editor subscribes: the audio thread's push() finds
+    the ring switched off and returns. The first Subscription switches every
+    ring on and starts one background thread that analyses each instance in
+    turn, updatesPerSecond times a second; the last one stops it again.
+
+    Levels and names are published behind sequence counters (seqlocks), so
+    the analysis thread never waits on a reader and readers always get a
+    consistent snapshot.
+
+    Held through a juce::SharedResourcePointer, so it's made with the first
+    instance and goes with the last.
+*/
+class SpectrumRegistry : private juce::Thread
+{
+public:
+    static constexpr int maxInstances = 64;
+
+    // Log spaced from 20 Hz to 20 kHz, about ten to the octave.
+    static constexpr int numBands = 96;
+
+    static constexpr float minimumDecibels = -100.f;
+
+    static constexpr int fftOrder = 12, fftSize = 1 << fftOrder;
+
+    // A fifth of a second at 48 kHz, three updates' worth.
+    static constexpr int fifoCapacity = 1 << 13;
+
+    static constexpr double updatesPerSecond = 15.0;
+
+    // The levels follow what a track occupies over the last moment, not every transient.
+    static constexpr double smoothingSeconds = 0.5;
+
+    // Two tracks mask each other in a band when both are within maskingRange
+    // of their own loudest band and within maskingDifference of each other.
+    static constexpr float maskingRangeDecibels = 24.f, maskingDifferenceDecibels = 6.f;
+
+    using Levels = std::array<float, numBands>;
+    using Bands = std::array<bool, numBands>;
+
+    struct Entry
+    {
+        int slot;
+        juce::String name;
+    };
+
+    /** Keeps every instance's spectrum coming while it exists. Message thread. */
+    class Subscription
+    {
+    public:
+        explicit Subscription(SpectrumRegistry& registryToUse);
+        ~Subscription();
+
+    private:
+        SpectrumRegistry& registry;
+
+        JUCE_DECLARE_NON_COPYABLE(Subscription)
+    };
+
+    SpectrumRegistry();
+    ~SpectrumRegistry() override;
+
+    /** Claims a free slot and names it after its number. -1 when all of them are taken. */
+    int join();
+
+    /** Frees a slot for the next instance. */
+    void leave(int slot);
+
+    /** Renames a slot, say after the host's track. Only the slot's owner. */
+    void setName(int slot, const juce::String& name);
+
+    juce::String getName(int slot) const;
+
+    /** Tells the analysis what sample rate a slot's audio is at. */
+    void prepare(int slot, double sampleRate) noexcept;
+
+    /** Adds a block of an instance's output, summed to mono. Audio thread
+        only, and free while nobody subscribes.
+    */
+    void push(int slot, const juce::dsp::AudioBlock<const float>& block) noexcept
+    {
+        if (juce::isPositiveAndBelow(slot, maxInstances))
+            slots[(size_t)slot]->fifo.push(block);
+    }
+
+    /** Every slot in use, in slot order. */
+    std::vector<Entry> getEntries() const;
+
+    /** The latest levels of a slot, in dBFS. False while it's empty or nothing has been analysed yet. */
+    bool getLevels(int slot, Levels& levels) const;
+
+    /** The bands where two sets of levels mask each other. */
+    static Bands getMaskedBands(const Levels& first, const Levels& second) noexcept;
+
+    static double getBandFrequency(int band) noexcept;
+
+private:
+    enum SlotState
+    {
+        freeSlot,
+        claimingSlot,
+        usedSlot
+    };
+
+    static constexpr int maxNameBytes = 48;
+
+    struct Slot
+    {
+        SpectrumFifo fifo{ fifoCapacity };
+
+        // Bumped by every join(), so the analysis knows to start over.
+        std::atomic<juce::uint32> generation{ 0 };
+
+        std::array<std::atomic<float>, numBands> levels{};
+        std::atomic<juce::uint32> levelSequence{ 0 };
+        std::atomic<bool> hasLevels{ false };
+
+        // UTF-8, null terminated.
+        std::array<std::atomic<char>, maxNameBytes> name{};
+        std::atomic<juce::uint32> nameSequence{ 0 };
+    };
+
+    // What the analysis thread keeps for each slot.
+    struct Analysis
+    {
+        juce::uint32 generation{ 0 };
+        double sampleRate{ 0 };
+        std::vector<float> history, incoming;
+        int numIncoming{ 0 };
+        std::array<double, numBands> power{};
+        bool started{ false };
+
+        // The bins of each band, or the bin to interpolate from and how far.
+        std::array<int, numBands> firstBin{}, lastBin{};
+        std::array<float, numBands> fraction{};
+    };
+
+    void subscribe();
+    void unsubscribe();
+
+    void run() override;
+
+    void analyse(int slot);
+
+    void publishLevels(Slot& slot, const Levels& levels) noexcept;
+
+    // Held by the analysis thread while it works on a slot, and by join()
+    // while it empties a slot's ring for a new owner.
+    juce::CriticalSection slotLock;
+
+    std::array<std::atomic<int>, maxInstances> states{};
+
+    // Made the first time a slot is claimed, and kept until the registry goes.
+    // Only written while claiming and only read once the slot is in use.
+    std::array<std::unique_ptr<Slot>, maxInstances> slots;
+
+    int subscribers{ 0 };
+
+    // Background thread only.
+    std::array<Analysis, maxInstances> analyses;
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> fftData;
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrumRegistry)
+};
@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+    StateFormat.cpp
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#include "StateFormat.h"
+#include <unordered_map>
+
+namespace StateFormat
+{
+    namespace
+    {
+        constexpr char magic[4]{ 'T', 'M', 'E', 'Q' };
+        constexpr size_t headerSize = 4 + 2 + 2 + 8;
+
+        juce::RangedAudioParameter& asRanged(juce::AudioProcessorParameter* parameter)
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+            jassert(ranged != nullptr); // every parameter comes from the APVTS layout
+            return *ranged;
+        }
+
+        std::vector<float> getDefaultValues(const juce::Array<juce::AudioProcessorParameter*>& parameters)
+        {
+            std::vector<float> values;
+            values.reserve((size_t)parameters.size());
+
+            for (auto* parameter : parameters)
+                values.push_back(parameter->getDefaultValue());
+
+            return values;
+        }
+
+        bool isCompact(const void* data, size_t sizeInBytes)
+        {
+            return sizeInBytes >= headerSize && std::memcmp(data, magic, sizeof(magic)) == 0;
+        }
+
+        float readPlainValue(const char* stored, int index)
+        {
+            auto bits = juce::ByteOrder::littleEndianInt(stored + (size_t)index * sizeof(float));
+
+            float plain;
+            std::memcpy(&plain, &bits, sizeof(float));
+            return plain;
+        }
+
+        juce::Result readCompact(const void* data, size_t sizeInBytes,
+            const juce::Array<juce::AudioProcessorParameter*>& parameters,
+            std::vector<float>& normalisedValues)
+        {
+            auto* bytes = static_cast<const char*>(data);
+
+            auto version = juce::ByteOrder::littleEndianShort(bytes + 4);
+            auto count = (int)juce::ByteOrder::littleEndianShort(bytes + 6);
+            auto layoutHash = juce::ByteOrder::littleEndianInt64(bytes + 8);
+            auto idsAt = headerSize + (size_t)count * sizeof(float);
+
+            if (version > currentVersion)
+                return juce::Result::fail("The state was saved by a newer version of the plug-in");
+
+            if (sizeInBytes < idsAt)
+                return juce::Result::fail("The state is cut short");
+
+            auto values = getDefaultValues(parameters);
+            auto* stored = bytes + headerSize;
+
+            // The parameters line up, so the values can be taken in order.
+            if (count <= parameters.size() && layoutHash == getLayoutHash(parameters, count))
+            {
+                for (int i = 0; i < count; ++i)
+                    values[(size_t)i] = asRanged(parameters.getUnchecked(i)).convertTo0to1(readPlainValue(stored, i));
+
+                normalisedValues = std::move(values);
+                return juce::Result::ok();
+            }
+
+            if (version < 2)
+                return juce::Result::fail("The state was saved with a different set of parameters, "
+                                          "by a version that didn't store their IDs");
+
+            std::unordered_map<juce::String, float> byID;
+            auto position = idsAt;
+
+            for (int i = 0; i < count; ++i)
+            {
+                auto* start = bytes + position;
+                auto* end = static_cast<const char*>(std::memchr(start, 0, sizeInBytes - position));
+
+                if (end == nullptr)
+                    return juce::Result::fail("The state's parameter IDs are cut short");
+
+                byID[juce::String::fromUTF8(start, (int)(end - start))] = readPlainValue(stored, i);
+                position += (size_t)(end - start) + 1;
+            }
+
+            for (int i = 0; i < parameters.size(); ++i)
+            {
+                auto& parameter = asRanged(parameters.getUnchecked(i));
+                auto found = byID.find(parameter.getParameterID());
+
+                if (found != byID.end())
+                    values[(size_t)i] = parameter.convertTo0to1(found->second);
+            }
+
+            normalisedValues = std::move(values);
+            return juce::Result::ok();
+        }
+
+        // Earlier versions saved apvts.state: a tree with one PARAM child per
+        // parameter, holding "id" and "value".
+        juce::Result readLegacy(const void* data, size_t sizeInBytes,
+            const juce::Array<juce::AudioProcessorParameter*>& parameters,
+            const juce::Identifier& legacyStateType,
+            std::vector<float>& normalisedValues)
+        {
+            auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
+
+            if (!tree.hasType(legacyStateType))
+                return juce::Result::fail("The state isn't one this plug-in saved");
+
+            std::unordered_map<juce::String, float> stored;
+
+            for (auto child : tree)
+                if (child.hasProperty("id") && child.hasProperty("value"))
+                    stored[child["id"].toString()] = (float)child["value"];
+
+            auto values = getDefaultValues(parameters);
+
+            for (int i = 0; i < parameters.size(); ++i)
+            {
+                auto& parameter = asRanged(parameters.getUnchecked(i));
+                auto found = stored.find(parameter.getParameterID());
+
+                if (found != stored.end())
+                    values[(size_t)i] = parameter.convertTo0to1(found->second);
+            }
+
+            normalisedValues = std::move(values);
+            return juce::Result::ok();
+        }
+    }
+
+    //==============================================================================
+    // FNV-1a over the IDs of the first numParameters parameters.
+    juce::uint64 getLayoutHash(const juce::Array<juce::AudioProcessorParameter*>& parameters, int numParameters)
+    {
+        juce::uint64 hash = 14695981039346656037ull;
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            for (auto c : asRanged(parameters.getUnchecked(i)).getParameterID())
+            {
+                hash ^= (juce::uint64)c;
+                hash *= 1099511628211ull;
+            }
+
+            hash ^= 0xff; // separator, so "ab" + "c" differs from "a" + "bc"
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    void write(const juce::Array<juce::AudioProcessorParameter*>& parameters, juce::MemoryBlock& destData)
+    {
+        jassert(parameters.size() <= std::numeric_limits<juce::uint16>::max());
+
+        juce::MemoryOutputStream stream(destData, false);
+
+        stream.write(magic, sizeof(magic));
+        stream.writeShort((short)currentVersion);
+        stream.writeShort((short)parameters.size());
+        stream.writeInt64((juce::int64)getLayoutHash(parameters, parameters.size()));
+
+        for (auto* parameter : parameters)
+        {
+            auto& ranged = asRanged(parameter);
+            stream.writeFloat(ranged.convertFrom0to1(ranged.getValue()));
+        }
+
+        for (auto* parameter : parameters)
+        {
+            auto id = asRanged(parameter).getParameterID().toUTF8();
+            stream.write(id.getAddress(), id.sizeInBytes());
+        }
+    }
+
+    juce::Result read(const void* data, int sizeInBytes,
+        const juce::Array<juce::AudioProcessorParameter*>& parameters,
+        const juce::Identifier& legacyStateType,
+        std::vector<float>& normalisedValues)
+    {
+        if (data == nullptr || sizeInBytes <= 0)
+            return juce::Result::fail("The state is empty");
+
+        if (isCompact(data, (size_t)sizeInBytes))
+            return readCompact(data, (size_t)sizeInBytes, parameters, normalisedValues);
+
+        return readLegacy(data, (size_t)sizeInBytes, parameters, legacyStateType, normalisedValues);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    StateFormat.h
+    Created: 18 Oct 2026
+    Author:  TradeMark Media & Tech
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    The plug-in's saved state: a small header, one little-endian float per
+    parameter in parameter order, and the parameters' IDs.
+
+        magic        4 bytes   "TMEQ"
+        version      uint16
+        count        uint16    number of values that follow
+        layoutHash   uint64    hash of the first `count` parameter IDs
+        values       count x float32, plain (not normalised) values
+        ids          count x UTF-8 parameter ID, each null terminated
+                     (from version 2 on)
+
+    Parameters are meant to be appended, so a block written by an older
+    version simply has fewer values; the rest get their defaults. When the
+    layout hash says the parameters don't line up with ours, because one was
+    inserted, removed or renamed, the values are matched up by ID instead.
+    Version 1 blocks have no IDs, so a mismatch there can't be recovered.
+
+    Blocks that aren't in this format are read as the ValueTree that earlier
+    versions saved.
+*/
+namespace StateFormat
+{
+    constexpr juce::uint16 currentVersion = 2;
+
+    /** A hash of the IDs of the first numParameters parameters, so a block of
+        values can be checked against the parameters it is applied to.
+    */
+    juce::uint64 getLayoutHash(const juce::Array<juce::AudioProcessorParameter*>& parameters, int numParameters);
+
+    /** Writes the current value of every parameter. */
+    void write(const juce::Array<juce::AudioProcessorParameter*>& parameters, juce::MemoryBlock& destData);
+
+    /** Reads a block written by write(), or a legacy ValueTree of type
+        legacyStateType, into one normalised value per parameter. Parameters
+        the block doesn't mention get their default value. Fails with a
+        message saying why, and leaves normalisedValues alone, if the block
+        can't be read.
+    */
+    juce::Result read(const void* data, int sizeInBytes,
+        const juce::Array<juce::AudioProcessorParameter*>& parameters,
+        const juce::Identifier& legacyStateType,
+        std::vector<float>& normalisedValues);
+}